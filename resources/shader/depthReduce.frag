@@ -0,0 +1,18 @@
+#version 330 core
+
+uniform sampler2D depthTexture;
+uniform int blockSize;
+
+out float depth;
+
+void main()
+{
+    // each texel holds the farthest depth of a block of pixels, pixels outside the viewport repeat the border.
+    ivec2 lastPixel = textureSize(depthTexture, 0) - 1;
+    ivec2 firstPixel = ivec2(gl_FragCoord.xy) * blockSize;
+    float maxDepth = 0.0f;
+    for (int y = 0; y < blockSize; ++y) {
+        for (int x = 0; x < blockSize; ++x) maxDepth = max(maxDepth, texelFetch(depthTexture, min(firstPixel + ivec2(x, y), lastPixel), 0).r);
+    }
+    depth = maxDepth;
+}
@@ -0,0 +1,10 @@
+#version 330 core
+
+in vec4 vColor;
+
+out vec4 color;
+
+void main()
+{
+    color = vec4(vColor.rgb, 1.0f);
+}
@@ -0,0 +1,57 @@
+#version 430 core
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec4 color;
+// per instance attribute, the base instance of each draw command selects the transformation of its node.
+layout(location = 2) in uint drawIndex;
+
+struct NodeTransform
+{
+    vec4 boundsMin;
+    vec4 boundsExtent;
+};
+
+// quantized positions arrive normalized to [0, 1] and are mapped to the nodes bounding box, float positions use (0, 1).
+layout(std430, binding = 0) readonly buffer NodeTransforms
+{
+    NodeTransform nodeTransforms[];
+};
+
+uniform mat4 viewProjectionMatrix;
+uniform float pointSize;
+
+// the attribute the points are colored by (PointCloudColorMode), scalar attributes arrive in color.r.
+uniform int colorMode;
+// the offset and scale mapping intensities and GPS times to [0, 1].
+uniform vec2 attributeRange;
+
+// ASPRS classes: never classified, unclassified, ground, low, medium and high vegetation, building, noise,
+// model key, water, rail, road surface, overlap.
+const vec3 classColors[13] = vec3[13](vec3(0.5f, 0.5f, 0.5f), vec3(0.7f, 0.7f, 0.7f), vec3(0.6f, 0.45f, 0.3f), vec3(0.6f, 0.9f, 0.4f),
+    vec3(0.3f, 0.75f, 0.2f), vec3(0.1f, 0.5f, 0.1f), vec3(0.9f, 0.3f, 0.2f), vec3(1.0f, 0.0f, 1.0f), vec3(1.0f, 1.0f, 0.0f),
+    vec3(0.2f, 0.4f, 1.0f), vec3(0.6f, 0.3f, 0.6f), vec3(0.3f, 0.3f, 0.3f), vec3(1.0f, 0.6f, 0.0f));
+const vec3 returnColors[5] = vec3[5](vec3(1.0f, 0.2f, 0.2f), vec3(0.2f, 0.9f, 0.2f), vec3(0.2f, 0.4f, 1.0f), vec3(1.0f, 0.9f, 0.2f),
+    vec3(0.9f, 0.3f, 0.9f));
+
+vec4 AttributeColor()
+{
+    if (colorMode == 1) return vec4(vec3(clamp((color.r - attributeRange.x) * attributeRange.y, 0.0f, 1.0f)), 1.0f);
+    if (colorMode == 2) return vec4(classColors[clamp(int(color.r), 0, 12)], 1.0f);
+    if (colorMode == 3) return vec4(returnColors[clamp(int(color.r) - 1, 0, 4)], 1.0f);
+    if (colorMode == 4) {
+        // blue over green to red from the first to the last point.
+        float t = clamp((color.r - attributeRange.x) * attributeRange.y, 0.0f, 1.0f);
+        return vec4(clamp(vec3(2.0f * t - 1.0f, 1.0f - abs(2.0f * t - 1.0f), 1.0f - 2.0f * t), 0.0f, 1.0f), 1.0f);
+    }
+    return color;
+}
+
+out vec4 vColor;
+
+void main()
+{
+    NodeTransform nodeTransform = nodeTransforms[drawIndex];
+    gl_Position = viewProjectionMatrix * vec4(nodeTransform.boundsMin.xyz + position * nodeTransform.boundsExtent.xyz, 1.0f);
+    gl_PointSize = pointSize;
+    vColor = AttributeColor();
+}
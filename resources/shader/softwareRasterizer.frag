@@ -0,0 +1,16 @@
+#version 330 core
+
+in vec2 vTexCoord;
+
+uniform sampler2D colorTexture;
+uniform sampler2D depthTexture;
+
+out vec4 color;
+
+void main()
+{
+    vec4 pointColor = texture(colorTexture, vTexCoord);
+    if (pointColor.a == 0.0f) discard;
+    color = vec4(pointColor.rgb, 1.0f);
+    gl_FragDepth = texture(depthTexture, vTexCoord).r;
+}
@@ -0,0 +1,11 @@
+#version 330 core
+
+out vec2 vTexCoord;
+
+void main()
+{
+    // full screen triangle, counter clockwise.
+    vec2 position = vec2(float((gl_VertexID & 1) << 2) - 1.0f, float((gl_VertexID & 2) << 1) - 1.0f);
+    vTexCoord = 0.5f * position + 0.5f;
+    gl_Position = vec4(position, 0.0f, 1.0f);
+}
@@ -11,8 +11,9 @@
 #include "core/glfw.h"
 #include <glbinding/gl/gl.h>
 #include <glbinding/Binding.h>
-#include <glbinding/callbacks.h>
 #include <imgui.h>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -20,98 +21,57 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "Vertices.h"
+#include "MeshCache.h"
+#include "PointCloudRenderer.h"
+#include "LivePointCloudRenderer.h"
 #include "core/imgui/imgui_impl_glfw_gl3.h"
 // #include "core/gfx/mesh/MeshRenderable.h"
 
-void ecb(const glbinding::FunctionCall & call) {
-    std::stringstream callOut;
-    callOut << call.function->name() << "(";
-    for (unsigned i = 0; i < call.parameters.size(); ++i)
-    {
-        callOut << call.parameters[i]->asString();
-        if (i < call.parameters.size() - 1)
-            callOut << ", ";
-    }
-    callOut << ")";
-
-    if (call.returnValue)
-        callOut << " -> " << call.returnValue->asString();
-
-    LOG(DBUG) << callOut.str();
-
-    const auto error = gl::glGetError();
-
-    auto doprint = true;
-    std::string errorStr;
-    switch (error)
-    {
-    case gl::GL_INVALID_ENUM:
-        errorStr = "GL_INVALID_ENUM";
-        break;
-    case gl::GL_INVALID_VALUE:
-        errorStr = "GL_INVALID_VALUE";
-        break;
-    case gl::GL_INVALID_OPERATION:
-        errorStr = "GL_INVALID_OPERATION";
-        break;
-    case gl::GL_INVALID_FRAMEBUFFER_OPERATION:
-        errorStr = "GL_INVALID_FRAMEBUFFER_OPERATION";
-        break;
-    case gl::GL_OUT_OF_MEMORY:
-        errorStr = "GL_OUT_OF_MEMORY";
-        break;
-    case gl::GL_STACK_UNDERFLOW:
-        errorStr = "GL_STACK_UNDERFLOW";
-        break;
-    case gl::GL_STACK_OVERFLOW:
-        errorStr = "GL_STACK_OVERFLOW";
-        break;
-    case gl::GL_TABLE_TOO_LARGE:
-        errorStr = "GL_TABLE_TOO_LARGE";
-        break;
-    case gl::GL_TEXTURE_TOO_LARGE_EXT:
-        errorStr = "GL_TEXTURE_TOO_LARGE_EXT";
-        break;
-    default:
-        doprint = false;
-        break;
-    }
+namespace viscom {
 
-    if (doprint) {
-        LOG(WARNING) << "Error: " << errorStr;
+    namespace {
+        /** Checks if two frame states show the same image of the point cloud, the point budget only changes how fast it is refined. */
+        bool IsSameImage(const FrameState& a, const FrameState& b)
+        {
+            return std::memcmp(&a.cameraPosition_, &b.cameraPosition_, sizeof(glm::vec3)) == 0 && std::memcmp(&a.cameraRotation_, &b.cameraRotation_, sizeof(glm::vec3)) == 0
+                && a.minNodeSize_ == b.minNodeSize_ && a.softwareRasterizer_ == b.softwareRasterizer_ && a.colorMode_ == b.colorMode_ && a.views_.size() == b.views_.size()
+                && (a.views_.empty() || std::memcmp(a.views_.data(), b.views_.data(), a.views_.size() * sizeof(ClusterView)) == 0);
+        }
     }
-}
-
-namespace viscom {
 
     ApplicationNodeImplementation::ApplicationNodeImplementation(ApplicationNodeInternal* appNode) :
         ApplicationNodeBase{ appNode }
     {
+        // slaves start with the same defaults as the master until the first state arrives.
+        CaptureFrameState();
     }
 
     ApplicationNodeImplementation::~ApplicationNodeImplementation() = default;
 
     void ApplicationNodeImplementation::InitOpenGL()
     {
-        {
-            using namespace glbinding;
-            Binding::initialize();
+        glbinding::Binding::initialize();
 #ifdef VISCOM_OGL_DEBUG_MSGS
-            setCallbackMaskExcept(CallbackMask::After | CallbackMask::ParametersAndReturnValue, { "glGetError" });
-            setAfterCallback(ecb);
-#endif // VISCOM_OGL_DEBUG_MSGS
+        try {
+            glTracer_ = std::make_unique<GLTracer>(VISCOM_GL_TRACE_FILE, VISCOM_GL_TRACE_SAMPLING, VISCOM_GL_TRACE_ARGUMENTS != 0);
         }
+        catch (const std::runtime_error& e) {
+            LOG(WARNING) << "OpenGL calls are not traced: " << e.what();
+        }
+#endif // VISCOM_OGL_DEBUG_MSGS
 
-        backgroundProgram_ = GetGPUProgramManager().GetResource("backgroundGrid", std::initializer_list<std::string>{ "backgroundGrid.vert", "backgroundGrid.frag" });
-        backgroundMVPLoc_ = backgroundProgram_->getUniformLocation("MVP");
+        programCache_ = std::make_unique<ProgramBinaryCache>(GetConfig().baseDirectory_ + "resources/shader", VISCOM_PROGRAM_CACHE_DIR);
 
-        triangleProgram_ = GetGPUProgramManager().GetResource("foregroundTriangle", std::initializer_list<std::string>{ "foregroundTriangle.vert", "foregroundTriangle.frag" });
-        triangleMVPLoc_ = triangleProgram_->getUniformLocation("MVP");
+        backgroundProgram_ = programCache_->GetProgram("backgroundGrid", { "backgroundGrid.vert", "backgroundGrid.frag" });
+        backgroundMVPLoc_ = gl::glGetUniformLocation(backgroundProgram_, "MVP");
 
-        teapotProgram_ = GetGPUProgramManager().GetResource("foregroundMesh", std::initializer_list<std::string>{ "foregroundMesh.vert", "foregroundMesh.frag" });
-        teapotModelMLoc_ = teapotProgram_->getUniformLocation("modelMatrix");
-        teapotNormalMLoc_ = teapotProgram_->getUniformLocation("normalMatrix");
-        teapotVPLoc_ = teapotProgram_->getUniformLocation("viewProjectionMatrix");
+        triangleProgram_ = programCache_->GetProgram("foregroundTriangle", { "foregroundTriangle.vert", "foregroundTriangle.frag" });
+        triangleMVPLoc_ = gl::glGetUniformLocation(triangleProgram_, "MVP");
+
+        teapotProgram_ = programCache_->GetProgram("foregroundMesh", { "foregroundMesh.vert", "foregroundMesh.frag" });
+        teapotModelMLoc_ = gl::glGetUniformLocation(teapotProgram_, "modelMatrix");
+        teapotNormalMLoc_ = gl::glGetUniformLocation(teapotProgram_, "normalMatrix");
+        teapotVPLoc_ = gl::glGetUniformLocation(teapotProgram_, "viewProjectionMatrix");
 
         std::vector<GridVertex> gridVertices;
 
@@ -155,24 +115,175 @@ namespace viscom {
 
         gl::glBindBuffer(gl::GL_ARRAY_BUFFER, 0);
 
-        teapotMesh_ = GetMeshManager().GetResource("/models/teapot/teapot.obj");
-        // teapotRenderable_ = MeshRenderable::create<SimpleMeshVertex>(teapotMesh_.get(), teapotProgram_.get());
+        LoadTeapot();
+
+        profiler_ = std::make_unique<FrameProfiler>();
+
+        std::string pointCloudFile = VISCOM_POINTCLOUD_FILE;
+        // a streamed point cloud is opened once its manifest arrived from the master.
+        if (!pointCloudFile.empty() && !IsPointCloudStreamed()) OpenPointCloud(pointCloudFile);
+
+        std::string livePointCloudFile = VISCOM_LIVE_POINTCLOUD_FILE;
+        if (!livePointCloudFile.empty()) {
+            try {
+                if (pointCloudProgram_ == 0) pointCloudProgram_ = programCache_->GetProgram("pointCloud", { "pointCloud.vert", "pointCloud.frag" });
+                // the live points share the origin of the point cloud drawn with them, its bounds are kept inside the root.
+                auto rootCenter = glm::vec3(0.0f);
+                auto rootSize = static_cast<float>(VISCOM_LIVE_ROOT_SIZE);
+                if (pointCloud_) {
+                    const auto& header = pointCloud_->GetFile().GetHeader();
+                    rootCenter = 0.5f * (header.boundsMin_ + header.boundsMax_);
+                    auto extent = header.boundsMax_ - header.boundsMin_;
+                    rootSize = std::max({ rootSize, extent.x, extent.y, extent.z });
+                }
+                auto ingestion = std::make_unique<LiveIngestion>(rootCenter, rootSize);
+                if (pointCloud_) ingestion->TailFile(livePointCloudFile, pointCloud_->GetFile().GetHeader().origin_);
+                else ingestion->TailFile(livePointCloudFile);
+                livePointCloud_ = std::make_unique<LivePointCloudRenderer>(std::move(ingestion), pointCloudProgram_);
+            }
+            catch (const std::runtime_error& e) {
+                LOG(WARNING) << "Could not ingest live points: " << e.what();
+            }
+        }
+
+        const auto& programStatistics = programCache_->GetStatistics();
+        LOG(INFO) << "Shader programs (" << (programStatistics.numCompiled_ == 0 ? "warm" : "cold") << " start): "
+            << programStatistics.numLoaded_ << " loaded from binaries in " << programStatistics.loadTime_ << " ms, "
+            << programStatistics.numCompiled_ << " compiled in " << programStatistics.compileTime_ << " ms.";
+    }
+
+    /**
+     *  Creates the point cloud renderer and its shader programs, logs a warning if the file cannot be drawn.
+     *  @param filename the point cloud file.
+     */
+    void ApplicationNodeImplementation::OpenPointCloud(const std::string& filename)
+    {
+        try {
+            pointCloudProgram_ = programCache_->GetProgram("pointCloud", { "pointCloud.vert", "pointCloud.frag" });
+            softwareRasterizerProgram_ = programCache_->GetProgram("softwareRasterizer", { "softwareRasterizer.vert", "softwareRasterizer.frag" });
+            // indirect draw calls with storage buffers need OpenGL 4.3, older contexts draw every node separately.
+            GLint majorVersion = 0, minorVersion = 0;
+            gl::glGetIntegerv(gl::GL_MAJOR_VERSION, &majorVersion);
+            gl::glGetIntegerv(gl::GL_MINOR_VERSION, &minorVersion);
+            if (majorVersion > 4 || (majorVersion == 4 && minorVersion >= 3)) {
+                try {
+                    pointCloudIndirectProgram_ = programCache_->GetProgram("pointCloudIndirect", { "pointCloudIndirect.vert", "pointCloud.frag" });
+                }
+                catch (const std::runtime_error& e) {
+                    LOG(WARNING) << "Could not create the indirect point cloud program: " << e.what();
+                }
+            }
+            try {
+                depthReduceProgram_ = programCache_->GetProgram("depthReduce", { "softwareRasterizer.vert", "depthReduce.frag" });
+            }
+            catch (const std::runtime_error& e) {
+                LOG(WARNING) << "Could not create the depth reduce program: " << e.what();
+            }
+            pointCloud_ = std::make_unique<PointCloudRenderer>(filename, pointCloudProgram_, pointCloudIndirectProgram_);
+            pointCloud_->SetSubmission(VISCOM_INDIRECT_DRAW != 0 ? PointCloudSubmission::Indirect : PointCloudSubmission::PerNode);
+            pointCloud_->SetCompositeProgram(softwareRasterizerProgram_);
+            pointCloud_->SetProgressive(VISCOM_PROGRESSIVE_REFINEMENT != 0);
+            pointCloud_->SetDepthReduceProgram(depthReduceProgram_);
+            pointCloud_->SetOcclusionCulling(VISCOM_OCCLUSION_CULLING != 0);
+        }
+        catch (const std::runtime_error& e) {
+            LOG(WARNING) << "Could not load point cloud: " << e.what();
+        }
+    }
+
+    /**
+     *  Loads the teapot into its vertex and index buffers. The interleaved vertices and indices are mapped from the
+     *  binary mesh cache if it is up to date, otherwise the mesh is parsed and the cache is written and mapped for
+     *  the next start. The buffers are created on both paths, drawing the teapot stays disabled.
+     */
+    void ApplicationNodeImplementation::LoadTeapot()
+    {
+        MeshCache cache(GetConfig().baseDirectory_ + "resources/models/teapot/teapot.obj", sizeof(SimpleMeshVertex));
+        std::vector<SimpleMeshVertex> vertices;
+        std::vector<std::uint32_t> indices;
+        if (!cache.Load()) {
+            auto mesh = GetMeshManager().GetResource("/models/teapot/teapot.obj");
+            vertices = SimpleMeshVertex::CreateVertices(mesh.get());
+            indices = mesh->GetIndices();
+            try {
+                cache.Store(vertices.data(), vertices.size(), indices.data(), indices.size());
+                cache.Load();
+            }
+            catch (const std::runtime_error& e) {
+                LOG(WARNING) << "Could not write mesh cache: " << e.what();
+            }
+        }
+
+        const void* vertexData = vertices.data();
+        const void* indexData = indices.data();
+        auto numVertices = vertices.size();
+        numTeapotIndices_ = indices.size();
+        if (cache.IsLoaded()) {
+            vertexData = cache.GetVertexData();
+            indexData = cache.GetIndexData();
+            numVertices = cache.GetNumVertices();
+            numTeapotIndices_ = cache.GetNumIndices();
+        }
+
+        gl::glGenBuffers(1, &vboTeapot_);
+        gl::glBindBuffer(gl::GL_ARRAY_BUFFER, vboTeapot_);
+        gl::glBufferData(gl::GL_ARRAY_BUFFER, numVertices * sizeof(SimpleMeshVertex), vertexData, gl::GL_STATIC_DRAW);
+        gl::glGenBuffers(1, &iboTeapot_);
+        gl::glBindBuffer(gl::GL_ELEMENT_ARRAY_BUFFER, iboTeapot_);
+        gl::glBufferData(gl::GL_ELEMENT_ARRAY_BUFFER, numTeapotIndices_ * sizeof(std::uint32_t), indexData, gl::GL_STATIC_DRAW);
+        gl::glBindBuffer(gl::GL_ELEMENT_ARRAY_BUFFER, 0);
+        gl::glBindBuffer(gl::GL_ARRAY_BUFFER, 0);
     }
 
     void ApplicationNodeImplementation::UpdateFrame(double currentTime, double)
     {
-        GetCamera()->SetPosition(camPos_);
-        glm::quat pitchQuat = glm::angleAxis(camRot_.x, glm::vec3(1.0f, 0.0f, 0.0f));
-        glm::quat yawQuat = glm::angleAxis(camRot_.y, glm::vec3(0.0f, 1.0f, 0.0f));
-        glm::quat rollQuat = glm::angleAxis(camRot_.z, glm::vec3(0.0f, 0.0f, 1.0f));
-        GetCamera()->SetOrientation(yawQuat * pitchQuat * rollQuat);
+        if (glTracer_) glTracer_->NextFrame();
+        profiler_->BeginFrame();
+        FrameProfiler::ScopedPhase profilePhase{ *profiler_, FramePhase::UpdateFrame };
+
+        // input and camera paths change the state of the next frame, the current one was already sent to the slaves.
+        UpdateCameraPath(currentTime);
+        CameraPathKeyframe camera;
+        camera.position_ = frameState_.cameraPosition_;
+        camera.rotation_ = frameState_.cameraRotation_;
+        GetCamera()->SetPosition(camera.position_);
+        GetCamera()->SetOrientation(camera.GetOrientation());
+        lodParameters_.pointBudget_ = frameState_.pointBudget_;
+        lodParameters_.minNodeSize_ = frameState_.minNodeSize_;
 
         triangleModelMatrix_ = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 0.0f, 0.0f)), static_cast<float>(currentTime), glm::vec3(0.0f, 1.0f, 0.0f));
         teapotModelMatrix_ = glm::scale(glm::rotate(glm::translate(glm::mat4(0.01f), glm::vec3(-3.0f, 0.0f, -5.0f)), static_cast<float>(currentTime), glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3(0.01f));
+
+        if (pointCloud_) {
+            auto cameraView = glm::inverse(glm::translate(glm::mat4(1.0f), camera.position_) * glm::mat4_cast(camera.GetOrientation()));
+            pointCloud_->BeginFrame();
+            pointCloud_->SetColorMode(static_cast<PointCloudColorMode>(frameState_.colorMode_));
+            // all nodes see the same state, so they start over and finish the refinement of a still view together.
+            if (frameState_.softwareRasterizer_ != 0 || !IsSameImage(frameState_, refinementState_)) pointCloud_->ResetRefinement();
+            refinementState_ = frameState_;
+            pointCloud_->SetClusterViews(cameraView, frameState_.views_);
+        }
+        // only applies the node updates the ingestion already sent, never waits for it.
+        if (livePointCloud_) livePointCloud_->BeginFrame();
+    }
+
+    /**
+     *  Takes the camera and level of detail parameters of the local input as state for the next frame. The views
+     *  are not changed, they are collected by the master.
+     */
+    void ApplicationNodeImplementation::CaptureFrameState()
+    {
+        frameState_.cameraPosition_ = camPos_;
+        frameState_.cameraRotation_ = camRot_;
+        frameState_.pointBudget_ = lodParameters_.pointBudget_;
+        frameState_.minNodeSize_ = lodParameters_.minNodeSize_;
+        frameState_.softwareRasterizer_ = useSoftwareRasterizer_ ? 1 : 0;
+        frameState_.colorMode_ = static_cast<std::uint8_t>(colorMode_);
     }
 
     void ApplicationNodeImplementation::ClearBuffer(FrameBuffer& fbo)
     {
+        FrameProfiler::ScopedPhase profilePhase{ *profiler_, FramePhase::ClearBuffer };
         fbo.DrawToFBO([]() {
             gl::glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
             gl::glClear(gl::GL_COLOR_BUFFER_BIT | gl::GL_DEPTH_BUFFER_BIT);
@@ -181,13 +292,14 @@ namespace viscom {
 
     void ApplicationNodeImplementation::DrawFrame(FrameBuffer& fbo)
     {
+        FrameProfiler::ScopedPhase profilePhase{ *profiler_, FramePhase::DrawFrame };
         fbo.DrawToFBO([this]() {
             gl::glBindVertexArray(vaoBackgroundGrid_);
             gl::glBindBuffer(gl::GL_ARRAY_BUFFER, vboBackgroundGrid_);
 
             auto MVP = GetCamera()->GetViewPerspectiveMatrix();
             {
-                gl::glUseProgram(backgroundProgram_->getProgramId());
+                gl::glUseProgram(backgroundProgram_);
                 gl::glUniformMatrix4fv(backgroundMVPLoc_, 1, gl::GL_FALSE, glm::value_ptr(MVP));
                 gl::glDrawArrays(gl::GL_TRIANGLES, 0, numBackgroundVertices_);
             }
@@ -195,21 +307,24 @@ namespace viscom {
             {
                 gl::glDisable(gl::GL_CULL_FACE);
                 auto triangleMVP = MVP * triangleModelMatrix_;
-                gl::glUseProgram(triangleProgram_->getProgramId());
+                gl::glUseProgram(triangleProgram_);
                 gl::glUniformMatrix4fv(triangleMVPLoc_, 1, gl::GL_FALSE, glm::value_ptr(triangleMVP));
                 gl::glDrawArrays(gl::GL_TRIANGLES, numBackgroundVertices_, 3);
                 gl::glEnable(gl::GL_CULL_FACE);
             }
 
             {
-                gl::glUseProgram(teapotProgram_->getProgramId());
+                gl::glUseProgram(teapotProgram_);
                 auto normalMatrix = glm::inverseTranspose(glm::mat3(teapotModelMatrix_));
                 gl::glUniformMatrix4fv(teapotModelMLoc_, 1, gl::GL_FALSE, glm::value_ptr(teapotModelMatrix_));
                 gl::glUniformMatrix3fv(teapotNormalMLoc_, 1, gl::GL_FALSE, glm::value_ptr(normalMatrix));
                 gl::glUniformMatrix4fv(teapotVPLoc_, 1, gl::GL_FALSE, glm::value_ptr(MVP));
-                // teapotRenderable_->Draw(teapotModelMatrix_);
             }
 
+            if (pointCloud_ && frameState_.softwareRasterizer_ != 0) pointCloud_->DrawSoftware(MVP, lodParameters_, softwareRasterizerProgram_);
+            else if (pointCloud_) pointCloud_->Draw(MVP, lodParameters_);
+            if (livePointCloud_) livePointCloud_->Draw(MVP, lodParameters_);
+
             gl::glBindBuffer(gl::GL_ARRAY_BUFFER, 0);
             gl::glBindVertexArray(0);
             gl::glUseProgram(0);
@@ -218,10 +333,19 @@ namespace viscom {
 
     void ApplicationNodeImplementation::CleanUp()
     {
+        livePointCloud_.reset();
+        pointCloud_.reset();
+        programCache_.reset();
+        profiler_.reset();
+        glTracer_.reset();
         if (vaoBackgroundGrid_ != 0) gl::glDeleteVertexArrays(1, &vaoBackgroundGrid_);
         vaoBackgroundGrid_ = 0;
         if (vboBackgroundGrid_ != 0) gl::glDeleteBuffers(1, &vboBackgroundGrid_);
         vboBackgroundGrid_ = 0;
+        if (iboTeapot_ != 0) gl::glDeleteBuffers(1, &iboTeapot_);
+        iboTeapot_ = 0;
+        if (vboTeapot_ != 0) gl::glDeleteBuffers(1, &vboTeapot_);
+        vboTeapot_ = 0;
     }
 
     bool ApplicationNodeImplementation::KeyboardCallback(int key, int scancode, int action, int mods)
@@ -277,8 +401,86 @@ namespace viscom {
         case GLFW_KEY_E:
             if (action == GLFW_REPEAT || action == GLFW_PRESS) camRot_ += glm::vec3(0.0, 0.0, 0.002);
             return true;
+
+        case GLFW_KEY_F9:
+            if (action == GLFW_PRESS) ToggleCameraPathRecording();
+            return true;
+
+        case GLFW_KEY_F10:
+            if (action == GLFW_PRESS) ToggleCameraPathReplay();
+            return true;
         }
         return false;
     }
 
+    /**
+     *  Starts recording the camera movement, or stops it and writes the recorded path to VISCOM_CAMERA_PATH_FILE.
+     */
+    void ApplicationNodeImplementation::ToggleCameraPathRecording()
+    {
+        if (cameraPathMode_ != CameraPathMode::Recording) {
+            cameraPath_ = CameraPath();
+            cameraPathMode_ = CameraPathMode::Recording;
+            cameraPathStart_ = -1.0;
+            LOG(INFO) << "Started recording camera path.";
+            return;
+        }
+
+        cameraPathMode_ = CameraPathMode::None;
+        try {
+            cameraPath_.Save(VISCOM_CAMERA_PATH_FILE);
+            LOG(INFO) << "Saved camera path with " << cameraPath_.GetKeyframes().size() << " keyframes to \"" << VISCOM_CAMERA_PATH_FILE << "\".";
+        }
+        catch (const std::runtime_error& e) {
+            LOG(WARNING) << "Could not save camera path: " << e.what();
+        }
+    }
+
+    /**
+     *  Starts replaying the camera path from VISCOM_CAMERA_PATH_FILE, or stops a running replay.
+     */
+    void ApplicationNodeImplementation::ToggleCameraPathReplay()
+    {
+        if (cameraPathMode_ == CameraPathMode::Replaying) {
+            cameraPathMode_ = CameraPathMode::None;
+            return;
+        }
+
+        try {
+            cameraPath_ = CameraPath(VISCOM_CAMERA_PATH_FILE);
+            if (cameraPath_.IsEmpty()) return;
+            cameraPathMode_ = CameraPathMode::Replaying;
+            cameraPathStart_ = -1.0;
+            LOG(INFO) << "Replaying camera path \"" << VISCOM_CAMERA_PATH_FILE << "\" (" << cameraPath_.GetDuration() << "s).";
+        }
+        catch (const std::runtime_error& e) {
+            LOG(WARNING) << "Could not load camera path: " << e.what();
+        }
+    }
+
+    /**
+     *  Records the current camera pose or sets it from the replayed path.
+     *  @param currentTime the current application time.
+     */
+    void ApplicationNodeImplementation::UpdateCameraPath(double currentTime)
+    {
+        if (cameraPathMode_ == CameraPathMode::None) return;
+        if (cameraPathStart_ < 0.0) cameraPathStart_ = currentTime;
+        auto pathTime = currentTime - cameraPathStart_;
+
+        if (cameraPathMode_ == CameraPathMode::Recording) {
+            CameraPathKeyframe keyframe;
+            keyframe.time_ = pathTime;
+            keyframe.position_ = camPos_;
+            keyframe.rotation_ = camRot_;
+            cameraPath_.AddKeyframe(keyframe);
+            return;
+        }
+
+        auto keyframe = cameraPath_.Sample(pathTime);
+        camPos_ = keyframe.position_;
+        camRot_ = keyframe.rotation_;
+        if (pathTime >= cameraPath_.GetDuration()) cameraPathMode_ = CameraPathMode::None;
+    }
+
 }
@@ -10,10 +10,18 @@
 
 #include "core/ApplicationNodeInternal.h"
 #include "core/ApplicationNodeBase.h"
+#include "CameraPath.h"
+#include "FrameProfiler.h"
+#include "FrameState.h"
+#include "GLTracer.h"
+#include "ProgramBinaryCache.h"
+#include "pointcloud/LODTraversal.h"
 
 namespace viscom {
 
     class MeshRenderable;
+    class LivePointCloudRenderer;
+    class PointCloudRenderer;
 
     class ApplicationNodeImplementation : public ApplicationNodeBase
     {
@@ -33,19 +41,55 @@ namespace viscom {
 
         virtual bool KeyboardCallback(int key, int scancode, int action, int mods) override;
 
+    protected:
+        /** Returns the point cloud renderer (nullptr if no point cloud is loaded). */
+        PointCloudRenderer* GetPointCloud() { return pointCloud_.get(); }
+        /** Returns the renderer of the live point cloud (nullptr if no points are ingested). */
+        LivePointCloudRenderer* GetLivePointCloud() { return livePointCloud_.get(); }
+        /** Returns the parameters for the point cloud level of detail selection. */
+        LODTraversalParameters& GetLODParameters() { return lodParameters_; }
+        /** Returns whether the point cloud is drawn by the CPU rasterizer. */
+        bool& GetUseSoftwareRasterizer() { return useSoftwareRasterizer_; }
+        /** Returns the attribute the point cloud is colored by (PointCloudColorMode). */
+        int& GetColorMode() { return colorMode_; }
+        /** Returns the profiler for the phases of a frame. */
+        FrameProfiler& GetProfiler() { return *profiler_; }
+        /** Returns the state all nodes render the current frame with. */
+        FrameState& GetFrameState() { return frameState_; }
+        void CaptureFrameState();
+        void OpenPointCloud(const std::string& filename);
+        /** Returns whether the point cloud is streamed from the master instead of being opened at start-up. */
+        virtual bool IsPointCloudStreamed() const { return false; }
+
     private:
+        /** The ways the camera path is used. */
+        enum class CameraPathMode
+        {
+            None,
+            Recording,
+            Replaying
+        };
+
+        void LoadTeapot();
+        void ToggleCameraPathRecording();
+        void ToggleCameraPathReplay();
+        void UpdateCameraPath(double currentTime);
+
+        /** Holds the cache creating the shader programs. */
+        std::unique_ptr<ProgramBinaryCache> programCache_;
+
         /** Holds the shader program for drawing the background. */
-        std::shared_ptr<GPUProgram> backgroundProgram_;
+        GLuint backgroundProgram_ = 0;
         /** Holds the location of the MVP matrix. */
         GLint backgroundMVPLoc_ = -1;
 
         /** Holds the shader program for drawing the foreground triangle. */
-        std::shared_ptr<GPUProgram> triangleProgram_;
+        GLuint triangleProgram_ = 0;
         /** Holds the location of the MVP matrix. */
         GLint triangleMVPLoc_ = -1;
 
         /** Holds the shader program for drawing the foreground teapot. */
-        std::shared_ptr<GPUProgram> teapotProgram_;
+        GLuint teapotProgram_ = 0;
         /** Holds the location of the model matrix. */
         GLint teapotModelMLoc_ = -1;
         /** Holds the location of the normal matrix. */
@@ -60,10 +104,47 @@ namespace viscom {
         /** Holds the vertex array object for the background grid. */
         GLuint vaoBackgroundGrid_ = 0;
 
-        /** Holds the teapot mesh. */
-        std::shared_ptr<Mesh> teapotMesh_;
-        /** Holds the teapot mesh renderable. */
-        // std::unique_ptr<MeshRenderable> teapotRenderable_;
+        /** Holds the number of indices of the teapot. */
+        std::size_t numTeapotIndices_ = 0;
+        /** Holds the vertex buffer for the teapot. */
+        GLuint vboTeapot_ = 0;
+        /** Holds the index buffer for the teapot. */
+        GLuint iboTeapot_ = 0;
+
+        /** Holds the shader program for drawing the point cloud. */
+        GLuint pointCloudProgram_ = 0;
+        /** Holds the shader program for drawing the point cloud with indirect draw calls (0 if not supported). */
+        GLuint pointCloudIndirectProgram_ = 0;
+        /** Holds the shader program compositing the result of the CPU rasterizer. */
+        GLuint softwareRasterizerProgram_ = 0;
+        /** Holds the shader program reducing the depth buffer for occlusion culling (0 if not available). */
+        GLuint depthReduceProgram_ = 0;
+        /** Holds the point cloud renderer (empty if no point cloud is loaded). */
+        std::unique_ptr<PointCloudRenderer> pointCloud_;
+        /** Holds the renderer of the live point cloud (empty if no points are ingested). */
+        std::unique_ptr<LivePointCloudRenderer> livePointCloud_;
+        /** Holds the parameters for the point cloud level of detail selection. */
+        LODTraversalParameters lodParameters_;
+        /** Holds whether the point cloud is drawn by the CPU rasterizer. */
+        bool useSoftwareRasterizer_ = VISCOM_SOFTWARE_RASTERIZER != 0;
+        /** Holds the attribute the point cloud is colored by (PointCloudColorMode). */
+        int colorMode_ = 0;
+        /** Holds the profiler for the phases of a frame. */
+        std::unique_ptr<FrameProfiler> profiler_;
+        /** Holds the tracer of the OpenGL calls (only with VISCOM_OGL_DEBUG_MSGS). */
+        std::unique_ptr<GLTracer> glTracer_;
+
+        /** Holds the state all nodes render the current frame with. */
+        FrameState frameState_;
+        /** Holds the state of the last frame, the point cloud is refined while it does not change. */
+        FrameState refinementState_;
+
+        /** Holds the camera path recorded or replayed. */
+        CameraPath cameraPath_;
+        /** Holds whether the camera path is recorded or replayed. */
+        CameraPathMode cameraPathMode_ = CameraPathMode::None;
+        /** Holds the application time the camera path started at (negative before the first frame). */
+        double cameraPathStart_ = -1.0;
 
         glm::mat4 triangleModelMatrix_;
         glm::mat4 teapotModelMatrix_;
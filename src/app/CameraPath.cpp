@@ -0,0 +1,98 @@
+/**
+ * @file   CameraPath.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of recorded camera paths.
+ */
+
+#include "CameraPath.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace viscom {
+
+    namespace {
+        /** The first line of a camera path file. */
+        const char* CAMERA_PATH_HEADER = "# viscom camera path: time px py pz pitch yaw roll";
+    }
+
+    /**
+     *  Loads a camera path. Empty lines and lines starting with '#' are ignored.
+     *  @param filename the name of the file.
+     */
+    CameraPath::CameraPath(const std::string& filename)
+    {
+        std::ifstream file{ filename };
+        if (!file) throw std::runtime_error("Could not open camera path \"" + filename + "\".");
+
+        std::string line;
+        for (auto lineNumber = 1; std::getline(file, line); ++lineNumber) {
+            if (line.empty() || line[0] == '#') continue;
+
+            std::istringstream lineStream{ line };
+            CameraPathKeyframe keyframe;
+            lineStream >> keyframe.time_ >> keyframe.position_.x >> keyframe.position_.y >> keyframe.position_.z
+                >> keyframe.rotation_.x >> keyframe.rotation_.y >> keyframe.rotation_.z;
+            if (!lineStream) throw std::runtime_error("Invalid keyframe in line " + std::to_string(lineNumber) + " of camera path \"" + filename + "\".");
+            AddKeyframe(keyframe);
+        }
+    }
+
+    /**
+     *  Appends a keyframe to the path.
+     *  @param keyframe the keyframe, it may not be earlier than the last one.
+     */
+    void CameraPath::AddKeyframe(const CameraPathKeyframe& keyframe)
+    {
+        if (!keyframes_.empty() && keyframe.time_ < keyframes_.back().time_) throw std::runtime_error("Camera path keyframes need to be ordered by time.");
+        keyframes_.push_back(keyframe);
+    }
+
+    /**
+     *  Returns the camera pose at a point in time, interpolated linearly between the neighboring keyframes.
+     *  Times before the first or after the last keyframe are clamped.
+     *  @param time the time since the start of the path in seconds.
+     */
+    CameraPathKeyframe CameraPath::Sample(double time) const
+    {
+        if (keyframes_.empty()) throw std::runtime_error("Cannot sample an empty camera path.");
+
+        auto next = std::upper_bound(keyframes_.begin(), keyframes_.end(), time, [](double t, const CameraPathKeyframe& keyframe) { return t < keyframe.time_; });
+        if (next == keyframes_.begin()) return keyframes_.front();
+        if (next == keyframes_.end()) return keyframes_.back();
+
+        const auto& previous = *(next - 1);
+        auto duration = next->time_ - previous.time_;
+        auto alpha = static_cast<float>(duration > 0.0 ? (time - previous.time_) / duration : 0.0);
+
+        CameraPathKeyframe result;
+        result.time_ = time;
+        result.position_ = glm::mix(previous.position_, next->position_, alpha);
+        result.rotation_ = glm::mix(previous.rotation_, next->rotation_, alpha);
+        return result;
+    }
+
+    /**
+     *  Writes the path to a file.
+     *  @param filename the name of the file.
+     */
+    void CameraPath::Save(const std::string& filename) const
+    {
+        std::ofstream file{ filename };
+        if (!file) throw std::runtime_error("Could not create file \"" + filename + "\".");
+
+        // enough digits that loading a saved path gives the exact same values.
+        file.precision(std::numeric_limits<double>::max_digits10);
+        file << CAMERA_PATH_HEADER << "\n";
+        for (const auto& keyframe : keyframes_) {
+            file << keyframe.time_ << " " << keyframe.position_.x << " " << keyframe.position_.y << " " << keyframe.position_.z << " "
+                << keyframe.rotation_.x << " " << keyframe.rotation_.y << " " << keyframe.rotation_.z << "\n";
+        }
+        if (!file) throw std::runtime_error("Could not write to file \"" + filename + "\".");
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ * @file   CameraPath.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of recorded camera paths.
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <string>
+#include <vector>
+
+namespace viscom {
+
+    /** A camera pose at a point in time, the rotation uses the pitch/yaw/roll angles of the application. */
+    struct CameraPathKeyframe
+    {
+        /** The time since the start of the path in seconds. */
+        double time_ = 0.0;
+        /** The camera position. */
+        glm::vec3 position_ = glm::vec3(0.0f);
+        /** The pitch, yaw and roll angles in radians. */
+        glm::vec3 rotation_ = glm::vec3(0.0f);
+
+        /** Returns the camera orientation, yaw is applied after pitch and roll like in the application. */
+        glm::quat GetOrientation() const
+        {
+            glm::quat pitchQuat = glm::angleAxis(rotation_.x, glm::vec3(1.0f, 0.0f, 0.0f));
+            glm::quat yawQuat = glm::angleAxis(rotation_.y, glm::vec3(0.0f, 1.0f, 0.0f));
+            glm::quat rollQuat = glm::angleAxis(rotation_.z, glm::vec3(0.0f, 0.0f, 1.0f));
+            return yawQuat * pitchQuat * rollQuat;
+        }
+    };
+
+    /**
+     *  A recorded camera movement that can be replayed. Paths are stored as text files with one keyframe
+     *  (time, position, rotation) per line, so they can be edited by hand and kept under version control.
+     */
+    class CameraPath
+    {
+    public:
+        CameraPath() = default;
+        explicit CameraPath(const std::string& filename);
+
+        void AddKeyframe(const CameraPathKeyframe& keyframe);
+        CameraPathKeyframe Sample(double time) const;
+        void Save(const std::string& filename) const;
+
+        /** Returns whether the path has no keyframes. */
+        bool IsEmpty() const { return keyframes_.empty(); }
+        /** Returns the keyframes. */
+        const std::vector<CameraPathKeyframe>& GetKeyframes() const { return keyframes_; }
+        /** Returns the duration of the path in seconds. */
+        double GetDuration() const { return keyframes_.empty() ? 0.0 : keyframes_.back().time_; }
+
+    private:
+        /** Holds the keyframes ordered by time. */
+        std::vector<CameraPathKeyframe> keyframes_;
+    };
+}
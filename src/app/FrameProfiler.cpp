@@ -0,0 +1,217 @@
+/**
+ * @file   FrameProfiler.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the CPU/GPU profiler for the phases of a frame.
+ */
+
+#include "FrameProfiler.h"
+
+#include <glbinding/gl/gl.h>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace viscom {
+
+    /**
+     *  Creates a new profiler.
+     *  @param historySize the number of frames kept.
+     */
+    FrameProfiler::FrameProfiler(std::size_t historySize) :
+        history_(std::max<std::size_t>(historySize, 2))
+    {
+    }
+
+    FrameProfiler::~FrameProfiler()
+    {
+        for (auto& querySet : querySets_) {
+            if (!querySet.queries_.empty()) gl::glDeleteQueries(static_cast<GLsizei>(querySet.queries_.size()), querySet.queries_.data());
+        }
+    }
+
+    /**
+     *  Finishes the current frame and starts a new one. GPU results of earlier frames are collected if available.
+     *  Needs the OpenGL context to be current.
+     */
+    void FrameProfiler::BeginFrame()
+    {
+        auto now = Clock::now();
+        if (frame_ > 0) {
+            GetCurrentSample().frameTime_ = std::chrono::duration<float, std::milli>(now - frameStart_).count();
+            numSamples_ = std::min(numSamples_ + 1, history_.size() - 1);
+        }
+
+        for (auto& querySet : querySets_) CollectQueries(querySet);
+
+        ++frame_;
+        frameStart_ = now;
+        GetCurrentSample() = FrameProfileSample();
+        GetCurrentSample().frame_ = frame_;
+
+        // results still pending after FRAMES_IN_FLIGHT frames are dropped instead of waiting for them.
+        auto& querySet = querySets_[frame_ % FRAMES_IN_FLIGHT];
+        querySet.frame_ = frame_;
+        querySet.numUsed_ = 0;
+        querySet.phases_.clear();
+    }
+
+    /**
+     *  Starts measuring a phase. A phase can be measured multiple times per frame (e.g. once per window).
+     *  @param phase the phase.
+     */
+    void FrameProfiler::BeginPhase(FramePhase phase)
+    {
+        if (frame_ == 0) return;
+        phaseStart_[static_cast<std::size_t>(phase)] = Clock::now();
+
+        auto& querySet = querySets_[frame_ % FRAMES_IN_FLIGHT];
+        querySet.phases_.push_back(phase);
+        gl::glQueryCounter(NextQuery(), gl::GL_TIMESTAMP);
+        NextQuery();
+    }
+
+    /**
+     *  Stops measuring a phase.
+     *  @param phase the phase.
+     */
+    void FrameProfiler::EndPhase(FramePhase phase)
+    {
+        if (frame_ == 0) return;
+        auto phaseIndex = static_cast<std::size_t>(phase);
+        GetCurrentSample().cpuTimes_[phaseIndex] += std::chrono::duration<float, std::milli>(Clock::now() - phaseStart_[phaseIndex]).count();
+
+        // the end query of a measurement directly follows its begin query.
+        auto& querySet = querySets_[frame_ % FRAMES_IN_FLIGHT];
+        for (auto i = querySet.phases_.size(); i > 0; --i) {
+            if (querySet.phases_[i - 1] != phase) continue;
+            gl::glQueryCounter(querySet.queries_[2 * (i - 1) + 1], gl::GL_TIMESTAMP);
+            break;
+        }
+    }
+
+    /**
+     *  Returns a sample from the history.
+     *  @param age the age of the sample, 0 is the last finished frame.
+     */
+    const FrameProfileSample& FrameProfiler::GetSample(std::size_t age) const
+    {
+        if (age >= numSamples_) throw std::out_of_range("Frame profile sample is not in the history.");
+        return history_[(frame_ - 2 - age) % history_.size()];
+    }
+
+    /**
+     *  Returns the newest sample with CPU and GPU times.
+     *  @param sample the sample.
+     *  @return whether such a sample exists.
+     */
+    bool FrameProfiler::GetLastCompleteSample(FrameProfileSample& sample) const
+    {
+        if (lastCompleteFrame_ == 0 || lastCompleteFrame_ >= frame_ || frame_ - lastCompleteFrame_ > numSamples_) return false;
+        sample = GetSample(static_cast<std::size_t>(frame_ - 1 - lastCompleteFrame_));
+        return true;
+    }
+
+    /**
+     *  Writes all samples in the history to a CSV file, oldest first.
+     *  @param filename the name of the file.
+     */
+    void FrameProfiler::WriteCSV(const std::string& filename) const
+    {
+        std::ofstream file{ filename };
+        if (!file) throw std::runtime_error("Could not create file \"" + filename + "\".");
+
+        file << "frame,frame_ms";
+        for (auto p = 0U; p < static_cast<std::size_t>(FramePhase::Count); ++p) file << "," << GetPhaseName(static_cast<FramePhase>(p)) << "_cpu_ms";
+        for (auto p = 0U; p < static_cast<std::size_t>(FramePhase::Count); ++p) file << "," << GetPhaseName(static_cast<FramePhase>(p)) << "_gpu_ms";
+        file << "\n";
+
+        for (auto age = numSamples_; age > 0; --age) {
+            const auto& sample = GetSample(age - 1);
+            file << sample.frame_ << "," << sample.frameTime_;
+            for (auto time : sample.cpuTimes_) file << "," << time;
+            for (auto time : sample.gpuTimes_) {
+                file << ",";
+                if (sample.hasGPUTimes_ != 0) file << time;
+            }
+            file << "\n";
+        }
+        if (!file) throw std::runtime_error("Could not write to file \"" + filename + "\".");
+    }
+
+    /** Returns the name of a phase. */
+    const char* FrameProfiler::GetPhaseName(FramePhase phase)
+    {
+        switch (phase) {
+        case FramePhase::UpdateFrame: return "UpdateFrame";
+        case FramePhase::ClearBuffer: return "ClearBuffer";
+        case FramePhase::DrawFrame: return "DrawFrame";
+        case FramePhase::Draw2D: return "Draw2D";
+        default: return "Unknown";
+        }
+    }
+
+    /**
+     *  Returns the time a node is busy with a frame: the larger of the summed CPU and GPU phase times. Waiting for
+     *  the swap is not part of any phase, so this is the cost of the frame even when the node is synchronized.
+     *  @param sample the sample.
+     *  @return the busy time in milliseconds.
+     */
+    float FrameProfiler::GetBusyTime(const FrameProfileSample& sample)
+    {
+        auto cpuTime = 0.0f, gpuTime = 0.0f;
+        for (auto time : sample.cpuTimes_) cpuTime += time;
+        if (sample.hasGPUTimes_ != 0) for (auto time : sample.gpuTimes_) gpuTime += time;
+        return std::max(cpuTime, gpuTime);
+    }
+
+    FrameProfileSample* FrameProfiler::FindSample(std::uint64_t frame)
+    {
+        if (frame == 0 || frame > frame_ || frame_ - frame >= history_.size()) return nullptr;
+        return &history_[(frame - 1) % history_.size()];
+    }
+
+    /**
+     *  Reads the results of a frames queries if all of them are available.
+     *  @param querySet the queries of the frame.
+     */
+    void FrameProfiler::CollectQueries(QuerySet& querySet)
+    {
+        if (querySet.frame_ == 0 || querySet.frame_ == frame_) return;
+        if (querySet.phases_.empty()) {
+            querySet.frame_ = 0;
+            return;
+        }
+
+        // queries finish in order, so all results are there if the last one is.
+        GLint available = 0;
+        gl::glGetQueryObjectiv(querySet.queries_[querySet.numUsed_ - 1], gl::GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == 0) return;
+
+        auto sample = FindSample(querySet.frame_);
+        if (sample != nullptr) {
+            for (std::size_t i = 0; i < querySet.phases_.size(); ++i) {
+                GLuint64 begin = 0, end = 0;
+                gl::glGetQueryObjectui64v(querySet.queries_[2 * i], gl::GL_QUERY_RESULT, &begin);
+                gl::glGetQueryObjectui64v(querySet.queries_[2 * i + 1], gl::GL_QUERY_RESULT, &end);
+                sample->gpuTimes_[static_cast<std::size_t>(querySet.phases_[i])] += static_cast<float>(end - begin) * 1e-6f;
+            }
+            sample->hasGPUTimes_ = 1;
+            lastCompleteFrame_ = std::max(lastCompleteFrame_, querySet.frame_);
+        }
+        querySet.frame_ = 0;
+    }
+
+    GLuint FrameProfiler::NextQuery()
+    {
+        auto& querySet = querySets_[frame_ % FRAMES_IN_FLIGHT];
+        if (querySet.numUsed_ == querySet.queries_.size()) {
+            auto oldSize = querySet.queries_.size();
+            querySet.queries_.resize(std::max<std::size_t>(16, 2 * oldSize));
+            gl::glGenQueries(static_cast<GLsizei>(querySet.queries_.size() - oldSize), querySet.queries_.data() + oldSize);
+        }
+        return querySet.queries_[querySet.numUsed_++];
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * @file   FrameProfiler.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the CPU/GPU profiler for the phases of a frame.
+ */
+
+#pragma once
+
+#include "core/main.h"
+
+#include <array>
+#include <chrono>
+
+namespace viscom {
+
+    /** The package id used by slaves to send their frame profiles to the master. */
+    constexpr std::uint16_t FRAME_PROFILE_PACKAGE_ID = 0x5046;
+
+    /** The profiled phases of a frame. */
+    enum class FramePhase : std::size_t
+    {
+        UpdateFrame,
+        ClearBuffer,
+        DrawFrame,
+        Draw2D,
+        Count
+    };
+
+    /** The timings of a single frame in milliseconds. */
+    struct FrameProfileSample
+    {
+        /** The number of the frame. */
+        std::uint64_t frame_ = 0;
+        /** The time from the start of this frame to the start of the next one. */
+        float frameTime_ = 0.0f;
+        /** The CPU time of each phase, summed over all windows. */
+        std::array<float, static_cast<std::size_t>(FramePhase::Count)> cpuTimes_ = {};
+        /** The GPU time of each phase, summed over all windows. */
+        std::array<float, static_cast<std::size_t>(FramePhase::Count)> gpuTimes_ = {};
+        /** Whether the GPU times are available. */
+        std::uint32_t hasGPUTimes_ = 0;
+    };
+
+    /**
+     *  Measures the CPU and GPU time of each phase of a frame. GPU times are measured with timestamp queries that
+     *  are read back a few frames later, and only if they are available, so profiling never stalls the pipeline.
+     *  The last frames are kept in a ring buffer.
+     */
+    class FrameProfiler
+    {
+    public:
+        /** The number of frames the GPU results may lag behind. */
+        static constexpr std::size_t FRAMES_IN_FLIGHT = 4;
+
+        explicit FrameProfiler(std::size_t historySize = 600);
+        FrameProfiler(const FrameProfiler&) = delete;
+        FrameProfiler& operator=(const FrameProfiler&) = delete;
+        ~FrameProfiler();
+
+        void BeginFrame();
+        void BeginPhase(FramePhase phase);
+        void EndPhase(FramePhase phase);
+
+        /** Returns the number of frames in the history. */
+        std::size_t GetNumSamples() const { return numSamples_; }
+        const FrameProfileSample& GetSample(std::size_t age) const;
+        bool GetLastCompleteSample(FrameProfileSample& sample) const;
+        void WriteCSV(const std::string& filename) const;
+
+        static const char* GetPhaseName(FramePhase phase);
+        static float GetBusyTime(const FrameProfileSample& sample);
+
+        /** Measures a phase for the lifetime of the object. */
+        class ScopedPhase
+        {
+        public:
+            ScopedPhase(FrameProfiler& profiler, FramePhase phase) : profiler_{ profiler }, phase_{ phase } { profiler_.BeginPhase(phase_); }
+            ScopedPhase(const ScopedPhase&) = delete;
+            ScopedPhase& operator=(const ScopedPhase&) = delete;
+            ~ScopedPhase() { profiler_.EndPhase(phase_); }
+
+        private:
+            /** Holds the profiler. */
+            FrameProfiler& profiler_;
+            /** Holds the measured phase. */
+            FramePhase phase_;
+        };
+
+    private:
+        using Clock = std::chrono::high_resolution_clock;
+
+        /** The timestamp queries issued in a frame. */
+        struct QuerySet
+        {
+            /** Holds the frame the queries were issued in. */
+            std::uint64_t frame_ = 0;
+            /** Holds the query objects, begin and end of each measurement. */
+            std::vector<GLuint> queries_;
+            /** Holds the number of queries used. */
+            std::size_t numUsed_ = 0;
+            /** Holds the phase of each measurement. */
+            std::vector<FramePhase> phases_;
+        };
+
+        FrameProfileSample& GetCurrentSample() { return history_[(frame_ - 1) % history_.size()]; }
+        FrameProfileSample* FindSample(std::uint64_t frame);
+        void CollectQueries(QuerySet& querySet);
+        GLuint NextQuery();
+
+        /** Holds the ring buffer of samples. */
+        std::vector<FrameProfileSample> history_;
+        /** Holds the number of valid samples. */
+        std::size_t numSamples_ = 0;
+        /** Holds the current frame number, starting at 1 (0 before the first frame). */
+        std::uint64_t frame_ = 0;
+        /** Holds the start of the current frame. */
+        Clock::time_point frameStart_;
+        /** Holds the start of each running phase. */
+        std::array<Clock::time_point, static_cast<std::size_t>(FramePhase::Count)> phaseStart_;
+        /** Holds the timestamp queries of the last frames. */
+        std::array<QuerySet, FRAMES_IN_FLIGHT> querySets_;
+        /** Holds the newest frame with GPU times. */
+        std::uint64_t lastCompleteFrame_ = 0;
+    };
+}
@@ -0,0 +1,142 @@
+/**
+ * @file   FrameState.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the delta encoding of the shared frame state.
+ */
+
+#include "FrameState.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace viscom {
+
+    namespace {
+        /** The fields of the frame state, bits of the field mask. */
+        enum FrameStateField : std::uint8_t
+        {
+            CameraPositionField = 1 << 0,
+            CameraRotationField = 1 << 1,
+            PointBudgetField = 1 << 2,
+            MinNodeSizeField = 1 << 3,
+            ViewsField = 1 << 4,
+            SoftwareRasterizerField = 1 << 5,
+            ColorModeField = 1 << 6,
+            AllFields = (1 << 7) - 1,
+            /** Marks frames containing all fields. */
+            KeyframeFlag = 1 << 7
+        };
+
+        template<typename T> bool IsSameBits(const T& a, const T& b) { return std::memcmp(&a, &b, sizeof(T)) == 0; }
+
+        template<typename T> void Append(std::vector<std::uint8_t>& buffer, const T& value)
+        {
+            auto offset = buffer.size();
+            buffer.resize(offset + sizeof(T));
+            std::memcpy(&buffer[offset], &value, sizeof(T));
+        }
+
+        /** Reads values from the received data. */
+        class FrameStateReader
+        {
+        public:
+            FrameStateReader(const std::uint8_t* data, std::size_t size) : data_{ data }, size_{ size } {}
+
+            template<typename T> bool Read(T& value)
+            {
+                if (size_ - position_ < sizeof(T)) return false;
+                std::memcpy(&value, data_ + position_, sizeof(T));
+                position_ += sizeof(T);
+                return true;
+            }
+
+        private:
+            const std::uint8_t* data_;
+            std::size_t size_;
+            std::size_t position_ = 0;
+        };
+    }
+
+    /**
+     *  Writes the changes of the state since the last frame.
+     *  @param state the state of the current frame.
+     *  @return the encoded data, valid until the next call.
+     */
+    const std::vector<std::uint8_t>& FrameStateEncoder::Encode(const FrameState& state)
+    {
+        std::uint8_t fields = 0;
+        if (!IsSameBits(state.cameraPosition_, lastState_.cameraPosition_)) fields |= CameraPositionField;
+        if (!IsSameBits(state.cameraRotation_, lastState_.cameraRotation_)) fields |= CameraRotationField;
+        if (state.pointBudget_ != lastState_.pointBudget_) fields |= PointBudgetField;
+        if (!IsSameBits(state.minNodeSize_, lastState_.minNodeSize_)) fields |= MinNodeSizeField;
+        if (state.softwareRasterizer_ != lastState_.softwareRasterizer_) fields |= SoftwareRasterizerField;
+        if (state.colorMode_ != lastState_.colorMode_) fields |= ColorModeField;
+        if (state.views_.size() != lastState_.views_.size()
+            || (!state.views_.empty() && std::memcmp(state.views_.data(), lastState_.views_.data(), state.views_.size() * sizeof(ClusterView)) != 0)) fields |= ViewsField;
+
+        if (fields != 0) ++version_;
+        if (numFrames_++ % KEYFRAME_INTERVAL == 0) fields = AllFields | KeyframeFlag;
+        lastState_ = state;
+
+        buffer_.clear();
+        Append(buffer_, version_);
+        Append(buffer_, fields);
+        if ((fields & CameraPositionField) != 0) Append(buffer_, state.cameraPosition_);
+        if ((fields & CameraRotationField) != 0) Append(buffer_, state.cameraRotation_);
+        if ((fields & PointBudgetField) != 0) Append(buffer_, state.pointBudget_);
+        if ((fields & MinNodeSizeField) != 0) Append(buffer_, state.minNodeSize_);
+        if ((fields & SoftwareRasterizerField) != 0) Append(buffer_, state.softwareRasterizer_);
+        if ((fields & ColorModeField) != 0) Append(buffer_, state.colorMode_);
+        if ((fields & ViewsField) != 0) {
+            auto numViews = static_cast<std::uint8_t>(std::min<std::size_t>(state.views_.size(), 255));
+            Append(buffer_, numViews);
+            for (std::size_t i = 0; i < numViews; ++i) Append(buffer_, state.views_[i]);
+        }
+        return buffer_;
+    }
+
+    /**
+     *  Applies the data of a frame.
+     *  @param data the encoded data.
+     *  @param size the size of the data in bytes.
+     *  @return whether the state is synchronized with the master.
+     */
+    bool FrameStateDecoder::Decode(const std::uint8_t* data, std::size_t size)
+    {
+        FrameStateReader reader{ data, size };
+        std::uint32_t version = 0;
+        std::uint8_t fields = 0;
+        if (!reader.Read(version) || !reader.Read(fields)) return synchronized_ = false;
+
+        auto isKeyframe = (fields & KeyframeFlag) != 0;
+        auto hasChanges = (fields & AllFields) != 0;
+        if (!isKeyframe) {
+            // changes are based on the previous version, idle frames repeat the current one.
+            auto expectedVersion = hasChanges ? version_ + 1 : version_;
+            if (!synchronized_ || version != expectedVersion) return synchronized_ = false;
+        }
+
+        // the new state is built on a copy, so incomplete data does not leave a mixed state.
+        auto state = state_;
+        auto valid = true;
+        if ((fields & CameraPositionField) != 0) valid = valid && reader.Read(state.cameraPosition_);
+        if ((fields & CameraRotationField) != 0) valid = valid && reader.Read(state.cameraRotation_);
+        if ((fields & PointBudgetField) != 0) valid = valid && reader.Read(state.pointBudget_);
+        if ((fields & MinNodeSizeField) != 0) valid = valid && reader.Read(state.minNodeSize_);
+        if ((fields & SoftwareRasterizerField) != 0) valid = valid && reader.Read(state.softwareRasterizer_);
+        if ((fields & ColorModeField) != 0) valid = valid && reader.Read(state.colorMode_);
+        if ((fields & ViewsField) != 0) {
+            std::uint8_t numViews = 0;
+            valid = valid && reader.Read(numViews);
+            state.views_.resize(valid ? numViews : 0);
+            for (auto& view : state.views_) valid = valid && reader.Read(view);
+        }
+        if (!valid) return synchronized_ = false;
+
+        state_ = std::move(state);
+        version_ = version;
+        return synchronized_ = true;
+    }
+}
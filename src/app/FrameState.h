@@ -0,0 +1,100 @@
+/**
+ * @file   FrameState.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the frame state shared by the master with all slaves.
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace viscom {
+
+    /** The package id used by slaves to send their views to the master. */
+    constexpr std::uint16_t CLUSTER_VIEWS_PACKAGE_ID = 0x5056;
+
+    /** A view (window and eye) of a cluster node relative to the camera. */
+    struct ClusterView
+    {
+        /** The view projection matrix without the camera transformation. */
+        glm::mat4 viewProjection_;
+        /** The height of the viewport in pixels. */
+        float viewportHeight_;
+    };
+
+    /** The state the master decides for a frame, all nodes render with the same state. */
+    struct FrameState
+    {
+        /** The camera position. */
+        glm::vec3 cameraPosition_ = glm::vec3(0.0f);
+        /** The pitch, yaw and roll angles of the camera in radians. */
+        glm::vec3 cameraRotation_ = glm::vec3(0.0f);
+        /** The point budget of the level of detail selection. */
+        std::uint64_t pointBudget_ = 0;
+        /** The minimum projected node size of the level of detail selection. */
+        float minNodeSize_ = 0.0f;
+        /** Whether the point cloud is drawn by the CPU rasterizer (0 or 1). */
+        std::uint8_t softwareRasterizer_ = 0;
+        /** The attribute the points are colored by (PointCloudColorMode). */
+        std::uint8_t colorMode_ = 0;
+        /** The views of all cluster nodes, the level of detail selection is done for all of them. */
+        std::vector<ClusterView> views_;
+    };
+
+    /**
+     *  Serializes the frame state on the master. Only fields that changed since the last frame are written, an idle
+     *  frame is a 5 byte header (version and field mask). Every KEYFRAME_INTERVAL frames all fields are written,
+     *  so a slave that missed data is back in sync after a while.
+     */
+    class FrameStateEncoder
+    {
+    public:
+        /** The number of frames between two frames containing all fields. */
+        static constexpr std::uint64_t KEYFRAME_INTERVAL = 600;
+
+        const std::vector<std::uint8_t>& Encode(const FrameState& state);
+
+        /** Returns the version of the last encoded state. */
+        std::uint32_t GetVersion() const { return version_; }
+        /** Returns the size of the last encoded frame in bytes. */
+        std::size_t GetSize() const { return buffer_.size(); }
+
+    private:
+        /** Holds the last encoded state. */
+        FrameState lastState_;
+        /** Holds the version of the state, it is increased on every change. */
+        std::uint32_t version_ = 0;
+        /** Holds the number of encoded frames. */
+        std::uint64_t numFrames_ = 0;
+        /** Holds the encoded data of the last frame. */
+        std::vector<std::uint8_t> buffer_;
+    };
+
+    /**
+     *  Applies the data written by FrameStateEncoder on a slave. Changes are only applied to the version they are
+     *  based on, after a gap the decoder waits for the next keyframe.
+     */
+    class FrameStateDecoder
+    {
+    public:
+        bool Decode(const std::uint8_t* data, std::size_t size);
+
+        /** Returns the decoded state. */
+        const FrameState& GetState() const { return state_; }
+        /** Returns whether the state matches the masters state. */
+        bool IsSynchronized() const { return synchronized_; }
+
+    private:
+        /** Holds the decoded state. */
+        FrameState state_;
+        /** Holds the version of the decoded state. */
+        std::uint32_t version_ = 0;
+        /** Holds whether the state matches the masters state. */
+        bool synchronized_ = false;
+    };
+}
@@ -0,0 +1,88 @@
+/**
+ * @file   GLTraceFormat.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Definition of the binary file format of OpenGL call traces.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace viscom {
+
+    /** The magic number at the start of each trace file ("VGLT"). */
+    constexpr std::uint32_t GLTRACE_MAGIC = 0x544C4756;
+    /** The version of the trace file format. */
+    constexpr std::uint32_t GLTRACE_VERSION = 1;
+    /** The maximum number of arguments stored per call, further arguments are dropped. */
+    constexpr unsigned GLTRACE_MAX_ARGUMENTS = 5;
+
+    /** The kinds of records in a trace. */
+    enum class GLTraceRecordType : std::uint8_t
+    {
+        /** An OpenGL call, function_ is the index in the function table. */
+        Call,
+        /** An OpenGL error found by the check at the end of a frame, argument 0 is the error code. */
+        Error,
+        /** The start of a frame, argument 0 is the frame number. */
+        Frame,
+        /** Records lost because the ring buffer of the thread was full, argument 0 is the number of records. */
+        Dropped
+    };
+
+    /** The types of recorded arguments, they tell the decoder how to print the raw bits. */
+    enum class GLTraceArgumentType : std::uint8_t
+    {
+        Unknown,
+        Int,
+        UInt,
+        Float,
+        Double,
+        Enum,
+        Boolean,
+        Pointer
+    };
+
+    /**
+     *  The header at the start of each trace file. It is followed by numFunctions_ function names (16 bit length
+     *  and characters) and the records until the end of the file.
+     */
+    struct GLTraceFileHeader
+    {
+        /** The magic number (GLTRACE_MAGIC). */
+        std::uint32_t magic_ = GLTRACE_MAGIC;
+        /** The file format version (GLTRACE_VERSION). */
+        std::uint32_t version_ = GLTRACE_VERSION;
+        /** The number of entries in the function table. */
+        std::uint32_t numFunctions_ = 0;
+        /** Only every n-th call of a thread is recorded. */
+        std::uint32_t samplingInterval_ = 1;
+        /** The start of the trace in nanoseconds since the epoch, record timestamps are relative to it. */
+        std::uint64_t startTime_ = 0;
+    };
+
+    /** A single record of a trace, the size is fixed so records are written to the ring buffers without allocation. */
+    struct GLTraceRecord
+    {
+        /** The time since the start of the trace in nanoseconds. */
+        std::uint64_t timestamp_;
+        /** The index of the recording thread. */
+        std::uint32_t thread_;
+        /** The index of the called function in the function table. */
+        std::uint16_t function_;
+        /** The type of the record. */
+        GLTraceRecordType type_;
+        /** The number of recorded arguments. */
+        std::uint8_t numArguments_;
+        /** The types of the arguments. */
+        GLTraceArgumentType argumentTypes_[GLTRACE_MAX_ARGUMENTS];
+        /** Padding, keeps the arguments 8 byte aligned. */
+        std::uint8_t padding_[3];
+        /** The raw bits of the arguments. */
+        std::uint64_t arguments_[GLTRACE_MAX_ARGUMENTS];
+    };
+
+    static_assert(sizeof(GLTraceRecord) == 64, "Trace records need to fill a cache line.");
+}
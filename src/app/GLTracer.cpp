@@ -0,0 +1,269 @@
+/**
+ * @file   GLTracer.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the low overhead OpenGL call tracer.
+ */
+
+#include "GLTracer.h"
+#include "core/main.h"
+
+#include <glbinding/gl/gl.h>
+#include <glbinding/AbstractFunction.h>
+#include <glbinding/AbstractValue.h>
+#include <glbinding/Binding.h>
+#include <glbinding/FunctionCall.h>
+#include <glbinding/Value.h>
+#include <glbinding/callbacks.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace viscom {
+
+    thread_local GLTracer::ThreadRing* GLTracer::threadRing_ = nullptr;
+    thread_local std::uint64_t GLTracer::threadGeneration_ = 0;
+    std::atomic<std::uint64_t> GLTracer::nextGeneration_{ 1 };
+
+    namespace {
+        /** The maximum number of errors taken from the error queue per frame, some drivers never empty it after a lost context. */
+        constexpr unsigned MAX_ERRORS_PER_FRAME = 16;
+
+        const char* GetErrorName(gl::GLenum error)
+        {
+            switch (error)
+            {
+            case gl::GL_INVALID_ENUM: return "GL_INVALID_ENUM";
+            case gl::GL_INVALID_VALUE: return "GL_INVALID_VALUE";
+            case gl::GL_INVALID_OPERATION: return "GL_INVALID_OPERATION";
+            case gl::GL_INVALID_FRAMEBUFFER_OPERATION: return "GL_INVALID_FRAMEBUFFER_OPERATION";
+            case gl::GL_OUT_OF_MEMORY: return "GL_OUT_OF_MEMORY";
+            case gl::GL_STACK_UNDERFLOW: return "GL_STACK_UNDERFLOW";
+            case gl::GL_STACK_OVERFLOW: return "GL_STACK_OVERFLOW";
+            case gl::GL_TABLE_TOO_LARGE: return "GL_TABLE_TOO_LARGE";
+            case gl::GL_TEXTURE_TOO_LARGE_EXT: return "GL_TEXTURE_TOO_LARGE_EXT";
+            default: return "unknown error";
+            }
+        }
+
+        /** Stores the value of a parameter as raw bits, only the common scalar types are known. */
+        GLTraceArgumentType EncodeArgument(const glbinding::AbstractValue* value, std::uint64_t& bits)
+        {
+            using glbinding::Value;
+            bits = 0;
+            if (auto v = dynamic_cast<const Value<GLuint>*>(value)) {
+                bits = v->value();
+                return GLTraceArgumentType::UInt;
+            }
+            if (auto v = dynamic_cast<const Value<GLint>*>(value)) {
+                bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(v->value()));
+                return GLTraceArgumentType::Int;
+            }
+            if (auto v = dynamic_cast<const Value<gl::GLenum>*>(value)) {
+                bits = static_cast<std::uint64_t>(v->value());
+                return GLTraceArgumentType::Enum;
+            }
+            if (auto v = dynamic_cast<const Value<gl::GLboolean>*>(value)) {
+                bits = v->value() == gl::GL_TRUE ? 1 : 0;
+                return GLTraceArgumentType::Boolean;
+            }
+            if (auto v = dynamic_cast<const Value<gl::GLfloat>*>(value)) {
+                auto floatValue = v->value();
+                std::uint32_t floatBits;
+                std::memcpy(&floatBits, &floatValue, sizeof(floatBits));
+                bits = floatBits;
+                return GLTraceArgumentType::Float;
+            }
+            if (auto v = dynamic_cast<const Value<gl::GLdouble>*>(value)) {
+                auto doubleValue = v->value();
+                std::memcpy(&bits, &doubleValue, sizeof(bits));
+                return GLTraceArgumentType::Double;
+            }
+            if (auto v = dynamic_cast<const Value<gl::GLsizeiptr>*>(value)) {
+                bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(v->value()));
+                return GLTraceArgumentType::Int;
+            }
+            if (auto v = dynamic_cast<const Value<gl::GLuint64>*>(value)) {
+                bits = v->value();
+                return GLTraceArgumentType::UInt;
+            }
+            if (auto v = dynamic_cast<const Value<const void*>*>(value)) {
+                bits = reinterpret_cast<std::uintptr_t>(v->value());
+                return GLTraceArgumentType::Pointer;
+            }
+            if (auto v = dynamic_cast<const Value<void*>*>(value)) {
+                bits = reinterpret_cast<std::uintptr_t>(v->value());
+                return GLTraceArgumentType::Pointer;
+            }
+            return GLTraceArgumentType::Unknown;
+        }
+    }
+
+    /**
+     *  Creates the tracer and registers it as the glbinding after callback, glbinding has to be initialized.
+     *  @param filename the name of the trace file.
+     *  @param samplingInterval only every n-th call of a thread is recorded.
+     *  @param recordArguments whether the arguments of calls are recorded.
+     *  @param ringSize the number of records kept per thread between two frames, older records are dropped.
+     */
+    GLTracer::GLTracer(const std::string& filename, unsigned samplingInterval, bool recordArguments, std::size_t ringSize) :
+        file_{ filename, std::ios::binary },
+        samplingInterval_{ std::max(samplingInterval, 1u) },
+        ringSize_{ std::max(ringSize, std::size_t{ 1 }) },
+        generation_{ nextGeneration_++ },
+        start_{ std::chrono::steady_clock::now() }
+    {
+        if (!file_) throw std::runtime_error("Could not create trace file \"" + filename + "\".");
+
+        for (const auto function : glbinding::Binding::functions()) {
+            if (functionNames_.size() > std::numeric_limits<std::uint16_t>::max()) break;
+            functionIds_[function] = static_cast<std::uint16_t>(functionNames_.size());
+            functionNames_.emplace_back(function->name());
+        }
+
+        GLTraceFileHeader header;
+        header.numFunctions_ = static_cast<std::uint32_t>(functionNames_.size());
+        header.samplingInterval_ = samplingInterval_;
+        header.startTime_ = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        file_.write(reinterpret_cast<const char*>(&header), sizeof(GLTraceFileHeader));
+        for (const auto& name : functionNames_) {
+            auto length = static_cast<std::uint16_t>(name.size());
+            file_.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            file_.write(name.data(), length);
+        }
+
+        using namespace glbinding;
+        auto mask = recordArguments ? CallbackMask::After | CallbackMask::Parameters : CallbackMask::After;
+        setCallbackMaskExcept(mask, { "glGetError" });
+        setAfterCallback([this](const FunctionCall& call) { RecordCall(call); });
+
+        BeginRecord(GetThreadRing(), GLTraceRecordType::Frame).arguments_[0] = frame_;
+    }
+
+    /** Unregisters the callback and writes the records of all threads. */
+    GLTracer::~GLTracer()
+    {
+        glbinding::setCallbackMask(glbinding::CallbackMask::None);
+        glbinding::setAfterCallback(nullptr);
+
+        std::lock_guard<std::mutex> lock{ ringsMutex_ };
+        for (auto& ring : rings_) Flush(*ring);
+        file_.flush();
+        if (numDroppedRecords_ > 0) LOG(WARNING) << "The OpenGL trace lost " << numDroppedRecords_ << " records, consider a larger sampling interval.";
+    }
+
+    /**
+     *  Ends the current frame: takes the errors of the frame from the error queue, writes the records of the calling
+     *  thread to the file and starts the next frame. Has to be called on the thread owning the context.
+     */
+    void GLTracer::NextFrame()
+    {
+        auto& ring = GetThreadRing();
+        for (unsigned i = 0; i < MAX_ERRORS_PER_FRAME; ++i) {
+            auto error = gl::glGetError();
+            if (error == gl::GL_NO_ERROR) break;
+
+            ++numErrors_;
+            BeginRecord(ring, GLTraceRecordType::Error).arguments_[0] = static_cast<std::uint64_t>(error);
+            // the error was raised by some call of this frame, the last recorded one is a hint where to look.
+            auto lastIndex = ring.writeIndex_.load(std::memory_order_relaxed);
+            std::string lastCall = "none";
+            for (auto j = lastIndex; j > ring.flushedIndex_ && lastIndex - j < ringSize_; --j) {
+                const auto& record = ring.records_[(j - 1) % ringSize_];
+                if (record.type_ == GLTraceRecordType::Call) {
+                    lastCall = functionNames_[record.function_];
+                    break;
+                }
+            }
+            LOG(WARNING) << "OpenGL error " << GetErrorName(error) << " in frame " << frame_ << " (last traced call: " << lastCall << ").";
+        }
+
+        Flush(ring);
+        BeginRecord(ring, GLTraceRecordType::Frame).arguments_[0] = ++frame_;
+    }
+
+    /** Records a call, called by glbinding after each OpenGL function. */
+    void GLTracer::RecordCall(const glbinding::FunctionCall& call)
+    {
+        auto& ring = GetThreadRing();
+        if (ring.numCalls_++ % samplingInterval_ != 0) return;
+
+        auto function = functionIds_.find(call.function);
+        if (function == functionIds_.end()) return;
+
+        auto& record = BeginRecord(ring, GLTraceRecordType::Call);
+        record.function_ = function->second;
+        auto numArguments = std::min(call.parameters.size(), std::size_t{ GLTRACE_MAX_ARGUMENTS });
+        record.numArguments_ = static_cast<std::uint8_t>(numArguments);
+        for (std::size_t i = 0; i < numArguments; ++i) record.argumentTypes_[i] = EncodeArgument(call.parameters[i], record.arguments_[i]);
+    }
+
+    /**
+     *  Starts a new record in a ring buffer, overwriting the oldest one if the buffer is full.
+     *  @param ring the ring buffer of the calling thread.
+     *  @param type the type of the record.
+     *  @return the record, it is flushed on the next frame.
+     */
+    GLTraceRecord& GLTracer::BeginRecord(ThreadRing& ring, GLTraceRecordType type)
+    {
+        // only the owning thread writes, so the index is published after the record is reset.
+        auto index = ring.writeIndex_.load(std::memory_order_relaxed);
+        auto& record = ring.records_[index % ringSize_];
+        std::memset(&record, 0, sizeof(GLTraceRecord));
+        record.timestamp_ = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count());
+        record.thread_ = ring.thread_;
+        record.type_ = type;
+        ring.writeIndex_.store(index + 1, std::memory_order_release);
+        return record;
+    }
+
+    /** Returns the ring buffer of the calling thread, it is created on the first call of a thread. */
+    GLTracer::ThreadRing& GLTracer::GetThreadRing()
+    {
+        if (threadGeneration_ == generation_) return *threadRing_;
+
+        auto ring = std::make_unique<ThreadRing>();
+        ring->records_ = std::make_unique<GLTraceRecord[]>(ringSize_);
+        std::lock_guard<std::mutex> lock{ ringsMutex_ };
+        ring->thread_ = static_cast<std::uint32_t>(rings_.size());
+        rings_.push_back(std::move(ring));
+        threadRing_ = rings_.back().get();
+        threadGeneration_ = generation_;
+        return *threadRing_;
+    }
+
+    /**
+     *  Writes the records of a ring buffer not written so far to the file, the stream buffers them until the tracer
+     *  is destroyed.
+     *  @param ring the ring buffer, its thread must not record at the same time.
+     */
+    void GLTracer::Flush(ThreadRing& ring)
+    {
+        auto end = ring.writeIndex_.load(std::memory_order_acquire);
+        auto begin = std::max(ring.flushedIndex_, end > ringSize_ ? end - ringSize_ : 0);
+        if (begin > ring.flushedIndex_) {
+            GLTraceRecord dropped;
+            std::memset(&dropped, 0, sizeof(GLTraceRecord));
+            dropped.timestamp_ = ring.records_[begin % ringSize_].timestamp_;
+            dropped.thread_ = ring.thread_;
+            dropped.type_ = GLTraceRecordType::Dropped;
+            dropped.arguments_[0] = begin - ring.flushedIndex_;
+            numDroppedRecords_ += dropped.arguments_[0];
+            file_.write(reinterpret_cast<const char*>(&dropped), sizeof(GLTraceRecord));
+        }
+
+        // the records form at most two contiguous ranges of the buffer.
+        while (begin < end) {
+            auto first = begin % ringSize_;
+            auto count = std::min(end - begin, static_cast<std::uint64_t>(ringSize_ - first));
+            file_.write(reinterpret_cast<const char*>(&ring.records_[first]), static_cast<std::streamsize>(count * sizeof(GLTraceRecord)));
+            begin += count;
+        }
+        ring.flushedIndex_ = end;
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file   GLTracer.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the low overhead OpenGL call tracer.
+ */
+
+#pragma once
+
+#include "GLTraceFormat.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace glbinding {
+    class AbstractFunction;
+    struct FunctionCall;
+}
+
+namespace viscom {
+
+    /**
+     *  Records the OpenGL calls made through glbinding into a binary trace that is decoded offline (GLTraceDecoder).
+     *  Each thread writes fixed size records into its own ring buffer without locks or allocations, optionally only
+     *  every n-th call. Errors are checked once per frame instead of after every call, and the rings are written to
+     *  the file at the same time. Recording arguments makes glbinding allocate a value per parameter, so it is
+     *  optional; without them a record holds the function, thread and time stamp.
+     */
+    class GLTracer
+    {
+    public:
+        /** The default number of records kept per thread between two frames. */
+        static constexpr std::size_t DEFAULT_RING_SIZE = 1 << 16;
+
+        GLTracer(const std::string& filename, unsigned samplingInterval, bool recordArguments, std::size_t ringSize = DEFAULT_RING_SIZE);
+        GLTracer(const GLTracer&) = delete;
+        GLTracer(GLTracer&&) = delete;
+        GLTracer& operator=(const GLTracer&) = delete;
+        GLTracer& operator=(GLTracer&&) = delete;
+        ~GLTracer();
+
+        void NextFrame();
+
+        /** Returns the number of OpenGL errors found so far. */
+        std::uint64_t GetNumErrors() const { return numErrors_; }
+        /** Returns the number of records lost because a ring buffer was full. */
+        std::uint64_t GetNumDroppedRecords() const { return numDroppedRecords_; }
+
+    private:
+        /** The ring buffer of a single thread, only the owning thread writes to it. */
+        struct ThreadRing
+        {
+            /** Holds the records. */
+            std::unique_ptr<GLTraceRecord[]> records_;
+            /** Holds the number of records written so far. */
+            std::atomic<std::uint64_t> writeIndex_{ 0 };
+            /** Holds the number of records written to the file so far. */
+            std::uint64_t flushedIndex_ = 0;
+            /** Holds the number of calls made by the thread, for sampling. */
+            std::uint64_t numCalls_ = 0;
+            /** Holds the index of the thread. */
+            std::uint32_t thread_ = 0;
+        };
+
+        void RecordCall(const glbinding::FunctionCall& call);
+        GLTraceRecord& BeginRecord(ThreadRing& ring, GLTraceRecordType type);
+        ThreadRing& GetThreadRing();
+        void Flush(ThreadRing& ring);
+
+        /** Holds the ring buffer of the current thread. */
+        static thread_local ThreadRing* threadRing_;
+        /** Holds the tracer the ring buffer of the current thread belongs to. */
+        static thread_local std::uint64_t threadGeneration_;
+        /** Holds the number of tracers created, to detect ring buffers of earlier tracers. */
+        static std::atomic<std::uint64_t> nextGeneration_;
+
+        /** Holds the trace file. */
+        std::ofstream file_;
+        /** Holds the number of calls per recorded call. */
+        unsigned samplingInterval_;
+        /** Holds the number of records per ring buffer. */
+        std::size_t ringSize_;
+        /** Holds the generation of this tracer. */
+        std::uint64_t generation_;
+        /** Holds the start of the trace. */
+        std::chrono::steady_clock::time_point start_;
+        /** Holds the index of each function in the function table of the file. */
+        std::unordered_map<const glbinding::AbstractFunction*, std::uint16_t> functionIds_;
+        /** Holds the names of the functions in the function table. */
+        std::vector<std::string> functionNames_;
+        /** Protects the list of ring buffers. */
+        std::mutex ringsMutex_;
+        /** Holds the ring buffers of all threads. */
+        std::vector<std::unique_ptr<ThreadRing>> rings_;
+        /** Holds the current frame. */
+        std::uint64_t frame_ = 0;
+        /** Holds the number of OpenGL errors found. */
+        std::uint64_t numErrors_ = 0;
+        /** Holds the number of records lost because a ring buffer was full. */
+        std::uint64_t numDroppedRecords_ = 0;
+    };
+}
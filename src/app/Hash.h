@@ -0,0 +1,32 @@
+/**
+ * @file   Hash.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Hashing of file contents for the caches.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace viscom {
+
+    /** The initial value of the FNV-1a hash. */
+    constexpr std::uint64_t FNV1A_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+
+    /**
+     *  Continues a 64 bit FNV-1a hash with a block of data, used to detect changed sources of cached data.
+     *  @param data the data to hash.
+     *  @param size the size of the data in bytes.
+     *  @param hash the hash of the preceding data.
+     *  @return the hash including the data.
+     */
+    inline std::uint64_t HashFNV1a(const void* data, std::size_t size, std::uint64_t hash = FNV1A_OFFSET_BASIS)
+    {
+        auto bytes = static_cast<const std::uint8_t*>(data);
+        for (std::size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+        return hash;
+    }
+}
@@ -0,0 +1,158 @@
+/**
+ * @file   LivePointCloudRenderer.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the renderer for point clouds growing while they are drawn.
+ */
+
+#include "LivePointCloudRenderer.h"
+#include "Vertices.h"
+
+#include <algorithm>
+#include <chrono>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace viscom {
+
+    /**
+     *  Creates the renderer.
+     *  @param ingestion the ingestion whose octree is drawn.
+     *  @param program the shader program used for drawing (pointCloud.vert), it has to outlive the renderer.
+     */
+    LivePointCloudRenderer::LivePointCloudRenderer(std::unique_ptr<LiveIngestion> ingestion, GLuint program) :
+        ingestion_{ std::move(ingestion) },
+        program_{ program }
+    {
+        viewProjectionLoc_ = gl::glGetUniformLocation(program_, "viewProjectionMatrix");
+        pointSizeLoc_ = gl::glGetUniformLocation(program_, "pointSize");
+        nodeBoundsMinLoc_ = gl::glGetUniformLocation(program_, "nodeBoundsMin");
+        nodeBoundsExtentLoc_ = gl::glGetUniformLocation(program_, "nodeBoundsExtent");
+        colorModeLoc_ = gl::glGetUniformLocation(program_, "colorMode");
+        positionLoc_ = gl::glGetAttribLocation(program_, "position");
+        colorLoc_ = gl::glGetAttribLocation(program_, "color");
+    }
+
+    LivePointCloudRenderer::~LivePointCloudRenderer()
+    {
+        // the ingestion threads are stopped first, they do not use any GPU resources.
+        ingestion_.reset();
+        for (auto& gpuNode : gpuNodes_) {
+            if (gpuNode.vao_ != 0) gl::glDeleteVertexArrays(1, &gpuNode.vao_);
+            if (gpuNode.vbo_ != 0) gl::glDeleteBuffers(1, &gpuNode.vbo_);
+        }
+    }
+
+    /**
+     *  Starts a new frame and applies the node updates sent since the last frame as far as the upload budget allows.
+     */
+    void LivePointCloudRenderer::BeginFrame()
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto allocatedBytes = statistics_.allocatedBytes_;
+        statistics_ = LivePointCloudStatistics{};
+        statistics_.allocatedBytes_ = allocatedBytes;
+
+        while ((statistics_.numAppliedUpdates_ == 0 || statistics_.uploadedBytes_ < uploadBudget_) && ingestion_->TryPopUpdate(update_)) {
+            ApplyUpdate(update_);
+            ++statistics_.numAppliedUpdates_;
+        }
+        gl::glBindBuffer(gl::GL_ARRAY_BUFFER, 0);
+        statistics_.updateTime_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     *  Draws the nodes selected for a view.
+     *  @param viewProjection the view projection matrix.
+     *  @param lodParameters the parameters of the level of detail selection.
+     */
+    void LivePointCloudRenderer::Draw(const glm::mat4& viewProjection, const LODTraversalParameters& lodParameters)
+    {
+        if (nodes_.empty()) return;
+
+        GLint viewport[4];
+        gl::glGetIntegerv(gl::GL_VIEWPORT, viewport);
+        const auto& selectedNodes = traversal_.Traverse(nodes_.data(), viewProjection, static_cast<float>(viewport[3]), lodParameters);
+
+        gl::glEnable(gl::GL_PROGRAM_POINT_SIZE);
+        gl::glUseProgram(program_);
+        gl::glUniformMatrix4fv(viewProjectionLoc_, 1, gl::GL_FALSE, glm::value_ptr(viewProjection));
+        gl::glUniform1f(pointSizeLoc_, 1.0f);
+        gl::glUniform3f(nodeBoundsMinLoc_, 0.0f, 0.0f, 0.0f);
+        gl::glUniform3f(nodeBoundsExtentLoc_, 1.0f, 1.0f, 1.0f);
+        // the program is shared with the file renderer, live points only have colors.
+        gl::glUniform1i(colorModeLoc_, 0);
+        for (auto nodeIndex : selectedNodes) {
+            const auto& node = nodes_[nodeIndex];
+            if (node.numPoints_ == 0) continue;
+            gl::glBindVertexArray(gpuNodes_[nodeIndex].vao_);
+            gl::glDrawArrays(gl::GL_POINTS, 0, static_cast<GLsizei>(node.numPoints_));
+            statistics_.numDrawnPoints_ += node.numPoints_;
+        }
+        gl::glBindVertexArray(0);
+        gl::glUseProgram(0);
+        gl::glDisable(gl::GL_PROGRAM_POINT_SIZE);
+    }
+
+    /**
+     *  Applies a node update. Children referenced by the record that were not sent yet get empty placeholders.
+     *  @param update the update.
+     */
+    void LivePointCloudRenderer::ApplyUpdate(const LiveNodeUpdate& update)
+    {
+        auto numNodes = static_cast<std::size_t>(update.nodeIndex_) + 1;
+        if (update.record_.firstChild_ != POINTCLOUD_NO_NODE) numNodes = std::max<std::size_t>(numNodes, update.record_.firstChild_ + update.record_.numChildren_);
+        if (nodes_.size() < numNodes) {
+            PointCloudNodeRecord placeholder;
+            placeholder.boundsMin_ = glm::vec3(0.0f);
+            placeholder.boundsMax_ = glm::vec3(0.0f);
+            nodes_.resize(numNodes, placeholder);
+            gpuNodes_.resize(numNodes);
+        }
+
+        nodes_[update.nodeIndex_] = update.record_;
+        if (update.points_.empty()) return;
+        ReserveNodeBuffer(update.nodeIndex_, update.record_.numPoints_, update.firstPoint_);
+        auto dataSize = update.points_.size() * sizeof(PointCloudPoint);
+        gl::glBindBuffer(gl::GL_ARRAY_BUFFER, gpuNodes_[update.nodeIndex_].vbo_);
+        gl::glBufferSubData(gl::GL_ARRAY_BUFFER, static_cast<gl::GLintptr>(update.firstPoint_ * sizeof(PointCloudPoint)),
+            static_cast<gl::GLsizeiptr>(dataSize), update.points_.data());
+        statistics_.uploadedBytes_ += dataSize;
+    }
+
+    /**
+     *  Makes sure the vertex buffer of a node can store a number of points, the points already stored are kept.
+     *  @param nodeIndex the node.
+     *  @param numPoints the number of points.
+     *  @param numKeptPoints the number of points at the start of the buffer that are copied to a new one.
+     */
+    void LivePointCloudRenderer::ReserveNodeBuffer(std::uint32_t nodeIndex, std::uint32_t numPoints, std::uint32_t numKeptPoints)
+    {
+        auto& gpuNode = gpuNodes_[nodeIndex];
+        if (numPoints <= gpuNode.capacity_) return;
+
+        // capacities double, so appending single points to a node copies each point only a constant number of times.
+        auto capacity = std::max(std::max(numPoints, 2 * gpuNode.capacity_), 1024U);
+        GLuint vbo = 0;
+        gl::glGenBuffers(1, &vbo);
+        gl::glBindBuffer(gl::GL_ARRAY_BUFFER, vbo);
+        gl::glBufferData(gl::GL_ARRAY_BUFFER, static_cast<gl::GLsizeiptr>(capacity * sizeof(PointCloudPoint)), nullptr, gl::GL_DYNAMIC_DRAW);
+        if (gpuNode.vbo_ != 0) {
+            numKeptPoints = std::min(numKeptPoints, gpuNode.capacity_);
+            if (numKeptPoints > 0) {
+                gl::glBindBuffer(gl::GL_COPY_READ_BUFFER, gpuNode.vbo_);
+                gl::glCopyBufferSubData(gl::GL_COPY_READ_BUFFER, gl::GL_ARRAY_BUFFER, 0, 0, static_cast<gl::GLsizeiptr>(numKeptPoints * sizeof(PointCloudPoint)));
+                gl::glBindBuffer(gl::GL_COPY_READ_BUFFER, 0);
+            }
+            gl::glDeleteBuffers(1, &gpuNode.vbo_);
+        }
+        statistics_.allocatedBytes_ += (capacity - gpuNode.capacity_) * sizeof(PointCloudPoint);
+        gpuNode.vbo_ = vbo;
+        gpuNode.capacity_ = capacity;
+
+        if (gpuNode.vao_ == 0) gl::glGenVertexArrays(1, &gpuNode.vao_);
+        gl::glBindVertexArray(gpuNode.vao_);
+        PointVertex::SetVertexAttributes(positionLoc_, colorLoc_);
+        gl::glBindVertexArray(0);
+    }
+}
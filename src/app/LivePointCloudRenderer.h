@@ -0,0 +1,106 @@
+/**
+ * @file   LivePointCloudRenderer.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the renderer for point clouds growing while they are drawn.
+ */
+
+#pragma once
+
+#include "core/main.h"
+#include "pointcloud/LiveIngestion.h"
+#include "pointcloud/LODTraversal.h"
+
+#include <memory>
+
+namespace viscom {
+
+    /** Statistics of the uploads of the live point cloud. */
+    struct LivePointCloudStatistics
+    {
+        /** The number of node updates applied in the current frame. */
+        std::uint32_t numAppliedUpdates_ = 0;
+        /** The number of bytes uploaded in the current frame. */
+        std::uint64_t uploadedBytes_ = 0;
+        /** The time spent applying updates in the current frame in milliseconds. */
+        double updateTime_ = 0.0;
+        /** The number of bytes of the vertex buffers. */
+        std::uint64_t allocatedBytes_ = 0;
+        /** The number of points drawn in the current frame, summed over all views. */
+        std::uint64_t numDrawnPoints_ = 0;
+    };
+
+    /**
+     *  Draws the octree of a live ingestion. Each frame the node updates sent by the ingestion worker are applied
+     *  until the upload budget is used up, the rest stays queued for the next frame, so neither updating nor drawing
+     *  ever waits for the ingestion. Each node has its own vertex buffer that grows by doubling, new points are
+     *  appended to it.
+     */
+    class LivePointCloudRenderer
+    {
+    public:
+        LivePointCloudRenderer(std::unique_ptr<LiveIngestion> ingestion, GLuint program);
+        LivePointCloudRenderer(const LivePointCloudRenderer&) = delete;
+        LivePointCloudRenderer& operator=(const LivePointCloudRenderer&) = delete;
+        ~LivePointCloudRenderer();
+
+        void BeginFrame();
+        void Draw(const glm::mat4& viewProjection, const LODTraversalParameters& lodParameters);
+
+        /** Returns the ingestion. */
+        const LiveIngestion& GetIngestion() const { return *ingestion_; }
+        /** Returns the statistics of the current frame. */
+        const LivePointCloudStatistics& GetStatistics() const { return statistics_; }
+        /** Returns the maximum number of bytes uploaded per frame. */
+        std::uint64_t GetUploadBudget() const { return uploadBudget_; }
+        /** Sets the maximum number of bytes uploaded per frame, at least one update is applied per frame. */
+        void SetUploadBudget(std::uint64_t uploadBudget) { uploadBudget_ = uploadBudget; }
+
+    private:
+        void ApplyUpdate(const LiveNodeUpdate& update);
+        void ReserveNodeBuffer(std::uint32_t nodeIndex, std::uint32_t numPoints, std::uint32_t numKeptPoints);
+
+        /** The GPU resources of a single node. */
+        struct GPUNode
+        {
+            /** Holds the vertex buffer. */
+            GLuint vbo_ = 0;
+            /** Holds the vertex array object. */
+            GLuint vao_ = 0;
+            /** Holds the number of points the vertex buffer can store. */
+            std::uint32_t capacity_ = 0;
+        };
+
+        /** Holds the ingestion. */
+        std::unique_ptr<LiveIngestion> ingestion_;
+        /** Holds the shader program. */
+        GLuint program_;
+        /** Holds the location of the view projection matrix. */
+        GLint viewProjectionLoc_ = -1;
+        /** Holds the location of the point size. */
+        GLint pointSizeLoc_ = -1;
+        /** Holds the location of the minimum of the node bounds. */
+        GLint nodeBoundsMinLoc_ = -1;
+        /** Holds the location of the extent of the node bounds. */
+        GLint nodeBoundsExtentLoc_ = -1;
+        /** Holds the location of the color mode. */
+        GLint colorModeLoc_ = -1;
+        /** Holds the location of the position attribute. */
+        GLint positionLoc_ = -1;
+        /** Holds the location of the color attribute. */
+        GLint colorLoc_ = -1;
+        /** Holds the node table as far as updates were applied. */
+        std::vector<PointCloudNodeRecord> nodes_;
+        /** Holds the GPU resources of each node. */
+        std::vector<GPUNode> gpuNodes_;
+        /** Holds the update currently applied, kept to reuse its memory. */
+        LiveNodeUpdate update_;
+        /** Holds the level of detail selection. */
+        LODTraversal traversal_;
+        /** Holds the maximum number of bytes uploaded per frame. */
+        std::uint64_t uploadBudget_ = 16ULL << 20;
+        /** Holds the statistics of the current frame. */
+        LivePointCloudStatistics statistics_;
+    };
+}
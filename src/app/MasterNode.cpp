@@ -8,19 +8,98 @@
 
 #include "MasterNode.h"
 #include <imgui.h>
+#include "PointCloudRenderer.h"
+#include "LivePointCloudRenderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 
 namespace viscom {
 
     MasterNode::MasterNode(ApplicationNodeInternal* appNode) :
-        ApplicationNodeImplementation{ appNode }
+        ApplicationNodeImplementation{ appNode },
+        budgetController_{ GetLODParameters().pointBudget_ }
     {
+        budgetController_.GetParameters().targetFrameTime_ = 1000.0f / static_cast<float>(VISCOM_TARGET_FRAME_RATE);
     }
 
     MasterNode::~MasterNode() = default;
 
+    void MasterNode::InitOpenGL()
+    {
+        ApplicationNodeImplementation::InitOpenGL();
+        // the slaves only need the file on the master, they request the chunks their views need.
+        if (VISCOM_POINTCLOUD_DISTRIBUTION != 0 && GetPointCloud()) chunkServer_ = std::make_unique<ChunkServer>(GetPointCloud()->GetFile());
+    }
+
+    /**
+     *  Decides the state of the next frame from the local input and the views of all nodes.
+     */
+    void MasterNode::PreSync()
+    {
+        ApplicationNodeImplementation::PreSync();
+        UpdatePointBudget();
+        CaptureFrameState();
+
+        // the master's views come first, then the slaves' views in the order of their ids, so the list is stable.
+        auto& views = GetFrameState().views_;
+        views.clear();
+        if (GetPointCloud()) views = GetPointCloud()->GetCameraRelativeViews();
+        for (const auto& slaveViews : slaveViews_) views.insert(views.end(), slaveViews.second.begin(), slaveViews.second.end());
+        if (views.size() > FrustumCuller::MAX_FRUSTA) views.resize(FrustumCuller::MAX_FRUSTA);
+
+        if (chunkServer_) {
+            chunkServer_->Send(static_cast<std::uint64_t>(VISCOM_DISTRIBUTION_BUDGET) << 20, [this](int clientID, const std::vector<std::uint8_t>& message) {
+                TransferDataToNode(message.data(), message.size(), CHUNK_DATA_PACKAGE_ID, static_cast<std::size_t>(clientID));
+            });
+        }
+    }
+
+    /**
+     *  Adapts the point budget to the slowest node. The budget is part of the frame state, so all nodes select the
+     *  same points and the seams between projectors never show different densities.
+     */
+    void MasterNode::UpdatePointBudget()
+    {
+        ++numFrames_;
+        FrameProfileSample sample;
+        if (!adaptiveBudget_ || !GetProfiler().GetLastCompleteSample(sample) || sample.frame_ == lastBudgetFrame_) return;
+        // frames of a still camera only add to a kept image, they do not tell the cost of a moving one.
+        if (GetPointCloud() && GetPointCloud()->IsRefining()) return;
+        lastBudgetFrame_ = sample.frame_;
+
+        auto frameTime = FrameProfiler::GetBusyTime(sample);
+        for (const auto& slave : slaveProfiles_) {
+            if (numFrames_ - slaveProfileFrames_[slave.first] > STALE_PROFILE_FRAMES) continue;
+            frameTime = std::max(frameTime, FrameProfiler::GetBusyTime(slave.second));
+        }
+        GetLODParameters().pointBudget_ = budgetController_.Update(frameTime);
+    }
+
+    /**
+     *  Sends the changes of the frame state to the slaves.
+     */
+    void MasterNode::EncodeData()
+    {
+        ApplicationNodeImplementation::EncodeData();
+        sharedFrameState_.setVal(frameStateEncoder_.Encode(GetFrameState()));
+        sgct::SharedData::instance()->writeVector(&sharedFrameState_);
+    }
+
+    void MasterNode::CleanUp()
+    {
+        // the server reads the file of the point cloud renderer.
+        chunkServer_.reset();
+        ApplicationNodeImplementation::CleanUp();
+    }
+
     void MasterNode::Draw2D(FrameBuffer& fbo)
     {
-        fbo.DrawToFBO([]() {
+        FrameProfiler::ScopedPhase profilePhase{ GetProfiler(), FramePhase::Draw2D };
+        fbo.DrawToFBO([this]() {
             ImGui::ShowTestWindow();
 
             ImGui::SetNextWindowPos(ImVec2(700, 60), ImGuiSetCond_FirstUseEver);
@@ -30,9 +109,287 @@ namespace viscom {
                 ImGui::Text("Hello World on Master!");
             }
             ImGui::End();
+
+            if (GetPointCloud()) {
+                ImGui::SetNextWindowPos(ImVec2(60, 60), ImGuiSetCond_FirstUseEver);
+                ImGui::SetNextWindowSize(ImVec2(400, 250), ImGuiSetCond_FirstUseEver);
+                if (ImGui::Begin("Point Cloud", nullptr, ImGuiWindowFlags_ShowBorders))
+                {
+                    auto& lodParameters = GetLODParameters();
+                    auto pointBudget = static_cast<int>(lodParameters.pointBudget_ / 1000);
+                    if (ImGui::SliderInt("Point Budget [k]", &pointBudget, 100, 50000)) {
+                        lodParameters.pointBudget_ = static_cast<std::uint64_t>(pointBudget) * 1000;
+                        budgetController_.Reset(lodParameters.pointBudget_);
+                    }
+                    if (ImGui::Checkbox("Adaptive Budget", &adaptiveBudget_) && adaptiveBudget_) budgetController_.Reset(lodParameters.pointBudget_);
+                    if (adaptiveBudget_) {
+                        auto& controllerParameters = budgetController_.GetParameters();
+                        auto targetRate = 1000.0f / controllerParameters.targetFrameTime_;
+                        if (ImGui::SliderFloat("Target Rate [Hz]", &targetRate, 20.0f, 144.0f, "%.0f")) controllerParameters.targetFrameTime_ = 1000.0f / targetRate;
+                        ImGui::Text("Load: %.0f%% of %.2f ms (%llu changes)", 100.0f * budgetController_.GetLoad(), controllerParameters.targetFrameTime_,
+                            static_cast<unsigned long long>(budgetController_.GetNumChanges()));
+                    }
+                    ImGui::SliderFloat("Min. Node Size [px]", &lodParameters.minNodeSize_, 10.0f, 1000.0f);
+                    ImGui::Checkbox("CPU Rasterizer", &GetUseSoftwareRasterizer());
+                    // all but RGB need a columnar file with the attribute, the CPU rasterizer always shows RGB.
+                    const char* colorModes[] = { "RGB", "Intensity", "Classification", "Return Number", "GPS Time" };
+                    if (ImGui::Combo("Color", &GetColorMode(), colorModes, 5) && !GetPointCloud()->IsColorModeAvailable(static_cast<PointCloudColorMode>(GetColorMode()))) {
+                        GetColorMode() = 0;
+                    }
+
+                    const auto& statistics = GetPointCloud()->GetTraversalStatistics();
+                    ImGui::Separator();
+                    ImGui::Text("Points: %llu / %llu", static_cast<unsigned long long>(statistics.numSelectedPoints_), static_cast<unsigned long long>(GetPointCloud()->GetFile().GetHeader().numPoints_));
+                    ImGui::Text("Nodes: %u selected, %u visited, %u culled", statistics.numSelectedNodes_, statistics.numVisitedNodes_, statistics.numCulledNodes_);
+                    ImGui::Text("Deepest Level: %u%s", statistics.maxLevel_, statistics.budgetReached_ ? " (budget reached)" : "");
+                    ImGui::Text("Views: %u local, %u cluster (%u traversals)", static_cast<unsigned>(GetPointCloud()->GetNumViews()),
+                        static_cast<unsigned>(GetFrameState().views_.size()), GetPointCloud()->GetNumTraversals());
+                    ImGui::Text("Frame State: version %u, %u bytes", frameStateEncoder_.GetVersion(), static_cast<unsigned>(frameStateEncoder_.GetSize()));
+                    ImGui::Text("GPU Points: %llu (%llu drawn)", static_cast<unsigned long long>(GetPointCloud()->GetNumResidentPoints()),
+                        static_cast<unsigned long long>(GetPointCloud()->GetNumDrawnPoints()));
+
+                    auto& streamingParameters = GetPointCloud()->GetStreamingParameters();
+                    auto uploadBudget = static_cast<int>(streamingParameters.uploadBudget_ >> 20);
+                    auto memoryLimit = static_cast<int>(streamingParameters.memoryLimit_ >> 20);
+                    ImGui::Separator();
+                    if (ImGui::SliderInt("Upload Budget [MB]", &uploadBudget, 1, 256)) streamingParameters.uploadBudget_ = static_cast<std::uint64_t>(uploadBudget) << 20;
+                    if (ImGui::SliderInt("GPU Memory [MB]", &memoryLimit, 64, 8192)) streamingParameters.memoryLimit_ = static_cast<std::uint64_t>(memoryLimit) << 20;
+                    auto indirect = GetPointCloud()->GetSubmission() == PointCloudSubmission::Indirect;
+                    if (GetPointCloud()->IsIndirectSupported() && ImGui::Checkbox("Indirect Draw", &indirect)) {
+                        GetPointCloud()->SetSubmission(indirect ? PointCloudSubmission::Indirect : PointCloudSubmission::PerNode);
+                    }
+                    auto progressive = GetPointCloud()->IsProgressive();
+                    if (ImGui::Checkbox("Progressive Refinement", &progressive)) GetPointCloud()->SetProgressive(progressive);
+                    if (GetPointCloud()->IsRefining()) {
+                        ImGui::Text("Refinement: %.0f%%%s", 100.0f * GetPointCloud()->GetRefinementProgress(), GetPointCloud()->IsRefinementComplete() ? " (complete)" : "");
+                    }
+                    auto occlusionCulling = GetPointCloud()->IsOcclusionCulling();
+                    if (ImGui::Checkbox("Occlusion Culling", &occlusionCulling)) GetPointCloud()->SetOcclusionCulling(occlusionCulling);
+                    if (occlusionCulling) {
+                        const auto& occlusion = GetPointCloud()->GetOcclusionStatistics();
+                        ImGui::Text("Occlusion: %u of %u nodes culled, %llu points saved", occlusion.numOccludedNodes_, occlusion.numTestedNodes_,
+                            static_cast<unsigned long long>(occlusion.numOccludedPoints_));
+                    }
+
+                    const auto& streaming = GetPointCloud()->GetStreamingStatistics();
+                    ImGui::Text("GPU Memory: %.1f MB in %.1f MB buffers (%.1f MB uploaded)", static_cast<double>(streaming.residentBytes_) / (1 << 20),
+                        static_cast<double>(streaming.allocatedBytes_) / (1 << 20), static_cast<double>(streaming.uploadedBytes_) / (1 << 20));
+                    if (GetPointCloud()->GetFile().IsColumnar()) {
+                        ImGui::Text("Columns: %.1f MB of other attributes not uploaded", static_cast<double>(streaming.skippedBytes_) / (1 << 20));
+                    }
+                    ImGui::Text("Draw Calls: %llu for %llu nodes", static_cast<unsigned long long>(GetPointCloud()->GetNumDrawCalls()),
+                        static_cast<unsigned long long>(GetPointCloud()->GetNumDrawnNodes()));
+                    ImGui::Text("Loading: %u missing, %u queued, %llu evicted", streaming.numMissingNodes_, static_cast<unsigned>(GetPointCloud()->GetNumQueuedNodes()),
+                        static_cast<unsigned long long>(streaming.numEvictedNodes_));
+
+                    ImGui::Separator();
+                    ImGui::Checkbox("Pick Points", &picking_);
+                    if (!picks_.empty()) {
+                        // positions are shown in the source coordinate system, e.g. georeferenced.
+                        auto position = GetPointCloud()->GetFile().GetHeader().origin_ + glm::dvec3(picks_.back().position_);
+                        ImGui::Text("Pick: (%.3f, %.3f, %.3f), spacing %.4f", position.x, position.y, position.z, pickSpacing_);
+                        if (picks_.size() == 2) ImGui::Text("Distance: %.4f", glm::length(picks_[1].position_ - picks_[0].position_));
+                        ImGui::Text("Query: %.3f ms, %u nodes, %llu points", pickTime_, pickStatistics_.numVisitedNodes_,
+                            static_cast<unsigned long long>(pickStatistics_.numTestedPoints_));
+                    }
+                }
+                ImGui::End();
+            }
+
+            DrawProfilerWindow();
         });
 
         ApplicationNodeImplementation::Draw2D(fbo);
     }
 
+    /**
+     *  Receives the frame profiles and views of the slaves.
+     *  @param receivedData the received data.
+     *  @param receivedLength the length of the received data in bytes.
+     *  @param packageID the id of the package.
+     *  @param clientID the id of the sending node.
+     */
+    bool MasterNode::DataTransferCallback(void* receivedData, int receivedLength, std::uint16_t packageID, int clientID)
+    {
+        if (packageID == CHUNK_REQUEST_PACKAGE_ID && chunkServer_) {
+            chunkServer_->Receive(clientID, receivedData, static_cast<std::size_t>(receivedLength));
+            return true;
+        }
+
+        if (packageID == CLUSTER_VIEWS_PACKAGE_ID && receivedLength % static_cast<int>(sizeof(ClusterView)) == 0) {
+            auto views = static_cast<const ClusterView*>(receivedData);
+            slaveViews_[clientID].assign(views, views + receivedLength / static_cast<int>(sizeof(ClusterView)));
+            return true;
+        }
+
+        if (packageID != FRAME_PROFILE_PACKAGE_ID || receivedLength != static_cast<int>(sizeof(FrameProfileSample)))
+            return ApplicationNodeImplementation::DataTransferCallback(receivedData, receivedLength, packageID, clientID);
+
+        std::memcpy(&slaveProfiles_[clientID], receivedData, sizeof(FrameProfileSample));
+        slaveProfileFrames_[clientID] = numFrames_;
+        return true;
+    }
+
+    /**
+     *  Picks the point under the mouse cursor on a left click.
+     *  @param button the mouse button.
+     *  @param action the action of the button.
+     */
+    bool MasterNode::MouseButtonCallback(int button, int action)
+    {
+        if (ApplicationNodeImplementation::MouseButtonCallback(button, action)) return true;
+
+        const auto& io = ImGui::GetIO();
+        if (!picking_ || button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS || io.WantCaptureMouse) return false;
+        if (io.DisplaySize.x <= 0.0f || io.DisplaySize.y <= 0.0f) return false;
+        PickPoint(glm::vec2(io.MousePos.x / io.DisplaySize.x, io.MousePos.y / io.DisplaySize.y));
+        return true;
+    }
+
+#ifdef WITH_TUIO
+    /**
+     *  Picks the point under a new touch.
+     *  @param tcur the touch cursor.
+     */
+    bool MasterNode::AddTuioCursor(TUIO::TuioCursor* tcur)
+    {
+        if (ApplicationNodeImplementation::AddTuioCursor(tcur)) return true;
+        if (!picking_) return false;
+        // touch positions are normalized to the screen with y pointing down, like the mouse position.
+        PickPoint(glm::vec2(tcur->getX(), tcur->getY()));
+        return true;
+    }
+#endif
+
+    /**
+     *  Picks the point nearest to the camera in a narrow cone around the ray through a screen position and estimates
+     *  the point spacing around it. The queries read the file directly, so they find points of nodes not drawn.
+     *  @param screenPosition the position on the screen, normalized to [0, 1] with y pointing down.
+     */
+    void MasterNode::PickPoint(const glm::vec2& screenPosition)
+    {
+        if (!GetPointCloud()) return;
+        if (!pointQuery_) pointQuery_ = std::make_unique<PointQuery>(GetPointCloud()->GetFile());
+
+        auto start = std::chrono::high_resolution_clock::now();
+        auto inverseViewProjection = glm::inverse(GetCamera()->GetViewPerspectiveMatrix());
+        auto unproject = [&inverseViewProjection](const glm::vec2& ndc, float depth) {
+            auto position = inverseViewProjection * glm::vec4(ndc, depth, 1.0f);
+            return glm::vec3(position) / position.w;
+        };
+        glm::vec2 ndc{ 2.0f * screenPosition.x - 1.0f, 1.0f - 2.0f * screenPosition.y };
+        auto nearPoint = unproject(ndc, -1.0f), farPoint = unproject(ndc, 1.0f);
+        auto coneEdge = unproject(ndc + glm::vec2(0.0f, 2.0f * PICK_CONE_RADIUS), 1.0f);
+        auto rayLength = glm::length(farPoint - nearPoint);
+        auto coneSlope = glm::length(coneEdge - farPoint) / rayLength;
+
+        PointQueryResult pick;
+        auto found = pointQuery_->Pick(nearPoint, farPoint - nearPoint, coneSlope, pick, rayLength);
+        pickStatistics_ = pointQuery_->GetStatistics();
+        if (found) {
+            // the nearest neighbors start with the picked point itself.
+            const auto& neighbors = pointQuery_->FindNearest(pick.position_, PICK_NEIGHBORS + 1);
+            pickSpacing_ = 0.0f;
+            for (std::size_t i = 1; i < neighbors.size(); ++i) pickSpacing_ += neighbors[i].distance_ / static_cast<float>(neighbors.size() - 1);
+            if (picks_.size() == 2) picks_.erase(picks_.begin());
+            picks_.push_back(pick);
+        }
+        pickTime_ = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    void MasterNode::DrawProfilerWindow()
+    {
+        ImGui::SetNextWindowPos(ImVec2(60, 330), ImGuiSetCond_FirstUseEver);
+        ImGui::SetNextWindowSize(ImVec2(400, 330), ImGuiSetCond_FirstUseEver);
+        if (ImGui::Begin("Profiler", nullptr, ImGuiWindowFlags_ShowBorders))
+        {
+            const auto& profiler = GetProfiler();
+            constexpr auto numPhases = static_cast<std::size_t>(FramePhase::Count);
+            auto numGraphSamples = std::min<std::size_t>(profiler.GetNumSamples(), 300);
+            std::vector<float> frameTimes(numGraphSamples);
+            for (std::size_t i = 0; i < numGraphSamples; ++i) frameTimes[i] = profiler.GetSample(numGraphSamples - 1 - i).frameTime_;
+
+            // phase times are averaged over the last second (at 60 Hz) to keep them readable.
+            auto numAverageSamples = std::min<std::size_t>(profiler.GetNumSamples(), 60);
+            std::array<float, numPhases> cpuTimes = {}, gpuTimes = {};
+            auto frameTime = 0.0f;
+            auto numGPUSamples = 0U;
+            for (std::size_t age = 0; age < numAverageSamples; ++age) {
+                const auto& sample = profiler.GetSample(age);
+                frameTime += sample.frameTime_ / numAverageSamples;
+                for (std::size_t p = 0; p < numPhases; ++p) cpuTimes[p] += sample.cpuTimes_[p] / numAverageSamples;
+                if (sample.hasGPUTimes_ == 0) continue;
+                ++numGPUSamples;
+                for (std::size_t p = 0; p < numPhases; ++p) gpuTimes[p] += sample.gpuTimes_[p];
+            }
+
+            char overlay[32];
+            std::snprintf(overlay, sizeof(overlay), "%.2f ms", frameTime);
+            ImGui::PlotLines("Frame", frameTimes.data(), static_cast<int>(frameTimes.size()), 0, overlay, 0.0f, std::numeric_limits<float>::max(), ImVec2(0, 80));
+
+            ImGui::Columns(3, "phases");
+            ImGui::Text("Phase"); ImGui::NextColumn();
+            ImGui::Text("CPU [ms]"); ImGui::NextColumn();
+            ImGui::Text("GPU [ms]"); ImGui::NextColumn();
+            ImGui::Separator();
+            for (std::size_t p = 0; p < numPhases; ++p) {
+                ImGui::Text("%s", FrameProfiler::GetPhaseName(static_cast<FramePhase>(p))); ImGui::NextColumn();
+                ImGui::Text("%.3f", cpuTimes[p]); ImGui::NextColumn();
+                if (numGPUSamples > 0) ImGui::Text("%.3f", gpuTimes[p] / numGPUSamples);
+                else ImGui::Text("-");
+                ImGui::NextColumn();
+            }
+            ImGui::Columns(1);
+
+            if (GetLivePointCloud()) {
+                // shown next to the frame time, ingestion must keep up without the frame time going up.
+                ImGui::Separator();
+                auto ingestion = GetLivePointCloud()->GetIngestion().GetStatistics();
+                const auto& upload = GetLivePointCloud()->GetStatistics();
+                ImGui::Text("Ingestion: %.2f Mpts/s, %llu points in %u nodes (%llu dropped)", ingestion.pointsPerSecond_ / 1e6,
+                    static_cast<unsigned long long>(ingestion.numInsertedPoints_), static_cast<unsigned>(ingestion.numNodes_),
+                    static_cast<unsigned long long>(ingestion.numRejectedPoints_));
+                ImGui::Text("Queues: %u / %u batches (%llu stalls), %u updates pending, %u nodes dirty", static_cast<unsigned>(ingestion.numQueuedBatches_),
+                    static_cast<unsigned>(ingestion.batchQueueCapacity_), static_cast<unsigned long long>(ingestion.numProducerStalls_),
+                    static_cast<unsigned>(ingestion.numPendingUpdates_), static_cast<unsigned>(ingestion.numDirtyNodes_));
+                ImGui::Text("Live Upload: %u updates, %.2f MB in %.3f ms (%.1f MB buffers)", upload.numAppliedUpdates_,
+                    static_cast<double>(upload.uploadedBytes_) / (1 << 20), upload.updateTime_, static_cast<double>(upload.allocatedBytes_) / (1 << 20));
+            }
+
+            if (chunkServer_) {
+                ImGui::Separator();
+                auto distribution = chunkServer_->GetStatistics();
+                ImGui::Text("Distribution: %.1f MB sent to %u slaves, %llu chunks sent, %llu read, %u pending, %llu manifests",
+                    static_cast<double>(distribution.sentBytes_) / (1 << 20), static_cast<unsigned>(distribution.numClients_),
+                    static_cast<unsigned long long>(distribution.numSentChunks_), static_cast<unsigned long long>(distribution.numReadChunks_),
+                    static_cast<unsigned>(distribution.numPendingChunks_), static_cast<unsigned long long>(distribution.numSentManifests_));
+            }
+
+            if (!slaveProfiles_.empty()) {
+                ImGui::Separator();
+                auto slowest = slaveProfiles_.begin();
+                for (auto it = slaveProfiles_.begin(); it != slaveProfiles_.end(); ++it) {
+                    if (it->second.frameTime_ > slowest->second.frameTime_) slowest = it;
+                }
+                for (const auto& slave : slaveProfiles_) {
+                    const auto& sample = slave.second;
+                    ImGui::Text("%sNode %d: %.2f ms (draw %.2f ms CPU, %.2f ms GPU)", slave.first == slowest->first ? "* " : "  ", slave.first, sample.frameTime_,
+                        sample.cpuTimes_[static_cast<std::size_t>(FramePhase::DrawFrame)], sample.gpuTimes_[static_cast<std::size_t>(FramePhase::DrawFrame)]);
+                }
+            }
+
+            ImGui::Separator();
+            if (ImGui::Button("Export CSV")) {
+                try {
+                    profiler.WriteCSV("frame_profile.csv");
+                    LOG(INFO) << "Wrote " << profiler.GetNumSamples() << " frame profiles to frame_profile.csv.";
+                }
+                catch (const std::runtime_error& e) {
+                    LOG(WARNING) << "Could not export frame profiles: " << e.what();
+                }
+            }
+        }
+        ImGui::End();
+    }
+
 }
@@ -9,10 +9,18 @@
 #pragma once
 
 #include "../app/ApplicationNodeImplementation.h"
+#include "pointcloud/ChunkDistribution.h"
+#include "pointcloud/PointBudgetController.h"
+#include "pointcloud/PointQuery.h"
 #ifdef WITH_TUIO
 #include "core/TuioInputWrapper.h"
 #endif
 
+#include <sgct.h>
+
+#include <map>
+#include <memory>
+
 namespace viscom {
 
     class MasterNode final : public ApplicationNodeImplementation
@@ -21,7 +29,61 @@ namespace viscom {
         explicit MasterNode(ApplicationNodeInternal* appNode);
         virtual ~MasterNode() override;
 
+        void InitOpenGL() override;
+        void PreSync() override;
         void Draw2D(FrameBuffer& fbo) override;
+        void EncodeData() override;
+        void CleanUp() override;
+
+        bool DataTransferCallback(void* receivedData, int receivedLength, std::uint16_t packageID, int clientID) override;
+        bool MouseButtonCallback(int button, int action) override;
+#ifdef WITH_TUIO
+        bool AddTuioCursor(TUIO::TuioCursor* tcur) override;
+#endif
+
+    private:
+        /** The number of frames after which the profile of a slave that stopped reporting is ignored. */
+        static constexpr std::uint64_t STALE_PROFILE_FRAMES = 120;
+        /** The radius of the cone points are picked in around the cursor, relative to the screen height. */
+        static constexpr float PICK_CONE_RADIUS = 0.005f;
+        /** The number of neighbors the point spacing at a picked point is averaged over. */
+        static constexpr std::size_t PICK_NEIGHBORS = 8;
+
+        void UpdatePointBudget();
+        void PickPoint(const glm::vec2& screenPosition);
+        void DrawProfilerWindow();
 
+        /** Holds the last frame profile reported by each slave. */
+        std::map<int, FrameProfileSample> slaveProfiles_;
+        /** Holds the frame of the master in which each slave reported its last profile. */
+        std::map<int, std::uint64_t> slaveProfileFrames_;
+        /** Holds the number of frames of the master. */
+        std::uint64_t numFrames_ = 0;
+        /** Holds the last frame of the master's profile used by the budget controller. */
+        std::uint64_t lastBudgetFrame_ = 0;
+        /** Holds the controller adapting the point budget of the whole cluster. */
+        PointBudgetController budgetController_;
+        /** Holds whether the point budget is adapted to the frame times. */
+        bool adaptiveBudget_ = VISCOM_ADAPTIVE_POINT_BUDGET != 0;
+        /** Holds the spatial queries on the point cloud (created on the first pick). */
+        std::unique_ptr<PointQuery> pointQuery_;
+        /** Holds whether clicks and touches pick points. */
+        bool picking_ = true;
+        /** Holds the last two picked points, the distance between them is measured. */
+        std::vector<PointQueryResult> picks_;
+        /** Holds the average distance of the last picked point to its neighbors. */
+        float pickSpacing_ = 0.0f;
+        /** Holds the time of the last pick including the neighbor search in milliseconds. */
+        float pickTime_ = 0.0f;
+        /** Holds the statistics of the ray query of the last pick. */
+        PointQueryStatistics pickStatistics_;
+        /** Holds the views reported by each slave. */
+        std::map<int, std::vector<ClusterView>> slaveViews_;
+        /** Holds the server distributing the point cloud to the slaves (nullptr if they open the file themselves). */
+        std::unique_ptr<ChunkServer> chunkServer_;
+        /** Holds the encoder for the frame state sent to the slaves. */
+        FrameStateEncoder frameStateEncoder_;
+        /** Holds the encoded frame state synchronized with the slaves. */
+        sgct::SharedVector<std::uint8_t> sharedFrameState_;
     };
 }
@@ -0,0 +1,188 @@
+/**
+ * @file   MeshCache.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the binary cache of interleaved mesh buffers.
+ */
+
+#include "MeshCache.h"
+#include "Hash.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+namespace viscom {
+
+    namespace {
+        /** The header at the start of each cache file, followed by the vertices and the (4 byte aligned) indices. */
+        struct MeshCacheHeader
+        {
+            /** The magic number (MeshCache::MAGIC). */
+            std::uint32_t magic_;
+            /** The cache format version (MeshCache::VERSION). */
+            std::uint32_t version_;
+            /** The size of the source file in bytes. */
+            std::uint64_t sourceSize_;
+            /** The modification time of the source file. */
+            std::int64_t sourceModificationTime_;
+            /** The FNV-1a hash of the source file. */
+            std::uint64_t sourceHash_;
+            /** The size of a single vertex. */
+            std::uint32_t vertexStride_;
+            /** The number of vertices. */
+            std::uint32_t numVertices_;
+            /** The number of indices. */
+            std::uint32_t numIndices_;
+            /** Padding, keeps the header 8 byte aligned. */
+            std::uint32_t padding_;
+        };
+
+        /** The size and modification time of a file. */
+        struct SourceInfo
+        {
+            std::uint64_t size_ = 0;
+            std::int64_t modificationTime_ = 0;
+        };
+
+        bool GetSourceInfo(const std::string& filename, SourceInfo& info)
+        {
+#ifdef _WIN32
+            struct _stat64 fileStat;
+            if (_stat64(filename.c_str(), &fileStat) != 0) return false;
+#else
+            struct stat fileStat;
+            if (stat(filename.c_str(), &fileStat) != 0) return false;
+#endif
+            info.size_ = static_cast<std::uint64_t>(fileStat.st_size);
+            info.modificationTime_ = static_cast<std::int64_t>(fileStat.st_mtime);
+            return true;
+        }
+
+        std::uint64_t HashFile(const std::string& filename)
+        {
+            MemoryMappedFile file{ filename };
+            return HashFNV1a(file.GetData(), file.GetSize());
+        }
+
+        std::uint64_t GetIndexOffset(std::uint64_t numVertices, std::uint32_t vertexStride)
+        {
+            return (sizeof(MeshCacheHeader) + numVertices * vertexStride + 3) & ~std::uint64_t{ 3 };
+        }
+    }
+
+    /**
+     *  Creates the cache of a mesh, the cache file is the source file name with ".vmc" appended.
+     *  @param sourceFilename the name of the mesh source file.
+     *  @param vertexStride the size of the interleaved vertices.
+     */
+    MeshCache::MeshCache(const std::string& sourceFilename, std::uint32_t vertexStride) :
+        sourceFilename_{ sourceFilename },
+        cacheFilename_{ sourceFilename + ".vmc" },
+        vertexStride_{ vertexStride }
+    {
+    }
+
+    /**
+     *  Maps the cache file if it matches the source and the vertex layout.
+     *  @return whether a valid cache was loaded.
+     */
+    bool MeshCache::Load()
+    {
+        SourceInfo source;
+        if (!GetSourceInfo(sourceFilename_, source)) return false;
+
+        MemoryMappedFile file;
+        try {
+            file = MemoryMappedFile{ cacheFilename_ };
+        }
+        catch (const std::runtime_error&) {
+            return false;
+        }
+        if (file.GetSize() < sizeof(MeshCacheHeader)) return false;
+
+        MeshCacheHeader header;
+        std::memcpy(&header, file.GetData(), sizeof(MeshCacheHeader));
+        if (header.magic_ != MAGIC || header.version_ != VERSION || header.vertexStride_ != vertexStride_ || header.sourceSize_ != source.size_) return false;
+        auto indexOffset = GetIndexOffset(header.numVertices_, vertexStride_);
+        if (indexOffset + static_cast<std::uint64_t>(header.numIndices_) * sizeof(std::uint32_t) != file.GetSize()) return false;
+        // copies of the source get new modification times, the hash is only checked then.
+        if (header.sourceModificationTime_ != source.modificationTime_) {
+            try {
+                if (header.sourceHash_ != HashFile(sourceFilename_)) return false;
+            }
+            catch (const std::runtime_error&) {
+                return false;
+            }
+        }
+
+        // the indices go to the GPU unchecked, so a damaged cache must not reference vertices outside the buffer.
+        auto indices = reinterpret_cast<const std::uint32_t*>(file.GetData() + indexOffset);
+        for (std::size_t i = 0; i < header.numIndices_; ++i) {
+            if (indices[i] >= header.numVertices_) return false;
+        }
+
+        file.Prefetch(0, file.GetSize());
+        cacheFile_ = std::move(file);
+        vertexOffset_ = sizeof(MeshCacheHeader);
+        numVertices_ = header.numVertices_;
+        indexOffset_ = static_cast<std::size_t>(indexOffset);
+        numIndices_ = header.numIndices_;
+        return true;
+    }
+
+    /**
+     *  Writes the buffers of the mesh to the cache file. The file is written under a temporary name and renamed,
+     *  so nodes sharing a directory never see a partially written cache.
+     *  @param vertices the interleaved vertices.
+     *  @param numVertices the number of vertices.
+     *  @param indices the indices.
+     *  @param numIndices the number of indices.
+     */
+    void MeshCache::Store(const void* vertices, std::size_t numVertices, const std::uint32_t* indices, std::size_t numIndices)
+    {
+        SourceInfo source;
+        if (!GetSourceInfo(sourceFilename_, source)) throw std::runtime_error("Could not read mesh file \"" + sourceFilename_ + "\".");
+
+        MeshCacheHeader header;
+        header.magic_ = MAGIC;
+        header.version_ = VERSION;
+        header.sourceSize_ = source.size_;
+        header.sourceModificationTime_ = source.modificationTime_;
+        header.sourceHash_ = HashFile(sourceFilename_);
+        header.vertexStride_ = vertexStride_;
+        header.numVertices_ = static_cast<std::uint32_t>(numVertices);
+        header.numIndices_ = static_cast<std::uint32_t>(numIndices);
+        header.padding_ = 0;
+
+        auto tempFilename = cacheFilename_ + "." + std::to_string(std::random_device{}()) + ".tmp";
+        {
+            std::ofstream out{ tempFilename, std::ios::binary };
+            if (!out) throw std::runtime_error("Could not create file \"" + tempFilename + "\".");
+            out.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+            out.write(static_cast<const char*>(vertices), static_cast<std::streamsize>(numVertices * vertexStride_));
+            const char padding[4] = {};
+            out.write(padding, static_cast<std::streamsize>(GetIndexOffset(numVertices, vertexStride_) - sizeof(MeshCacheHeader) - numVertices * vertexStride_));
+            out.write(reinterpret_cast<const char*>(indices), static_cast<std::streamsize>(numIndices * sizeof(std::uint32_t)));
+            if (!out) {
+                out.close();
+                std::remove(tempFilename.c_str());
+                throw std::runtime_error("Could not write file \"" + tempFilename + "\".");
+            }
+        }
+
+        // renaming does not replace existing files on Windows.
+        if (std::rename(tempFilename.c_str(), cacheFilename_.c_str()) != 0) {
+            std::remove(cacheFilename_.c_str());
+            if (std::rename(tempFilename.c_str(), cacheFilename_.c_str()) != 0) {
+                std::remove(tempFilename.c_str());
+                throw std::runtime_error("Could not replace file \"" + cacheFilename_ + "\".");
+            }
+        }
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file   MeshCache.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the binary cache of interleaved mesh buffers.
+ */
+
+#pragma once
+
+#include "pointcloud/MemoryMappedFile.h"
+
+#include <cstdint>
+#include <string>
+
+namespace viscom {
+
+    /**
+     *  Stores the final interleaved vertex and index buffers of a mesh in a binary file next to its source, so later
+     *  starts map them directly into the GPU buffers instead of parsing the source again. The cache is keyed by the
+     *  size, modification time and content hash of the source: it is used as is if size and modification time
+     *  match, and after the source was copied (e.g. deployed to the cluster nodes) if its content hash matches.
+     */
+    class MeshCache
+    {
+    public:
+        /** The magic number at the start of cache files ("VMSH"). */
+        static constexpr std::uint32_t MAGIC = 0x48534D56;
+        /** The version of the cache format, caches of other versions are rebuilt. */
+        static constexpr std::uint32_t VERSION = 1;
+
+        MeshCache(const std::string& sourceFilename, std::uint32_t vertexStride);
+
+        bool Load();
+        void Store(const void* vertices, std::size_t numVertices, const std::uint32_t* indices, std::size_t numIndices);
+
+        /** Returns the name of the cache file. */
+        const std::string& GetCacheFilename() const { return cacheFilename_; }
+        /** Returns whether a valid cache is loaded. */
+        bool IsLoaded() const { return cacheFile_.IsOpen(); }
+        /** Returns the interleaved vertices of the loaded cache. */
+        const void* GetVertexData() const { return cacheFile_.GetData() + vertexOffset_; }
+        /** Returns the number of vertices of the loaded cache. */
+        std::size_t GetNumVertices() const { return numVertices_; }
+        /** Returns the indices of the loaded cache. */
+        const std::uint32_t* GetIndexData() const { return reinterpret_cast<const std::uint32_t*>(cacheFile_.GetData() + indexOffset_); }
+        /** Returns the number of indices of the loaded cache. */
+        std::size_t GetNumIndices() const { return numIndices_; }
+
+    private:
+        /** Holds the name of the mesh source file. */
+        std::string sourceFilename_;
+        /** Holds the name of the cache file. */
+        std::string cacheFilename_;
+        /** Holds the size of a single vertex, caches with other vertex layouts are rebuilt. */
+        std::uint32_t vertexStride_;
+        /** Holds the mapped cache file. */
+        MemoryMappedFile cacheFile_;
+        /** Holds the offset of the vertices in the cache file. */
+        std::size_t vertexOffset_ = 0;
+        /** Holds the number of vertices. */
+        std::size_t numVertices_ = 0;
+        /** Holds the offset of the indices in the cache file. */
+        std::size_t indexOffset_ = 0;
+        /** Holds the number of indices. */
+        std::size_t numIndices_ = 0;
+    };
+}
@@ -0,0 +1,1135 @@
+/**
+ * @file   PointCloudRenderer.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the renderer for out-of-core point clouds.
+ */
+
+#include "PointCloudRenderer.h"
+
+#include "core/ApplicationNodeBase.h"
+#include <glbinding/gl/gl.h>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Vertices.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace viscom {
+
+    namespace {
+        /** The binding point of the storage buffer with the node transformations. */
+        constexpr GLuint NODE_TRANSFORM_BINDING = 0;
+
+        /**
+         *  Checks if a predicted view projection matrix matches the actual one up to rounding. Columns are compared
+         *  separately, so large translations do not hide differences in the projection.
+         */
+        bool IsSameViewProjection(const glm::mat4& predicted, const glm::mat4& actual)
+        {
+            for (auto c = 0; c < 4; ++c) {
+                auto maxDifference = 0.0f;
+                auto maxValue = 0.0f;
+                for (auto r = 0; r < 4; ++r) {
+                    maxDifference = std::max(maxDifference, std::abs(predicted[c][r] - actual[c][r]));
+                    maxValue = std::max(maxValue, std::abs(actual[c][r]));
+                }
+                if (maxDifference > 1e-4f * maxValue + 1e-6f) return false;
+            }
+            return true;
+        }
+
+        /** Returns the attribute shown by a color mode. */
+        PointAttribute GetColorAttribute(PointCloudColorMode colorMode)
+        {
+            switch (colorMode) {
+            case PointCloudColorMode::Intensity: return PointAttribute::Intensity;
+            case PointCloudColorMode::Classification: return PointAttribute::Classification;
+            case PointCloudColorMode::ReturnNumber: return PointAttribute::ReturnNumber;
+            case PointCloudColorMode::GPSTime: return PointAttribute::GPSTime;
+            default: return PointAttribute::Color;
+            }
+        }
+    }
+
+    static_assert(sizeof(PointVertex) == sizeof(PointCloudPoint), "Point vertices need to match the file layout.");
+    static_assert(sizeof(CompactPointVertex) == sizeof(PointCloudCompactPoint), "Compact point vertices need to match the file layout.");
+
+    /**
+     *  Opens a point cloud file.
+     *  @param filename the name of the point cloud file.
+     *  @param program the shader program used for drawing, it has to outlive the renderer.
+     *  @param indirectProgram the shader program used for indirect draw calls or 0 if they are not supported (needs
+     *      OpenGL 4.3), it has to outlive the renderer.
+     *  @param numLoaderThreads the number of threads loading nodes in the background.
+     */
+    PointCloudRenderer::PointCloudRenderer(const std::string& filename, GLuint program, GLuint indirectProgram, unsigned numLoaderThreads) :
+        file_{ filename },
+        program_{ program },
+        indirectProgram_{ indirectProgram },
+        gpuNodes_(file_.GetNumNodes()),
+        loader_{ file_, numLoaderThreads },
+        requestedFrame_(file_.GetNumNodes(), 0),
+        drawnInCall_(file_.GetNumNodes(), 0)
+    {
+        viewProjectionLoc_ = gl::glGetUniformLocation(program_, "viewProjectionMatrix");
+        pointSizeLoc_ = gl::glGetUniformLocation(program_, "pointSize");
+        nodeBoundsMinLoc_ = gl::glGetUniformLocation(program_, "nodeBoundsMin");
+        nodeBoundsExtentLoc_ = gl::glGetUniformLocation(program_, "nodeBoundsExtent");
+        positionLoc_ = gl::glGetAttribLocation(program_, "position");
+        colorLoc_ = gl::glGetAttribLocation(program_, "color");
+        colorModeLoc_ = gl::glGetUniformLocation(program_, "colorMode");
+        attributeRangeLoc_ = gl::glGetUniformLocation(program_, "attributeRange");
+        culler_.SetNodes(file_.GetNodes(), file_.GetNumNodes());
+
+        if (indirectProgram_ != 0) {
+            indirectViewProjectionLoc_ = gl::glGetUniformLocation(indirectProgram_, "viewProjectionMatrix");
+            indirectPointSizeLoc_ = gl::glGetUniformLocation(indirectProgram_, "pointSize");
+            drawIndexLoc_ = gl::glGetAttribLocation(indirectProgram_, "drawIndex");
+            indirectColorModeLoc_ = gl::glGetUniformLocation(indirectProgram_, "colorMode");
+            indirectAttributeRangeLoc_ = gl::glGetUniformLocation(indirectProgram_, "attributeRange");
+            // both programs use the vertex arrays of the shared buffers.
+            if (gl::glGetAttribLocation(indirectProgram_, "position") != positionLoc_ || gl::glGetAttribLocation(indirectProgram_, "color") != colorLoc_
+                || drawIndexLoc_ < 0) {
+                LOG(WARNING) << "The attributes of the indirect point cloud program do not match, indirect draw calls are disabled.";
+                indirectProgram_ = 0;
+            }
+        }
+        if (indirectProgram_ != 0) {
+            // a view draws each node at most once, so the draw indices never exceed the number of nodes.
+            std::vector<GLuint> drawIndices(file_.GetNumNodes());
+            std::iota(drawIndices.begin(), drawIndices.end(), 0);
+            gl::glGenBuffers(1, &drawIndexBuffer_);
+            gl::glBindBuffer(gl::GL_ARRAY_BUFFER, drawIndexBuffer_);
+            gl::glBufferData(gl::GL_ARRAY_BUFFER, drawIndices.size() * sizeof(GLuint), drawIndices.data(), gl::GL_STATIC_DRAW);
+            gl::glBindBuffer(gl::GL_ARRAY_BUFFER, 0);
+            gl::glGenBuffers(1, &commandBuffer_);
+            gl::glGenBuffers(1, &transformBuffer_);
+            submission_ = PointCloudSubmission::Indirect;
+        }
+
+        LOG(INFO) << "Opened point cloud \"" << filename << "\" (" << file_.GetHeader().numPoints_ << " points, "
+            << file_.GetNumNodes() << " nodes).";
+    }
+
+    PointCloudRenderer::~PointCloudRenderer()
+    {
+        for (auto& arena : arenas_) {
+            if (arena.vao_ != 0) gl::glDeleteVertexArrays(1, &arena.vao_);
+            if (arena.vbo_ != 0) gl::glDeleteBuffers(1, &arena.vbo_);
+            if (arena.attributeVbo_ != 0) gl::glDeleteBuffers(1, &arena.attributeVbo_);
+        }
+        if (drawIndexBuffer_ != 0) gl::glDeleteBuffers(1, &drawIndexBuffer_);
+        if (commandBuffer_ != 0) gl::glDeleteBuffers(1, &commandBuffer_);
+        if (transformBuffer_ != 0) gl::glDeleteBuffers(1, &transformBuffer_);
+        if (softwareColorTexture_ != 0) gl::glDeleteTextures(1, &softwareColorTexture_);
+        if (softwareDepthTexture_ != 0) gl::glDeleteTextures(1, &softwareDepthTexture_);
+        if (fullScreenVAO_ != 0) gl::glDeleteVertexArrays(1, &fullScreenVAO_);
+        DeleteRefinementTargets();
+        DeleteOcclusionViews();
+    }
+
+    /**
+     *  Starts a new frame, the upload budget is shared by all draw calls of a frame.
+     */
+    void PointCloudRenderer::BeginFrame()
+    {
+        ++frame_;
+        requests_.clear();
+        missingChunks_.clear();
+        previousViews_.swap(currentViews_);
+        currentViews_.clear();
+        numTraversalsLastFrame_ = numTraversals_;
+        numTraversals_ = 0;
+        clusterViewProjections_.clear();
+        clusterViewportHeights_.clear();
+
+        // rounding changes the relative views a little every frame, they are only replaced by real changes.
+        auto viewsChanged = previousViews_.size() != cameraRelativeViews_.size();
+        for (std::size_t i = 0; i < previousViews_.size() && !viewsChanged; ++i) {
+            viewsChanged = previousViews_[i].viewportHeight_ != cameraRelativeViews_[i].viewportHeight_
+                || !IsSameViewProjection(cameraRelativeViews_[i].viewProjection_, previousViews_[i].relativeToCamera_);
+        }
+        if (viewsChanged) {
+            cameraRelativeViews_.clear();
+            for (const auto& view : previousViews_) cameraRelativeViews_.push_back(ClusterView{ view.relativeToCamera_, view.viewportHeight_ });
+            ++cameraRelativeViewsVersion_;
+        }
+        streamingStatistics_.uploadedBytes_ = 0;
+        streamingStatistics_.numMissingNodes_ = 0;
+        numDrawnPoints_ = 0;
+        numDrawnNodes_ = 0;
+        numDrawCalls_ = 0;
+        occlusionStatistics_ = OcclusionStatistics{};
+        ++numStaticFrames_;
+    }
+
+    /**
+     *  Sets the way draw calls are submitted, indirect draw calls fall back to a call per node if not supported.
+     *  @param submission the way draw calls are submitted.
+     */
+    void PointCloudRenderer::SetSubmission(PointCloudSubmission submission)
+    {
+        submission_ = submission == PointCloudSubmission::Indirect && !IsIndirectSupported() ? PointCloudSubmission::PerNode : submission;
+    }
+
+    /**
+     *  Enables or disables the progressive refinement of still views. It needs the composite program, without it
+     *  the refinement stays disabled.
+     *  @param progressive whether still views are refined progressively.
+     */
+    void PointCloudRenderer::SetProgressive(bool progressive)
+    {
+        progressive_ = progressive && compositeProgram_ != 0;
+        numStaticFrames_ = 0;
+        if (!progressive_) DeleteRefinementTargets();
+    }
+
+    /**
+     *  Enables or disables the occlusion culling. It needs the depth reduce program, without it the culling stays
+     *  disabled.
+     *  @param occlusionCulling whether nodes hidden behind the depths of earlier frames are skipped.
+     */
+    void PointCloudRenderer::SetOcclusionCulling(bool occlusionCulling)
+    {
+        occlusionCulling_ = occlusionCulling && depthReduceProgram_ != 0;
+        if (!occlusionCulling_) DeleteOcclusionViews();
+    }
+
+    /**
+     *  Checks if the points can be colored by an attribute, i.e., if the file stores it in its own column.
+     *  @param colorMode the color mode.
+     */
+    bool PointCloudRenderer::IsColorModeAvailable(PointCloudColorMode colorMode) const
+    {
+        return colorMode == PointCloudColorMode::RGB || (file_.IsColumnar() && file_.HasAttribute(GetColorAttribute(colorMode)));
+    }
+
+    /**
+     *  Sets the attribute the points are colored by, modes not available for the file are ignored. The positions
+     *  stay on the GPU, the resident nodes are drawn again once the column of the new attribute is uploaded.
+     *  @param colorMode the color mode.
+     */
+    void PointCloudRenderer::SetColorMode(PointCloudColorMode colorMode)
+    {
+        if (colorMode == colorMode_ || !IsColorModeAvailable(colorMode)) return;
+        colorMode_ = colorMode;
+        ++colorVersion_;
+        for (const auto& arena : arenas_) {
+            if (arena.vao_ != 0) SetColorAttribute(arena);
+        }
+        gl::glBindVertexArray(0);
+        gl::glBindBuffer(gl::GL_ARRAY_BUFFER, 0);
+
+        streamingStatistics_.residentBytes_ = 0;
+        for (auto nodeIndex : lru_) streamingStatistics_.residentBytes_ += GetResidentSize(nodeIndex);
+        ResetRefinement();
+    }
+
+    /**
+     *  Checks if the images of all views contain all nodes of their selections without point budget, the views are
+     *  then only composited until the image changes.
+     *  @return whether the refinement is complete.
+     */
+    bool PointCloudRenderer::IsRefinementComplete() const
+    {
+        if (!IsRefining() || refinementTargets_.empty()) return false;
+        for (const auto& target : refinementTargets_) {
+            if (!target.selected_ || target.firstPending_ < target.nodes_.size()) return false;
+        }
+        return true;
+    }
+
+    /**
+     *  Returns the part of the selections without point budget already in the images of the views.
+     *  @return the progress between 0 and 1.
+     */
+    float PointCloudRenderer::GetRefinementProgress() const
+    {
+        if (!IsRefining()) return 0.0f;
+        std::size_t numNodes = 0, numDrawnNodes = 0;
+        for (const auto& target : refinementTargets_) {
+            if (!target.selected_) return 0.0f;
+            numNodes += target.nodes_.size();
+            numDrawnNodes += target.firstPending_;
+        }
+        return numNodes == 0 ? 1.0f : static_cast<float>(numDrawnNodes) / static_cast<float>(numNodes);
+    }
+
+    /**
+     *  Sets the camera and the views of all cluster nodes for the current frame. The views of all nodes are used
+     *  for the shared selection, so every node selects the same nodes from the same state.
+     *  @param cameraView the view matrix of the camera.
+     *  @param clusterViews the views of all cluster nodes relative to the camera.
+     */
+    void PointCloudRenderer::SetClusterViews(const glm::mat4& cameraView, const std::vector<ClusterView>& clusterViews)
+    {
+        inverseCameraView_ = glm::inverse(glm::dmat4(cameraView));
+        clusterViewProjections_.clear();
+        clusterViewportHeights_.clear();
+        for (std::size_t i = 0; i < clusterViews.size() && i < FrustumCuller::MAX_FRUSTA; ++i) {
+            clusterViewProjections_.push_back(clusterViews[i].viewProjection_ * cameraView);
+            clusterViewportHeights_.push_back(clusterViews[i].viewportHeight_);
+        }
+    }
+
+    /**
+     *  Returns the number of bytes a resident node uses on the GPU, for columnar files its positions and the column
+     *  of the current color mode.
+     *  @param nodeIndex the index of the node.
+     */
+    std::uint64_t PointCloudRenderer::GetResidentSize(std::uint32_t nodeIndex) const
+    {
+        if (!file_.IsColumnar()) return file_.GetNodeDataSize(nodeIndex);
+        return file_.GetColumnSize(nodeIndex, PointAttribute::Position) + file_.GetColumnSize(nodeIndex, GetColorAttribute(colorMode_));
+    }
+
+    /**
+     *  Returns the number of bytes uploaded for a node, resident nodes of columnar files only need the column of the
+     *  current color mode.
+     *  @param nodeIndex the index of the node.
+     */
+    std::uint64_t PointCloudRenderer::GetUploadSize(std::uint32_t nodeIndex) const
+    {
+        if (gpuNodes_[nodeIndex].arena_ == NO_ARENA) return GetResidentSize(nodeIndex);
+        return file_.GetColumnSize(nodeIndex, GetColorAttribute(colorMode_));
+    }
+
+    /**
+     *  Returns the columns the loader reads for a node before its upload (0 for the whole chunk of interleaved files).
+     *  @param nodeIndex the index of the node.
+     */
+    std::uint32_t PointCloudRenderer::GetLoadColumns(std::uint32_t nodeIndex) const
+    {
+        if (!file_.IsColumnar()) return 0;
+        auto columns = GetAttributeBit(GetColorAttribute(colorMode_));
+        if (gpuNodes_[nodeIndex].arena_ == NO_ARENA) columns |= GetAttributeBit(PointAttribute::Position);
+        return columns;
+    }
+
+    /**
+     *  Uploads a loaded node. For columnar files only the positions and the column of the current color mode are
+     *  uploaded, a resident node whose column is outdated only gets the new column.
+     *  @param nodeIndex the index of the node.
+     */
+    void PointCloudRenderer::UploadNode(std::uint32_t nodeIndex)
+    {
+        auto& gpuNode = gpuNodes_[nodeIndex];
+        auto uploadSize = GetUploadSize(nodeIndex);
+        if (gpuNode.arena_ == NO_ARENA) {
+            auto dataSize = file_.IsColumnar() ? file_.GetColumnSize(nodeIndex, PointAttribute::Position) : file_.GetNodeDataSize(nodeIndex);
+
+            // nodes go to the first shared buffer with enough space, so few buffers (and draw calls) hold all nodes.
+            std::uint64_t offset = 0;
+            auto arenaIndex = NO_ARENA;
+            for (std::uint32_t i = 0; i < arenas_.size() && arenaIndex == NO_ARENA; ++i) {
+                if (arenas_[i].vbo_ != 0 && arenas_[i].allocator_.Allocate(dataSize, offset)) arenaIndex = i;
+            }
+            if (arenaIndex == NO_ARENA) {
+                arenaIndex = CreateArena(std::max<std::uint64_t>(dataSize, streamingParameters_.arenaSize_));
+                arenas_[arenaIndex].allocator_.Allocate(dataSize, offset);
+            }
+            auto& arena = arenas_[arenaIndex];
+            ++arena.numNodes_;
+            gpuNode.arena_ = arenaIndex;
+            gpuNode.offset_ = offset;
+
+            // the loader paged the mapped chunk in, so it is the source of the upload without a copy in between.
+            auto data = file_.IsColumnar() ? file_.GetColumnData(nodeIndex, PointAttribute::Position) : file_.GetNodeData(nodeIndex);
+            gl::glBindBuffer(gl::GL_ARRAY_BUFFER, arena.vbo_);
+            gl::glBufferSubData(gl::GL_ARRAY_BUFFER, static_cast<gl::GLintptr>(offset), static_cast<gl::GLsizeiptr>(dataSize), data);
+
+            lru_.push_front(nodeIndex);
+            gpuNode.lruPosition_ = lru_.begin();
+            numResidentPoints_ += file_.GetNode(nodeIndex).numPoints_;
+            streamingStatistics_.residentBytes_ += GetResidentSize(nodeIndex);
+        }
+        if (file_.IsColumnar()) {
+            // the columns are stored at the same vertex index as the positions.
+            auto attribute = GetColorAttribute(colorMode_);
+            auto offset = gpuNode.offset_ / GetVertexStride() * GetPointAttributeSize(attribute);
+            gl::glBindBuffer(gl::GL_ARRAY_BUFFER, arenas_[gpuNode.arena_].attributeVbo_);
+            gl::glBufferSubData(gl::GL_ARRAY_BUFFER, static_cast<gl::GLintptr>(offset), static_cast<gl::GLsizeiptr>(file_.GetColumnSize(nodeIndex, attribute)),
+                file_.GetColumnData(nodeIndex, attribute));
+            streamingStatistics_.skippedBytes_ += static_cast<std::uint64_t>(file_.GetNode(nodeIndex).numPoints_) * file_.GetPointStride() - uploadSize;
+        }
+        gl::glBindBuffer(gl::GL_ARRAY_BUFFER, 0);
+
+        gpuNode.colorVersion_ = colorVersion_;
+        gpuNode.lastUsedFrame_ = frame_;
+        loader_.Release(nodeIndex);
+        streamingStatistics_.uploadedBytes_ += uploadSize;
+    }
+
+    /**
+     *  Deletes the least recently used nodes until the memory limit is met. Nodes used in the current frame are kept.
+     */
+    void PointCloudRenderer::EvictNodes()
+    {
+        while (streamingStatistics_.residentBytes_ > streamingParameters_.memoryLimit_ && !lru_.empty()) {
+            auto nodeIndex = lru_.back();
+            auto& gpuNode = gpuNodes_[nodeIndex];
+            if (gpuNode.lastUsedFrame_ == frame_) break;
+
+            auto& arena = arenas_[gpuNode.arena_];
+            arena.allocator_.Free(gpuNode.offset_, file_.IsColumnar() ? file_.GetColumnSize(nodeIndex, PointAttribute::Position) : file_.GetNodeDataSize(nodeIndex));
+            // empty buffers are deleted, so the memory limit also bounds the size of the shared buffers.
+            if (--arena.numNodes_ == 0) {
+                gl::glDeleteVertexArrays(1, &arena.vao_);
+                gl::glDeleteBuffers(1, &arena.vbo_);
+                if (arena.attributeVbo_ != 0) gl::glDeleteBuffers(1, &arena.attributeVbo_);
+                arena.vao_ = 0;
+                arena.vbo_ = 0;
+                arena.attributeVbo_ = 0;
+                streamingStatistics_.allocatedBytes_ -= arena.allocator_.GetSize() + arena.attributeBufferSize_;
+            }
+            streamingStatistics_.residentBytes_ -= GetResidentSize(nodeIndex);
+            gpuNode.arena_ = NO_ARENA;
+            lru_.pop_back();
+
+            numResidentPoints_ -= file_.GetNode(nodeIndex).numPoints_;
+            ++streamingStatistics_.numEvictedNodes_;
+        }
+    }
+
+    /**
+     *  Creates a shared vertex buffer, reusing the slot of a deleted one.
+     *  @param size the size of the buffer in bytes.
+     *  @return the index of the buffer.
+     */
+    std::uint32_t PointCloudRenderer::CreateArena(std::uint64_t size)
+    {
+        std::uint32_t arenaIndex = 0;
+        while (arenaIndex < arenas_.size() && arenas_[arenaIndex].vbo_ != 0) ++arenaIndex;
+        if (arenaIndex == arenas_.size()) arenas_.emplace_back();
+
+        auto& arena = arenas_[arenaIndex];
+        arena.allocator_ = RangeAllocator{ size };
+        arena.numNodes_ = 0;
+        arena.attributeBufferSize_ = 0;
+        gl::glGenBuffers(1, &arena.vbo_);
+        gl::glBindBuffer(gl::GL_ARRAY_BUFFER, arena.vbo_);
+        gl::glBufferData(gl::GL_ARRAY_BUFFER, static_cast<gl::GLsizeiptr>(size), nullptr, gl::GL_DYNAMIC_DRAW);
+
+        gl::glGenVertexArrays(1, &arena.vao_);
+        gl::glBindVertexArray(arena.vao_);
+        if (file_.IsColumnar()) {
+            // the attribute buffer holds the largest column of each position, so switching the color mode needs no reallocation.
+            ColumnarPointVertex::SetPositionAttribute(positionLoc_);
+            arena.attributeBufferSize_ = size / GetVertexStride() * std::max(GetPointAttributeSize(PointAttribute::Color), GetPointAttributeSize(PointAttribute::GPSTime));
+            gl::glGenBuffers(1, &arena.attributeVbo_);
+            gl::glBindBuffer(gl::GL_ARRAY_BUFFER, arena.attributeVbo_);
+            gl::glBufferData(gl::GL_ARRAY_BUFFER, static_cast<gl::GLsizeiptr>(arena.attributeBufferSize_), nullptr, gl::GL_DYNAMIC_DRAW);
+            SetColorAttribute(arena);
+        }
+        else if (IsQuantized()) CompactPointVertex::SetVertexAttributes(positionLoc_, colorLoc_);
+        else PointVertex::SetVertexAttributes(positionLoc_, colorLoc_);
+        if (IsIndirectSupported()) {
+            // per instance attributes start at the base instance, which is the index of the draw command.
+            gl::glBindBuffer(gl::GL_ARRAY_BUFFER, drawIndexBuffer_);
+            gl::glEnableVertexAttribArray(drawIndexLoc_);
+            gl::glVertexAttribIPointer(drawIndexLoc_, 1, gl::GL_UNSIGNED_INT, 0, nullptr);
+            gl::glVertexAttribDivisor(drawIndexLoc_, 1);
+        }
+        gl::glBindVertexArray(0);
+        gl::glBindBuffer(gl::GL_ARRAY_BUFFER, 0);
+
+        streamingStatistics_.allocatedBytes_ += size + arena.attributeBufferSize_;
+        return arenaIndex;
+    }
+
+    /**
+     *  Points the color attribute of a shared buffers vertex array to its attribute buffer, in the format of the
+     *  column of the current color mode. Leaves the vertex array and the attribute buffer bound.
+     *  @param arena the shared vertex buffer (of a columnar file).
+     */
+    void PointCloudRenderer::SetColorAttribute(const NodeArena& arena) const
+    {
+        gl::glBindVertexArray(arena.vao_);
+        gl::glBindBuffer(gl::GL_ARRAY_BUFFER, arena.attributeVbo_);
+        switch (colorMode_) {
+        case PointCloudColorMode::Intensity: ColumnarPointVertex::SetColorAttribute(colorLoc_, 1, gl::GL_UNSIGNED_SHORT, gl::GL_TRUE); break;
+        // classes and return numbers are looked up in a palette, so they are passed unnormalized.
+        case PointCloudColorMode::Classification:
+        case PointCloudColorMode::ReturnNumber: ColumnarPointVertex::SetColorAttribute(colorLoc_, 1, gl::GL_UNSIGNED_BYTE, gl::GL_FALSE); break;
+        case PointCloudColorMode::GPSTime: ColumnarPointVertex::SetColorAttribute(colorLoc_, 1, gl::GL_FLOAT, gl::GL_FALSE); break;
+        default: ColumnarPointVertex::SetColorAttribute(colorLoc_, 4, gl::GL_UNSIGNED_BYTE, gl::GL_TRUE); break;
+        }
+    }
+
+    /**
+     *  Returns the offset and scale mapping the scalar attribute of the color mode to [0, 1] in the shaders.
+     *  Intensities arrive normalized to the 16 bit range and are scaled to the largest intensity of the file.
+     */
+    glm::vec2 PointCloudRenderer::GetAttributeRange() const
+    {
+        const auto& header = file_.GetHeader();
+        if (colorMode_ == PointCloudColorMode::Intensity) return glm::vec2(0.0f, 65535.0f / static_cast<float>(std::max(header.maxIntensity_, 1U)));
+        if (colorMode_ == PointCloudColorMode::GPSTime) return glm::vec2(header.gpsTimeMin_, 1.0f / std::max(header.gpsTimeMax_ - header.gpsTimeMin_, 1e-6f));
+        return glm::vec2(0.0f, 1.0f);
+    }
+
+    /**
+     *  Adds a view to the views drawn in the current frame.
+     *  @param viewProjection the view projection matrix.
+     *  @param viewportHeight the height of the viewport in pixels.
+     *  @return the index of the view in the current frame.
+     */
+    std::size_t PointCloudRenderer::AddView(const glm::mat4& viewProjection, float viewportHeight)
+    {
+        auto viewIndex = currentViews_.size();
+        View view;
+        view.viewProjection_ = viewProjection;
+        view.viewportHeight_ = viewportHeight;
+        view.relativeToFirst_ = viewIndex == 0 ? glm::dmat4(1.0) : glm::dmat4(viewProjection) * glm::inverse(glm::dmat4(currentViews_[0].viewProjection_));
+        view.relativeToCamera_ = glm::mat4(glm::dmat4(viewProjection) * inverseCameraView_);
+        currentViews_.push_back(view);
+        return viewIndex;
+    }
+
+    /**
+     *  Selects the nodes for a view. The first view of a frame does a single traversal for all views, the other
+     *  views of the frame reuse it. With cluster views set, the traversal covers the views of all cluster nodes.
+     *  Otherwise the other views of this node are predicted: all views share the camera, so the transformation from
+     *  the first views clip space to another views clip space only depends on the projections and eye offsets and is
+     *  taken from the last frame. Views not covered by the shared selection (first frame, changed setup) get their
+     *  own traversal.
+     *  @param viewProjection the view projection matrix.
+     *  @param viewportHeight the height of the viewport in pixels.
+     *  @param lodParameters the parameters of the level of detail selection.
+     *  @return the selected nodes, parents are always selected before their children.
+     */
+    const std::vector<std::uint32_t>& PointCloudRenderer::SelectNodes(const glm::mat4& viewProjection, float viewportHeight, const LODTraversalParameters& lodParameters)
+    {
+        auto viewIndex = AddView(viewProjection, viewportHeight);
+        if (viewIndex == 0) {
+            if (!clusterViewProjections_.empty()) {
+                sharedViewProjections_ = clusterViewProjections_;
+                sharedViewportHeights_ = clusterViewportHeights_;
+            } else {
+                sharedViewProjections_.assign(1, viewProjection);
+                sharedViewportHeights_.assign(1, viewportHeight);
+                for (std::size_t v = 1; v < previousViews_.size() && v < FrustumCuller::MAX_FRUSTA; ++v) {
+                    sharedViewProjections_.push_back(glm::mat4(previousViews_[v].relativeToFirst_ * glm::dmat4(viewProjection)));
+                    sharedViewportHeights_.push_back(previousViews_[v].viewportHeight_);
+                }
+            }
+
+            sharedFrusta_.clear();
+            for (const auto& sharedViewProjection : sharedViewProjections_) sharedFrusta_.push_back(Frustum::FromMatrix(sharedViewProjection));
+            const auto& visibilityMasks = culler_.Cull(sharedFrusta_.data(), sharedFrusta_.size());
+
+            ++numTraversals_;
+            traversal_.Traverse(file_.GetNodes(), sharedViewProjections_.data(), sharedViewportHeights_.data(), sharedViewProjections_.size(),
+                visibilityMasks.data(), lodParameters);
+        }
+
+        for (const auto& sharedViewProjection : sharedViewProjections_) {
+            if (IsSameViewProjection(sharedViewProjection, viewProjection)) return traversal_.GetSelectedNodes();
+        }
+
+        ++numTraversals_;
+        return viewTraversal_.Traverse(file_.GetNodes(), viewProjection, viewportHeight, lodParameters);
+    }
+
+    /**
+     *  Selects the nodes for the current view and draws the ones on the GPU. With progressive refinement the nodes
+     *  are drawn into an image of the view that is kept while the camera does not move (see DrawProgressive). With
+     *  occlusion culling nodes behind the depths of an earlier frame are skipped and the depths of this frame are
+     *  read back for later ones.
+     *  @param viewProjection the view projection matrix.
+     *  @param lodParameters the parameters of the level of detail selection.
+     */
+    void PointCloudRenderer::Draw(const glm::mat4& viewProjection, const LODTraversalParameters& lodParameters)
+    {
+        GLint viewport[4];
+        gl::glGetIntegerv(gl::GL_VIEWPORT, viewport);
+        if (IsRefining() && viewport[2] > 0 && viewport[3] > 0) {
+            DrawProgressive(viewProjection, viewport, lodParameters);
+            return;
+        }
+
+        auto viewIndex = currentViews_.size();
+        const auto& selectedNodes = SelectNodes(viewProjection, static_cast<float>(viewport[3]), lodParameters);
+        auto occluders = PrepareOcclusion(viewIndex, viewProjection);
+        DrawNodes(selectedNodes, 0, viewProjection, nullptr, std::numeric_limits<std::uint64_t>::max(), occluders);
+        CaptureDepth(viewIndex, viewport, viewProjection);
+    }
+
+    /**
+     *  Draws selected nodes that are on the GPU. Missing nodes are uploaded if they are loaded and the upload budget
+     *  allows it, otherwise they are requested from the loader. A node is only drawn if its parent is, so while
+     *  children are loading their coarser ancestors fill the view. Nodes of the shared selection outside of this
+     *  view are skipped, as are nodes occluded by the depth pyramid.
+     *  @param nodes the selected nodes, parents before their children.
+     *  @param firstNode the index of the first selected node considered.
+     *  @param viewProjection the view projection matrix.
+     *  @param target the retained image the nodes are added to, nodes already in it are skipped (may be nullptr).
+     *  @param maxPoints the number of points after which no further nodes are drawn.
+     *  @param occluders the depths of an earlier frame reprojected to this view (may be nullptr).
+     */
+    void PointCloudRenderer::DrawNodes(const std::vector<std::uint32_t>& nodes, std::size_t firstNode, const glm::mat4& viewProjection,
+        RefinementTarget* target, std::uint64_t maxPoints, const DepthPyramid* occluders)
+    {
+        auto frustum = Frustum::FromMatrix(viewProjection);
+
+        ++drawCall_;
+        drawList_.clear();
+        std::uint64_t numPoints = 0;
+        for (auto i = firstNode; i < nodes.size() && numPoints < maxPoints; ++i) {
+            auto nodeIndex = nodes[i];
+            if (target != nullptr && target->drawn_[nodeIndex]) continue;
+            const auto& node = file_.GetNode(nodeIndex);
+            auto& gpuNode = gpuNodes_[nodeIndex];
+
+            // after a change of the color mode resident nodes of columnar files only need the column of the new attribute.
+            auto hasColumn = gpuNode.arena_ != NO_ARENA && gpuNode.colorVersion_ == colorVersion_;
+            if (!hasColumn && node.numPoints_ > 0) {
+                // at least one node is uploaded per frame, so large nodes do not starve.
+                auto uploadedBytes = streamingStatistics_.uploadedBytes_;
+                auto withinBudget = uploadedBytes == 0 || uploadedBytes + GetUploadSize(nodeIndex) <= streamingParameters_.uploadBudget_;
+                auto state = loader_.GetState(nodeIndex);
+                if (state == NodeLoader::State::Ready && withinBudget) UploadNode(nodeIndex);
+                else if (state != NodeLoader::State::Ready && requestedFrame_[nodeIndex] != frame_) {
+                    // selected nodes are ordered by importance, so earlier ones are loaded first.
+                    requestedFrame_[nodeIndex] = frame_;
+                    requests_.push_back(NodeLoadRequest{ static_cast<float>(nodes.size() - i), nodeIndex, GetLoadColumns(nodeIndex) });
+                }
+            }
+
+            if (frustum.IsOutside(node.boundsMin_, node.boundsMax_)) {
+                // children lie inside their parent, so they are outside as well.
+                if (target != nullptr) target->drawn_[nodeIndex] = true;
+                continue;
+            }
+            if (occluders != nullptr) {
+                // occluded nodes are still loaded above, they are needed as soon as they come into view again.
+                ++occlusionStatistics_.numTestedNodes_;
+                if (occluders->IsOccluded(node.boundsMin_, node.boundsMax_)) {
+                    ++occlusionStatistics_.numOccludedNodes_;
+                    occlusionStatistics_.numOccludedPoints_ += node.numPoints_;
+                    continue;
+                }
+            }
+            auto parentDrawn = node.parent_ == POINTCLOUD_NO_NODE || drawnInCall_[node.parent_] == drawCall_ || (target != nullptr && target->drawn_[node.parent_]);
+            auto resident = (gpuNode.arena_ != NO_ARENA && gpuNode.colorVersion_ == colorVersion_) || node.numPoints_ == 0;
+            if (!parentDrawn || !resident) {
+                ++streamingStatistics_.numMissingNodes_;
+                continue;
+            }
+
+            drawnInCall_[nodeIndex] = drawCall_;
+            if (target != nullptr) target->drawn_[nodeIndex] = true;
+            if (node.numPoints_ == 0) continue;
+            gpuNode.lastUsedFrame_ = frame_;
+            lru_.splice(lru_.begin(), lru_, gpuNode.lruPosition_);
+            drawList_.push_back(nodeIndex);
+            numPoints += node.numPoints_;
+        }
+        if (chunkReplica_ != nullptr) {
+            // nodes of a distributed file can only be loaded once their chunk is on disk.
+            auto chunkReplica = chunkReplica_;
+            auto missing = std::stable_partition(requests_.begin(), requests_.end(),
+                [chunkReplica](const NodeLoadRequest& request) { return chunkReplica->IsAvailable(request.nodeIndex_); });
+            missingChunks_.insert(missingChunks_.end(), missing, requests_.end());
+            requests_.erase(missing, requests_.end());
+            chunkReplica_->Request(missingChunks_);
+        }
+        loader_.Request(requests_);
+        EvictNodes();
+        numDrawnPoints_ += numPoints;
+        numDrawnNodes_ += drawList_.size();
+
+        gl::glEnable(gl::GL_PROGRAM_POINT_SIZE);
+        if (submission_ == PointCloudSubmission::Indirect) SubmitIndirect(viewProjection);
+        else SubmitPerNode(viewProjection);
+        gl::glBindVertexArray(0);
+        gl::glUseProgram(0);
+        gl::glDisable(gl::GL_PROGRAM_POINT_SIZE);
+    }
+
+    /**
+     *  Draws a view with progressive refinement. The first frame of a still camera draws the regular selection into
+     *  an image of the view that is kept, every following frame adds the next nodes of the selection without point
+     *  budget, at most a point budget per frame. Once all nodes are in the image nothing is drawn anymore. The image
+     *  is composited into the current framebuffer with depth in every frame.
+     *  @param viewProjection the view projection matrix.
+     *  @param viewport the viewport of the view.
+     *  @param lodParameters the parameters of the level of detail selection.
+     */
+    void PointCloudRenderer::DrawProgressive(const glm::mat4& viewProjection, const GLint* viewport, const LODTraversalParameters& lodParameters)
+    {
+        auto viewIndex = currentViews_.size();
+        if (refinementTargets_.size() <= viewIndex) refinementTargets_.resize(viewIndex + 1);
+        auto& target = refinementTargets_[viewIndex];
+        auto viewportHeight = static_cast<float>(viewport[3]);
+        // views may also change without the camera, e.g. with head tracking.
+        auto restart = numStaticFrames_ == 1 || target.width_ != viewport[2] || target.height_ != viewport[3]
+            || !IsSameViewProjection(target.viewProjection_, viewProjection);
+
+        if (!ResizeRefinementTarget(target, viewport[2], viewport[3])) {
+            LOG(WARNING) << "Could not create the framebuffer of the progressive refinement, it is disabled.";
+            SetProgressive(false);
+            DrawNodes(SelectNodes(viewProjection, viewportHeight, lodParameters), 0, viewProjection, nullptr, std::numeric_limits<std::uint64_t>::max());
+            return;
+        }
+
+        GLint drawFramebuffer = 0, readFramebuffer = 0;
+        gl::glGetIntegerv(gl::GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+        gl::glGetIntegerv(gl::GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+        auto scissorTest = gl::glIsEnabled(gl::GL_SCISSOR_TEST);
+        gl::glBindFramebuffer(gl::GL_FRAMEBUFFER, target.fbo_);
+        gl::glViewport(0, 0, target.width_, target.height_);
+        gl::glDisable(gl::GL_SCISSOR_TEST);
+
+        if (restart) {
+            target.viewProjection_ = viewProjection;
+            target.nodes_.clear();
+            target.selected_ = false;
+            target.drawn_.assign(file_.GetNumNodes(), false);
+            target.firstPending_ = 0;
+            gl::glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            gl::glClear(gl::GL_COLOR_BUFFER_BIT | gl::GL_DEPTH_BUFFER_BIT);
+            // the first image is the selection of a moving camera, so the view does not change when the camera stops.
+            DrawNodes(SelectNodes(viewProjection, viewportHeight, lodParameters), 0, viewProjection, &target, std::numeric_limits<std::uint64_t>::max());
+        } else {
+            AddView(viewProjection, viewportHeight);
+            if (!target.selected_) {
+                auto fullParameters = lodParameters;
+                fullParameters.pointBudget_ = std::numeric_limits<std::uint64_t>::max();
+                ++numTraversals_;
+                target.nodes_ = viewTraversal_.Traverse(file_.GetNodes(), viewProjection, viewportHeight, fullParameters);
+                target.selected_ = true;
+            }
+            if (target.firstPending_ < target.nodes_.size()) DrawNodes(target.nodes_, target.firstPending_, viewProjection, &target, lodParameters.pointBudget_);
+        }
+        while (target.firstPending_ < target.nodes_.size() && target.drawn_[target.nodes_[target.firstPending_]]) ++target.firstPending_;
+
+        gl::glBindFramebuffer(gl::GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(drawFramebuffer));
+        gl::glBindFramebuffer(gl::GL_READ_FRAMEBUFFER, static_cast<GLuint>(readFramebuffer));
+        gl::glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        if (scissorTest == gl::GL_TRUE) gl::glEnable(gl::GL_SCISSOR_TEST);
+        Composite(compositeProgram_, target.colorTexture_, target.depthTexture_);
+        // the depths are only needed once the camera moves again, the first image is as close as any later one.
+        if (restart) CaptureDepth(viewIndex, viewport, viewProjection);
+    }
+
+    /**
+     *  Creates the framebuffer of a retained image or resizes it to the viewport.
+     *  @param target the retained image.
+     *  @param width the width of the viewport.
+     *  @param height the height of the viewport.
+     *  @return whether the framebuffer is complete.
+     */
+    bool PointCloudRenderer::ResizeRefinementTarget(RefinementTarget& target, GLsizei width, GLsizei height)
+    {
+        if (target.fbo_ != 0 && target.width_ == width && target.height_ == height) return true;
+        target.width_ = width;
+        target.height_ = height;
+
+        auto createTexture = [width, height](GLuint& texture, gl::GLenum internalFormat, gl::GLenum format, gl::GLenum type) {
+            if (texture == 0) gl::glGenTextures(1, &texture);
+            gl::glBindTexture(gl::GL_TEXTURE_2D, texture);
+            gl::glTexImage2D(gl::GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), width, height, 0, format, type, nullptr);
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_MIN_FILTER, static_cast<GLint>(gl::GL_NEAREST));
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_MAG_FILTER, static_cast<GLint>(gl::GL_NEAREST));
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_WRAP_S, static_cast<GLint>(gl::GL_CLAMP_TO_EDGE));
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_WRAP_T, static_cast<GLint>(gl::GL_CLAMP_TO_EDGE));
+        };
+        createTexture(target.colorTexture_, gl::GL_RGBA8, gl::GL_RGBA, gl::GL_UNSIGNED_BYTE);
+        createTexture(target.depthTexture_, gl::GL_DEPTH_COMPONENT32F, gl::GL_DEPTH_COMPONENT, gl::GL_FLOAT);
+        gl::glBindTexture(gl::GL_TEXTURE_2D, 0);
+
+        GLint drawFramebuffer = 0;
+        gl::glGetIntegerv(gl::GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+        if (target.fbo_ == 0) gl::glGenFramebuffers(1, &target.fbo_);
+        gl::glBindFramebuffer(gl::GL_DRAW_FRAMEBUFFER, target.fbo_);
+        gl::glFramebufferTexture2D(gl::GL_DRAW_FRAMEBUFFER, gl::GL_COLOR_ATTACHMENT0, gl::GL_TEXTURE_2D, target.colorTexture_, 0);
+        gl::glFramebufferTexture2D(gl::GL_DRAW_FRAMEBUFFER, gl::GL_DEPTH_ATTACHMENT, gl::GL_TEXTURE_2D, target.depthTexture_, 0);
+        auto complete = gl::glCheckFramebufferStatus(gl::GL_DRAW_FRAMEBUFFER) == gl::GL_FRAMEBUFFER_COMPLETE;
+        gl::glBindFramebuffer(gl::GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(drawFramebuffer));
+        return complete;
+    }
+
+    /**
+     *  Deletes the retained images of all views.
+     */
+    void PointCloudRenderer::DeleteRefinementTargets()
+    {
+        for (auto& target : refinementTargets_) {
+            if (target.fbo_ != 0) gl::glDeleteFramebuffers(1, &target.fbo_);
+            if (target.colorTexture_ != 0) gl::glDeleteTextures(1, &target.colorTexture_);
+            if (target.depthTexture_ != 0) gl::glDeleteTextures(1, &target.depthTexture_);
+        }
+        refinementTargets_.clear();
+    }
+
+    /**
+     *  Builds the depth pyramid of a view from the latest depths read back. Finished read backs are only polled, the
+     *  depths are typically a few frames old and reprojected to the current view.
+     *  @param viewIndex the index of the view in the current frame.
+     *  @param viewProjection the view projection matrix.
+     *  @return the depth pyramid or nullptr if no depths are available yet.
+     */
+    const DepthPyramid* PointCloudRenderer::PrepareOcclusion(std::size_t viewIndex, const glm::mat4& viewProjection)
+    {
+        if (!occlusionCulling_ || viewIndex >= occlusionViews_.size()) return nullptr;
+        auto& view = occlusionViews_[viewIndex];
+
+        // read backs finish in order, starting with the oldest one, only the latest finished one is copied.
+        auto latest = NUM_DEPTH_READBACKS;
+        for (std::size_t i = 0; i < NUM_DEPTH_READBACKS; ++i) {
+            auto slot = (view.nextReadback_ + i) % NUM_DEPTH_READBACKS;
+            if (view.fences_[slot] == nullptr) continue;
+            auto status = gl::glClientWaitSync(view.fences_[slot], gl::GL_NONE_BIT, 0);
+            if (status != gl::GL_ALREADY_SIGNALED && status != gl::GL_CONDITION_SATISFIED) break;
+            gl::glDeleteSync(view.fences_[slot]);
+            view.fences_[slot] = nullptr;
+            latest = slot;
+        }
+        if (latest != NUM_DEPTH_READBACKS) {
+            auto numTexels = static_cast<std::size_t>(view.blockWidth_) * static_cast<std::size_t>(view.blockHeight_);
+            gl::glBindBuffer(gl::GL_PIXEL_PACK_BUFFER, view.pixelBuffers_[latest]);
+            auto data = static_cast<const float*>(gl::glMapBufferRange(gl::GL_PIXEL_PACK_BUFFER, 0, numTexels * sizeof(float), gl::GL_MAP_READ_BIT));
+            if (data != nullptr) {
+                view.depths_.assign(data, data + numTexels);
+                view.depthsViewProjection_ = view.readbackViewProjections_[latest];
+                gl::glUnmapBuffer(gl::GL_PIXEL_PACK_BUFFER);
+            }
+            gl::glBindBuffer(gl::GL_PIXEL_PACK_BUFFER, 0);
+        }
+        if (view.depths_.empty()) return nullptr;
+
+        view.pyramid_.Reproject(view.depths_.data(), static_cast<unsigned>(view.blockWidth_), static_cast<unsigned>(view.blockHeight_),
+            view.depthsViewProjection_, viewProjection);
+        return &view.pyramid_;
+    }
+
+    /**
+     *  Starts the read back of the depths of a view. The depth buffer is copied, reduced to the farthest depth of
+     *  each block of pixels and read into a pixel buffer without waiting; the fence tells when it arrived. If all
+     *  pixel buffers are still in flight the GPU is behind and the frame is skipped.
+     *  @param viewIndex the index of the view in the current frame.
+     *  @param viewport the viewport of the view.
+     *  @param viewProjection the view projection matrix the depths were drawn with.
+     */
+    void PointCloudRenderer::CaptureDepth(std::size_t viewIndex, const GLint* viewport, const glm::mat4& viewProjection)
+    {
+        if (!occlusionCulling_ || viewport[2] <= 0 || viewport[3] <= 0) return;
+
+        GLint sampleBuffers = 0;
+        gl::glGetIntegerv(gl::GL_SAMPLE_BUFFERS, &sampleBuffers);
+        if (sampleBuffers != 0) {
+            LOG(WARNING) << "Depths of multisampled framebuffers cannot be copied, occlusion culling is disabled.";
+            SetOcclusionCulling(false);
+            return;
+        }
+
+        if (occlusionViews_.size() <= viewIndex) occlusionViews_.resize(viewIndex + 1);
+        auto& view = occlusionViews_[viewIndex];
+        if (!ResizeOcclusionView(view, viewport[2], viewport[3])) {
+            LOG(WARNING) << "Could not create the framebuffer of the occlusion culling, it is disabled.";
+            SetOcclusionCulling(false);
+            return;
+        }
+        auto slot = view.nextReadback_;
+        if (view.fences_[slot] != nullptr) return;
+
+        GLint drawFramebuffer = 0, readFramebuffer = 0;
+        gl::glGetIntegerv(gl::GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+        gl::glGetIntegerv(gl::GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+        auto scissorTest = gl::glIsEnabled(gl::GL_SCISSOR_TEST);
+        auto blend = gl::glIsEnabled(gl::GL_BLEND);
+
+        gl::glActiveTexture(gl::GL_TEXTURE0);
+        gl::glBindTexture(gl::GL_TEXTURE_2D, view.depthTexture_);
+        gl::glCopyTexSubImage2D(gl::GL_TEXTURE_2D, 0, 0, 0, viewport[0], viewport[1], view.width_, view.height_);
+
+        if (fullScreenVAO_ == 0) gl::glGenVertexArrays(1, &fullScreenVAO_);
+        gl::glBindFramebuffer(gl::GL_FRAMEBUFFER, view.blockFBO_);
+        gl::glViewport(0, 0, view.blockWidth_, view.blockHeight_);
+        gl::glDisable(gl::GL_SCISSOR_TEST);
+        gl::glDisable(gl::GL_BLEND);
+        gl::glUseProgram(depthReduceProgram_);
+        gl::glUniform1i(gl::glGetUniformLocation(depthReduceProgram_, "depthTexture"), 0);
+        gl::glUniform1i(gl::glGetUniformLocation(depthReduceProgram_, "blockSize"), DEPTH_BLOCK_SIZE);
+        gl::glBindVertexArray(fullScreenVAO_);
+        gl::glDrawArrays(gl::GL_TRIANGLES, 0, 3);
+        gl::glBindVertexArray(0);
+        gl::glUseProgram(0);
+        gl::glBindTexture(gl::GL_TEXTURE_2D, 0);
+
+        gl::glPixelStorei(gl::GL_PACK_ALIGNMENT, 4);
+        gl::glBindBuffer(gl::GL_PIXEL_PACK_BUFFER, view.pixelBuffers_[slot]);
+        gl::glReadPixels(0, 0, view.blockWidth_, view.blockHeight_, gl::GL_RED, gl::GL_FLOAT, nullptr);
+        gl::glBindBuffer(gl::GL_PIXEL_PACK_BUFFER, 0);
+        view.fences_[slot] = gl::glFenceSync(gl::GL_SYNC_GPU_COMMANDS_COMPLETE, gl::GL_NONE_BIT);
+        view.readbackViewProjections_[slot] = viewProjection;
+        view.nextReadback_ = (slot + 1) % NUM_DEPTH_READBACKS;
+
+        gl::glBindFramebuffer(gl::GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(drawFramebuffer));
+        gl::glBindFramebuffer(gl::GL_READ_FRAMEBUFFER, static_cast<GLuint>(readFramebuffer));
+        gl::glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        if (scissorTest == gl::GL_TRUE) gl::glEnable(gl::GL_SCISSOR_TEST);
+        if (blend == gl::GL_TRUE) gl::glEnable(gl::GL_BLEND);
+    }
+
+    /**
+     *  Creates the textures, framebuffer and pixel buffers of the read back of a view or resizes them to the
+     *  viewport. Read backs still in flight are dropped.
+     *  @param view the read back depths of the view.
+     *  @param width the width of the viewport.
+     *  @param height the height of the viewport.
+     *  @return whether the framebuffer is complete.
+     */
+    bool PointCloudRenderer::ResizeOcclusionView(OcclusionView& view, GLsizei width, GLsizei height)
+    {
+        if (view.blockFBO_ != 0 && view.width_ == width && view.height_ == height) return true;
+        for (auto& fence : view.fences_) {
+            if (fence != nullptr) gl::glDeleteSync(fence);
+            fence = nullptr;
+        }
+        view.depths_.clear();
+        view.width_ = width;
+        view.height_ = height;
+        view.blockWidth_ = (width + DEPTH_BLOCK_SIZE - 1) / DEPTH_BLOCK_SIZE;
+        view.blockHeight_ = (height + DEPTH_BLOCK_SIZE - 1) / DEPTH_BLOCK_SIZE;
+
+        auto createTexture = [](GLuint& texture, GLsizei textureWidth, GLsizei textureHeight, gl::GLenum internalFormat, gl::GLenum format) {
+            if (texture == 0) gl::glGenTextures(1, &texture);
+            gl::glBindTexture(gl::GL_TEXTURE_2D, texture);
+            gl::glTexImage2D(gl::GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), textureWidth, textureHeight, 0, format, gl::GL_FLOAT, nullptr);
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_MIN_FILTER, static_cast<GLint>(gl::GL_NEAREST));
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_MAG_FILTER, static_cast<GLint>(gl::GL_NEAREST));
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_WRAP_S, static_cast<GLint>(gl::GL_CLAMP_TO_EDGE));
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_WRAP_T, static_cast<GLint>(gl::GL_CLAMP_TO_EDGE));
+        };
+        createTexture(view.depthTexture_, width, height, gl::GL_DEPTH_COMPONENT32F, gl::GL_DEPTH_COMPONENT);
+        createTexture(view.blockTexture_, view.blockWidth_, view.blockHeight_, gl::GL_R32F, gl::GL_RED);
+        gl::glBindTexture(gl::GL_TEXTURE_2D, 0);
+
+        if (view.pixelBuffers_[0] == 0) gl::glGenBuffers(static_cast<GLsizei>(NUM_DEPTH_READBACKS), view.pixelBuffers_.data());
+        for (auto pixelBuffer : view.pixelBuffers_) {
+            gl::glBindBuffer(gl::GL_PIXEL_PACK_BUFFER, pixelBuffer);
+            gl::glBufferData(gl::GL_PIXEL_PACK_BUFFER, static_cast<std::size_t>(view.blockWidth_) * static_cast<std::size_t>(view.blockHeight_) * sizeof(float),
+                nullptr, gl::GL_STREAM_READ);
+        }
+        gl::glBindBuffer(gl::GL_PIXEL_PACK_BUFFER, 0);
+
+        GLint drawFramebuffer = 0;
+        gl::glGetIntegerv(gl::GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+        if (view.blockFBO_ == 0) gl::glGenFramebuffers(1, &view.blockFBO_);
+        gl::glBindFramebuffer(gl::GL_DRAW_FRAMEBUFFER, view.blockFBO_);
+        gl::glFramebufferTexture2D(gl::GL_DRAW_FRAMEBUFFER, gl::GL_COLOR_ATTACHMENT0, gl::GL_TEXTURE_2D, view.blockTexture_, 0);
+        auto complete = gl::glCheckFramebufferStatus(gl::GL_DRAW_FRAMEBUFFER) == gl::GL_FRAMEBUFFER_COMPLETE;
+        gl::glBindFramebuffer(gl::GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(drawFramebuffer));
+        return complete;
+    }
+
+    /**
+     *  Deletes the read back depths of all views, read backs in flight are dropped.
+     */
+    void PointCloudRenderer::DeleteOcclusionViews()
+    {
+        for (auto& view : occlusionViews_) {
+            for (auto fence : view.fences_) if (fence != nullptr) gl::glDeleteSync(fence);
+            if (view.pixelBuffers_[0] != 0) gl::glDeleteBuffers(static_cast<GLsizei>(NUM_DEPTH_READBACKS), view.pixelBuffers_.data());
+            if (view.blockFBO_ != 0) gl::glDeleteFramebuffers(1, &view.blockFBO_);
+            if (view.depthTexture_ != 0) gl::glDeleteTextures(1, &view.depthTexture_);
+            if (view.blockTexture_ != 0) gl::glDeleteTextures(1, &view.blockTexture_);
+        }
+        occlusionViews_.clear();
+    }
+
+    /**
+     *  Draws the nodes of the draw list with a draw call per node.
+     *  @param viewProjection the view projection matrix.
+     */
+    void PointCloudRenderer::SubmitPerNode(const glm::mat4& viewProjection)
+    {
+        gl::glUseProgram(program_);
+        gl::glUniformMatrix4fv(viewProjectionLoc_, 1, gl::GL_FALSE, glm::value_ptr(viewProjection));
+        gl::glUniform1f(pointSizeLoc_, 1.0f);
+        gl::glUniform3f(nodeBoundsMinLoc_, 0.0f, 0.0f, 0.0f);
+        gl::glUniform3f(nodeBoundsExtentLoc_, 1.0f, 1.0f, 1.0f);
+        gl::glUniform1i(colorModeLoc_, static_cast<GLint>(colorMode_));
+        gl::glUniform2fv(attributeRangeLoc_, 1, glm::value_ptr(GetAttributeRange()));
+
+        auto stride = GetVertexStride();
+        auto boundArena = NO_ARENA;
+        for (auto nodeIndex : drawList_) {
+            const auto& node = file_.GetNode(nodeIndex);
+            const auto& gpuNode = gpuNodes_[nodeIndex];
+            if (IsQuantized()) {
+                auto extent = node.boundsMax_ - node.boundsMin_;
+                gl::glUniform3fv(nodeBoundsMinLoc_, 1, glm::value_ptr(node.boundsMin_));
+                gl::glUniform3fv(nodeBoundsExtentLoc_, 1, glm::value_ptr(extent));
+            }
+            if (gpuNode.arena_ != boundArena) {
+                gl::glBindVertexArray(arenas_[gpuNode.arena_].vao_);
+                boundArena = gpuNode.arena_;
+            }
+            gl::glDrawArrays(gl::GL_POINTS, static_cast<GLint>(gpuNode.offset_ / stride), static_cast<GLsizei>(node.numPoints_));
+            ++numDrawCalls_;
+        }
+    }
+
+    /**
+     *  Draws the nodes of the draw list with a glMultiDrawArraysIndirect per shared vertex buffer. The commands and
+     *  the node transformations are uploaded once per view, the base instance of each command selects its
+     *  transformation in the storage buffer.
+     *  @param viewProjection the view projection matrix.
+     */
+    void PointCloudRenderer::SubmitIndirect(const glm::mat4& viewProjection)
+    {
+        // the commands of a shared buffer have to be consecutive, the order of the nodes within a buffer is kept.
+        std::stable_sort(drawList_.begin(), drawList_.end(), [this](std::uint32_t a, std::uint32_t b) { return gpuNodes_[a].arena_ < gpuNodes_[b].arena_; });
+
+        auto stride = GetVertexStride();
+        drawCommands_.clear();
+        nodeTransforms_.clear();
+        arenaDraws_.clear();
+        for (auto nodeIndex : drawList_) {
+            const auto& node = file_.GetNode(nodeIndex);
+            const auto& gpuNode = gpuNodes_[nodeIndex];
+            if (arenaDraws_.empty() || arenaDraws_.back().arena_ != gpuNode.arena_) arenaDraws_.push_back(ArenaDraw{ gpuNode.arena_, drawCommands_.size(), 0 });
+            ++arenaDraws_.back().numCommands_;
+
+            auto drawIndex = static_cast<GLuint>(drawCommands_.size());
+            drawCommands_.push_back(DrawArraysIndirectCommand{ node.numPoints_, 1, static_cast<GLuint>(gpuNode.offset_ / stride), drawIndex });
+            // float positions are stored in world space, quantized ones relative to the node bounds.
+            if (IsQuantized()) nodeTransforms_.push_back(NodeTransform{ glm::vec4(node.boundsMin_, 0.0f), glm::vec4(node.boundsMax_ - node.boundsMin_, 0.0f) });
+            else nodeTransforms_.push_back(NodeTransform{ glm::vec4(0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 0.0f) });
+        }
+        if (drawCommands_.empty()) return;
+
+        // respecifying the buffers lets the driver keep the data of earlier views until they are drawn.
+        gl::glBindBuffer(gl::GL_DRAW_INDIRECT_BUFFER, commandBuffer_);
+        gl::glBufferData(gl::GL_DRAW_INDIRECT_BUFFER, drawCommands_.size() * sizeof(DrawArraysIndirectCommand), drawCommands_.data(), gl::GL_STREAM_DRAW);
+        gl::glBindBuffer(gl::GL_SHADER_STORAGE_BUFFER, transformBuffer_);
+        gl::glBufferData(gl::GL_SHADER_STORAGE_BUFFER, nodeTransforms_.size() * sizeof(NodeTransform), nodeTransforms_.data(), gl::GL_STREAM_DRAW);
+        gl::glBindBufferBase(gl::GL_SHADER_STORAGE_BUFFER, NODE_TRANSFORM_BINDING, transformBuffer_);
+
+        gl::glUseProgram(indirectProgram_);
+        gl::glUniformMatrix4fv(indirectViewProjectionLoc_, 1, gl::GL_FALSE, glm::value_ptr(viewProjection));
+        gl::glUniform1f(indirectPointSizeLoc_, 1.0f);
+        gl::glUniform1i(indirectColorModeLoc_, static_cast<GLint>(colorMode_));
+        gl::glUniform2fv(indirectAttributeRangeLoc_, 1, glm::value_ptr(GetAttributeRange()));
+        for (const auto& draw : arenaDraws_) {
+            gl::glBindVertexArray(arenas_[draw.arena_].vao_);
+            gl::glMultiDrawArraysIndirect(gl::GL_POINTS, reinterpret_cast<const void*>(draw.firstCommand_ * sizeof(DrawArraysIndirectCommand)),
+                static_cast<GLsizei>(draw.numCommands_), 0);
+            ++numDrawCalls_;
+        }
+
+        gl::glBindBufferBase(gl::GL_SHADER_STORAGE_BUFFER, NODE_TRANSFORM_BINDING, 0);
+        gl::glBindBuffer(gl::GL_SHADER_STORAGE_BUFFER, 0);
+        gl::glBindBuffer(gl::GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    /**
+     *  Selects the nodes for the current view and draws them with the CPU rasterizer, for nodes without a usable
+     *  GPU. Points are read directly from the mapped file, so nodes do not need to be resident on the GPU. Nodes of a
+     *  distributed file are skipped and requested until their chunk arrived. The result is copied to textures and composited into the current framebuffer with depth, so it mixes with
+     *  geometry drawn by the GPU.
+     *  @param viewProjection the view projection matrix.
+     *  @param lodParameters the parameters of the level of detail selection.
+     *  @param compositeProgram the shader program copying the rasterized colors and depths to the framebuffer.
+     */
+    void PointCloudRenderer::DrawSoftware(const glm::mat4& viewProjection, const LODTraversalParameters& lodParameters, GLuint compositeProgram)
+    {
+        GLint viewport[4];
+        gl::glGetIntegerv(gl::GL_VIEWPORT, viewport);
+        if (viewport[2] <= 0 || viewport[3] <= 0) return;
+        const auto& selectedNodes = SelectNodes(viewProjection, static_cast<float>(viewport[3]), lodParameters);
+        auto frustum = Frustum::FromMatrix(viewProjection);
+
+        drawList_.clear();
+        for (std::size_t i = 0; i < selectedNodes.size(); ++i) {
+            auto nodeIndex = selectedNodes[i];
+            const auto& node = file_.GetNode(nodeIndex);
+            if (node.numPoints_ == 0) continue;
+            if (chunkReplica_ != nullptr && !chunkReplica_->IsAvailable(nodeIndex)) {
+                // the chunks of a distributed file that did not arrive yet read as zeros.
+                missingChunks_.push_back(NodeLoadRequest{ static_cast<float>(selectedNodes.size() - i), nodeIndex, GetLoadColumns(nodeIndex) });
+                ++streamingStatistics_.numMissingNodes_;
+                continue;
+            }
+            if (frustum.IsOutside(node.boundsMin_, node.boundsMax_)) continue;
+            drawList_.push_back(nodeIndex);
+            numDrawnPoints_ += node.numPoints_;
+        }
+        if (chunkReplica_ != nullptr) chunkReplica_->Request(missingChunks_);
+        numDrawnNodes_ += drawList_.size();
+
+        if (!softwareRasterizer_) softwareRasterizer_ = std::make_unique<SoftwareRasterizer>();
+        ResizeSoftwareTextures(static_cast<unsigned>(viewport[2]), static_cast<unsigned>(viewport[3]));
+        softwareRasterizer_->Clear();
+        softwareRasterizer_->Draw(file_, drawList_, viewProjection);
+        softwareRasterizer_->Resolve();
+
+        auto width = static_cast<GLsizei>(softwareRasterizer_->GetWidth());
+        auto height = static_cast<GLsizei>(softwareRasterizer_->GetHeight());
+        gl::glPixelStorei(gl::GL_UNPACK_ALIGNMENT, 4);
+        gl::glBindTexture(gl::GL_TEXTURE_2D, softwareColorTexture_);
+        gl::glTexSubImage2D(gl::GL_TEXTURE_2D, 0, 0, 0, width, height, gl::GL_RGBA, gl::GL_UNSIGNED_BYTE, softwareRasterizer_->GetColors().data());
+        gl::glBindTexture(gl::GL_TEXTURE_2D, softwareDepthTexture_);
+        gl::glTexSubImage2D(gl::GL_TEXTURE_2D, 0, 0, 0, width, height, gl::GL_RED, gl::GL_FLOAT, softwareRasterizer_->GetDepths().data());
+
+        Composite(compositeProgram, softwareColorTexture_, softwareDepthTexture_);
+    }
+
+    /**
+     *  Copies colors and depths from textures to the current framebuffer with a full screen triangle, texels
+     *  without points (alpha 0) are discarded.
+     *  @param compositeProgram the shader program copying the colors and depths.
+     *  @param colorTexture the color texture.
+     *  @param depthTexture the depth texture.
+     */
+    void PointCloudRenderer::Composite(GLuint compositeProgram, GLuint colorTexture, GLuint depthTexture)
+    {
+        if (fullScreenVAO_ == 0) gl::glGenVertexArrays(1, &fullScreenVAO_);
+        gl::glUseProgram(compositeProgram);
+        gl::glActiveTexture(gl::GL_TEXTURE0);
+        gl::glBindTexture(gl::GL_TEXTURE_2D, colorTexture);
+        gl::glUniform1i(gl::glGetUniformLocation(compositeProgram, "colorTexture"), 0);
+        gl::glActiveTexture(gl::GL_TEXTURE1);
+        gl::glBindTexture(gl::GL_TEXTURE_2D, depthTexture);
+        gl::glUniform1i(gl::glGetUniformLocation(compositeProgram, "depthTexture"), 1);
+        gl::glBindVertexArray(fullScreenVAO_);
+        gl::glDrawArrays(gl::GL_TRIANGLES, 0, 3);
+
+        gl::glBindVertexArray(0);
+        gl::glBindTexture(gl::GL_TEXTURE_2D, 0);
+        gl::glActiveTexture(gl::GL_TEXTURE0);
+        gl::glBindTexture(gl::GL_TEXTURE_2D, 0);
+        gl::glUseProgram(0);
+    }
+
+    /**
+     *  Resizes the CPU rasterizer and (re)creates the textures its result is uploaded to.
+     *  @param width the width of the viewport.
+     *  @param height the height of the viewport.
+     */
+    void PointCloudRenderer::ResizeSoftwareTextures(unsigned width, unsigned height)
+    {
+        if (softwareColorTexture_ != 0 && softwareRasterizer_->GetWidth() == width && softwareRasterizer_->GetHeight() == height) return;
+        softwareRasterizer_->Resize(width, height);
+
+        auto createTexture = [width, height](GLuint& texture, gl::GLenum internalFormat, gl::GLenum format, gl::GLenum type) {
+            if (texture == 0) gl::glGenTextures(1, &texture);
+            gl::glBindTexture(gl::GL_TEXTURE_2D, texture);
+            gl::glTexImage2D(gl::GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), static_cast<GLsizei>(width), static_cast<GLsizei>(height), 0, format, type, nullptr);
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_MIN_FILTER, static_cast<GLint>(gl::GL_NEAREST));
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_MAG_FILTER, static_cast<GLint>(gl::GL_NEAREST));
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_WRAP_S, static_cast<GLint>(gl::GL_CLAMP_TO_EDGE));
+            gl::glTexParameteri(gl::GL_TEXTURE_2D, gl::GL_TEXTURE_WRAP_T, static_cast<GLint>(gl::GL_CLAMP_TO_EDGE));
+        };
+        createTexture(softwareColorTexture_, gl::GL_RGBA8, gl::GL_RGBA, gl::GL_UNSIGNED_BYTE);
+        createTexture(softwareDepthTexture_, gl::GL_R32F, gl::GL_RED, gl::GL_FLOAT);
+        gl::glBindTexture(gl::GL_TEXTURE_2D, 0);
+    }
+}
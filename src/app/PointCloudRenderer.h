@@ -0,0 +1,478 @@
+/**
+ * @file   PointCloudRenderer.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the renderer for out-of-core point clouds.
+ */
+
+#pragma once
+
+#include "core/main.h"
+#include "FrameState.h"
+#include "pointcloud/ChunkDistribution.h"
+#include "pointcloud/DepthPyramid.h"
+#include "pointcloud/FrustumCuller.h"
+#include "pointcloud/LODTraversal.h"
+#include "pointcloud/NodeLoader.h"
+#include "pointcloud/PointCloudFile.h"
+#include "pointcloud/RangeAllocator.h"
+#include "pointcloud/SoftwareRasterizer.h"
+
+#include <array>
+#include <list>
+
+namespace viscom {
+
+    /** Parameters of the node streaming. */
+    struct PointCloudStreamingParameters
+    {
+        /** The maximum number of bytes uploaded to the GPU per frame. */
+        std::uint64_t uploadBudget_ = 32ULL << 20;
+        /** The maximum number of bytes kept on the GPU before unused nodes are evicted. */
+        std::uint64_t memoryLimit_ = 1ULL << 30;
+        /** The size of the shared vertex buffers the nodes are stored in (larger nodes get their own buffer). */
+        std::uint64_t arenaSize_ = 64ULL << 20;
+    };
+
+    /** The ways of submitting the draw calls of the selected nodes. */
+    enum class PointCloudSubmission
+    {
+        /** One glDrawArrays per node, with the node bounds as uniforms. */
+        PerNode,
+        /** One glMultiDrawArraysIndirect per shared vertex buffer, with the node bounds in a storage buffer. */
+        Indirect
+    };
+
+    /** The attributes the points can be colored by, all but RGB need a columnar file storing the attribute. */
+    enum class PointCloudColorMode : std::uint8_t
+    {
+        /** The RGB colors. */
+        RGB,
+        /** The return intensity as gray scale. */
+        Intensity,
+        /** A color per classification (ASPRS classes). */
+        Classification,
+        /** A color per return number. */
+        ReturnNumber,
+        /** The GPS time as color ramp from the first to the last point. */
+        GPSTime
+    };
+
+    /** Statistics of the node streaming. */
+    struct PointCloudStreamingStatistics
+    {
+        /** The number of bytes stored on the GPU. */
+        std::uint64_t residentBytes_ = 0;
+        /** The number of bytes of the shared vertex buffers, including unused ranges. */
+        std::uint64_t allocatedBytes_ = 0;
+        /** The number of bytes uploaded in the current frame. */
+        std::uint64_t uploadedBytes_ = 0;
+        /** The number of selected nodes not drawn because they are still loading. */
+        std::uint32_t numMissingNodes_ = 0;
+        /** The number of nodes evicted since the renderer was created. */
+        std::uint64_t numEvictedNodes_ = 0;
+        /** The number of bytes of columns not needed by the color mode and therefore not uploaded since the renderer was created. */
+        std::uint64_t skippedBytes_ = 0;
+    };
+
+    class PointCloudRenderer
+    {
+    public:
+        PointCloudRenderer(const std::string& filename, GLuint program, GLuint indirectProgram, unsigned numLoaderThreads = 2);
+        PointCloudRenderer(const PointCloudRenderer&) = delete;
+        PointCloudRenderer(PointCloudRenderer&&) = delete;
+        PointCloudRenderer& operator=(const PointCloudRenderer&) = delete;
+        PointCloudRenderer& operator=(PointCloudRenderer&&) = delete;
+        ~PointCloudRenderer();
+
+        void BeginFrame();
+        void SetClusterViews(const glm::mat4& cameraView, const std::vector<ClusterView>& clusterViews);
+        void Draw(const glm::mat4& viewProjection, const LODTraversalParameters& lodParameters);
+        void DrawSoftware(const glm::mat4& viewProjection, const LODTraversalParameters& lodParameters, GLuint compositeProgram);
+
+        /** Returns the point cloud file. */
+        const PointCloudFile& GetFile() const { return file_; }
+        /** Returns the number of points currently stored on the GPU. */
+        std::uint64_t GetNumResidentPoints() const { return numResidentPoints_; }
+        /** Returns the number of points drawn in the current frame, summed over all views. */
+        std::uint64_t GetNumDrawnPoints() const { return numDrawnPoints_; }
+        /** Returns the number of nodes drawn in the current frame, summed over all views. */
+        std::uint64_t GetNumDrawnNodes() const { return numDrawnNodes_; }
+        /** Returns the number of OpenGL draw calls for the points in the current frame, summed over all views. */
+        std::uint64_t GetNumDrawCalls() const { return numDrawCalls_; }
+        /** Returns whether the nodes can be drawn with indirect draw calls. */
+        bool IsIndirectSupported() const { return indirectProgram_ != 0; }
+        /** Returns the way draw calls are submitted. */
+        PointCloudSubmission GetSubmission() const { return submission_; }
+        void SetSubmission(PointCloudSubmission submission);
+        /** Returns whether still views are refined progressively. */
+        bool IsProgressive() const { return progressive_; }
+        void SetProgressive(bool progressive);
+        /** Sets the shader program compositing retained images into the framebuffer, needed for progressive refinement. */
+        void SetCompositeProgram(GLuint compositeProgram) { compositeProgram_ = compositeProgram; }
+        /** Starts the refinement over, the image changed since the last frame. */
+        void ResetRefinement() { numStaticFrames_ = 0; }
+        /** Returns whether the current frame continues the image of the last one (progressive refinement only). */
+        bool IsRefining() const { return progressive_ && numStaticFrames_ > 0; }
+        bool IsRefinementComplete() const;
+        float GetRefinementProgress() const;
+        /** Returns whether nodes hidden behind the depths of earlier frames are skipped. */
+        bool IsOcclusionCulling() const { return occlusionCulling_; }
+        void SetOcclusionCulling(bool occlusionCulling);
+        /** Returns the attribute the points are colored by. */
+        PointCloudColorMode GetColorMode() const { return colorMode_; }
+        bool IsColorModeAvailable(PointCloudColorMode colorMode) const;
+        void SetColorMode(PointCloudColorMode colorMode);
+        /** Sets the shader program reducing the depth buffer to blocks before it is read back, needed for occlusion culling. */
+        void SetDepthReduceProgram(GLuint depthReduceProgram) { depthReduceProgram_ = depthReduceProgram; }
+        /** Returns the statistics of the occlusion culling in the current frame, summed over all views. */
+        const OcclusionStatistics& GetOcclusionStatistics() const { return occlusionStatistics_; }
+        /** Returns the statistics of the last level of detail selection shared by all views. */
+        const LODTraversalStatistics& GetTraversalStatistics() const { return traversal_.GetStatistics(); }
+        /** Returns the number of views drawn in the last frame. */
+        std::size_t GetNumViews() const { return previousViews_.size(); }
+        /** Returns the number of traversals done in the last frame. */
+        unsigned GetNumTraversals() const { return numTraversalsLastFrame_; }
+        /** Returns the views of this node relative to the camera, as drawn in the last frame. */
+        const std::vector<ClusterView>& GetCameraRelativeViews() const { return cameraRelativeViews_; }
+        /** Returns a number that changes whenever the views relative to the camera change. */
+        std::uint64_t GetCameraRelativeViewsVersion() const { return cameraRelativeViewsVersion_; }
+        /** Returns the statistics of the node streaming. */
+        const PointCloudStreamingStatistics& GetStreamingStatistics() const { return streamingStatistics_; }
+        /** Returns the number of nodes waiting to be loaded. */
+        std::size_t GetNumQueuedNodes() const { return loader_.GetNumQueued(); }
+        /** Returns the parameters of the node streaming. */
+        PointCloudStreamingParameters& GetStreamingParameters() { return streamingParameters_; }
+        /**
+         *  Sets the local copy of a file distributed by the master, nodes are only loaded once their chunk arrived
+         *  and the missing ones are requested from it instead. It has to outlive the renderer.
+         */
+        void SetChunkReplica(ChunkReplica* chunkReplica) { chunkReplica_ = chunkReplica; }
+
+    private:
+        /** Returns whether the positions are quantized relative to the node bounds. */
+        bool IsQuantized() const { return file_.GetHeader().pointLayout_ != PointLayout::Float32RGBA8; }
+        /** Returns the size of a vertex in the shared vertex buffers, for columnar files the size of a position. */
+        std::uint64_t GetVertexStride() const { return file_.IsColumnar() ? sizeof(glm::u16vec3) : file_.GetPointStride(); }
+        std::uint64_t GetResidentSize(std::uint32_t nodeIndex) const;
+        std::uint64_t GetUploadSize(std::uint32_t nodeIndex) const;
+        std::uint32_t GetLoadColumns(std::uint32_t nodeIndex) const;
+        glm::vec2 GetAttributeRange() const;
+        std::size_t AddView(const glm::mat4& viewProjection, float viewportHeight);
+        const std::vector<std::uint32_t>& SelectNodes(const glm::mat4& viewProjection, float viewportHeight, const LODTraversalParameters& lodParameters);
+        void UploadNode(std::uint32_t nodeIndex);
+        void EvictNodes();
+        std::uint32_t CreateArena(std::uint64_t size);
+        struct NodeArena;
+        void SetColorAttribute(const NodeArena& arena) const;
+        void SubmitPerNode(const glm::mat4& viewProjection);
+        void SubmitIndirect(const glm::mat4& viewProjection);
+        void ResizeSoftwareTextures(unsigned width, unsigned height);
+        void Composite(GLuint compositeProgram, GLuint colorTexture, GLuint depthTexture);
+
+        struct RefinementTarget;
+        void DrawNodes(const std::vector<std::uint32_t>& nodes, std::size_t firstNode, const glm::mat4& viewProjection, RefinementTarget* target,
+            std::uint64_t maxPoints, const DepthPyramid* occluders = nullptr);
+        void DrawProgressive(const glm::mat4& viewProjection, const GLint* viewport, const LODTraversalParameters& lodParameters);
+        bool ResizeRefinementTarget(RefinementTarget& target, GLsizei width, GLsizei height);
+        void DeleteRefinementTargets();
+
+        struct OcclusionView;
+        const DepthPyramid* PrepareOcclusion(std::size_t viewIndex, const glm::mat4& viewProjection);
+        void CaptureDepth(std::size_t viewIndex, const GLint* viewport, const glm::mat4& viewProjection);
+        bool ResizeOcclusionView(OcclusionView& view, GLsizei width, GLsizei height);
+        void DeleteOcclusionViews();
+
+        /** A view (window and eye) drawn in a frame. */
+        struct View
+        {
+            /** Holds the view projection matrix. */
+            glm::mat4 viewProjection_;
+            /** Holds the height of the viewport in pixels. */
+            float viewportHeight_;
+            /** Holds the transformation from the first views clip space to this views clip space. */
+            glm::dmat4 relativeToFirst_;
+            /** Holds the view projection matrix without the camera transformation. */
+            glm::mat4 relativeToCamera_;
+        };
+
+        /** Marks nodes not stored on the GPU. */
+        static constexpr std::uint32_t NO_ARENA = 0xFFFFFFFF;
+
+        /** The GPU resources of a single octree node. */
+        struct GPUNode
+        {
+            /** Holds the shared vertex buffer the points are stored in. */
+            std::uint32_t arena_ = NO_ARENA;
+            /** Holds the offset of the points in the shared vertex buffer in bytes. */
+            std::uint64_t offset_ = 0;
+            /** Holds the last frame the node was drawn in. */
+            std::uint64_t lastUsedFrame_ = 0;
+            /** Holds the position of the node in the LRU list. */
+            std::list<std::uint32_t>::iterator lruPosition_;
+            /** Holds the color version the attribute column was uploaded for (columnar files only). */
+            std::uint32_t colorVersion_ = 0;
+        };
+
+        /** A shared vertex buffer storing the points of many nodes, so they can be drawn by a single call. */
+        struct NodeArena
+        {
+            /** Holds the vertex buffer, for columnar files the positions only. */
+            GLuint vbo_ = 0;
+            /** Holds the buffer of the column shown by the color mode (columnar files only). */
+            GLuint attributeVbo_ = 0;
+            /** Holds the size of the attribute buffer in bytes. */
+            std::uint64_t attributeBufferSize_ = 0;
+            /** Holds the vertex array object. */
+            GLuint vao_ = 0;
+            /** Holds the ranges of the buffer used by nodes. */
+            RangeAllocator allocator_{ 0 };
+            /** Holds the number of nodes stored in the buffer. */
+            std::uint32_t numNodes_ = 0;
+        };
+
+        /** The command of a single draw of glMultiDrawArraysIndirect. */
+        struct DrawArraysIndirectCommand
+        {
+            /** Holds the number of points. */
+            GLuint count_;
+            /** Holds the number of instances (1). */
+            GLuint instanceCount_;
+            /** Holds the first point in the shared vertex buffer. */
+            GLuint first_;
+            /** Holds the index of the nodes transformation. */
+            GLuint baseInstance_;
+        };
+
+        /** The transformation of the positions of a node to world space, laid out for std430 storage buffers. */
+        struct NodeTransform
+        {
+            /** Holds the minimum of the node bounds. */
+            glm::vec4 boundsMin_;
+            /** Holds the extent of the node bounds. */
+            glm::vec4 boundsExtent_;
+        };
+
+        /** The indirect draw commands of a shared vertex buffer. */
+        struct ArenaDraw
+        {
+            /** Holds the index of the shared vertex buffer. */
+            std::uint32_t arena_;
+            /** Holds the index of the first command. */
+            std::size_t firstCommand_;
+            /** Holds the number of commands. */
+            std::size_t numCommands_;
+        };
+
+        /** The image of a view kept between frames while the camera does not move, finer nodes are added to it. */
+        struct RefinementTarget
+        {
+            /** Holds the framebuffer. */
+            GLuint fbo_ = 0;
+            /** Holds the color texture. */
+            GLuint colorTexture_ = 0;
+            /** Holds the depth texture. */
+            GLuint depthTexture_ = 0;
+            /** Holds the width of the textures. */
+            GLsizei width_ = 0;
+            /** Holds the height of the textures. */
+            GLsizei height_ = 0;
+            /** Holds the view projection matrix of the image. */
+            glm::mat4 viewProjection_;
+            /** Holds the selection without point budget, the final content of the image. */
+            std::vector<std::uint32_t> nodes_;
+            /** Holds whether the selection without point budget was done. */
+            bool selected_ = false;
+            /** Holds whether each node is part of the image (or outside of the view). */
+            std::vector<bool> drawn_;
+            /** Holds the index of the first node of the selection not in the image. */
+            std::size_t firstPending_ = 0;
+        };
+
+        /** The number of depth read backs of a view in flight, so the CPU never waits for the GPU. */
+        static constexpr std::size_t NUM_DEPTH_READBACKS = 3;
+        /** The size of the blocks of pixels the depth buffer is reduced to before the read back. */
+        static constexpr GLsizei DEPTH_BLOCK_SIZE = 8;
+
+        /** The depths of a view read back from earlier frames for occlusion culling. */
+        struct OcclusionView
+        {
+            /** Holds the copy of the depth buffer. */
+            GLuint depthTexture_ = 0;
+            /** Holds the texture with the farthest depth of each block. */
+            GLuint blockTexture_ = 0;
+            /** Holds the framebuffer the blocks are reduced into. */
+            GLuint blockFBO_ = 0;
+            /** Holds the width of the viewport. */
+            GLsizei width_ = 0;
+            /** Holds the height of the viewport. */
+            GLsizei height_ = 0;
+            /** Holds the width of the block texture. */
+            GLsizei blockWidth_ = 0;
+            /** Holds the height of the block texture. */
+            GLsizei blockHeight_ = 0;
+            /** Holds the pixel buffers the blocks are read back into. */
+            std::array<GLuint, NUM_DEPTH_READBACKS> pixelBuffers_ = {};
+            /** Holds the fences signaling finished read backs (nullptr if the buffer is not in flight). */
+            std::array<gl::GLsync, NUM_DEPTH_READBACKS> fences_ = {};
+            /** Holds the view projection matrix of each read back. */
+            std::array<glm::mat4, NUM_DEPTH_READBACKS> readbackViewProjections_;
+            /** Holds the pixel buffer of the next read back. */
+            std::size_t nextReadback_ = 0;
+            /** Holds the depths of the latest finished read back. */
+            std::vector<float> depths_;
+            /** Holds the view projection matrix of the latest finished read back. */
+            glm::mat4 depthsViewProjection_;
+            /** Holds the pyramid of the latest depths reprojected to the current view. */
+            DepthPyramid pyramid_;
+        };
+
+        /** Holds the point cloud file. */
+        PointCloudFile file_;
+        /** Holds the shader program for drawing the points. */
+        GLuint program_;
+        /** Holds the location of the VP matrix. */
+        GLint viewProjectionLoc_ = -1;
+        /** Holds the location of the point size. */
+        GLint pointSizeLoc_ = -1;
+        /** Holds the location of the node bounds minimum used for dequantization. */
+        GLint nodeBoundsMinLoc_ = -1;
+        /** Holds the location of the node bounds extent used for dequantization. */
+        GLint nodeBoundsExtentLoc_ = -1;
+        /** Holds the location of the position attribute. */
+        GLint positionLoc_ = -1;
+        /** Holds the location of the color attribute. */
+        GLint colorLoc_ = -1;
+        /** Holds the location of the color mode. */
+        GLint colorModeLoc_ = -1;
+        /** Holds the location of the range the scalar attributes are mapped to colors with. */
+        GLint attributeRangeLoc_ = -1;
+        /** Holds the shader program for drawing the points with indirect draw calls (0 if not supported). */
+        GLuint indirectProgram_;
+        /** Holds the location of the VP matrix of the indirect program. */
+        GLint indirectViewProjectionLoc_ = -1;
+        /** Holds the location of the point size of the indirect program. */
+        GLint indirectPointSizeLoc_ = -1;
+        /** Holds the location of the draw index attribute of the indirect program. */
+        GLint drawIndexLoc_ = -1;
+        /** Holds the location of the color mode of the indirect program. */
+        GLint indirectColorModeLoc_ = -1;
+        /** Holds the location of the attribute range of the indirect program. */
+        GLint indirectAttributeRangeLoc_ = -1;
+        /** Holds the way draw calls are submitted. */
+        PointCloudSubmission submission_ = PointCloudSubmission::PerNode;
+
+        /** Holds the level of detail selection shared by all views of a frame. */
+        LODTraversal traversal_;
+        /** Holds the level of detail selection for views not covered by the shared selection. */
+        LODTraversal viewTraversal_;
+        /** Holds the culling of all nodes against the views of a frame. */
+        FrustumCuller culler_;
+        /** Holds the views of the last frame. */
+        std::vector<View> previousViews_;
+        /** Holds the views of the current frame. */
+        std::vector<View> currentViews_;
+        /** Holds the predicted view projection matrices the shared selection was done for. */
+        std::vector<glm::mat4> sharedViewProjections_;
+        /** Holds the viewport heights the shared selection was done for. */
+        std::vector<float> sharedViewportHeights_;
+        /** Holds the frusta of the shared selection. */
+        std::vector<Frustum> sharedFrusta_;
+        /** Holds the inverse camera view matrix of the current frame. */
+        glm::dmat4 inverseCameraView_ = glm::dmat4(1.0);
+        /** Holds the view projection matrices of all cluster nodes for the current frame. */
+        std::vector<glm::mat4> clusterViewProjections_;
+        /** Holds the viewport heights of all cluster nodes. */
+        std::vector<float> clusterViewportHeights_;
+        /** Holds the views of this node relative to the camera. */
+        std::vector<ClusterView> cameraRelativeViews_;
+        /** Holds the version of the views relative to the camera. */
+        std::uint64_t cameraRelativeViewsVersion_ = 0;
+        /** Holds the number of traversals in the current frame. */
+        unsigned numTraversals_ = 0;
+        /** Holds the number of traversals in the last frame. */
+        unsigned numTraversalsLastFrame_ = 0;
+        /** Holds the GPU resources for each node in the file. */
+        std::vector<GPUNode> gpuNodes_;
+        /** Holds the shared vertex buffers, deleted ones are reused. */
+        std::vector<NodeArena> arenas_;
+        /** Holds the buffer of draw indices 0 to the number of nodes, read per instance to find the transformation. */
+        GLuint drawIndexBuffer_ = 0;
+        /** Holds the buffer of indirect draw commands. */
+        GLuint commandBuffer_ = 0;
+        /** Holds the storage buffer of node transformations. */
+        GLuint transformBuffer_ = 0;
+        /** Holds the indirect draw commands of the current view. */
+        std::vector<DrawArraysIndirectCommand> drawCommands_;
+        /** Holds the node transformations of the current view. */
+        std::vector<NodeTransform> nodeTransforms_;
+        /** Holds the draws of each shared vertex buffer for the current view. */
+        std::vector<ArenaDraw> arenaDraws_;
+        /** Holds the number of points stored on the GPU. */
+        std::uint64_t numResidentPoints_ = 0;
+        /** Holds the number of points drawn in the current frame. */
+        std::uint64_t numDrawnPoints_ = 0;
+        /** Holds the number of nodes drawn in the current frame. */
+        std::uint64_t numDrawnNodes_ = 0;
+        /** Holds the number of draw calls in the current frame. */
+        std::uint64_t numDrawCalls_ = 0;
+        /** Holds the resident nodes, the most recently used first. */
+        std::list<std::uint32_t> lru_;
+        /** Holds the attribute the points are colored by. */
+        PointCloudColorMode colorMode_ = PointCloudColorMode::RGB;
+        /** Holds the version of the color mode, nodes with an older version need the column of the current attribute. */
+        std::uint32_t colorVersion_ = 0;
+
+        /** Holds the background loader. */
+        NodeLoader loader_;
+        /** Holds the load requests of the current frame. */
+        std::vector<NodeLoadRequest> requests_;
+        /** Holds the local copy of a distributed file, or nullptr if the whole file is on disk. */
+        ChunkReplica* chunkReplica_ = nullptr;
+        /** Holds the requests of the current frame for chunks not on disk yet. */
+        std::vector<NodeLoadRequest> missingChunks_;
+        /** Holds the last frame each node was requested in, to avoid duplicate requests from multiple viewports. */
+        std::vector<std::uint64_t> requestedFrame_;
+        /** Holds the last draw call each node was drawn in. */
+        std::vector<std::uint64_t> drawnInCall_;
+        /** Holds the nodes drawn by the current draw call. */
+        std::vector<std::uint32_t> drawList_;
+        /** Holds the current frame number. */
+        std::uint64_t frame_ = 1;
+        /** Holds the number of draw calls so far. */
+        std::uint64_t drawCall_ = 0;
+
+        /** Holds the CPU rasterizer (created on first use). */
+        std::unique_ptr<SoftwareRasterizer> softwareRasterizer_;
+        /** Holds the texture the colors of the CPU rasterizer are uploaded to. */
+        GLuint softwareColorTexture_ = 0;
+        /** Holds the texture the depths of the CPU rasterizer are uploaded to. */
+        GLuint softwareDepthTexture_ = 0;
+        /** Holds the empty vertex array object for drawing the full screen triangle. */
+        GLuint fullScreenVAO_ = 0;
+
+        /** Holds whether still views are refined progressively. */
+        bool progressive_ = false;
+        /** Holds the shader program compositing retained images into the framebuffer. */
+        GLuint compositeProgram_ = 0;
+        /** Holds the number of frames the image did not change. */
+        std::uint64_t numStaticFrames_ = 0;
+        /** Holds the retained image of each view. */
+        std::vector<RefinementTarget> refinementTargets_;
+
+        /** Holds whether nodes hidden behind the depths of earlier frames are skipped. */
+        bool occlusionCulling_ = false;
+        /** Holds the shader program reducing the depth buffer to blocks. */
+        GLuint depthReduceProgram_ = 0;
+        /** Holds the read back depths of each view. */
+        std::vector<OcclusionView> occlusionViews_;
+        /** Holds the statistics of the occlusion culling in the current frame. */
+        OcclusionStatistics occlusionStatistics_;
+
+        /** Holds the parameters of the node streaming. */
+        PointCloudStreamingParameters streamingParameters_;
+        /** Holds the statistics of the node streaming. */
+        PointCloudStreamingStatistics streamingStatistics_;
+    };
+}
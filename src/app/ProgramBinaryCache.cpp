@@ -0,0 +1,295 @@
+/**
+ * @file   ProgramBinaryCache.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the persistent cache of linked shader program binaries.
+ */
+
+#include "ProgramBinaryCache.h"
+#include "Hash.h"
+
+#include <glbinding/gl/gl.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace viscom {
+
+    namespace {
+        /** The magic number at the start of binary files ("VSPB"). */
+        constexpr std::uint32_t PROGRAM_BINARY_MAGIC = 0x42505356;
+        /** The version of the binary file format. */
+        constexpr std::uint32_t PROGRAM_BINARY_VERSION = 1;
+
+        /** The header at the start of each binary file, followed by the program binary. */
+        struct ProgramBinaryHeader
+        {
+            /** The magic number (PROGRAM_BINARY_MAGIC). */
+            std::uint32_t magic_;
+            /** The file format version (PROGRAM_BINARY_VERSION). */
+            std::uint32_t version_;
+            /** The hash of the shader file names and sources. */
+            std::uint64_t sourceHash_;
+            /** The hash of the vendor, renderer and version string. */
+            std::uint64_t driverHash_;
+            /** The format of the binary returned by the driver. */
+            std::uint32_t binaryFormat_;
+            /** The size of the binary in bytes. */
+            std::uint32_t binarySize_;
+        };
+
+        using Clock = std::chrono::high_resolution_clock;
+
+        double GetMilliseconds(Clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        std::string ReadTextFile(const std::string& filename)
+        {
+            std::ifstream file{ filename };
+            if (!file) throw std::runtime_error("Could not open file \"" + filename + "\".");
+            std::stringstream content;
+            content << file.rdbuf();
+            return content.str();
+        }
+
+        std::string GetGLString(gl::GLenum name)
+        {
+            auto value = gl::glGetString(name);
+            return value != nullptr ? reinterpret_cast<const char*>(value) : "";
+        }
+
+        gl::GLenum GetShaderType(const std::string& filename)
+        {
+            auto extension = filename.substr(filename.find_last_of('.') + 1);
+            if (extension == "vert") return gl::GL_VERTEX_SHADER;
+            if (extension == "geom") return gl::GL_GEOMETRY_SHADER;
+            if (extension == "frag") return gl::GL_FRAGMENT_SHADER;
+            if (extension == "comp") return gl::GL_COMPUTE_SHADER;
+            throw std::runtime_error("Unknown shader type of \"" + filename + "\".");
+        }
+
+        GLuint CompileShader(const std::string& filename, const std::string& source)
+        {
+            auto sourcePtr = source.c_str();
+            auto shader = gl::glCreateShader(GetShaderType(filename));
+            gl::glShaderSource(shader, 1, &sourcePtr, nullptr);
+            gl::glCompileShader(shader);
+
+            GLint status = 0;
+            gl::glGetShaderiv(shader, gl::GL_COMPILE_STATUS, &status);
+            if (status == 0) {
+                GLint logLength = 0;
+                gl::glGetShaderiv(shader, gl::GL_INFO_LOG_LENGTH, &logLength);
+                std::string log(static_cast<std::size_t>(std::max(logLength, 1)), '\0');
+                gl::glGetShaderInfoLog(shader, logLength, nullptr, &log[0]);
+                gl::glDeleteShader(shader);
+                throw std::runtime_error("Could not compile shader \"" + filename + "\": " + log);
+            }
+            return shader;
+        }
+
+        bool IsLinked(GLuint program)
+        {
+            GLint status = 0;
+            gl::glGetProgramiv(program, gl::GL_LINK_STATUS, &status);
+            return status != 0;
+        }
+
+        void MakeDirectory(const std::string& directory)
+        {
+            // fails if the directory exists, other errors show up when the first binary is written.
+#ifdef _WIN32
+            _mkdir(directory.c_str());
+#else
+            mkdir(directory.c_str(), 0755);
+#endif
+        }
+    }
+
+    /**
+     *  Creates the cache, an OpenGL context has to be current.
+     *  @param shaderDirectory the directory of the shader sources.
+     *  @param cacheDirectory the directory of the cached binaries, it is created if needed.
+     */
+    ProgramBinaryCache::ProgramBinaryCache(const std::string& shaderDirectory, const std::string& cacheDirectory) :
+        shaderDirectory_{ shaderDirectory },
+        cacheDirectory_{ cacheDirectory }
+    {
+        GLint numBinaryFormats = 0;
+        gl::glGetIntegerv(gl::GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+        supported_ = numBinaryFormats > 0;
+
+        auto driver = GetGLString(gl::GL_VENDOR) + "\n" + GetGLString(gl::GL_RENDERER) + "\n" + GetGLString(gl::GL_VERSION);
+        driverHash_ = HashFNV1a(driver.data(), driver.size());
+        if (supported_) MakeDirectory(cacheDirectory_);
+        else LOG(INFO) << "The driver does not support program binaries, shaders are compiled on every start.";
+    }
+
+    ProgramBinaryCache::~ProgramBinaryCache()
+    {
+        for (const auto& program : programs_) gl::glDeleteProgram(program.second);
+    }
+
+    /**
+     *  Returns a program, creating it from its binary or its sources on the first request.
+     *  @param name the name of the program.
+     *  @param shaderFiles the shader files relative to the shader directory, the type is given by the extension.
+     *  @return the program.
+     */
+    GLuint ProgramBinaryCache::GetProgram(const std::string& name, std::initializer_list<std::string> shaderFiles)
+    {
+        auto existing = programs_.find(name);
+        if (existing != programs_.end()) return existing->second;
+
+        auto start = Clock::now();
+        std::vector<std::string> sources;
+        auto sourceHash = FNV1A_OFFSET_BASIS;
+        for (const auto& shaderFile : shaderFiles) {
+            sources.push_back(ReadTextFile(shaderDirectory_ + "/" + shaderFile));
+            // the terminating zeros separate the names and sources in the hash.
+            sourceHash = HashFNV1a(shaderFile.c_str(), shaderFile.size() + 1, sourceHash);
+            sourceHash = HashFNV1a(sources.back().c_str(), sources.back().size() + 1, sourceHash);
+        }
+
+        auto program = supported_ ? LoadBinary(name, sourceHash) : 0;
+        if (program != 0) {
+            ++statistics_.numLoaded_;
+            statistics_.loadTime_ += GetMilliseconds(start);
+            return programs_[name] = program;
+        }
+
+        std::vector<GLuint> shaders;
+        try {
+            auto source = sources.begin();
+            for (const auto& shaderFile : shaderFiles) shaders.push_back(CompileShader(shaderFile, *source++));
+        }
+        catch (const std::runtime_error&) {
+            for (auto shader : shaders) gl::glDeleteShader(shader);
+            throw;
+        }
+
+        program = gl::glCreateProgram();
+        for (auto shader : shaders) gl::glAttachShader(program, shader);
+        if (supported_) gl::glProgramParameteri(program, gl::GL_PROGRAM_BINARY_RETRIEVABLE_HINT, static_cast<GLint>(gl::GL_TRUE));
+        gl::glLinkProgram(program);
+        for (auto shader : shaders) {
+            gl::glDetachShader(program, shader);
+            gl::glDeleteShader(shader);
+        }
+        if (!IsLinked(program)) {
+            GLint logLength = 0;
+            gl::glGetProgramiv(program, gl::GL_INFO_LOG_LENGTH, &logLength);
+            std::string log(static_cast<std::size_t>(std::max(logLength, 1)), '\0');
+            gl::glGetProgramInfoLog(program, logLength, nullptr, &log[0]);
+            gl::glDeleteProgram(program);
+            throw std::runtime_error("Could not link program \"" + name + "\": " + log);
+        }
+        ++statistics_.numCompiled_;
+        statistics_.compileTime_ += GetMilliseconds(start);
+
+        if (supported_) StoreBinary(name, program, sourceHash);
+        return programs_[name] = program;
+    }
+
+    /** Returns the binary file of a program, nodes with different drivers sharing a directory use different files. */
+    std::string ProgramBinaryCache::GetBinaryFilename(const std::string& name) const
+    {
+        std::stringstream filename;
+        filename << cacheDirectory_ << "/" << name << "_" << std::hex << std::setw(16) << std::setfill('0') << driverHash_ << ".bin";
+        return filename.str();
+    }
+
+    /**
+     *  Creates a program from its cached binary.
+     *  @param name the name of the program.
+     *  @param sourceHash the hash of the current shader sources.
+     *  @return the program or 0 if there is no matching binary.
+     */
+    GLuint ProgramBinaryCache::LoadBinary(const std::string& name, std::uint64_t sourceHash) const
+    {
+        std::ifstream file{ GetBinaryFilename(name), std::ios::binary };
+        if (!file) return 0;
+
+        ProgramBinaryHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(ProgramBinaryHeader))) return 0;
+        if (header.magic_ != PROGRAM_BINARY_MAGIC || header.version_ != PROGRAM_BINARY_VERSION || header.sourceHash_ != sourceHash
+            || header.driverHash_ != driverHash_) return 0;
+        std::vector<char> binary(header.binarySize_);
+        if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size()))) return 0;
+
+        auto program = gl::glCreateProgram();
+        gl::glProgramBinary(program, static_cast<gl::GLenum>(header.binaryFormat_), binary.data(), static_cast<GLsizei>(binary.size()));
+        // drivers may reject binaries even if the strings match, e.g. after an update keeping the version string.
+        if (!IsLinked(program)) {
+            LOG(INFO) << "The driver rejected the binary of program \"" << name << "\", compiling it.";
+            gl::glDeleteProgram(program);
+            return 0;
+        }
+        return program;
+    }
+
+    /**
+     *  Writes the binary of a program, it is written under a temporary name and renamed, so nodes sharing the
+     *  directory never read a partially written binary. Errors are logged, the program is compiled again then.
+     *  @param name the name of the program.
+     *  @param program the linked program.
+     *  @param sourceHash the hash of the shader sources.
+     */
+    void ProgramBinaryCache::StoreBinary(const std::string& name, GLuint program, std::uint64_t sourceHash) const
+    {
+        GLint binarySize = 0;
+        gl::glGetProgramiv(program, gl::GL_PROGRAM_BINARY_LENGTH, &binarySize);
+        if (binarySize <= 0) return;
+        std::vector<char> binary(static_cast<std::size_t>(binarySize));
+        gl::GLenum binaryFormat;
+        GLsizei length = 0;
+        gl::glGetProgramBinary(program, binarySize, &length, &binaryFormat, binary.data());
+
+        ProgramBinaryHeader header;
+        header.magic_ = PROGRAM_BINARY_MAGIC;
+        header.version_ = PROGRAM_BINARY_VERSION;
+        header.sourceHash_ = sourceHash;
+        header.driverHash_ = driverHash_;
+        header.binaryFormat_ = static_cast<std::uint32_t>(binaryFormat);
+        header.binarySize_ = static_cast<std::uint32_t>(length);
+
+        auto filename = GetBinaryFilename(name);
+        auto tempFilename = filename + "." + std::to_string(std::random_device{}()) + ".tmp";
+        {
+            std::ofstream file{ tempFilename, std::ios::binary };
+            file.write(reinterpret_cast<const char*>(&header), sizeof(ProgramBinaryHeader));
+            file.write(binary.data(), length);
+            if (!file) {
+                file.close();
+                std::remove(tempFilename.c_str());
+                LOG(WARNING) << "Could not write program binary \"" << tempFilename << "\".";
+                return;
+            }
+        }
+
+        // renaming does not replace existing files on Windows.
+        if (std::rename(tempFilename.c_str(), filename.c_str()) != 0) {
+            std::remove(filename.c_str());
+            if (std::rename(tempFilename.c_str(), filename.c_str()) != 0) {
+                std::remove(tempFilename.c_str());
+                LOG(WARNING) << "Could not replace program binary \"" << filename << "\".";
+            }
+        }
+    }
+}
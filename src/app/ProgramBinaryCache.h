@@ -0,0 +1,73 @@
+/**
+ * @file   ProgramBinaryCache.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the persistent cache of linked shader program binaries.
+ */
+
+#pragma once
+
+#include "core/main.h"
+
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+
+namespace viscom {
+
+    /** Statistics of the programs created by the cache, to compare cold and warm starts. */
+    struct ProgramBinaryCacheStatistics
+    {
+        /** The number of programs loaded from cached binaries. */
+        unsigned numLoaded_ = 0;
+        /** The number of programs compiled from source. */
+        unsigned numCompiled_ = 0;
+        /** The time spent loading cached binaries in milliseconds. */
+        double loadTime_ = 0.0;
+        /** The time spent compiling and linking in milliseconds. */
+        double compileTime_ = 0.0;
+    };
+
+    /**
+     *  Creates shader programs by name like the GPU program manager, but keeps the linked binaries
+     *  (glGetProgramBinary) in a directory, so later starts skip compiling and linking. A binary is only used if
+     *  the hash of the shader sources and the driver (vendor, renderer and version string) match and the driver
+     *  accepts it, otherwise the program is compiled and the binary replaced. Programs are owned by the cache.
+     */
+    class ProgramBinaryCache
+    {
+    public:
+        ProgramBinaryCache(const std::string& shaderDirectory, const std::string& cacheDirectory);
+        ProgramBinaryCache(const ProgramBinaryCache&) = delete;
+        ProgramBinaryCache(ProgramBinaryCache&&) = delete;
+        ProgramBinaryCache& operator=(const ProgramBinaryCache&) = delete;
+        ProgramBinaryCache& operator=(ProgramBinaryCache&&) = delete;
+        ~ProgramBinaryCache();
+
+        GLuint GetProgram(const std::string& name, std::initializer_list<std::string> shaderFiles);
+
+        /** Returns whether the driver supports program binaries. */
+        bool IsSupported() const { return supported_; }
+        /** Returns the statistics of the programs created so far. */
+        const ProgramBinaryCacheStatistics& GetStatistics() const { return statistics_; }
+
+    private:
+        std::string GetBinaryFilename(const std::string& name) const;
+        GLuint LoadBinary(const std::string& name, std::uint64_t sourceHash) const;
+        void StoreBinary(const std::string& name, GLuint program, std::uint64_t sourceHash) const;
+
+        /** Holds the directory of the shader sources. */
+        std::string shaderDirectory_;
+        /** Holds the directory of the cached binaries. */
+        std::string cacheDirectory_;
+        /** Holds the hash of the vendor, renderer and version string. */
+        std::uint64_t driverHash_ = 0;
+        /** Holds whether the driver supports program binaries. */
+        bool supported_ = false;
+        /** Holds the programs by name. */
+        std::unordered_map<std::string, GLuint> programs_;
+        /** Holds the statistics. */
+        ProgramBinaryCacheStatistics statistics_;
+    };
+}
@@ -8,6 +8,7 @@
 
 #include "SlaveNode.h"
 #include <imgui.h>
+#include "PointCloudRenderer.h"
 
 namespace viscom {
 
@@ -16,8 +17,75 @@ namespace viscom {
     {
     }
 
+    void SlaveNode::InitOpenGL()
+    {
+        SlaveNodeInternal::InitOpenGL();
+        std::string pointCloudFile = VISCOM_POINTCLOUD_FILE;
+        if (IsPointCloudStreamed() && !pointCloudFile.empty()) chunkReplica_ = std::make_unique<ChunkReplica>(VISCOM_CHUNK_CACHE_DIR);
+    }
+
+    void SlaveNode::UpdateFrame(double currentTime, double elapsedTime)
+    {
+        if (chunkReplica_) UpdateChunkReplica(currentTime);
+        SlaveNodeInternal::UpdateFrame(currentTime, elapsedTime);
+
+        // the master shows the profiles of all slaves to find the slowest node.
+        FrameProfileSample sample;
+        if (GetProfiler().GetLastCompleteSample(sample) && sample.frame_ != lastReportedFrame_) {
+            TransferDataToNode(&sample, sizeof(FrameProfileSample), FRAME_PROFILE_PACKAGE_ID, 0);
+            lastReportedFrame_ = sample.frame_;
+        }
+
+        // the master selects nodes for the views of all slaves, it only needs to know when they change.
+        auto pointCloud = GetPointCloud();
+        if (pointCloud != nullptr && pointCloud->GetCameraRelativeViewsVersion() != lastReportedViewsVersion_) {
+            const auto& views = pointCloud->GetCameraRelativeViews();
+            TransferDataToNode(views.data(), views.size() * sizeof(ClusterView), CLUSTER_VIEWS_PACKAGE_ID, 0);
+            lastReportedViewsVersion_ = pointCloud->GetCameraRelativeViewsVersion();
+        }
+
+        // the requests of this frame were collected while drawing the last one.
+        if (chunkReplica_ && chunkReplica_->CreateChunkRequest(chunkRequest_))
+            TransferDataToNode(chunkRequest_.data(), chunkRequest_.size(), CHUNK_REQUEST_PACKAGE_ID, 0);
+        if (chunkReplica_ && !firstPointsLogged_ && pointCloud != nullptr && pointCloud->GetNumDrawnPoints() > 0) {
+            const auto& statistics = chunkReplica_->GetStatistics();
+            LOG(INFO) << "First points of the distributed point cloud drawn after " << (currentTime - startTime_) << " s ("
+                << statistics.numCachedChunks_ << " of " << statistics.numChunks_ << " chunks cached, "
+                << statistics.receivedBytes_ << " bytes received).";
+            firstPointsLogged_ = true;
+        }
+    }
+
+    /**
+     *  Writes the data received from the master to the local copy of the point cloud. The manifest is requested
+     *  until it arrives, then the local copy is opened and draws whatever chunks it holds.
+     *  @param currentTime the current time in seconds.
+     */
+    void SlaveNode::UpdateChunkReplica(double currentTime)
+    {
+        if (startTime_ < 0.0) startTime_ = currentTime;
+        try {
+            chunkReplica_->Update();
+        }
+        catch (const std::runtime_error& e) {
+            LOG(WARNING) << "Could not update the distributed point cloud: " << e.what();
+        }
+        if (GetPointCloud() != nullptr) return;
+
+        if (chunkReplica_->IsReady()) {
+            OpenPointCloud(chunkReplica_->GetFilename());
+            if (GetPointCloud() != nullptr) GetPointCloud()->SetChunkReplica(chunkReplica_.get());
+        }
+        else if (currentTime - lastManifestRequest_ >= MANIFEST_REQUEST_INTERVAL) {
+            auto request = ChunkReplica::CreateManifestRequest();
+            TransferDataToNode(request.data(), request.size(), CHUNK_REQUEST_PACKAGE_ID, 0);
+            lastManifestRequest_ = currentTime;
+        }
+    }
+
     void SlaveNode::Draw2D(FrameBuffer& fbo)
     {
+        FrameProfiler::ScopedPhase profilePhase{ GetProfiler(), FramePhase::Draw2D };
 #ifdef VISCOM_CLIENTGUI
         ImGui::ShowTestWindow();
 #endif
@@ -26,6 +94,36 @@ namespace viscom {
         SlaveNodeInternal::Draw2D(fbo);
     }
 
+    /**
+     *  Receives the frame state from the master. Until the first complete state arrives (or after missing data) the
+     *  last synchronized state is kept.
+     */
+    void SlaveNode::DecodeData()
+    {
+        SlaveNodeInternal::DecodeData();
+        sgct::SharedData::instance()->readVector(&sharedFrameState_);
+        auto data = sharedFrameState_.getVal();
+        if (frameStateDecoder_.Decode(data.data(), data.size())) GetFrameState() = frameStateDecoder_.GetState();
+    }
+
+    /**
+     *  Receives the chunks of the point cloud sent by the master, they are written to disk in the next frame.
+     */
+    bool SlaveNode::DataTransferCallback(void* receivedData, int receivedLength, std::uint16_t packageID, int clientID)
+    {
+        if (packageID != CHUNK_DATA_PACKAGE_ID || !chunkReplica_)
+            return SlaveNodeInternal::DataTransferCallback(receivedData, receivedLength, packageID, clientID);
+        chunkReplica_->Receive(receivedData, static_cast<std::size_t>(receivedLength));
+        return true;
+    }
+
+    void SlaveNode::CleanUp()
+    {
+        // the renderer reads the local copy, so it goes first.
+        SlaveNodeInternal::CleanUp();
+        chunkReplica_.reset();
+    }
+
     SlaveNode::~SlaveNode() = default;
 
 }
@@ -9,6 +9,10 @@
 #pragma once
 
 #include "core/SlaveNodeHelper.h"
+#include "pointcloud/ChunkDistribution.h"
+#include <sgct.h>
+
+#include <memory>
 
 namespace viscom {
 
@@ -18,7 +22,41 @@ namespace viscom {
         explicit SlaveNode(ApplicationNodeInternal* appNode);
         virtual ~SlaveNode() override;
 
+        void InitOpenGL() override;
+        void UpdateFrame(double currentTime, double elapsedTime) override;
         void Draw2D(FrameBuffer& fbo) override;
+        void DecodeData() override;
+        void CleanUp() override;
+
+        bool DataTransferCallback(void* receivedData, int receivedLength, std::uint16_t packageID, int clientID) override;
+
+    protected:
+        /** Returns whether the point cloud is received from the master. */
+        bool IsPointCloudStreamed() const override { return VISCOM_POINTCLOUD_DISTRIBUTION != 0; }
+
+    private:
+        /** The time in seconds after which an unanswered manifest request is sent again. */
+        static constexpr double MANIFEST_REQUEST_INTERVAL = 2.0;
+
+        void UpdateChunkReplica(double currentTime);
 
+        /** Holds the last frame whose profile was sent to the master. */
+        std::uint64_t lastReportedFrame_ = 0;
+        /** Holds the version of the views last sent to the master. */
+        std::uint64_t lastReportedViewsVersion_ = 0;
+        /** Holds the decoder for the frame state received from the master. */
+        FrameStateDecoder frameStateDecoder_;
+        /** Holds the encoded frame state synchronized with the master. */
+        sgct::SharedVector<std::uint8_t> sharedFrameState_;
+        /** Holds the local copy of the point cloud distributed by the master (nullptr if the file is opened directly). */
+        std::unique_ptr<ChunkReplica> chunkReplica_;
+        /** Holds the time the last manifest request was sent (negative before the first one). */
+        double lastManifestRequest_ = -MANIFEST_REQUEST_INTERVAL;
+        /** Holds the time the slave was started, to measure the time until the first points are drawn. */
+        double startTime_ = -1.0;
+        /** Holds whether the time until the first points were drawn was logged. */
+        bool firstPointsLogged_ = false;
+        /** Holds the last chunk request, kept to reuse its memory. */
+        std::vector<std::uint8_t> chunkRequest_;
     };
 }
@@ -39,20 +39,76 @@ namespace viscom {
             gl::glVertexAttribPointer(attribLoc[2], 2, gl::GL_FLOAT, gl::GL_FALSE, sizeof(SimpleMeshVertex), reinterpret_cast<GLvoid*>(offsetof(SimpleMeshVertex, texCoords_)));
         }
 
-        static GLuint CreateVertexBuffer(const Mesh* mesh)
+        static std::vector<SimpleMeshVertex> CreateVertices(const Mesh* mesh)
         {
-            GLuint vbo = 0;
-            gl::glGenBuffers(1, &vbo);
             std::vector<SimpleMeshVertex> bufferMem(mesh->GetVertices().size());
             for (auto i = 0U; i < mesh->GetVertices().size(); ++i) {
                 bufferMem[i].position_ = mesh->GetVertices()[i];
                 bufferMem[i].normal_ = mesh->GetNormals()[i];
                 bufferMem[i].texCoords_ = glm::vec2(mesh->GetTexCoords(0)[i]);
             }
+            return bufferMem;
+        }
+
+        static GLuint CreateVertexBuffer(const Mesh* mesh)
+        {
+            GLuint vbo = 0;
+            gl::glGenBuffers(1, &vbo);
+            auto bufferMem = CreateVertices(mesh);
             gl::glBindBuffer(gl::GL_ARRAY_BUFFER, vbo);
             gl::glBufferData(gl::GL_ARRAY_BUFFER, bufferMem.size() * sizeof(SimpleMeshVertex), bufferMem.data(), gl::GL_STATIC_DRAW);
             gl::glBindBuffer(gl::GL_ARRAY_BUFFER, 0);
             return vbo;
         }
     };
+
+    struct PointVertex
+    {
+        glm::vec3 position_;
+        glm::u8vec4 color_;
+
+        PointVertex() : position_(0.0f), color_(0) {}
+        PointVertex(const glm::vec3& pos, const glm::u8vec4& col) : position_(pos), color_(col) {}
+        static void SetVertexAttributes(GLint positionLoc, GLint colorLoc)
+        {
+            gl::glEnableVertexAttribArray(positionLoc);
+            gl::glVertexAttribPointer(positionLoc, 3, gl::GL_FLOAT, gl::GL_FALSE, sizeof(PointVertex), reinterpret_cast<GLvoid*>(offsetof(PointVertex, position_)));
+            gl::glEnableVertexAttribArray(colorLoc);
+            gl::glVertexAttribPointer(colorLoc, 4, gl::GL_UNSIGNED_BYTE, gl::GL_TRUE, sizeof(PointVertex), reinterpret_cast<GLvoid*>(offsetof(PointVertex, color_)));
+        }
+    };
+
+    struct CompactPointVertex
+    {
+        glm::u16vec3 position_;
+        std::uint16_t padding_;
+        glm::u8vec4 color_;
+
+        CompactPointVertex() : position_(0), padding_(0), color_(0) {}
+        CompactPointVertex(const glm::u16vec3& pos, const glm::u8vec4& col) : position_(pos), padding_(0), color_(col) {}
+        static void SetVertexAttributes(GLint positionLoc, GLint colorLoc)
+        {
+            gl::glEnableVertexAttribArray(positionLoc);
+            gl::glVertexAttribPointer(positionLoc, 3, gl::GL_UNSIGNED_SHORT, gl::GL_TRUE, sizeof(CompactPointVertex), reinterpret_cast<GLvoid*>(offsetof(CompactPointVertex, position_)));
+            gl::glEnableVertexAttribArray(colorLoc);
+            gl::glVertexAttribPointer(colorLoc, 4, gl::GL_UNSIGNED_BYTE, gl::GL_TRUE, sizeof(CompactPointVertex), reinterpret_cast<GLvoid*>(offsetof(CompactPointVertex, color_)));
+        }
+    };
+
+    /** The columns of a columnar point cloud, each attribute comes from its own tightly packed buffer. */
+    struct ColumnarPointVertex
+    {
+        static void SetPositionAttribute(GLint positionLoc)
+        {
+            gl::glEnableVertexAttribArray(positionLoc);
+            gl::glVertexAttribPointer(positionLoc, 3, gl::GL_UNSIGNED_SHORT, gl::GL_TRUE, sizeof(glm::u16vec3), nullptr);
+        }
+
+        /** Scalar attributes arrive in the first component of the color, the others are (0, 0, 1). */
+        static void SetColorAttribute(GLint colorLoc, GLint components, gl::GLenum type, gl::GLboolean normalized)
+        {
+            gl::glEnableVertexAttribArray(colorLoc);
+            gl::glVertexAttribPointer(colorLoc, components, type, normalized, 0, nullptr);
+        }
+    };
 }
@@ -0,0 +1,421 @@
+/**
+ * @file   ChunkDistribution.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the distribution of point cloud chunks from the master to the slaves.
+ */
+
+#include "ChunkDistribution.h"
+#include "../Hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace viscom {
+
+    namespace {
+        void MakeDirectory(const std::string& directory)
+        {
+            // fails if the directory exists, other errors show up when the cache files are written.
+#ifdef _WIN32
+            _mkdir(directory.c_str());
+#else
+            mkdir(directory.c_str(), 0755);
+#endif
+        }
+    }
+
+    /**
+     *  Creates the server for a file.
+     *  @param file the point cloud file, it has to outlive the server.
+     *  @param maxMessageSize the maximum number of bytes of data per message, larger chunks are split.
+     */
+    ChunkServer::ChunkServer(const PointCloudFile& file, std::size_t maxMessageSize) :
+        file_{ file },
+        maxMessageSize_{ std::max<std::size_t>(maxMessageSize, 1) }
+    {
+        auto nodeTableSize = static_cast<std::size_t>(file_.GetNumNodes()) * sizeof(PointCloudNodeRecord);
+        manifest_.resize(sizeof(PointCloudFileHeader) + nodeTableSize);
+        std::memcpy(manifest_.data(), &file_.GetHeader(), sizeof(PointCloudFileHeader));
+        std::memcpy(manifest_.data() + sizeof(PointCloudFileHeader), file_.GetNodes(), nodeTableSize);
+        // 0 marks a replica without manifest.
+        datasetId_ = std::max<std::uint64_t>(HashFNV1a(manifest_.data(), manifest_.size()), 1);
+    }
+
+    /**
+     *  Handles a request of a slave, can be called from any thread.
+     *  @param clientID the id of the slave.
+     *  @param data the request.
+     *  @param size the size of the request in bytes.
+     *  @return whether the request was valid.
+     */
+    bool ChunkServer::Receive(int clientID, const void* data, std::size_t size)
+    {
+        ChunkRequestHeader header;
+        if (size < sizeof(ChunkRequestHeader)) return false;
+        std::memcpy(&header, data, sizeof(ChunkRequestHeader));
+
+        std::lock_guard<std::mutex> lock{ mutex_ };
+        auto& client = clients_[clientID];
+        if (header.type_ == ChunkMessageType::Manifest) {
+            // a slave asking for the manifest starts over (e.g. after a restart), its cache decides what it requests.
+            client.manifestRequested_ = true;
+            client.pending_.clear();
+            client.sent_.assign(file_.GetNumNodes(), false);
+            return true;
+        }
+
+        if (header.type_ != ChunkMessageType::Chunk || header.datasetId_ != datasetId_
+            || size != sizeof(ChunkRequestHeader) + static_cast<std::size_t>(header.numNodes_) * sizeof(std::uint32_t)) return false;
+        if (client.sent_.empty()) client.sent_.assign(file_.GetNumNodes(), false);
+
+        auto nodes = static_cast<const std::uint8_t*>(data) + sizeof(ChunkRequestHeader);
+        client.pending_.clear();
+        for (std::uint32_t i = 0; i < header.numNodes_; ++i) {
+            std::uint32_t nodeIndex;
+            std::memcpy(&nodeIndex, nodes + i * sizeof(std::uint32_t), sizeof(std::uint32_t));
+            if (nodeIndex >= file_.GetNumNodes() || file_.GetNode(nodeIndex).numPoints_ == 0 || client.sent_[nodeIndex]) continue;
+            client.pending_.push_back(nodeIndex);
+        }
+        return true;
+    }
+
+    /**
+     *  Sends manifests and requested chunks until a byte budget is used up, at least one chunk is sent per call so
+     *  large chunks do not starve. Slaves take turns, and each chunk read goes to every slave that requested it.
+     *  @param byteBudget the number of bytes to send.
+     *  @param send the function sending a message to a slave.
+     *  @return the number of bytes sent.
+     */
+    std::uint64_t ChunkServer::Send(std::uint64_t byteBudget, const SendFunction& send)
+    {
+        std::lock_guard<std::mutex> lock{ mutex_ };
+        std::uint64_t sentBytes = 0;
+        std::vector<int> clientIDs;
+        for (auto& client : clients_) {
+            if (!client.second.manifestRequested_) continue;
+            clientIDs.assign(1, client.first);
+            sentBytes += SendData(ChunkMessageType::Manifest, 0, manifest_.data(), manifest_.size(), clientIDs, send);
+            client.second.manifestRequested_ = false;
+            ++statistics_.numSentManifests_;
+        }
+
+        std::vector<int> order;
+        for (const auto& client : clients_) order.push_back(client.first);
+        std::rotate(order.begin(), std::lower_bound(order.begin(), order.end(), nextClientID_), order.end());
+
+        auto sentChunk = true;
+        auto firstChunk = true;
+        while (sentChunk && (firstChunk || sentBytes < byteBudget)) {
+            sentChunk = false;
+            for (auto clientID : order) {
+                if (!firstChunk && sentBytes >= byteBudget) break;
+                auto& pending = clients_[clientID].pending_;
+                // chunks sent to other slaves in the meantime went to this one as well.
+                auto& sent = clients_[clientID].sent_;
+                pending.erase(pending.begin(), std::find_if(pending.begin(), pending.end(), [&sent](std::uint32_t nodeIndex) { return !sent[nodeIndex]; }));
+                if (pending.empty()) continue;
+
+                auto nodeIndex = pending.front();
+                clientIDs.clear();
+                for (auto& other : clients_) {
+                    auto& otherPending = other.second.pending_;
+                    auto position = std::find(otherPending.begin(), otherPending.end(), nodeIndex);
+                    if (position == otherPending.end()) continue;
+                    otherPending.erase(position);
+                    other.second.sent_[nodeIndex] = true;
+                    clientIDs.push_back(other.first);
+                }
+                sentBytes += SendData(ChunkMessageType::Chunk, nodeIndex, static_cast<const std::uint8_t*>(file_.GetNodeData(nodeIndex)),
+                    file_.GetNodeDataSize(nodeIndex), clientIDs, send);
+                ++statistics_.numReadChunks_;
+                statistics_.numSentChunks_ += clientIDs.size();
+                nextClientID_ = clientID + 1;
+                sentChunk = true;
+                firstChunk = false;
+            }
+        }
+        return sentBytes;
+    }
+
+    ChunkServerStatistics ChunkServer::GetStatistics() const
+    {
+        std::lock_guard<std::mutex> lock{ mutex_ };
+        auto statistics = statistics_;
+        statistics.numClients_ = clients_.size();
+        statistics.numPendingChunks_ = 0;
+        for (const auto& client : clients_) statistics.numPendingChunks_ += client.second.pending_.size();
+        return statistics;
+    }
+
+    /**
+     *  Sends data to slaves, split into messages of at most the maximum message size.
+     *  @param type the kind of data.
+     *  @param nodeIndex the node of a chunk.
+     *  @param data the data.
+     *  @param size the size of the data in bytes.
+     *  @param clientIDs the slaves receiving the data.
+     *  @param send the function sending a message to a slave.
+     *  @return the number of bytes sent to all slaves.
+     */
+    std::uint64_t ChunkServer::SendData(ChunkMessageType type, std::uint32_t nodeIndex, const std::uint8_t* data, std::size_t size,
+        const std::vector<int>& clientIDs, const SendFunction& send)
+    {
+        std::uint64_t sentBytes = 0;
+        std::size_t offset = 0;
+        do {
+            auto partSize = std::min(maxMessageSize_, size - offset);
+            ChunkDataHeader header{ type, nodeIndex, datasetId_, offset, size };
+            message_.resize(sizeof(ChunkDataHeader) + partSize);
+            std::memcpy(message_.data(), &header, sizeof(ChunkDataHeader));
+            std::memcpy(message_.data() + sizeof(ChunkDataHeader), data + offset, partSize);
+            for (auto clientID : clientIDs) send(clientID, message_);
+            sentBytes += message_.size() * clientIDs.size();
+            offset += partSize;
+        } while (offset < size);
+        statistics_.sentBytes_ += sentBytes;
+        return sentBytes;
+    }
+
+    /**
+     *  Creates an empty replica.
+     *  @param cacheDirectory the directory of the cached files, it is created if needed.
+     */
+    ChunkReplica::ChunkReplica(const std::string& cacheDirectory) :
+        cacheDirectory_{ cacheDirectory }
+    {
+        MakeDirectory(cacheDirectory_);
+    }
+
+    /** Returns the request for the manifest, sent until the manifest arrives. */
+    std::vector<std::uint8_t> ChunkReplica::CreateManifestRequest()
+    {
+        ChunkRequestHeader header{ ChunkMessageType::Manifest, 0, 0 };
+        std::vector<std::uint8_t> message(sizeof(ChunkRequestHeader));
+        std::memcpy(message.data(), &header, sizeof(ChunkRequestHeader));
+        return message;
+    }
+
+    /**
+     *  Queues a message of the master, can be called from any thread.
+     *  @param data the message.
+     *  @param size the size of the message in bytes.
+     */
+    void ChunkReplica::Receive(const void* data, std::size_t size)
+    {
+        auto bytes = static_cast<const std::uint8_t*>(data);
+        std::lock_guard<std::mutex> lock{ inboxMutex_ };
+        inbox_.emplace_back(bytes, bytes + size);
+    }
+
+    /**
+     *  Writes the received data to disk. Invalid messages are dropped, an exception is thrown if the manifest is
+     *  corrupt or the cache cannot be written.
+     */
+    void ChunkReplica::Update()
+    {
+        messages_.clear();
+        {
+            std::lock_guard<std::mutex> lock{ inboxMutex_ };
+            std::swap(messages_, inbox_);
+        }
+
+        for (const auto& message : messages_) {
+            ChunkDataHeader header;
+            if (message.size() < sizeof(ChunkDataHeader)) continue;
+            std::memcpy(&header, message.data(), sizeof(ChunkDataHeader));
+            statistics_.receivedBytes_ += message.size();
+            auto data = message.data() + sizeof(ChunkDataHeader);
+            auto size = message.size() - sizeof(ChunkDataHeader);
+            if (header.offset_ > header.totalSize_ || size > header.totalSize_ - header.offset_) continue;
+            if (header.type_ == ChunkMessageType::Manifest) ReceiveManifest(header, data, size);
+            else if (header.type_ == ChunkMessageType::Chunk) ReceiveChunk(header, data, size);
+        }
+    }
+
+    /**
+     *  Sets the chunks needed next, called with the nodes selected but not available.
+     *  @param requests the chunks with their priority, higher priorities are requested first.
+     */
+    void ChunkReplica::Request(const std::vector<NodeLoadRequest>& requests)
+    {
+        std::vector<NodeLoadRequest> missing;
+        for (const auto& request : requests) if (!IsAvailable(request.nodeIndex_)) missing.push_back(request);
+        std::stable_sort(missing.begin(), missing.end(), [](const NodeLoadRequest& a, const NodeLoadRequest& b) { return b < a; });
+        if (missing.size() > MAX_REQUESTED_CHUNKS) missing.resize(MAX_REQUESTED_CHUNKS);
+
+        requested_.clear();
+        for (const auto& request : missing) requested_.push_back(request.nodeIndex_);
+    }
+
+    /**
+     *  Creates the request of the chunks set by Request(), if it changed since the last one.
+     *  @param message the request.
+     *  @return whether a request needs to be sent.
+     */
+    bool ChunkReplica::CreateChunkRequest(std::vector<std::uint8_t>& message)
+    {
+        if (!IsReady() || requested_ == lastRequested_) return false;
+        lastRequested_ = requested_;
+        statistics_.numRequestedChunks_ = static_cast<std::uint32_t>(requested_.size());
+
+        ChunkRequestHeader header{ ChunkMessageType::Chunk, static_cast<std::uint32_t>(requested_.size()), datasetId_ };
+        message.resize(sizeof(ChunkRequestHeader) + requested_.size() * sizeof(std::uint32_t));
+        std::memcpy(message.data(), &header, sizeof(ChunkRequestHeader));
+        if (!requested_.empty()) std::memcpy(message.data() + sizeof(ChunkRequestHeader), requested_.data(), requested_.size() * sizeof(std::uint32_t));
+        return true;
+    }
+
+    /**
+     *  Adds a received part, parts are sent again when a request is repeated.
+     *  @param offset the offset of the part.
+     *  @param size the size of the part.
+     *  @return the number of bytes not received before.
+     */
+    std::uint64_t ChunkReplica::ReceivedParts::Add(std::uint64_t offset, std::uint64_t size)
+    {
+        auto begin = offset, end = offset + size;
+        if (begin == end) return 0;
+        // merges all ranges overlapping or touching the part, starting with the last one that starts before it.
+        auto range = ranges_.upper_bound(begin);
+        if (range != ranges_.begin() && std::prev(range)->second >= begin) --range;
+        std::uint64_t numOld = 0;
+        while (range != ranges_.end() && range->first <= end) {
+            if (range->second > offset && range->first < offset + size) numOld += std::min(range->second, offset + size) - std::max(range->first, offset);
+            begin = std::min(begin, range->first);
+            end = std::max(end, range->second);
+            range = ranges_.erase(range);
+        }
+        ranges_.emplace(begin, end);
+        numBytes_ += size - numOld;
+        return size - numOld;
+    }
+
+    void ChunkReplica::ReceiveManifest(const ChunkDataHeader& header, const std::uint8_t* data, std::size_t size)
+    {
+        // the dataset cannot change while the local file is open.
+        if (IsReady()) return;
+        if (header.datasetId_ != datasetId_ || manifest_.size() != header.totalSize_) {
+            datasetId_ = header.datasetId_;
+            manifest_.assign(static_cast<std::size_t>(header.totalSize_), 0);
+            manifestReceived_ = ReceivedParts{};
+        }
+        std::memcpy(manifest_.data() + header.offset_, data, size);
+        manifestReceived_.Add(header.offset_, size);
+        if (manifestReceived_.numBytes_ < manifest_.size()) return;
+
+        if (std::max<std::uint64_t>(HashFNV1a(manifest_.data(), manifest_.size()), 1) != datasetId_) {
+            datasetId_ = 0;
+            manifest_.clear();
+            throw std::runtime_error("The point cloud manifest received from the master is corrupt.");
+        }
+        std::memcpy(&header_, manifest_.data(), std::min(sizeof(PointCloudFileHeader), manifest_.size()));
+        auto nodeTableSize = static_cast<std::size_t>(header_.numNodes_) * sizeof(PointCloudNodeRecord);
+        if (manifest_.size() != sizeof(PointCloudFileHeader) + nodeTableSize || header_.magic_ != POINTCLOUD_MAGIC
+            || header_.nodeTableOffset_ < sizeof(PointCloudFileHeader)) {
+            datasetId_ = 0;
+            manifest_.clear();
+            throw std::runtime_error("The point cloud manifest received from the master is not a point cloud file.");
+        }
+        nodes_.resize(header_.numNodes_);
+        std::memcpy(nodes_.data(), manifest_.data() + sizeof(PointCloudFileHeader), nodeTableSize);
+        OpenCache();
+        manifest_ = std::vector<std::uint8_t>();
+    }
+
+    void ChunkReplica::ReceiveChunk(const ChunkDataHeader& header, const std::uint8_t* data, std::size_t size)
+    {
+        if (!IsReady() || header.datasetId_ != datasetId_ || header.nodeIndex_ >= nodes_.size() || available_[header.nodeIndex_] != 0) return;
+        const auto& node = nodes_[header.nodeIndex_];
+        if (header.totalSize_ != GetNodeChunkSize(header_, node.numPoints_)) return;
+
+        file_.seekp(static_cast<std::streamoff>(node.dataOffset_ + header.offset_));
+        file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        auto& received = partialChunks_[header.nodeIndex_];
+        received.Add(header.offset_, size);
+        if (received.numBytes_ < header.totalSize_) return;
+        partialChunks_.erase(header.nodeIndex_);
+
+        // the chunk is only listed once its data is written, so an interrupted write is requested again.
+        file_.flush();
+        chunkList_.seekp(static_cast<std::streamoff>(header.nodeIndex_));
+        chunkList_.put(1);
+        chunkList_.flush();
+        if (!file_ || !chunkList_) throw std::runtime_error("Could not write chunk " + std::to_string(header.nodeIndex_) + " to \"" + filename_ + "\".");
+        available_[header.nodeIndex_] = 1;
+        ++statistics_.numReceivedChunks_;
+        ++statistics_.numAvailableChunks_;
+    }
+
+    /**
+     *  Opens the cached copy of the dataset, or creates it with the manifest in place and no chunks. The copy is
+     *  as large as the original file, the missing chunks are holes in it.
+     */
+    void ChunkReplica::OpenCache()
+    {
+        std::ostringstream baseName;
+        baseName << cacheDirectory_ << "/" << std::hex << std::setw(16) << std::setfill('0') << datasetId_;
+        auto dataFilename = baseName.str() + ".vpc";
+        auto listFilename = baseName.str() + ".chunks";
+        auto nodeTableSize = nodes_.size() * sizeof(PointCloudNodeRecord);
+        auto fileSize = header_.nodeTableOffset_ + nodeTableSize;
+
+        available_.assign(nodes_.size(), 0);
+        auto reused = false;
+        {
+            std::ifstream data{ dataFilename, std::ios::binary | std::ios::ate };
+            std::ifstream list{ listFilename, std::ios::binary | std::ios::ate };
+            if (data && list && static_cast<std::uint64_t>(data.tellg()) == fileSize && static_cast<std::uint64_t>(list.tellg()) == nodes_.size()) {
+                // files of other datasets could have the same name, so the manifest has to match as well.
+                std::vector<std::uint8_t> header(sizeof(PointCloudFileHeader)), nodeTable(nodeTableSize);
+                data.seekg(0);
+                data.read(reinterpret_cast<char*>(header.data()), static_cast<std::streamsize>(header.size()));
+                data.seekg(static_cast<std::streamoff>(header_.nodeTableOffset_));
+                data.read(reinterpret_cast<char*>(nodeTable.data()), static_cast<std::streamsize>(nodeTable.size()));
+                list.seekg(0);
+                list.read(reinterpret_cast<char*>(available_.data()), static_cast<std::streamsize>(available_.size()));
+                reused = data && list && std::memcmp(header.data(), &header_, header.size()) == 0 && std::memcmp(nodeTable.data(), nodes_.data(), nodeTableSize) == 0;
+            }
+        }
+
+        if (!reused) {
+            available_.assign(nodes_.size(), 0);
+            std::ofstream data{ dataFilename, std::ios::binary | std::ios::trunc };
+            data.write(reinterpret_cast<const char*>(&header_), sizeof(PointCloudFileHeader));
+            data.seekp(static_cast<std::streamoff>(header_.nodeTableOffset_));
+            data.write(reinterpret_cast<const char*>(nodes_.data()), static_cast<std::streamsize>(nodeTableSize));
+            std::ofstream list{ listFilename, std::ios::binary | std::ios::trunc };
+            list.write(reinterpret_cast<const char*>(available_.data()), static_cast<std::streamsize>(available_.size()));
+            if (!data || !list) throw std::runtime_error("Could not create the chunk cache \"" + dataFilename + "\".");
+        }
+
+        file_.open(dataFilename, std::ios::binary | std::ios::in | std::ios::out);
+        chunkList_.open(listFilename, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file_ || !chunkList_) throw std::runtime_error("Could not open the chunk cache \"" + dataFilename + "\".");
+
+        statistics_.numChunks_ = statistics_.numCachedChunks_ = statistics_.numAvailableChunks_ = 0;
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            // empty nodes have no chunk to wait for.
+            if (nodes_[i].numPoints_ == 0) {
+                available_[i] = 1;
+                continue;
+            }
+            ++statistics_.numChunks_;
+            available_[i] = available_[i] != 0 ? 1 : 0;
+            statistics_.numCachedChunks_ += available_[i];
+        }
+        statistics_.numAvailableChunks_ = statistics_.numCachedChunks_;
+        filename_ = dataFilename;
+    }
+}
@@ -0,0 +1,234 @@
+/**
+ * @file   ChunkDistribution.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the distribution of point cloud chunks from the master to the slaves.
+ */
+
+#pragma once
+
+#include "NodeLoader.h"
+#include "PointCloudFile.h"
+
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace viscom {
+
+    /** The id of the packages with chunk requests sent from a slave to the master. */
+    constexpr std::uint16_t CHUNK_REQUEST_PACKAGE_ID = 0x5052;
+    /** The id of the packages with chunk data sent from the master to a slave. */
+    constexpr std::uint16_t CHUNK_DATA_PACKAGE_ID = 0x5044;
+
+    /** The kinds of data distributed. */
+    enum class ChunkMessageType : std::uint32_t
+    {
+        /** The file header followed by the node table. */
+        Manifest = 0,
+        /** The points of a node. */
+        Chunk = 1
+    };
+
+    /** The start of a request, followed by the requested node indices (chunk requests only). */
+    struct ChunkRequestHeader
+    {
+        /** The kind of data requested, a manifest request starts the distribution to the slave over. */
+        ChunkMessageType type_;
+        /** The number of requested nodes, most important first. */
+        std::uint32_t numNodes_;
+        /** The id of the dataset the nodes belong to. */
+        std::uint64_t datasetId_;
+    };
+
+    /** The start of a data message, followed by a part of the manifest or a chunk. */
+    struct ChunkDataHeader
+    {
+        /** The kind of data. */
+        ChunkMessageType type_;
+        /** The node of a chunk. */
+        std::uint32_t nodeIndex_;
+        /** The id of the dataset. */
+        std::uint64_t datasetId_;
+        /** The offset of the part in the manifest or chunk. */
+        std::uint64_t offset_;
+        /** The size of the whole manifest or chunk. */
+        std::uint64_t totalSize_;
+    };
+
+    /** Statistics of the chunk server. */
+    struct ChunkServerStatistics
+    {
+        /** The number of bytes sent, including message headers. */
+        std::uint64_t sentBytes_ = 0;
+        /** The number of chunks sent, counted once per slave. */
+        std::uint64_t numSentChunks_ = 0;
+        /** The number of chunks read from the file. */
+        std::uint64_t numReadChunks_ = 0;
+        /** The number of manifests sent. */
+        std::uint64_t numSentManifests_ = 0;
+        /** The number of requested chunks not sent yet. */
+        std::size_t numPendingChunks_ = 0;
+        /** The number of slaves that requested data. */
+        std::size_t numClients_ = 0;
+    };
+
+    /**
+     *  Serves the chunks of a point cloud file to the slaves of a cluster, so only the master needs the file. Each
+     *  slave requests the chunks its own views need, most important first, and replaces its request whenever its
+     *  selection changes. Every frame the server sends chunks up to a byte budget, taking turns between the slaves.
+     *  A chunk is read once and sent to every slave that requested it (a fan-out like a multicast), and the server
+     *  remembers what each slave has received, so requests for chunks still on their way are ignored.
+     */
+    class ChunkServer
+    {
+    public:
+        /** Sends a message to a slave. */
+        using SendFunction = std::function<void(int clientID, const std::vector<std::uint8_t>& message)>;
+
+        explicit ChunkServer(const PointCloudFile& file, std::size_t maxMessageSize = 4 << 20);
+
+        bool Receive(int clientID, const void* data, std::size_t size);
+        std::uint64_t Send(std::uint64_t byteBudget, const SendFunction& send);
+
+        /** Returns the id of the dataset, a hash of the manifest. */
+        std::uint64_t GetDatasetId() const { return datasetId_; }
+        ChunkServerStatistics GetStatistics() const;
+
+    private:
+        /** The distribution state of a slave. */
+        struct Client
+        {
+            /** Holds whether the slave waits for the manifest. */
+            bool manifestRequested_ = false;
+            /** Holds the requested chunks not sent yet, most important first. */
+            std::vector<std::uint32_t> pending_;
+            /** Holds whether each chunk was sent to the slave. */
+            std::vector<bool> sent_;
+        };
+
+        std::uint64_t SendData(ChunkMessageType type, std::uint32_t nodeIndex, const std::uint8_t* data, std::size_t size,
+            const std::vector<int>& clientIDs, const SendFunction& send);
+
+        /** Holds the point cloud file. */
+        const PointCloudFile& file_;
+        /** Holds the maximum size of the data in a message, larger chunks are split. */
+        std::size_t maxMessageSize_;
+        /** Holds the manifest (file header and node table). */
+        std::vector<std::uint8_t> manifest_;
+        /** Holds the id of the dataset. */
+        std::uint64_t datasetId_;
+        /** Holds the state of each slave. */
+        std::map<int, Client> clients_;
+        /** Holds the slave served first in the next frame. */
+        int nextClientID_ = 0;
+        /** Holds the message currently sent, kept to reuse its memory. */
+        std::vector<std::uint8_t> message_;
+        /** Holds the statistics. */
+        ChunkServerStatistics statistics_;
+        /** Synchronizes requests arriving on the network thread with sending. */
+        mutable std::mutex mutex_;
+    };
+
+    /** Statistics of a chunk replica. */
+    struct ChunkReplicaStatistics
+    {
+        /** The number of bytes received, including message headers. */
+        std::uint64_t receivedBytes_ = 0;
+        /** The number of chunks received. */
+        std::uint32_t numReceivedChunks_ = 0;
+        /** The number of chunks already in the cache when the manifest arrived. */
+        std::uint32_t numCachedChunks_ = 0;
+        /** The number of chunks on disk. */
+        std::uint32_t numAvailableChunks_ = 0;
+        /** The number of chunks of the dataset (nodes with points). */
+        std::uint32_t numChunks_ = 0;
+        /** The number of chunks in the last request. */
+        std::uint32_t numRequestedChunks_ = 0;
+    };
+
+    /**
+     *  The local copy of a point cloud file on a slave, filled with the chunks sent by the master. The copy has the
+     *  layout of the original file, so it is opened like any point cloud file, and is kept in a cache directory
+     *  under the id of the dataset together with a list of the chunks it holds. Restarting a slave only requests
+     *  the chunks missing in its cache. Messages can arrive on any thread, they are written to disk by Update().
+     */
+    class ChunkReplica
+    {
+    public:
+        explicit ChunkReplica(const std::string& cacheDirectory);
+
+        static std::vector<std::uint8_t> CreateManifestRequest();
+        void Receive(const void* data, std::size_t size);
+        void Update();
+        void Request(const std::vector<NodeLoadRequest>& requests);
+        bool CreateChunkRequest(std::vector<std::uint8_t>& message);
+
+        /** Returns whether the manifest arrived and the local file can be opened. */
+        bool IsReady() const { return !filename_.empty(); }
+        /** Returns the name of the local file (empty until the manifest arrived). */
+        const std::string& GetFilename() const { return filename_; }
+        /** Returns whether the chunk of a node is on disk. */
+        bool IsAvailable(std::uint32_t nodeIndex) const { return nodeIndex < available_.size() && available_[nodeIndex] != 0; }
+        /** Returns the statistics. */
+        const ChunkReplicaStatistics& GetStatistics() const { return statistics_; }
+
+    private:
+        /** The maximum number of chunks requested at once, the most important ones. */
+        static constexpr std::size_t MAX_REQUESTED_CHUNKS = 256;
+
+        /** The parts of a manifest or chunk received so far, parts sent again are only counted once. */
+        struct ReceivedParts
+        {
+            std::uint64_t Add(std::uint64_t offset, std::uint64_t size);
+
+            /** Holds the received byte ranges, the end of each range by its start, ranges do not touch. */
+            std::map<std::uint64_t, std::uint64_t> ranges_;
+            /** Holds the number of bytes received. */
+            std::uint64_t numBytes_ = 0;
+        };
+
+        void ReceiveManifest(const ChunkDataHeader& header, const std::uint8_t* data, std::size_t size);
+        void ReceiveChunk(const ChunkDataHeader& header, const std::uint8_t* data, std::size_t size);
+        void OpenCache();
+
+        /** Holds the directory of the cached files. */
+        std::string cacheDirectory_;
+        /** Holds the messages received but not processed yet. */
+        std::vector<std::vector<std::uint8_t>> inbox_;
+        /** Synchronizes the received messages. */
+        std::mutex inboxMutex_;
+        /** Holds the messages processed by Update(), kept to reuse their memory. */
+        std::vector<std::vector<std::uint8_t>> messages_;
+        /** Holds the id of the dataset (0 until the manifest arrived). */
+        std::uint64_t datasetId_ = 0;
+        /** Holds the manifest while it arrives. */
+        std::vector<std::uint8_t> manifest_;
+        /** Holds the parts of the manifest received. */
+        ReceivedParts manifestReceived_;
+        /** Holds the header of the dataset. */
+        PointCloudFileHeader header_;
+        /** Holds the node table of the dataset. */
+        std::vector<PointCloudNodeRecord> nodes_;
+        /** Holds the name of the local file. */
+        std::string filename_;
+        /** Holds the local file. */
+        std::fstream file_;
+        /** Holds the list of chunks in the local file, one byte per node. */
+        std::fstream chunkList_;
+        /** Holds whether each chunk is on disk. */
+        std::vector<std::uint8_t> available_;
+        /** Holds the parts received of chunks split into several messages. */
+        std::map<std::uint32_t, ReceivedParts> partialChunks_;
+        /** Holds the chunks to request, most important first. */
+        std::vector<std::uint32_t> requested_;
+        /** Holds the chunks of the last request sent. */
+        std::vector<std::uint32_t> lastRequested_;
+        /** Holds the statistics. */
+        ChunkReplicaStatistics statistics_;
+    };
+}
@@ -0,0 +1,176 @@
+/**
+ * @file   DepthPyramid.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the hierarchical depth buffer for occlusion culling.
+ */
+
+#include "DepthPyramid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace viscom {
+
+    /**
+     *  Builds the pyramid from a depth buffer.
+     *  @param depths the window depths, rows bottom to top.
+     *  @param width the width of the depth buffer.
+     *  @param height the height of the depth buffer.
+     *  @param viewProjection the view projection matrix the depths were drawn with.
+     */
+    void DepthPyramid::Build(const float* depths, unsigned width, unsigned height, const glm::mat4& viewProjection)
+    {
+        viewProjection_ = viewProjection;
+        levels_.clear();
+        widths_.clear();
+        heights_.clear();
+        if (width == 0 || height == 0) return;
+
+        levels_.emplace_back(depths, depths + static_cast<std::size_t>(width) * height);
+        widths_.push_back(width);
+        heights_.push_back(height);
+        while (widths_.back() > 1 || heights_.back() > 1) {
+            auto sourceWidth = widths_.back(), sourceHeight = heights_.back();
+            auto levelWidth = (sourceWidth + 1) / 2, levelHeight = (sourceHeight + 1) / 2;
+            std::vector<float> level(static_cast<std::size_t>(levelWidth) * levelHeight);
+            const auto& source = levels_.back();
+            for (auto y = 0U; y < levelHeight; ++y) {
+                // odd sizes repeat the last row or column, so each texel covers the same pixels as with even sizes.
+                auto y0 = 2 * y, y1 = std::min(2 * y + 1, sourceHeight - 1);
+                for (auto x = 0U; x < levelWidth; ++x) {
+                    auto x0 = 2 * x, x1 = std::min(2 * x + 1, sourceWidth - 1);
+                    level[static_cast<std::size_t>(y) * levelWidth + x] = std::max(std::max(source[y0 * sourceWidth + x0], source[y0 * sourceWidth + x1]),
+                        std::max(source[y1 * sourceWidth + x0], source[y1 * sourceWidth + x1]));
+                }
+            }
+            levels_.push_back(std::move(level));
+            widths_.push_back(levelWidth);
+            heights_.push_back(levelHeight);
+        }
+    }
+
+    /**
+     *  Builds the pyramid from a depth buffer of an earlier frame, moved to the current view.
+     *  @param depths the window depths, rows bottom to top.
+     *  @param width the width of the depth buffer.
+     *  @param height the height of the depth buffer.
+     *  @param depthViewProjection the view projection matrix the depths were drawn with.
+     *  @param viewProjection the view projection matrix of the current view.
+     */
+    void DepthPyramid::Reproject(const float* depths, unsigned width, unsigned height, const glm::mat4& depthViewProjection, const glm::mat4& viewProjection)
+    {
+        if (std::memcmp(&depthViewProjection, &viewProjection, sizeof(glm::mat4)) == 0) {
+            Build(depths, width, height, viewProjection);
+            return;
+        }
+
+        // texels are moved from the clip space of the depths to the current clip space in a single step.
+        auto clipToClip = glm::dmat4(viewProjection) * glm::inverse(glm::dmat4(depthViewProjection));
+        reprojected_.assign(static_cast<std::size_t>(width) * height, -1.0f);
+        for (auto y = 0U; y < height; ++y) {
+            for (auto x = 0U; x < width; ++x) {
+                auto depth = depths[static_cast<std::size_t>(y) * width + x];
+                if (depth >= 1.0f) continue;
+
+                glm::dvec4 ndc{ (x + 0.5) / width * 2.0 - 1.0, (y + 0.5) / height * 2.0 - 1.0, 2.0 * depth - 1.0, 1.0 };
+                auto clip = clipToClip * ndc;
+                if (clip.w <= 1e-9) continue;
+                auto screenX = (0.5 * clip.x / clip.w + 0.5) * width, screenY = (0.5 * clip.y / clip.w + 0.5) * height;
+                auto reprojectedDepth = static_cast<float>(0.5 * clip.z / clip.w + 0.5);
+                if (screenX < 0.0 || screenY < 0.0 || screenX >= width || screenY >= height || reprojectedDepth < 0.0f) continue;
+
+                auto& texel = reprojected_[static_cast<std::size_t>(screenY) * width + static_cast<std::size_t>(screenX)];
+                texel = std::max(texel, std::min(reprojectedDepth, 1.0f));
+            }
+        }
+        for (auto& texel : reprojected_) if (texel < 0.0f) texel = 1.0f;
+        Build(reprojected_.data(), width, height, viewProjection);
+    }
+
+    /**
+     *  Tests whether a box is behind the depths on the coarsest level it covers at most 2x2 texels of.
+     *  @param boxMin the minimum of the box.
+     *  @param boxMax the maximum of the box.
+     *  @return whether the box is occluded.
+     */
+    bool DepthPyramid::IsOccluded(const glm::vec3& boxMin, const glm::vec3& boxMax) const
+    {
+        glm::ivec4 rect;
+        auto minDepth = 0.0f;
+        if (!GetScreenBounds(boxMin, boxMax, rect, minDepth)) return false;
+
+        std::size_t level = 0;
+        while (level + 1 < levels_.size() && ((rect.z >> level) - (rect.x >> level) > 1 || (rect.w >> level) - (rect.y >> level) > 1)) ++level;
+        return minDepth > GetMaxDepth(level, glm::ivec4(rect.x >> level, rect.y >> level, rect.z >> level, rect.w >> level));
+    }
+
+    /**
+     *  Tests whether a box is behind the depths of all pixels it covers on the finest level, for testing IsOccluded.
+     *  @param boxMin the minimum of the box.
+     *  @param boxMax the maximum of the box.
+     *  @return whether the box is occluded.
+     */
+    bool DepthPyramid::IsOccludedReference(const glm::vec3& boxMin, const glm::vec3& boxMax) const
+    {
+        glm::ivec4 rect;
+        auto minDepth = 0.0f;
+        if (!GetScreenBounds(boxMin, boxMax, rect, minDepth)) return false;
+        return minDepth > GetMaxDepth(0, rect);
+    }
+
+    /**
+     *  Projects a box to the finest level.
+     *  @param boxMin the minimum of the box.
+     *  @param boxMax the maximum of the box.
+     *  @param rect the covered pixels (minimum x, y and maximum x, y, inclusive).
+     *  @param minDepth the nearest window depth of the box.
+     *  @return whether the box is on screen and in front of the camera, otherwise it cannot be tested.
+     */
+    bool DepthPyramid::GetScreenBounds(const glm::vec3& boxMin, const glm::vec3& boxMax, glm::ivec4& rect, float& minDepth) const
+    {
+        if (levels_.empty()) return false;
+
+        glm::vec3 ndcMin{ std::numeric_limits<float>::max() }, ndcMax{ -std::numeric_limits<float>::max() };
+        // the corners are the projected minimum plus the projected edges, which saves most of the multiplications.
+        auto minClip = viewProjection_ * glm::vec4(boxMin, 1.0f);
+        auto extent = boxMax - boxMin;
+        glm::vec4 edges[3] = { viewProjection_[0] * extent.x, viewProjection_[1] * extent.y, viewProjection_[2] * extent.z };
+        for (auto c = 0; c < 8; ++c) {
+            auto clip = minClip;
+            for (auto axis = 0; axis < 3; ++axis) if ((c & (4 >> axis)) != 0) clip += edges[axis];
+            // boxes reaching behind the camera cover an unbounded part of the screen.
+            if (clip.w <= 1e-6f) return false;
+            auto ndc = glm::vec3(clip) / clip.w;
+            ndcMin = glm::min(ndcMin, ndc);
+            ndcMax = glm::max(ndcMax, ndc);
+        }
+        if (ndcMax.x < -1.0f || ndcMax.y < -1.0f || ndcMin.x > 1.0f || ndcMin.y > 1.0f) return false;
+        minDepth = 0.5f * ndcMin.z + 0.5f;
+
+        auto width = static_cast<int>(widths_[0]), height = static_cast<int>(heights_[0]);
+        auto toPixel = [](float ndc, int size) { return std::min(static_cast<int>(std::floor((0.5f * glm::clamp(ndc, -1.0f, 1.0f) + 0.5f) * size)), size - 1); };
+        rect = glm::ivec4(toPixel(ndcMin.x, width), toPixel(ndcMin.y, height), toPixel(ndcMax.x, width), toPixel(ndcMax.y, height));
+        return true;
+    }
+
+    /**
+     *  Returns the farthest depth of a rectangle of texels.
+     *  @param level the level.
+     *  @param rect the texels (minimum x, y and maximum x, y, inclusive).
+     *  @return the farthest depth.
+     */
+    float DepthPyramid::GetMaxDepth(std::size_t level, const glm::ivec4& rect) const
+    {
+        const auto& depths = levels_[level];
+        auto width = static_cast<std::size_t>(widths_[level]);
+        auto maxDepth = 0.0f;
+        for (auto y = rect.y; y <= rect.w; ++y) {
+            for (auto x = rect.x; x <= rect.z; ++x) maxDepth = std::max(maxDepth, depths[static_cast<std::size_t>(y) * width + static_cast<std::size_t>(x)]);
+        }
+        return maxDepth;
+    }
+}
@@ -0,0 +1,71 @@
+/**
+ * @file   DepthPyramid.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the hierarchical depth buffer for occlusion culling.
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace viscom {
+
+    /** Statistics of the occlusion culling. */
+    struct OcclusionStatistics
+    {
+        /** The number of nodes tested. */
+        std::uint32_t numTestedNodes_ = 0;
+        /** The number of nodes found to be occluded. */
+        std::uint32_t numOccludedNodes_ = 0;
+        /** The number of points of the occluded nodes. */
+        std::uint64_t numOccludedPoints_ = 0;
+    };
+
+    /**
+     *  A pyramid of depth buffers, each level holds the farthest depth of 2x2 texels of the level below. A box is
+     *  occluded if its nearest depth is behind the farthest depth of all texels it covers, which is tested on the
+     *  level where it covers at most 2x2 texels. The depths come from an earlier frame and are reprojected to the
+     *  current view first. Reprojected texels keep the farthest depth landing on them, texels nothing lands on are
+     *  empty, so the result stays conservative apart from small shifts within a texel.
+     *  Depths are window depths in [0, 1], rows bottom to top like OpenGL.
+     */
+    class DepthPyramid
+    {
+    public:
+        void Build(const float* depths, unsigned width, unsigned height, const glm::mat4& viewProjection);
+        void Reproject(const float* depths, unsigned width, unsigned height, const glm::mat4& depthViewProjection, const glm::mat4& viewProjection);
+        bool IsOccluded(const glm::vec3& boxMin, const glm::vec3& boxMax) const;
+        bool IsOccludedReference(const glm::vec3& boxMin, const glm::vec3& boxMax) const;
+
+        /** Returns whether the pyramid holds depths. */
+        bool IsEmpty() const { return levels_.empty(); }
+        /** Returns the number of levels. */
+        std::size_t GetNumLevels() const { return levels_.size(); }
+        /** Returns the width of the finest level. */
+        unsigned GetWidth() const { return widths_.empty() ? 0 : widths_[0]; }
+        /** Returns the height of the finest level. */
+        unsigned GetHeight() const { return heights_.empty() ? 0 : heights_[0]; }
+        /** Returns the view projection matrix the depths are for. */
+        const glm::mat4& GetViewProjection() const { return viewProjection_; }
+
+    private:
+        bool GetScreenBounds(const glm::vec3& boxMin, const glm::vec3& boxMax, glm::ivec4& rect, float& minDepth) const;
+        float GetMaxDepth(std::size_t level, const glm::ivec4& rect) const;
+
+        /** Holds the depths of each level. */
+        std::vector<std::vector<float>> levels_;
+        /** Holds the width of each level. */
+        std::vector<unsigned> widths_;
+        /** Holds the height of each level. */
+        std::vector<unsigned> heights_;
+        /** Holds the view projection matrix the depths are for. */
+        glm::mat4 viewProjection_ = glm::mat4(1.0f);
+        /** Holds the reprojected depths, kept between frames to avoid allocations. */
+        std::vector<float> reprojected_;
+    };
+}
@@ -0,0 +1,54 @@
+/**
+ * @file   Frustum.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  View frustum for culling octree nodes.
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace viscom {
+
+    /** A view frustum given by six planes with normals pointing inside. */
+    struct Frustum
+    {
+        /** The planes (left, right, bottom, top, near, far) as (normal, distance). */
+        glm::vec4 planes_[6];
+
+        /**
+         *  Extracts the frustum planes from a view projection matrix.
+         *  @param viewProjection the view projection matrix.
+         */
+        static Frustum FromMatrix(const glm::mat4& viewProjection)
+        {
+            glm::vec4 rows[4];
+            for (auto r = 0; r < 4; ++r) rows[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+
+            Frustum result;
+            for (auto i = 0; i < 3; ++i) {
+                result.planes_[2 * i] = rows[3] + rows[i];
+                result.planes_[2 * i + 1] = rows[3] - rows[i];
+            }
+            for (auto& plane : result.planes_) plane = plane / glm::length(glm::vec3(plane));
+            return result;
+        }
+
+        /**
+         *  Tests whether an axis aligned box is completely outside of the frustum.
+         *  Conservative: boxes near the frustum corners may be reported as inside.
+         *  @param boxMin the minimum of the box.
+         *  @param boxMax the maximum of the box.
+         */
+        bool IsOutside(const glm::vec3& boxMin, const glm::vec3& boxMax) const
+        {
+            for (const auto& plane : planes_) {
+                glm::vec3 positiveVertex{ plane.x >= 0.0f ? boxMax.x : boxMin.x, plane.y >= 0.0f ? boxMax.y : boxMin.y, plane.z >= 0.0f ? boxMax.z : boxMin.z };
+                if (glm::dot(glm::vec3(plane), positiveVertex) + plane.w < 0.0f) return true;
+            }
+            return false;
+        }
+    };
+}
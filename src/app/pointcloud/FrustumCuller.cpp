@@ -0,0 +1,176 @@
+/**
+ * @file   FrustumCuller.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the vectorized culling of node bounds against multiple frusta.
+ */
+
+#include "FrustumCuller.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__AVX__)
+#define VISCOM_CULLING_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VISCOM_CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+namespace viscom {
+
+    namespace {
+#if defined(VISCOM_CULLING_AVX)
+        constexpr std::size_t CULLING_LANES = 8;
+#elif defined(VISCOM_CULLING_SSE)
+        constexpr std::size_t CULLING_LANES = 4;
+#else
+        constexpr std::size_t CULLING_LANES = 1;
+#endif
+        constexpr std::size_t PLANES_PER_FRUSTUM = sizeof(Frustum::planes_) / sizeof(Frustum::planes_[0]);
+        constexpr std::size_t COEFFICIENTS_PER_PLANE = 7;
+    }
+
+    /**
+     *  Stores the bounds of all nodes for culling.
+     *  @param nodes the node table.
+     *  @param numNodes the number of nodes.
+     */
+    void FrustumCuller::SetNodes(const PointCloudNodeRecord* nodes, std::size_t numNodes)
+    {
+        centerX_.resize(numNodes);
+        centerY_.resize(numNodes);
+        centerZ_.resize(numNodes);
+        extentX_.resize(numNodes);
+        extentY_.resize(numNodes);
+        extentZ_.resize(numNodes);
+        visibilityMasks_.assign(numNodes, 0);
+
+        for (std::size_t i = 0; i < numNodes; ++i) {
+            auto center = 0.5f * (nodes[i].boundsMin_ + nodes[i].boundsMax_);
+            auto extent = 0.5f * (nodes[i].boundsMax_ - nodes[i].boundsMin_);
+            centerX_[i] = center.x;
+            centerY_[i] = center.y;
+            centerZ_[i] = center.z;
+            extentX_[i] = extent.x;
+            extentY_[i] = extent.y;
+            extentZ_[i] = extent.z;
+        }
+    }
+
+    /**
+     *  Tests all nodes against a number of frusta. A box is outside a plane if the distance of its center is smaller
+     *  than the negative projected half extent, like Frustum::IsOutside() this is conservative near the corners.
+     *  @param frusta the frusta.
+     *  @param numFrusta the number of frusta (at most MAX_FRUSTA).
+     *  @return the visibility mask of each node.
+     */
+    const std::vector<std::uint32_t>& FrustumCuller::Cull(const Frustum* frusta, std::size_t numFrusta)
+    {
+        if (numFrusta > MAX_FRUSTA) throw std::runtime_error("Too many frusta for culling.");
+        auto numNodes = visibilityMasks_.size();
+        std::size_t begin = 0;
+
+        // the plane coefficients are broadcast once, the inner loop then only loads them.
+        planeCoefficients_.resize(numFrusta * PLANES_PER_FRUSTUM * COEFFICIENTS_PER_PLANE * CULLING_LANES);
+        for (std::size_t p = 0; p < numFrusta * PLANES_PER_FRUSTUM; ++p) {
+            const auto& plane = frusta[p / PLANES_PER_FRUSTUM].planes_[p % PLANES_PER_FRUSTUM];
+            float coefficients[COEFFICIENTS_PER_PLANE] = { plane.x, plane.y, plane.z, plane.w, std::abs(plane.x), std::abs(plane.y), std::abs(plane.z) };
+            for (std::size_t c = 0; c < COEFFICIENTS_PER_PLANE; ++c) {
+                for (std::size_t l = 0; l < CULLING_LANES; ++l) planeCoefficients_[(COEFFICIENTS_PER_PLANE * p + c) * CULLING_LANES + l] = coefficients[c];
+            }
+        }
+
+#if defined(VISCOM_CULLING_AVX)
+        for (; begin + 8 <= numNodes; begin += 8) {
+            auto cx = _mm256_loadu_ps(&centerX_[begin]);
+            auto cy = _mm256_loadu_ps(&centerY_[begin]);
+            auto cz = _mm256_loadu_ps(&centerZ_[begin]);
+            auto ex = _mm256_loadu_ps(&extentX_[begin]);
+            auto ey = _mm256_loadu_ps(&extentY_[begin]);
+            auto ez = _mm256_loadu_ps(&extentZ_[begin]);
+            auto masks = _mm256_setzero_ps();
+            for (std::size_t f = 0; f < numFrusta; ++f) {
+                auto outside = _mm256_setzero_ps();
+                for (std::size_t p = f * PLANES_PER_FRUSTUM; p < (f + 1) * PLANES_PER_FRUSTUM; ++p) {
+                    const auto* plane = &planeCoefficients_[COEFFICIENTS_PER_PLANE * CULLING_LANES * p];
+                    auto distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(plane), cx), _mm256_mul_ps(_mm256_loadu_ps(plane + 8), cy)),
+                        _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(plane + 16), cz), _mm256_loadu_ps(plane + 24)));
+                    auto radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(plane + 32), ex), _mm256_mul_ps(_mm256_loadu_ps(plane + 40), ey)),
+                        _mm256_mul_ps(_mm256_loadu_ps(plane + 48), ez));
+                    outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+                }
+                // the masks are combined as bit patterns in float registers, AVX has no 256 bit integer operations.
+                masks = _mm256_or_ps(masks, _mm256_andnot_ps(outside, _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(1U << f)))));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&visibilityMasks_[begin]), _mm256_castps_si256(masks));
+        }
+#elif defined(VISCOM_CULLING_SSE)
+        for (; begin + 4 <= numNodes; begin += 4) {
+            auto cx = _mm_loadu_ps(&centerX_[begin]);
+            auto cy = _mm_loadu_ps(&centerY_[begin]);
+            auto cz = _mm_loadu_ps(&centerZ_[begin]);
+            auto ex = _mm_loadu_ps(&extentX_[begin]);
+            auto ey = _mm_loadu_ps(&extentY_[begin]);
+            auto ez = _mm_loadu_ps(&extentZ_[begin]);
+            auto masks = _mm_setzero_si128();
+            for (std::size_t f = 0; f < numFrusta; ++f) {
+                auto outside = _mm_setzero_ps();
+                for (std::size_t p = f * PLANES_PER_FRUSTUM; p < (f + 1) * PLANES_PER_FRUSTUM; ++p) {
+                    const auto* plane = &planeCoefficients_[COEFFICIENTS_PER_PLANE * CULLING_LANES * p];
+                    auto distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(plane), cx), _mm_mul_ps(_mm_loadu_ps(plane + 4), cy)),
+                        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(plane + 8), cz), _mm_loadu_ps(plane + 12)));
+                    auto radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(plane + 16), ex), _mm_mul_ps(_mm_loadu_ps(plane + 20), ey)),
+                        _mm_mul_ps(_mm_loadu_ps(plane + 24), ez));
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+                }
+                masks = _mm_or_si128(masks, _mm_andnot_si128(_mm_castps_si128(outside), _mm_set1_epi32(static_cast<int>(1U << f))));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&visibilityMasks_[begin]), masks);
+        }
+#endif
+
+        CullScalar(frusta, numFrusta, begin, numNodes);
+        return visibilityMasks_;
+    }
+
+    /**
+     *  Tests a range of nodes without vector instructions. Used for the remainder of the vectorized loop and as
+     *  reference for the benchmark.
+     *  @param frusta the frusta.
+     *  @param numFrusta the number of frusta (at most MAX_FRUSTA).
+     *  @param begin the first node.
+     *  @param end the node after the last one.
+     */
+    void FrustumCuller::CullScalar(const Frustum* frusta, std::size_t numFrusta, std::size_t begin, std::size_t end)
+    {
+        for (auto i = begin; i < end; ++i) {
+            std::uint32_t mask = 0;
+            for (std::size_t f = 0; f < numFrusta; ++f) {
+                auto outside = false;
+                for (const auto& plane : frusta[f].planes_) {
+                    // same order of operations as the vectorized code, so both give the same results.
+                    auto distance = (plane.x * centerX_[i] + plane.y * centerY_[i]) + (plane.z * centerZ_[i] + plane.w);
+                    auto radius = (std::abs(plane.x) * extentX_[i] + std::abs(plane.y) * extentY_[i]) + std::abs(plane.z) * extentZ_[i];
+                    outside = outside || distance + radius < 0.0f;
+                }
+                if (!outside) mask |= 1U << f;
+            }
+            visibilityMasks_[i] = mask;
+        }
+    }
+
+    /** Returns the name of the instruction set used by the culling kernel. */
+    const char* FrustumCuller::GetInstructionSet()
+    {
+#if defined(VISCOM_CULLING_AVX)
+        return "AVX";
+#elif defined(VISCOM_CULLING_SSE)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * @file   FrustumCuller.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the vectorized culling of node bounds against multiple frusta.
+ */
+
+#pragma once
+
+#include "Frustum.h"
+#include "PointCloudFormat.h"
+
+#include <vector>
+
+namespace viscom {
+
+    /**
+     *  Tests the bounding boxes of all octree nodes against all frusta of a cluster node (windows and eyes) at once.
+     *  The boxes are stored as centers and half extents in separate arrays, so the kernel tests 8 (AVX) or 4 (SSE)
+     *  boxes against a plane with a few vector instructions. The instruction set is chosen at compile time
+     *  (VISCOM_ENABLE_AVX in CMake), other platforms use a scalar fallback.
+     */
+    class FrustumCuller
+    {
+    public:
+        /** The maximum number of frusta tested in a single pass. */
+        static constexpr std::size_t MAX_FRUSTA = 32;
+
+        void SetNodes(const PointCloudNodeRecord* nodes, std::size_t numNodes);
+        const std::vector<std::uint32_t>& Cull(const Frustum* frusta, std::size_t numFrusta);
+        void CullScalar(const Frustum* frusta, std::size_t numFrusta, std::size_t begin, std::size_t end);
+
+        /** Returns the visibility masks of the last pass, bit i is set if a node is (potentially) inside frustum i. */
+        const std::vector<std::uint32_t>& GetVisibilityMasks() const { return visibilityMasks_; }
+        /** Returns the number of nodes. */
+        std::size_t GetNumNodes() const { return visibilityMasks_.size(); }
+
+        static const char* GetInstructionSet();
+
+    private:
+        /** Holds the x coordinates of the box centers. */
+        std::vector<float> centerX_;
+        /** Holds the y coordinates of the box centers. */
+        std::vector<float> centerY_;
+        /** Holds the z coordinates of the box centers. */
+        std::vector<float> centerZ_;
+        /** Holds the half extents of the boxes in x direction. */
+        std::vector<float> extentX_;
+        /** Holds the half extents of the boxes in y direction. */
+        std::vector<float> extentY_;
+        /** Holds the half extents of the boxes in z direction. */
+        std::vector<float> extentZ_;
+        /** Holds the visibility mask of each node. */
+        std::vector<std::uint32_t> visibilityMasks_;
+        /** Holds the plane coefficients (nx, ny, nz, d, |nx|, |ny|, |nz|) of all frusta, each repeated for all vector lanes. */
+        std::vector<float> planeCoefficients_;
+    };
+}
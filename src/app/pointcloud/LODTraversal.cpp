@@ -0,0 +1,118 @@
+/**
+ * @file   LODTraversal.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the view dependent level of detail selection.
+ */
+
+#include "LODTraversal.h"
+#include "Frustum.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace viscom {
+
+    /**
+     *  Selects the nodes to render.
+     *  @param nodes the node table of the point cloud.
+     *  @param viewProjection the view projection matrix.
+     *  @param viewportHeight the height of the viewport in pixels.
+     *  @param parameters the traversal parameters.
+     *  @return the selected nodes, parents are always selected before their children.
+     */
+    const std::vector<std::uint32_t>& LODTraversal::Traverse(const PointCloudNodeRecord* nodes, const glm::mat4& viewProjection, float viewportHeight,
+        const LODTraversalParameters& parameters)
+    {
+        auto frustum = Frustum::FromMatrix(viewProjection);
+        TraverseQueue(nodes, parameters, [nodes, &frustum](std::uint32_t nodeIndex) { return !frustum.IsOutside(nodes[nodeIndex].boundsMin_, nodes[nodeIndex].boundsMax_); },
+            [&viewProjection, viewportHeight](const PointCloudNodeRecord& node) { return GetProjectedSize(node, viewProjection, viewportHeight); });
+        return selectedNodes_;
+    }
+
+    /**
+     *  Selects the nodes to render for multiple views at once.
+     *  @param nodes the node table of the point cloud.
+     *  @param viewProjections the view projection matrices of all views.
+     *  @param viewportHeights the heights of the viewports in pixels.
+     *  @param numViews the number of views.
+     *  @param visibilityMasks the visibility of each node, bit i is set if the node is visible in view i (see FrustumCuller).
+     *  @param parameters the traversal parameters.
+     *  @return the selected nodes, parents are always selected before their children.
+     */
+    const std::vector<std::uint32_t>& LODTraversal::Traverse(const PointCloudNodeRecord* nodes, const glm::mat4* viewProjections, const float* viewportHeights,
+        std::size_t numViews, const std::uint32_t* visibilityMasks, const LODTraversalParameters& parameters)
+    {
+        TraverseQueue(nodes, parameters, [visibilityMasks](std::uint32_t nodeIndex) { return visibilityMasks[nodeIndex] != 0; },
+            [nodes, viewProjections, viewportHeights, numViews, visibilityMasks](const PointCloudNodeRecord& node) {
+            auto mask = visibilityMasks[&node - nodes];
+            auto size = 0.0f;
+            for (std::size_t v = 0; v < numViews; ++v) {
+                if ((mask & (1U << v)) != 0) size = std::max(size, GetProjectedSize(node, viewProjections[v], viewportHeights[v]));
+            }
+            return size;
+        });
+        return selectedNodes_;
+    }
+
+    template<typename VisibleFn, typename SizeFn> void LODTraversal::TraverseQueue(const PointCloudNodeRecord* nodes, const LODTraversalParameters& parameters,
+        VisibleFn isVisible, SizeFn projectedSize)
+    {
+        selectedNodes_.clear();
+        queue_.clear();
+        statistics_ = LODTraversalStatistics();
+
+        auto pushNode = [this, nodes, &isVisible, &projectedSize](std::uint32_t nodeIndex, float minSize) {
+            ++statistics_.numVisitedNodes_;
+            if (!isVisible(nodeIndex)) {
+                ++statistics_.numCulledNodes_;
+                return;
+            }
+            auto size = projectedSize(nodes[nodeIndex]);
+            if (size < minSize) return;
+            queue_.push_back(QueueEntry{ size, nodeIndex });
+            std::push_heap(queue_.begin(), queue_.end());
+        };
+
+        pushNode(0, 0.0f);
+        while (!queue_.empty()) {
+            std::pop_heap(queue_.begin(), queue_.end());
+            auto nodeIndex = queue_.back().nodeIndex_;
+            queue_.pop_back();
+
+            const auto& node = nodes[nodeIndex];
+            if (statistics_.numSelectedPoints_ + node.numPoints_ > parameters.pointBudget_) {
+                statistics_.budgetReached_ = true;
+                break;
+            }
+
+            selectedNodes_.push_back(nodeIndex);
+            statistics_.numSelectedPoints_ += node.numPoints_;
+            statistics_.maxLevel_ = std::max<unsigned>(statistics_.maxLevel_, node.level_);
+
+            for (auto c = 0U; c < node.numChildren_; ++c) pushNode(node.firstChild_ + c, parameters.minNodeSize_);
+        }
+
+        statistics_.numSelectedNodes_ = static_cast<std::uint32_t>(selectedNodes_.size());
+    }
+
+    /**
+     *  Estimates the size of a nodes bounding sphere on screen.
+     *  @param node the node.
+     *  @param viewProjection the view projection matrix.
+     *  @param viewportHeight the height of the viewport in pixels.
+     *  @return the projected diameter in pixels.
+     */
+    float LODTraversal::GetProjectedSize(const PointCloudNodeRecord& node, const glm::mat4& viewProjection, float viewportHeight)
+    {
+        auto center = 0.5f * (node.boundsMin_ + node.boundsMax_);
+        auto radius = 0.5f * glm::length(node.boundsMax_ - node.boundsMin_);
+        auto clipW = glm::dot(glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]), glm::vec4(center, 1.0f));
+        if (clipW <= radius) return std::numeric_limits<float>::max();
+
+        // the view matrix is rigid, so the length of the second row is the vertical scale of the projection.
+        auto projectionScale = glm::length(glm::vec3(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1]));
+        return viewportHeight * radius * projectionScale / clipW;
+    }
+}
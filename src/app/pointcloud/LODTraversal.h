@@ -0,0 +1,87 @@
+/**
+ * @file   LODTraversal.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the view dependent level of detail selection.
+ */
+
+#pragma once
+
+#include "PointCloudFormat.h"
+
+#include <vector>
+
+namespace viscom {
+
+    /** Parameters of the level of detail selection. */
+    struct LODTraversalParameters
+    {
+        /** The maximum number of points selected. */
+        std::uint64_t pointBudget_ = 5000000;
+        /** Nodes are only refined if their projected size in pixels is larger than this. */
+        float minNodeSize_ = 100.0f;
+    };
+
+    /** Statistics of a single level of detail selection. */
+    struct LODTraversalStatistics
+    {
+        /** The number of nodes visited. */
+        std::uint32_t numVisitedNodes_ = 0;
+        /** The number of nodes culled by the view frustum. */
+        std::uint32_t numCulledNodes_ = 0;
+        /** The number of nodes selected. */
+        std::uint32_t numSelectedNodes_ = 0;
+        /** The number of points selected. */
+        std::uint64_t numSelectedPoints_ = 0;
+        /** The deepest level selected. */
+        unsigned maxLevel_ = 0;
+        /** Whether the traversal was stopped by the point budget. */
+        bool budgetReached_ = false;
+    };
+
+    /**
+     *  Selects the octree nodes to render for a view. Nodes are visited in order of their projected size, so the
+     *  nodes most important for the image are selected first and the selection stops as soon as the point budget
+     *  is reached. As nodes refine their ancestors, a node is only selected after its parent.
+     *  Multiple views (e.g. all windows and eyes of a cluster node) can share a single selection, a node is then
+     *  visited if it is visible in any view and prioritized by its largest projected size.
+     */
+    class LODTraversal
+    {
+    public:
+        const std::vector<std::uint32_t>& Traverse(const PointCloudNodeRecord* nodes, const glm::mat4& viewProjection, float viewportHeight,
+            const LODTraversalParameters& parameters);
+        const std::vector<std::uint32_t>& Traverse(const PointCloudNodeRecord* nodes, const glm::mat4* viewProjections, const float* viewportHeights,
+            std::size_t numViews, const std::uint32_t* visibilityMasks, const LODTraversalParameters& parameters);
+
+        /** Returns the nodes selected by the last traversal. */
+        const std::vector<std::uint32_t>& GetSelectedNodes() const { return selectedNodes_; }
+        /** Returns the statistics of the last traversal. */
+        const LODTraversalStatistics& GetStatistics() const { return statistics_; }
+
+        static float GetProjectedSize(const PointCloudNodeRecord& node, const glm::mat4& viewProjection, float viewportHeight);
+
+    private:
+        template<typename VisibleFn, typename SizeFn> void TraverseQueue(const PointCloudNodeRecord* nodes, const LODTraversalParameters& parameters,
+            VisibleFn isVisible, SizeFn projectedSize);
+
+        /** An entry of the traversal queue. */
+        struct QueueEntry
+        {
+            /** The projected size of the node. */
+            float priority_;
+            /** The index of the node. */
+            std::uint32_t nodeIndex_;
+
+            bool operator<(const QueueEntry& rhs) const { return priority_ < rhs.priority_; }
+        };
+
+        /** Holds the traversal queue, kept between traversals to avoid allocations. */
+        std::vector<QueueEntry> queue_;
+        /** Holds the selected nodes. */
+        std::vector<std::uint32_t> selectedNodes_;
+        /** Holds the statistics. */
+        LODTraversalStatistics statistics_;
+    };
+}
@@ -0,0 +1,257 @@
+/**
+ * @file   LiveIngestion.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the background ingestion of points arriving while the point cloud is drawn.
+ */
+
+#include "LiveIngestion.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace viscom {
+
+    namespace {
+        /** The number of points the file tailing thread collects per batch. */
+        constexpr std::size_t TAIL_BATCH_SIZE = 4096;
+        /** The interval in which the worker sends node updates and the file tailing thread polls for new data. */
+        constexpr std::chrono::milliseconds PUBLISH_INTERVAL{ 10 };
+
+        /**
+         *  Parses a line with a point ("x y z [r g b]"), values separated by white space or commas.
+         *  @param line the line.
+         *  @param position the position read.
+         *  @param color the color read, white if the line has no color.
+         *  @return whether the line holds a point.
+         */
+        bool ParsePointLine(const std::string& line, glm::dvec3& position, glm::u8vec4& color)
+        {
+            double values[6];
+            auto numValues = 0;
+            auto current = line.c_str();
+            while (numValues < 6) {
+                while (*current == ' ' || *current == '\t' || *current == ',' || *current == ';') ++current;
+                char* valueEnd = nullptr;
+                values[numValues] = std::strtod(current, &valueEnd);
+                if (valueEnd == current) break;
+                current = valueEnd;
+                ++numValues;
+            }
+            if (numValues < 3) return false;
+
+            position = glm::dvec3(values[0], values[1], values[2]);
+            color = glm::u8vec4(255);
+            if (numValues == 6) {
+                for (auto c = 0; c < 3; ++c) color[c] = static_cast<std::uint8_t>(std::min(std::max(values[3 + c], 0.0), 255.0));
+            }
+            return true;
+        }
+    }
+
+    /**
+     *  Creates an empty octree and starts the worker.
+     *  @param center the center of the root cube.
+     *  @param size the edge length of the root cube.
+     *  @param parameters the parameters of the octree.
+     *  @param batchQueueCapacity the number of batches the producer can be ahead of the worker.
+     *  @param updateQueueCapacity the number of node updates the worker can be ahead of the render thread.
+     */
+    LiveIngestion::LiveIngestion(const glm::vec3& center, float size, const LiveOctreeParameters& parameters,
+        std::size_t batchQueueCapacity, std::size_t updateQueueCapacity) :
+        octree_{ center, size, parameters },
+        batches_{ batchQueueCapacity },
+        updates_{ updateQueueCapacity }
+    {
+        worker_ = std::thread{ &LiveIngestion::WorkerLoop, this };
+    }
+
+    LiveIngestion::~LiveIngestion()
+    {
+        stop_ = true;
+        if (producer_.joinable()) producer_.join();
+        worker_.join();
+    }
+
+    /**
+     *  Passes a batch of points to the worker without waiting. Must not be called while a file is tailed.
+     *  @param batch the points, relative to the origin of the octree. They are only moved from if the batch was queued.
+     *  @return whether the batch was queued, false if the worker is too far behind.
+     */
+    bool LiveIngestion::Push(std::vector<PointCloudPoint>&& batch)
+    {
+        auto numPoints = batch.size();
+        if (!batches_.TryPush(std::move(batch))) {
+            ++numProducerStalls_;
+            return false;
+        }
+        numReceivedPoints_ += numPoints;
+        return true;
+    }
+
+    /**
+     *  Starts a thread reading points appended to a text file ("x y z [r g b]" per line) as they arrive, e.g.
+     *  written by a scanner. The position of the first point becomes the origin of the octree.
+     *  @param filename the file.
+     */
+    void LiveIngestion::TailFile(const std::string& filename)
+    {
+        StartTailing(filename, glm::dvec3(0.0), true);
+    }
+
+    /**
+     *  Starts a thread reading points appended to a text file ("x y z [r g b]" per line) as they arrive, e.g.
+     *  written by a scanner.
+     *  @param filename the file.
+     *  @param origin the position subtracted from all points, e.g. the origin of a point cloud file drawn with them.
+     */
+    void LiveIngestion::TailFile(const std::string& filename, const glm::dvec3& origin)
+    {
+        StartTailing(filename, origin, false);
+    }
+
+    /**
+     *  Removes the oldest node update, called by the render thread. Never waits for the worker.
+     *  @param update the update removed.
+     *  @return whether there was an update.
+     */
+    bool LiveIngestion::TryPopUpdate(LiveNodeUpdate& update)
+    {
+        return updates_.TryPop(update);
+    }
+
+    /** Returns whether all pushed points were inserted and all changes were sent to the render thread. */
+    bool LiveIngestion::IsIdle() const
+    {
+        return numInsertedPoints_ + numRejectedPoints_ == numReceivedPoints_ && numDirtyNodes_ == 0;
+    }
+
+    LiveIngestionStatistics LiveIngestion::GetStatistics() const
+    {
+        LiveIngestionStatistics statistics;
+        statistics.numReceivedPoints_ = numReceivedPoints_;
+        statistics.numInsertedPoints_ = numInsertedPoints_;
+        statistics.numRejectedPoints_ = numRejectedPoints_;
+        statistics.pointsPerSecond_ = pointsPerSecond_;
+        statistics.numQueuedBatches_ = batches_.GetSize();
+        statistics.batchQueueCapacity_ = batches_.GetCapacity();
+        statistics.numProducerStalls_ = numProducerStalls_;
+        statistics.numPendingUpdates_ = updates_.GetSize();
+        statistics.numDirtyNodes_ = numDirtyNodes_;
+        statistics.numNodes_ = numNodes_;
+        return statistics;
+    }
+
+    void LiveIngestion::StartTailing(const std::string& filename, const glm::dvec3& origin, bool originFromFirstPoint)
+    {
+        if (producer_.joinable()) throw std::runtime_error("A file is already tailed.");
+        std::ifstream file{ filename, std::ios::binary };
+        if (!file) throw std::runtime_error("Could not open file \"" + filename + "\".");
+        producer_ = std::thread{ &LiveIngestion::TailLoop, this, std::move(file), origin, originFromFirstPoint };
+    }
+
+    void LiveIngestion::TailLoop(std::ifstream file, glm::dvec3 origin, bool originFromFirstPoint)
+    {
+        std::vector<PointCloudPoint> batch;
+        std::string line, partialLine;
+        auto pushBatch = [this, &batch]() {
+            while (!batch.empty() && !Push(std::move(batch))) {
+                if (stop_) return;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            batch.clear();
+        };
+
+        while (!stop_) {
+            // at the end of the file a line may still be written, it is kept until its end arrives.
+            if (!std::getline(file, line) || file.eof()) {
+                partialLine += line;
+                line.clear();
+                file.clear();
+                pushBatch();
+                std::this_thread::sleep_for(PUBLISH_INTERVAL);
+                continue;
+            }
+            if (!partialLine.empty()) {
+                line = partialLine + line;
+                partialLine.clear();
+            }
+
+            glm::dvec3 position;
+            glm::u8vec4 color;
+            if (!ParsePointLine(line, position, color)) continue;
+            if (originFromFirstPoint) {
+                origin = position;
+                originFromFirstPoint = false;
+            }
+            batch.push_back(PointCloudPoint{ glm::vec3(position - origin), color });
+            if (batch.size() >= TAIL_BATCH_SIZE) pushBatch();
+        }
+    }
+
+    void LiveIngestion::WorkerLoop()
+    {
+        using Clock = std::chrono::steady_clock;
+        auto lastPublish = Clock::now();
+        auto windowStart = lastPublish;
+        std::uint64_t windowPoints = 0;
+        auto firstWindowClosed = false;
+        std::vector<PointCloudPoint> batch;
+
+        while (!stop_) {
+            // changes are coalesced while the producer keeps the worker busy, but sent right away when it runs dry.
+            if (Clock::now() - lastPublish >= PUBLISH_INTERVAL) {
+                PublishUpdates();
+                lastPublish = Clock::now();
+            }
+
+            auto inserted = false;
+            while (Clock::now() - lastPublish < PUBLISH_INTERVAL && batches_.TryPop(batch)) {
+                // the first window starts with the first points, not when the worker started waiting for them.
+                if (!firstWindowClosed && windowPoints == 0) windowStart = Clock::now();
+                auto rejectedBefore = octree_.GetStatistics().numRejectedPoints_;
+                octree_.Insert(batch.data(), batch.size());
+                auto numRejected = octree_.GetStatistics().numRejectedPoints_ - rejectedBefore;
+                // the changed nodes are counted before the points, so IsIdle() never misses them.
+                numDirtyNodes_ = octree_.GetDirtyNodes().size();
+                numRejectedPoints_ += numRejected;
+                numInsertedPoints_ += batch.size() - numRejected;
+                windowPoints += batch.size() - numRejected;
+                inserted = true;
+            }
+            if (!inserted) PublishUpdates();
+
+            auto now = Clock::now();
+            std::chrono::duration<double> windowLength = now - windowStart;
+            if (windowLength.count() >= 1.0 && (firstWindowClosed || windowPoints > 0)) {
+                pointsPerSecond_ = static_cast<double>(windowPoints) / windowLength.count();
+                windowPoints = 0;
+                windowStart = now;
+                firstWindowClosed = true;
+            } else if (!firstWindowClosed && inserted && windowLength.count() > 0.0) {
+                // until the first window is full the rate since the first points is reported, so short runs do not report 0.
+                pointsPerSecond_ = static_cast<double>(windowPoints) / windowLength.count();
+            }
+
+            if (!inserted) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void LiveIngestion::PublishUpdates()
+    {
+        const auto& dirtyNodes = octree_.GetDirtyNodes();
+        std::size_t numSent = 0;
+        LiveNodeUpdate update;
+        for (; numSent < dirtyNodes.size() && updates_.GetSize() < updates_.GetCapacity(); ++numSent) {
+            octree_.CreateUpdate(dirtyNodes[numSent], update);
+            // only this thread pushes, so the queue cannot have filled up since the size was checked.
+            updates_.TryPush(std::move(update));
+        }
+        octree_.ClearDirtyNodes(numSent);
+        numDirtyNodes_ = octree_.GetDirtyNodes().size();
+        numNodes_ = octree_.GetNodes().size();
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * @file   LiveIngestion.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the background ingestion of points arriving while the point cloud is drawn.
+ */
+
+#pragma once
+
+#include "LiveOctree.h"
+#include "LockFreeQueue.h"
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace viscom {
+
+    /** Statistics of the live ingestion. */
+    struct LiveIngestionStatistics
+    {
+        /** The number of points pushed by the producer. */
+        std::uint64_t numReceivedPoints_ = 0;
+        /** The number of points inserted into the octree. */
+        std::uint64_t numInsertedPoints_ = 0;
+        /** The number of points dropped because they were outside of the root node. */
+        std::uint64_t numRejectedPoints_ = 0;
+        /** The number of inserted points per second, measured over about one second (since the first points until then). */
+        double pointsPerSecond_ = 0.0;
+        /** The number of batches waiting for the worker. */
+        std::size_t numQueuedBatches_ = 0;
+        /** The maximum number of batches waiting for the worker. */
+        std::size_t batchQueueCapacity_ = 0;
+        /** The number of times the producer found the batch queue full. */
+        std::uint64_t numProducerStalls_ = 0;
+        /** The number of node updates waiting for the render thread. */
+        std::size_t numPendingUpdates_ = 0;
+        /** The number of changed nodes the worker has not sent to the render thread yet. */
+        std::size_t numDirtyNodes_ = 0;
+        /** The number of nodes in the octree. */
+        std::size_t numNodes_ = 0;
+    };
+
+    /**
+     *  Inserts points into a live octree on a worker thread while the render thread draws it. A single producer
+     *  (either the caller of Push() or the file tailing thread started by TailFile()) passes batches to the worker
+     *  through a lock-free queue. The worker inserts them and, about every 10ms, sends the changes of the touched
+     *  nodes through a second lock-free queue to the render thread. If the render thread falls behind and this
+     *  queue is full, the nodes stay marked as changed and their updates are merged with later changes, so the
+     *  render thread never waits and the worker never waits for it.
+     */
+    class LiveIngestion
+    {
+    public:
+        LiveIngestion(const glm::vec3& center, float size, const LiveOctreeParameters& parameters = LiveOctreeParameters{},
+            std::size_t batchQueueCapacity = 256, std::size_t updateQueueCapacity = 4096);
+        LiveIngestion(const LiveIngestion&) = delete;
+        LiveIngestion& operator=(const LiveIngestion&) = delete;
+        ~LiveIngestion();
+
+        bool Push(std::vector<PointCloudPoint>&& batch);
+        void TailFile(const std::string& filename);
+        void TailFile(const std::string& filename, const glm::dvec3& origin);
+        bool TryPopUpdate(LiveNodeUpdate& update);
+        bool IsIdle() const;
+        LiveIngestionStatistics GetStatistics() const;
+
+    private:
+        void StartTailing(const std::string& filename, const glm::dvec3& origin, bool originFromFirstPoint);
+        void TailLoop(std::ifstream file, glm::dvec3 origin, bool originFromFirstPoint);
+        void WorkerLoop();
+        void PublishUpdates();
+
+        /** Holds the octree, only accessed by the worker. */
+        LiveOctree octree_;
+        /** Holds the batches from the producer to the worker. */
+        LockFreeQueue<std::vector<PointCloudPoint>> batches_;
+        /** Holds the node updates from the worker to the render thread. */
+        LockFreeQueue<LiveNodeUpdate> updates_;
+        /** Holds whether the threads should terminate. */
+        std::atomic<bool> stop_{ false };
+        /** Holds the number of points pushed. */
+        std::atomic<std::uint64_t> numReceivedPoints_{ 0 };
+        /** Holds the number of points inserted. */
+        std::atomic<std::uint64_t> numInsertedPoints_{ 0 };
+        /** Holds the number of points outside of the root node. */
+        std::atomic<std::uint64_t> numRejectedPoints_{ 0 };
+        /** Holds the inserted points per second. */
+        std::atomic<double> pointsPerSecond_{ 0.0 };
+        /** Holds the number of failed pushes. */
+        std::atomic<std::uint64_t> numProducerStalls_{ 0 };
+        /** Holds the number of changed nodes not sent yet. */
+        std::atomic<std::size_t> numDirtyNodes_{ 0 };
+        /** Holds the number of nodes. */
+        std::atomic<std::size_t> numNodes_{ 0 };
+        /** Holds the worker thread. */
+        std::thread worker_;
+        /** Holds the file tailing thread. */
+        std::thread producer_;
+    };
+}
@@ -0,0 +1,170 @@
+/**
+ * @file   LiveOctree.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the level of detail octree points are inserted into while it is drawn.
+ */
+
+#include "LiveOctree.h"
+
+#include <algorithm>
+
+namespace viscom {
+
+    /**
+     *  Creates an empty octree.
+     *  @param center the center of the root cube.
+     *  @param size the edge length of the root cube.
+     *  @param parameters the parameters of the octree.
+     */
+    LiveOctree::LiveOctree(const glm::vec3& center, float size, const LiveOctreeParameters& parameters) :
+        parameters_{ parameters }
+    {
+        parameters_.gridSize_ = std::max(parameters_.gridSize_, 1U);
+        PointCloudNodeRecord root;
+        root.boundsMin_ = center - glm::vec3(0.5f * size);
+        root.boundsMax_ = center + glm::vec3(0.5f * size);
+        records_.push_back(root);
+        nodes_.emplace_back();
+        MarkDirty(0, 0);
+    }
+
+    /**
+     *  Inserts points, points outside of the root cube are dropped.
+     *  @param points the points.
+     *  @param numPoints the number of points.
+     */
+    void LiveOctree::Insert(const PointCloudPoint* points, std::size_t numPoints)
+    {
+        // copied as splitting a node grows the records.
+        glm::vec3 boundsMin = records_[0].boundsMin_;
+        glm::vec3 boundsMax = records_[0].boundsMax_;
+        for (std::size_t i = 0; i < numPoints; ++i) {
+            const auto& position = points[i].position_;
+            if (glm::any(glm::lessThan(position, boundsMin)) || glm::any(glm::greaterThan(position, boundsMax))) {
+                ++statistics_.numRejectedPoints_;
+                continue;
+            }
+            InsertPoint(0, points[i]);
+            ++statistics_.numPoints_;
+        }
+    }
+
+    /**
+     *  Creates the update of a changed node.
+     *  @param nodeIndex the node.
+     *  @param update the update.
+     */
+    void LiveOctree::CreateUpdate(std::uint32_t nodeIndex, LiveNodeUpdate& update) const
+    {
+        const auto& node = nodes_[nodeIndex];
+        update.nodeIndex_ = nodeIndex;
+        update.record_ = records_[nodeIndex];
+        update.firstPoint_ = std::min(node.firstDirtyPoint_, static_cast<std::uint32_t>(node.points_.size()));
+        update.points_.assign(node.points_.begin() + update.firstPoint_, node.points_.end());
+    }
+
+    /**
+     *  Marks the first changed nodes as unchanged after their updates were sent.
+     *  @param numNodes the number of nodes at the start of the list of changed nodes.
+     */
+    void LiveOctree::ClearDirtyNodes(std::size_t numNodes)
+    {
+        numNodes = std::min(numNodes, dirtyNodes_.size());
+        for (std::size_t i = 0; i < numNodes; ++i) nodes_[dirtyNodes_[i]].firstDirtyPoint_ = NOT_DIRTY;
+        dirtyNodes_.erase(dirtyNodes_.begin(), dirtyNodes_.begin() + static_cast<std::ptrdiff_t>(numNodes));
+    }
+
+    /**
+     *  Inserts a point into the subtree of a node.
+     *  @param nodeIndex the node.
+     *  @param point the point, it has to be inside the node.
+     */
+    void LiveOctree::InsertPoint(std::uint32_t nodeIndex, const PointCloudPoint& point)
+    {
+        while (true) {
+            const auto& record = records_[nodeIndex];
+            if (record.firstChild_ == POINTCLOUD_NO_NODE) {
+                AppendPoint(nodeIndex, point);
+                if (nodes_[nodeIndex].points_.size() > parameters_.maxLeafPoints_ && record.level_ < parameters_.maxLevel_) Split(nodeIndex);
+                return;
+            }
+
+            auto grid = static_cast<float>(parameters_.gridSize_);
+            auto maxCell = parameters_.gridSize_ - 1;
+            auto cell = glm::min(glm::uvec3(glm::max((point.position_ - record.boundsMin_) / (record.boundsMax_ - record.boundsMin_) * grid, glm::vec3(0.0f))),
+                glm::uvec3(maxCell));
+            if (nodes_[nodeIndex].occupiedCells_.insert((cell.z * parameters_.gridSize_ + cell.y) * parameters_.gridSize_ + cell.x).second) {
+                AppendPoint(nodeIndex, point);
+                return;
+            }
+
+            // the octants are ordered like the bits of morton codes, x in the lowest bit.
+            auto center = 0.5f * (record.boundsMin_ + record.boundsMax_);
+            auto octant = (point.position_.x >= center.x ? 1U : 0U) | (point.position_.y >= center.y ? 2U : 0U) | (point.position_.z >= center.z ? 4U : 0U);
+            nodeIndex = record.firstChild_ + octant;
+        }
+    }
+
+    /**
+     *  Appends a point to a node.
+     *  @param nodeIndex the node.
+     *  @param point the point.
+     */
+    void LiveOctree::AppendPoint(std::uint32_t nodeIndex, const PointCloudPoint& point)
+    {
+        auto& node = nodes_[nodeIndex];
+        MarkDirty(nodeIndex, static_cast<std::uint32_t>(node.points_.size()));
+        node.points_.push_back(point);
+        records_[nodeIndex].numPoints_ = static_cast<std::uint32_t>(node.points_.size());
+    }
+
+    /**
+     *  Turns a full leaf into an inner node with 8 children and inserts its points again.
+     *  @param nodeIndex the leaf.
+     */
+    void LiveOctree::Split(std::uint32_t nodeIndex)
+    {
+        ++statistics_.numSplits_;
+        auto firstChild = static_cast<std::uint32_t>(records_.size());
+        auto boundsMin = records_[nodeIndex].boundsMin_, boundsMax = records_[nodeIndex].boundsMax_;
+        auto center = 0.5f * (boundsMin + boundsMax);
+        for (auto octant = 0U; octant < 8; ++octant) {
+            PointCloudNodeRecord child;
+            for (auto axis = 0; axis < 3; ++axis) {
+                auto upper = (octant & (1U << axis)) != 0;
+                child.boundsMin_[axis] = upper ? center[axis] : boundsMin[axis];
+                child.boundsMax_[axis] = upper ? boundsMax[axis] : center[axis];
+            }
+            child.parent_ = nodeIndex;
+            child.level_ = static_cast<std::uint8_t>(records_[nodeIndex].level_ + 1);
+            records_.push_back(child);
+            nodes_.emplace_back();
+            // empty children are sent as well, the renderer needs their records to follow the parent.
+            MarkDirty(firstChild + octant, 0);
+        }
+
+        auto& record = records_[nodeIndex];
+        record.firstChild_ = firstChild;
+        record.childMask_ = 0xff;
+        record.numChildren_ = 8;
+        record.numPoints_ = 0;
+        auto points = std::move(nodes_[nodeIndex].points_);
+        nodes_[nodeIndex].points_.clear();
+        MarkDirty(nodeIndex, 0);
+        for (const auto& point : points) InsertPoint(nodeIndex, point);
+    }
+
+    /**
+     *  Remembers a change of a node.
+     *  @param nodeIndex the node.
+     *  @param firstPoint the first changed point.
+     */
+    void LiveOctree::MarkDirty(std::uint32_t nodeIndex, std::uint32_t firstPoint)
+    {
+        auto& node = nodes_[nodeIndex];
+        if (node.firstDirtyPoint_ == NOT_DIRTY) dirtyNodes_.push_back(nodeIndex);
+        node.firstDirtyPoint_ = std::min(node.firstDirtyPoint_, firstPoint);
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file   LiveOctree.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the level of detail octree points are inserted into while it is drawn.
+ */
+
+#pragma once
+
+#include "PointCloudFormat.h"
+
+#include <unordered_set>
+#include <vector>
+
+namespace viscom {
+
+    /** Parameters of the live octree. */
+    struct LiveOctreeParameters
+    {
+        /** The number of points a leaf holds before it is split. */
+        std::uint32_t maxLeafPoints_ = 20000;
+        /** The number of grid cells per axis of a node, inner nodes keep one point per cell. */
+        std::uint32_t gridSize_ = 128;
+        /** The deepest level, leaves on it grow without being split. */
+        unsigned maxLevel_ = 20;
+    };
+
+    /** Statistics of the live octree. */
+    struct LiveOctreeStatistics
+    {
+        /** The number of points in the octree. */
+        std::uint64_t numPoints_ = 0;
+        /** The number of points outside of the root node that were dropped. */
+        std::uint64_t numRejectedPoints_ = 0;
+        /** The number of leaves split so far. */
+        std::uint64_t numSplits_ = 0;
+    };
+
+    /** The changes of a node since its last update, sent to the renderer. */
+    struct LiveNodeUpdate
+    {
+        /** The node. */
+        std::uint32_t nodeIndex_ = 0;
+        /** The current node record (bounds, children and number of points). */
+        PointCloudNodeRecord record_;
+        /** The first changed point, the points before it did not change since the last update. */
+        std::uint32_t firstPoint_ = 0;
+        /** The points from the first changed point on. */
+        std::vector<PointCloudPoint> points_;
+    };
+
+    /**
+     *  A level of detail octree built incrementally while points arrive. A point is passed down from the root until
+     *  it hits a node whose grid cell at the point is still empty (inner nodes keep one point per cell, so they
+     *  hold an even subsample) or a leaf. Leaves take all points until they are full, then they get all 8 children
+     *  at once and their points are inserted again starting at the leaf. Children are always created together, so
+     *  the node table has the same layout as the one of a file and the level of detail selection works on both.
+     *  Points of a node are only appended to except for splits, changed nodes are remembered with the first
+     *  changed point, so only the new points have to be uploaded. The root cube is fixed, points outside of it
+     *  are dropped.
+     */
+    class LiveOctree
+    {
+    public:
+        LiveOctree(const glm::vec3& center, float size, const LiveOctreeParameters& parameters = LiveOctreeParameters{});
+
+        void Insert(const PointCloudPoint* points, std::size_t numPoints);
+        void CreateUpdate(std::uint32_t nodeIndex, LiveNodeUpdate& update) const;
+        void ClearDirtyNodes(std::size_t numNodes);
+
+        /** Returns the node table. */
+        const std::vector<PointCloudNodeRecord>& GetNodes() const { return records_; }
+        /** Returns the points of a node. */
+        const std::vector<PointCloudPoint>& GetNodePoints(std::uint32_t nodeIndex) const { return nodes_[nodeIndex].points_; }
+        /** Returns the nodes changed since they were last cleared, in the order they changed first. */
+        const std::vector<std::uint32_t>& GetDirtyNodes() const { return dirtyNodes_; }
+        /** Returns the statistics. */
+        const LiveOctreeStatistics& GetStatistics() const { return statistics_; }
+
+    private:
+        /** Marks nodes without changes. */
+        static constexpr std::uint32_t NOT_DIRTY = 0xffffffff;
+
+        /** The points of a node. */
+        struct Node
+        {
+            /** Holds the points. */
+            std::vector<PointCloudPoint> points_;
+            /** Holds the occupied grid cells of inner nodes. */
+            std::unordered_set<std::uint32_t> occupiedCells_;
+            /** Holds the first point changed since the last update or NOT_DIRTY. */
+            std::uint32_t firstDirtyPoint_ = NOT_DIRTY;
+        };
+
+        void InsertPoint(std::uint32_t nodeIndex, const PointCloudPoint& point);
+        void AppendPoint(std::uint32_t nodeIndex, const PointCloudPoint& point);
+        void Split(std::uint32_t nodeIndex);
+        void MarkDirty(std::uint32_t nodeIndex, std::uint32_t firstPoint);
+
+        /** Holds the parameters. */
+        LiveOctreeParameters parameters_;
+        /** Holds the node table. */
+        std::vector<PointCloudNodeRecord> records_;
+        /** Holds the points of each node. */
+        std::vector<Node> nodes_;
+        /** Holds the changed nodes. */
+        std::vector<std::uint32_t> dirtyNodes_;
+        /** Holds the statistics. */
+        LiveOctreeStatistics statistics_;
+    };
+}
@@ -0,0 +1,79 @@
+/**
+ * @file   LockFreeQueue.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration and implementation of a bounded lock-free queue for one producer and one consumer.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace viscom {
+
+    /**
+     *  A bounded ring buffer passing values from exactly one producer thread to exactly one consumer thread without
+     *  locks. Neither side ever waits: pushing to a full queue and popping from an empty one fail instead. The
+     *  indices live on separate cache lines, so both sides do not invalidate each other's cache on every call.
+     */
+    template<typename T> class LockFreeQueue
+    {
+    public:
+        /**
+         *  Creates an empty queue.
+         *  @param capacity the maximum number of values in the queue.
+         */
+        explicit LockFreeQueue(std::size_t capacity) : slots_(capacity + 1) {}
+        LockFreeQueue(const LockFreeQueue&) = delete;
+        LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+        /**
+         *  Appends a value, called by the producer only.
+         *  @param value the value, it is only moved from if the queue is not full.
+         *  @return whether the value was appended.
+         */
+        bool TryPush(T&& value)
+        {
+            auto tail = tail_.load(std::memory_order_relaxed);
+            auto next = tail + 1 == slots_.size() ? 0 : tail + 1;
+            if (next == head_.load(std::memory_order_acquire)) return false;
+            slots_[tail] = std::move(value);
+            tail_.store(next, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         *  Removes the oldest value, called by the consumer only.
+         *  @param value the value removed.
+         *  @return whether a value was removed.
+         */
+        bool TryPop(T& value)
+        {
+            auto head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire)) return false;
+            value = std::move(slots_[head]);
+            head_.store(head + 1 == slots_.size() ? 0 : head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Returns the number of values in the queue, only exact if neither side is active. */
+        std::size_t GetSize() const
+        {
+            auto head = head_.load(std::memory_order_acquire), tail = tail_.load(std::memory_order_acquire);
+            return tail >= head ? tail - head : tail + slots_.size() - head;
+        }
+        /** Returns the maximum number of values in the queue. */
+        std::size_t GetCapacity() const { return slots_.size() - 1; }
+
+    private:
+        /** Holds the values, one slot stays empty to tell a full queue from an empty one. */
+        std::vector<T> slots_;
+        /** Holds the slot of the oldest value, written by the consumer. */
+        alignas(64) std::atomic<std::size_t> head_{ 0 };
+        /** Holds the slot after the newest value, written by the producer. */
+        alignas(64) std::atomic<std::size_t> tail_{ 0 };
+    };
+}
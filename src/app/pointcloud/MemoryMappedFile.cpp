@@ -0,0 +1,162 @@
+/**
+ * @file   MemoryMappedFile.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of a read-only memory mapped file.
+ */
+
+#include "MemoryMappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace viscom {
+
+    /**
+     *  Maps the file.
+     *  @param filename the name of the file to map.
+     */
+    MemoryMappedFile::MemoryMappedFile(const std::string& filename) :
+        filename_{ filename }
+    {
+#ifdef _WIN32
+        // writers are allowed, the chunk cache of a slave fills the file while it is mapped.
+        fileHandle_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (fileHandle_ == INVALID_HANDLE_VALUE) {
+            fileHandle_ = nullptr;
+            throw std::runtime_error("Could not open file \"" + filename + "\".");
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle_, &fileSize) || fileSize.QuadPart == 0) {
+            Close();
+            throw std::runtime_error("Could not map empty file \"" + filename + "\".");
+        }
+        size_ = static_cast<std::size_t>(fileSize.QuadPart);
+
+        mappingHandle_ = CreateFileMappingA(fileHandle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle_ == nullptr) {
+            Close();
+            throw std::runtime_error("Could not create file mapping for \"" + filename + "\".");
+        }
+
+        data_ = static_cast<const std::uint8_t*>(MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, 0));
+        if (data_ == nullptr) {
+            Close();
+            throw std::runtime_error("Could not map file \"" + filename + "\".");
+        }
+#else
+        fd_ = open(filename.c_str(), O_RDONLY);
+        if (fd_ == -1) throw std::runtime_error("Could not open file \"" + filename + "\".");
+
+        struct stat fileStat;
+        if (fstat(fd_, &fileStat) == -1 || fileStat.st_size == 0) {
+            Close();
+            throw std::runtime_error("Could not map empty file \"" + filename + "\".");
+        }
+        size_ = static_cast<std::size_t>(fileStat.st_size);
+
+        auto mapping = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED) {
+            Close();
+            throw std::runtime_error("Could not map file \"" + filename + "\".");
+        }
+        data_ = static_cast<const std::uint8_t*>(mapping);
+        // access to node chunks is driven by the view, the kernels read-ahead does not help here.
+        madvise(mapping, size_, MADV_RANDOM);
+#endif
+    }
+
+    MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& rhs) noexcept :
+        filename_{ std::move(rhs.filename_) },
+        data_{ rhs.data_ },
+        size_{ rhs.size_ },
+#ifdef _WIN32
+        fileHandle_{ rhs.fileHandle_ },
+        mappingHandle_{ rhs.mappingHandle_ }
+#else
+        fd_{ rhs.fd_ }
+#endif
+    {
+        rhs.data_ = nullptr;
+        rhs.size_ = 0;
+#ifdef _WIN32
+        rhs.fileHandle_ = nullptr;
+        rhs.mappingHandle_ = nullptr;
+#else
+        rhs.fd_ = -1;
+#endif
+    }
+
+    MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            Close();
+            filename_ = std::move(rhs.filename_);
+            std::swap(data_, rhs.data_);
+            std::swap(size_, rhs.size_);
+#ifdef _WIN32
+            std::swap(fileHandle_, rhs.fileHandle_);
+            std::swap(mappingHandle_, rhs.mappingHandle_);
+#else
+            std::swap(fd_, rhs.fd_);
+#endif
+        }
+        return *this;
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        Close();
+    }
+
+    /**
+     *  Hints the operating system that a range of the file will be accessed soon.
+     *  @param offset the start of the range.
+     *  @param size the size of the range.
+     */
+    void MemoryMappedFile::Prefetch(std::size_t offset, std::size_t size) const
+    {
+        if (data_ == nullptr || offset >= size_) return;
+        if (offset + size > size_) size = size_ - offset;
+#ifdef _WIN32
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = const_cast<std::uint8_t*>(data_ + offset);
+        range.NumberOfBytes = size;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+        static const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        auto pageOffset = offset - (offset % pageSize);
+        madvise(const_cast<std::uint8_t*>(data_ + pageOffset), size + (offset - pageOffset), MADV_WILLNEED);
+#endif
+    }
+
+    void MemoryMappedFile::Close()
+    {
+#ifdef _WIN32
+        if (data_ != nullptr) UnmapViewOfFile(data_);
+        if (mappingHandle_ != nullptr) CloseHandle(mappingHandle_);
+        if (fileHandle_ != nullptr) CloseHandle(fileHandle_);
+        mappingHandle_ = nullptr;
+        fileHandle_ = nullptr;
+#else
+        if (data_ != nullptr) munmap(const_cast<std::uint8_t*>(data_), size_);
+        if (fd_ != -1) close(fd_);
+        fd_ = -1;
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
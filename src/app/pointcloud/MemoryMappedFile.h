@@ -0,0 +1,62 @@
+/**
+ * @file   MemoryMappedFile.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of a read-only memory mapped file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace viscom {
+
+    /**
+     *  Maps a whole file read-only into the address space. Mapping is independent of the file size, pages are only
+     *  read from disk when they are accessed.
+     */
+    class MemoryMappedFile
+    {
+    public:
+        MemoryMappedFile() = default;
+        explicit MemoryMappedFile(const std::string& filename);
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile(MemoryMappedFile&&) noexcept;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(MemoryMappedFile&&) noexcept;
+        ~MemoryMappedFile();
+
+        /** Returns whether a file is mapped. */
+        bool IsOpen() const { return data_ != nullptr; }
+        /** Returns the start of the mapped file. */
+        const std::uint8_t* GetData() const { return data_; }
+        /** Returns the size of the mapped file in bytes. */
+        std::size_t GetSize() const { return size_; }
+        /** Returns the name of the mapped file. */
+        const std::string& GetFilename() const { return filename_; }
+
+        void Prefetch(std::size_t offset, std::size_t size) const;
+
+    private:
+        void Close();
+
+        /** Holds the name of the file. */
+        std::string filename_;
+        /** Holds the start of the mapping. */
+        const std::uint8_t* data_ = nullptr;
+        /** Holds the size of the mapping. */
+        std::size_t size_ = 0;
+#ifdef _WIN32
+        /** Holds the file handle. */
+        void* fileHandle_ = nullptr;
+        /** Holds the file mapping handle. */
+        void* mappingHandle_ = nullptr;
+#else
+        /** Holds the file descriptor. */
+        int fd_ = -1;
+#endif
+    };
+}
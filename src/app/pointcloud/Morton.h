@@ -0,0 +1,106 @@
+/**
+ * @file   Morton.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Morton (z-order) codes for the octree construction.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace viscom {
+
+    /** The number of bits per axis of a morton code. */
+    constexpr unsigned MORTON_BITS_PER_AXIS = 21;
+    /** The deepest octree level that can be addressed by morton codes. */
+    constexpr unsigned MORTON_MAX_LEVEL = MORTON_BITS_PER_AXIS;
+
+    /** Inserts two zero bits between each of the lower 21 bits of a value. */
+    inline std::uint64_t MortonSpreadBits(std::uint64_t v)
+    {
+        v &= 0x1fffff;
+        v = (v | v << 32) & 0x1f00000000ffff;
+        v = (v | v << 16) & 0x1f0000ff0000ff;
+        v = (v | v << 8) & 0x100f00f00f00f00f;
+        v = (v | v << 4) & 0x10c30c30c30c30c3;
+        v = (v | v << 2) & 0x1249249249249249;
+        return v;
+    }
+
+    /** Removes the two bits between each of the bits of a spread value (inverse of MortonSpreadBits). */
+    inline std::uint64_t MortonCompactBits(std::uint64_t v)
+    {
+        v &= 0x1249249249249249;
+        v = (v ^ (v >> 2)) & 0x10c30c30c30c30c3;
+        v = (v ^ (v >> 4)) & 0x100f00f00f00f00f;
+        v = (v ^ (v >> 8)) & 0x1f0000ff0000ff;
+        v = (v ^ (v >> 16)) & 0x1f00000000ffff;
+        v = (v ^ (v >> 32)) & 0x1fffff;
+        return v;
+    }
+
+    /** Returns the octant (bit 0: x, bit 1: y, bit 2: z) of a code on a given octree level (1 is the first level below the root). */
+    inline unsigned MortonOctant(std::uint64_t code, unsigned level)
+    {
+        return static_cast<unsigned>(code >> (3 * (MORTON_MAX_LEVEL - level))) & 7;
+    }
+
+    /** Returns the code prefix identifying the octree cell of a code on a given level. */
+    inline std::uint64_t MortonPrefix(std::uint64_t code, unsigned level)
+    {
+        return level == 0 ? 0 : code >> (3 * (MORTON_MAX_LEVEL - level));
+    }
+
+    /** Maps positions inside a cube to morton codes. */
+    class MortonGrid
+    {
+    public:
+        MortonGrid() = default;
+        /**
+         *  Creates the smallest cube containing the given bounding box.
+         *  @param boundsMin the minimum of the bounding box.
+         *  @param boundsMax the maximum of the bounding box.
+         */
+        MortonGrid(const glm::vec3& boundsMin, const glm::vec3& boundsMax) :
+            origin_{ boundsMin },
+            size_{ glm::max(glm::max(boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y), glm::max(boundsMax.z - boundsMin.z, 1e-6f)) },
+            scale_{ static_cast<float>(1 << MORTON_BITS_PER_AXIS) / size_ }
+        {
+        }
+
+        /** Returns the morton code of a position. */
+        std::uint64_t Encode(const glm::vec3& position) const
+        {
+            const auto maxCell = static_cast<float>((1 << MORTON_BITS_PER_AXIS) - 1);
+            auto cell = glm::clamp((position - origin_) * scale_, glm::vec3(0.0f), glm::vec3(maxCell));
+            return MortonSpreadBits(static_cast<std::uint64_t>(cell.x)) | (MortonSpreadBits(static_cast<std::uint64_t>(cell.y)) << 1)
+                | (MortonSpreadBits(static_cast<std::uint64_t>(cell.z)) << 2);
+        }
+
+        /** Returns the minimum of the cell identified by a code prefix on a given level. */
+        glm::vec3 GetCellMin(std::uint64_t prefix, unsigned level) const
+        {
+            auto code = level == 0 ? 0 : prefix << (3 * (MORTON_MAX_LEVEL - level));
+            glm::vec3 cell{ static_cast<float>(MortonCompactBits(code)), static_cast<float>(MortonCompactBits(code >> 1)), static_cast<float>(MortonCompactBits(code >> 2)) };
+            return origin_ + cell / scale_;
+        }
+
+        /** Returns the edge length of the cells on a given level. */
+        float GetCellSize(unsigned level) const { return size_ / static_cast<float>(1 << level); }
+        /** Returns the minimum of the cube. */
+        const glm::vec3& GetOrigin() const { return origin_; }
+        /** Returns the edge length of the cube. */
+        float GetSize() const { return size_; }
+
+    private:
+        /** Holds the minimum of the cube. */
+        glm::vec3 origin_;
+        /** Holds the edge length of the cube. */
+        float size_ = 1.0f;
+        /** Holds the number of cells per unit length. */
+        float scale_ = 1.0f;
+    };
+}
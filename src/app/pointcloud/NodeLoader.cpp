@@ -0,0 +1,120 @@
+/**
+ * @file   NodeLoader.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the asynchronous loader for octree nodes.
+ */
+
+#include "NodeLoader.h"
+#include "PointCloudFile.h"
+
+#include <algorithm>
+
+namespace viscom {
+
+    /**
+     *  Starts the worker threads.
+     *  @param file the point cloud file.
+     *  @param numThreads the number of worker threads.
+     */
+    NodeLoader::NodeLoader(const PointCloudFile& file, unsigned numThreads) :
+        file_{ file },
+        states_{ new std::atomic<State>[file.GetNumNodes()] }
+    {
+        for (auto i = 0U; i < file.GetNumNodes(); ++i) states_[i] = State::None;
+        for (auto t = 0U; t < std::max(1U, numThreads); ++t) workers_.emplace_back(&NodeLoader::WorkerLoop, this);
+    }
+
+    NodeLoader::~NodeLoader()
+    {
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            stop_ = true;
+        }
+        wakeUp_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    /**
+     *  Replaces all pending requests. Nodes currently loading or already loaded are not affected.
+     *  @param requests the new requests.
+     */
+    void NodeLoader::Request(const std::vector<NodeLoadRequest>& requests)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            for (const auto& request : pending_) {
+                auto expected = State::Queued;
+                states_[request.nodeIndex_].compare_exchange_strong(expected, State::None);
+            }
+            pending_.clear();
+
+            for (const auto& request : requests) {
+                auto expected = State::None;
+                if (states_[request.nodeIndex_].compare_exchange_strong(expected, State::Queued)) pending_.push_back(request);
+            }
+            std::make_heap(pending_.begin(), pending_.end());
+        }
+        wakeUp_.notify_all();
+    }
+
+    std::size_t NodeLoader::GetNumQueued() const
+    {
+        std::lock_guard<std::mutex> lock{ mutex_ };
+        return pending_.size();
+    }
+
+    void NodeLoader::WorkerLoop()
+    {
+        while (true) {
+            NodeLoadRequest request;
+            {
+                std::unique_lock<std::mutex> lock{ mutex_ };
+                wakeUp_.wait(lock, [this]() { return stop_ || !pending_.empty(); });
+                if (stop_) return;
+
+                std::pop_heap(pending_.begin(), pending_.end());
+                request = pending_.back();
+                pending_.pop_back();
+                states_[request.nodeIndex_] = State::Loading;
+            }
+
+            LoadNode(request);
+            states_[request.nodeIndex_] = State::Ready;
+        }
+    }
+
+    void NodeLoader::LoadNode(const NodeLoadRequest& request)
+    {
+        auto nodeIndex = request.nodeIndex_;
+        if (request.columns_ == 0 || !file_.IsColumnar()) {
+            if (file_.GetNodeDataSize(nodeIndex) == 0) return;
+            file_.PrefetchNode(nodeIndex);
+            numLoadedBytes_ += TouchPages(file_.GetNodeData(nodeIndex), file_.GetNodeDataSize(nodeIndex));
+            return;
+        }
+
+        // the columns of a chunk are consecutive, all requested ones are prefetched before the first is touched.
+        for (std::uint32_t a = 0; a < POINTCLOUD_NUM_ATTRIBUTES; ++a) {
+            if ((request.columns_ & (1U << a)) != 0) file_.PrefetchColumn(nodeIndex, static_cast<PointAttribute>(a));
+        }
+        for (std::uint32_t a = 0; a < POINTCLOUD_NUM_ATTRIBUTES; ++a) {
+            auto attribute = static_cast<PointAttribute>(a);
+            if ((request.columns_ & (1U << a)) == 0 || file_.GetColumnSize(nodeIndex, attribute) == 0) continue;
+            numLoadedBytes_ += TouchPages(file_.GetColumnData(nodeIndex, attribute), file_.GetColumnSize(nodeIndex, attribute));
+        }
+    }
+
+    /** Reads one byte of each page of a range, returns the size of the range. */
+    std::size_t NodeLoader::TouchPages(const void* data, std::size_t size)
+    {
+        // touching each page makes the kernel read it, the render thread then uploads from memory.
+        auto bytes = static_cast<const volatile std::uint8_t*>(data);
+        std::uint8_t sink = 0;
+        for (std::size_t offset = 0; offset < size; offset += 4096) sink ^= bytes[offset];
+        sink ^= bytes[size - 1];
+        (void)sink;
+        return size;
+    }
+}
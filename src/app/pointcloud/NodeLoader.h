@@ -0,0 +1,95 @@
+/**
+ * @file   NodeLoader.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the asynchronous loader for octree nodes.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace viscom {
+
+    class PointCloudFile;
+
+    /** A request for loading a node. */
+    struct NodeLoadRequest
+    {
+        /** The priority of the request, higher priorities are loaded first. */
+        float priority_;
+        /** The index of the node. */
+        std::uint32_t nodeIndex_;
+        /** The columns of a columnar file to load, one bit per PointAttribute (0 loads the whole chunk). */
+        std::uint32_t columns_ = 0;
+
+        bool operator<(const NodeLoadRequest& rhs) const { return priority_ < rhs.priority_; }
+    };
+
+    /**
+     *  Loads the chunks of octree nodes on background threads. Loading pages the mapped chunk into memory, so the
+     *  upload on the render thread copies from memory without waiting for the disk. For columnar files a request
+     *  can name the columns it needs, only their pages are read.
+     *  The set of requests is replaced each frame, so nodes that are no longer visible are never loaded.
+     */
+    class NodeLoader
+    {
+    public:
+        /** The loading state of a node. */
+        enum class State : std::uint8_t
+        {
+            /** The node is neither requested nor loaded. */
+            None,
+            /** The node is waiting for a worker. */
+            Queued,
+            /** A worker is loading the node. */
+            Loading,
+            /** The node is in memory and can be uploaded. */
+            Ready
+        };
+
+        NodeLoader(const PointCloudFile& file, unsigned numThreads);
+        NodeLoader(const NodeLoader&) = delete;
+        NodeLoader& operator=(const NodeLoader&) = delete;
+        ~NodeLoader();
+
+        void Request(const std::vector<NodeLoadRequest>& requests);
+        /** Returns the loading state of a node. */
+        State GetState(std::uint32_t nodeIndex) const { return states_[nodeIndex].load(); }
+        /** Marks a node as consumed after it was uploaded. */
+        void Release(std::uint32_t nodeIndex) { states_[nodeIndex] = State::None; }
+        /** Returns the number of nodes waiting for a worker. */
+        std::size_t GetNumQueued() const;
+        /** Returns the number of bytes loaded since the loader was created. */
+        std::uint64_t GetNumLoadedBytes() const { return numLoadedBytes_; }
+
+    private:
+        void WorkerLoop();
+        void LoadNode(const NodeLoadRequest& request);
+        static std::size_t TouchPages(const void* data, std::size_t size);
+
+        /** Holds the point cloud file. */
+        const PointCloudFile& file_;
+        /** Holds the loading state of each node. */
+        std::unique_ptr<std::atomic<State>[]> states_;
+        /** Holds the pending requests as a heap. */
+        std::vector<NodeLoadRequest> pending_;
+        /** Synchronizes the pending requests. */
+        mutable std::mutex mutex_;
+        /** Wakes up workers when new requests arrive. */
+        std::condition_variable wakeUp_;
+        /** Holds whether the workers should terminate. */
+        bool stop_ = false;
+        /** Holds the number of bytes loaded. */
+        std::atomic<std::uint64_t> numLoadedBytes_{ 0 };
+        /** Holds the worker threads. */
+        std::vector<std::thread> workers_;
+    };
+}
@@ -0,0 +1,219 @@
+/**
+ * @file   OctreeBuilder.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the builder for the level of detail octree.
+ */
+
+#include "OctreeBuilder.h"
+#include "Parallel.h"
+#include "PointCloudWriter.h"
+
+#include <algorithm>
+
+namespace viscom {
+
+    /**
+     *  Constructor.
+     *  @param options the build options.
+     */
+    OctreeBuilder::OctreeBuilder(const OctreeBuildOptions& options) :
+        options_{ options }
+    {
+    }
+
+    /**
+     *  Builds the octree and writes all node chunks.
+     *  @param points the points sorted by their morton codes.
+     *  @param codes the sorted morton codes.
+     *  @param numPoints the number of points.
+     *  @param grid the grid used to compute the morton codes.
+     *  @param boundsMin the minimum of the bounding box of all points.
+     *  @param boundsMax the maximum of the bounding box of all points.
+     *  @param writer the writer for the node chunks.
+     *  @param attributes the scan attributes in the order of the points, passed to the writer with each chunk (may be nullptr).
+     *  @return the node records in breadth first order.
+     */
+    std::vector<PointCloudNodeRecord> OctreeBuilder::Build(const PointCloudPoint* points, const std::uint64_t* codes, std::uint64_t numPoints,
+        const MortonGrid& grid, const glm::vec3& boundsMin, const glm::vec3& boundsMax, PointCloudWriter& writer, const PointCloudAttributes* attributes)
+    {
+        points_ = points;
+        attributes_ = attributes;
+        writer_ = &writer;
+        numDroppedPoints_ = 0;
+
+        BuildStructure(codes, numPoints, grid, boundsMin, boundsMax);
+
+        // a task root is the topmost node of a subtree small enough to be built by a single thread.
+        std::vector<std::uint32_t> taskRoots;
+        std::vector<std::vector<std::uint32_t>> upperLevels;
+        std::vector<char> inTask(nodes_.size(), 0);
+        for (auto i = 0U; i < nodes_.size(); ++i) {
+            const auto& node = nodes_[i];
+            if (node.parent_ != POINTCLOUD_NO_NODE && inTask[node.parent_]) {
+                inTask[i] = 1;
+            } else if (nodeEnd_[i] - nodeBegin_[i] <= options_.maxPointsPerTask_ || node.numChildren_ == 0) {
+                inTask[i] = 1;
+                taskRoots.push_back(i);
+            } else {
+                if (upperLevels.size() <= node.level_) upperLevels.resize(node.level_ + 1U);
+                upperLevels[node.level_].push_back(i);
+            }
+        }
+
+        auto numThreads = GetNumWorkerThreads(options_.numThreads_);
+        std::vector<ChunkBuffer> chunkBuffers(numThreads);
+        for (auto& chunkBuffer : chunkBuffers) chunkBuffer.subsampler_ = Subsampler{ options_.sampling_ };
+        std::vector<PointIndexList> remainingPoints(nodes_.size());
+
+        ParallelForDynamic(taskRoots.size(), numThreads, [this, &taskRoots, &chunkBuffers, &remainingPoints](std::size_t i, unsigned t) {
+            remainingPoints[taskRoots[i]] = BuildSubtree(taskRoots[i], chunkBuffers[t]);
+        });
+
+        for (auto level = upperLevels.size(); level > 0; --level) {
+            const auto& levelNodes = upperLevels[level - 1];
+            // the top levels have fewer nodes than threads, the remaining threads help sampling each node.
+            auto samplingThreads = std::max(1U, numThreads / static_cast<unsigned>(levelNodes.size()));
+            ParallelForDynamic(levelNodes.size(), numThreads, [this, &levelNodes, &chunkBuffers, &remainingPoints, samplingThreads](std::size_t i, unsigned t) {
+                const auto& node = nodes_[levelNodes[i]];
+                std::vector<PointIndexList> childPoints(node.numChildren_);
+                for (auto c = 0U; c < node.numChildren_; ++c) childPoints[c].swap(remainingPoints[node.firstChild_ + c]);
+                remainingPoints[levelNodes[i]] = SampleChildren(levelNodes[i], childPoints, chunkBuffers[t], samplingThreads);
+            });
+        }
+
+        WriteNode(0, remainingPoints[0], chunkBuffers[0]);
+        return std::move(nodes_);
+    }
+
+    void OctreeBuilder::BuildStructure(const std::uint64_t* codes, std::uint64_t numPoints, const MortonGrid& grid, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+    {
+        nodes_.clear();
+        nodeBegin_.clear();
+        nodeEnd_.clear();
+        std::vector<std::uint64_t> prefixes;
+
+        PointCloudNodeRecord root;
+        root.boundsMin_ = boundsMin;
+        root.boundsMax_ = boundsMax;
+        nodes_.push_back(root);
+        nodeBegin_.push_back(0);
+        nodeEnd_.push_back(numPoints);
+        prefixes.push_back(0);
+
+        // nodes_ is used as the queue for the breadth first traversal, so children end up consecutive.
+        for (auto i = 0U; i < nodes_.size(); ++i) {
+            auto begin = nodeBegin_[i];
+            auto end = nodeEnd_[i];
+            unsigned level = nodes_[i].level_;
+            if (end - begin <= options_.maxPointsPerNode_ || level == MORTON_MAX_LEVEL) continue;
+
+            nodes_[i].firstChild_ = static_cast<std::uint32_t>(nodes_.size());
+            auto childLevel = level + 1;
+            auto childPrefixBase = prefixes[i] << 3;
+            auto shift = 3 * (MORTON_MAX_LEVEL - childLevel);
+            auto childBegin = begin;
+            for (auto octant = 0U; octant < 8; ++octant) {
+                auto childEnd = static_cast<std::uint64_t>(std::lower_bound(codes + childBegin, codes + end, (childPrefixBase + octant + 1) << shift) - codes);
+                if (childEnd == childBegin) continue;
+
+                PointCloudNodeRecord child;
+                auto cellMin = grid.GetCellMin(childPrefixBase + octant, childLevel);
+                child.boundsMin_ = glm::max(cellMin, boundsMin);
+                child.boundsMax_ = glm::min(cellMin + glm::vec3(grid.GetCellSize(childLevel)), boundsMax);
+                child.parent_ = i;
+                child.level_ = static_cast<std::uint8_t>(childLevel);
+                nodes_[i].childMask_ |= static_cast<std::uint8_t>(1 << octant);
+                nodes_[i].numChildren_ += 1;
+
+                nodes_.push_back(child);
+                nodeBegin_.push_back(childBegin);
+                nodeEnd_.push_back(childEnd);
+                prefixes.push_back(childPrefixBase + octant);
+                childBegin = childEnd;
+            }
+        }
+    }
+
+    /**
+     *  Builds a subtree bottom-up and writes the chunks of all its nodes except the subtree root.
+     *  @param nodeIndex the root of the subtree.
+     *  @param chunkBuffer the threads buffer for gathering chunks.
+     *  @return the points of the subtree root, which may still be sampled by its parent.
+     */
+    OctreeBuilder::PointIndexList OctreeBuilder::BuildSubtree(std::uint32_t nodeIndex, ChunkBuffer& chunkBuffer)
+    {
+        const auto& node = nodes_[nodeIndex];
+        if (node.numChildren_ == 0) {
+            auto begin = nodeBegin_[nodeIndex];
+            auto end = nodeEnd_[nodeIndex];
+            if (end - begin > options_.maxPointsPerNode_) {
+                numDroppedPoints_ += end - begin - options_.maxPointsPerNode_;
+                end = begin + options_.maxPointsPerNode_;
+            }
+            PointIndexList result(end - begin);
+            for (auto i = begin; i < end; ++i) result[i - begin] = i;
+            return result;
+        }
+
+        std::vector<PointIndexList> childPoints(node.numChildren_);
+        for (auto c = 0U; c < node.numChildren_; ++c) childPoints[c] = BuildSubtree(node.firstChild_ + c, chunkBuffer);
+        return SampleChildren(nodeIndex, childPoints, chunkBuffer);
+    }
+
+    /**
+     *  Moves a subsample of the childrens points to a node and writes the remaining points of the children.
+     *  The children are sampled together with the method of the build options. As the points are sorted by their
+     *  morton codes even the stride sampling spreads the sample over the nodes volume, the grid based methods give
+     *  a more even spacing on scans of varying density.
+     *  @param nodeIndex the index of the node.
+     *  @param childPoints the remaining points of each child.
+     *  @param chunkBuffer the threads buffer for gathering chunks.
+     *  @param numThreads the number of threads used for sampling.
+     *  @return the points of the node.
+     */
+    OctreeBuilder::PointIndexList OctreeBuilder::SampleChildren(std::uint32_t nodeIndex, std::vector<PointIndexList>& childPoints, ChunkBuffer& chunkBuffer, unsigned numThreads)
+    {
+        const auto& node = nodes_[nodeIndex];
+        auto& candidates = chunkBuffer.candidates_;
+        candidates.clear();
+        for (const auto& points : childPoints) candidates.insert(candidates.end(), points.begin(), points.end());
+
+        // keep at least three of four points in the children, coarse levels of surface scans are four times sparser.
+        auto maxSamples = std::min<std::size_t>(options_.maxPointsPerNode_, (candidates.size() + 3) / 4);
+        const auto& selected = chunkBuffer.subsampler_.Sample(points_, candidates.data(), candidates.size(), node.boundsMin_, node.boundsMax_, maxSamples, numThreads);
+
+        PointIndexList result;
+        result.reserve(chunkBuffer.subsampler_.GetNumSamples());
+        std::size_t counter = 0;
+        for (auto c = 0U; c < childPoints.size(); ++c) {
+            auto& points = childPoints[c];
+            auto kept = points.begin();
+            for (auto pointIndex : points) {
+                if (selected[counter++] != 0) result.push_back(pointIndex);
+                else *kept++ = pointIndex;
+            }
+            points.erase(kept, points.end());
+            WriteNode(node.firstChild_ + c, points, chunkBuffer);
+            PointIndexList().swap(points);
+        }
+        return result;
+    }
+
+    void OctreeBuilder::WriteNode(std::uint32_t nodeIndex, const PointIndexList& pointIndices, ChunkBuffer& chunkBuffer)
+    {
+        auto& node = nodes_[nodeIndex];
+        node.numPoints_ = static_cast<std::uint32_t>(pointIndices.size());
+        if (pointIndices.empty()) return;
+
+        chunkBuffer.points_.resize(pointIndices.size());
+        for (auto i = 0U; i < pointIndices.size(); ++i) chunkBuffer.points_[i] = points_[pointIndices[i]];
+        if (attributes_ != nullptr) {
+            chunkBuffer.attributes_.resize(pointIndices.size());
+            for (auto i = 0U; i < pointIndices.size(); ++i) chunkBuffer.attributes_[i] = attributes_[pointIndices[i]];
+        }
+        node.dataOffset_ = writer_->WriteChunk(chunkBuffer.points_.data(), chunkBuffer.points_.size(), node.boundsMin_, node.boundsMax_,
+            attributes_ != nullptr ? chunkBuffer.attributes_.data() : nullptr);
+    }
+}
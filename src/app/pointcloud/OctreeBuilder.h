@@ -0,0 +1,91 @@
+/**
+ * @file   OctreeBuilder.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the builder for the level of detail octree.
+ */
+
+#pragma once
+
+#include "Morton.h"
+#include "PointCloudFormat.h"
+#include "Subsampler.h"
+
+#include <atomic>
+#include <vector>
+
+namespace viscom {
+
+    class PointCloudWriter;
+
+    /** Options for building a level of detail octree. */
+    struct OctreeBuildOptions
+    {
+        /** The maximum number of points in a single node. */
+        std::uint32_t maxPointsPerNode_ = 32768;
+        /** Subtrees with at most this many points are built by a single thread. */
+        std::uint64_t maxPointsPerTask_ = 1 << 22;
+        /** The number of threads to use (0 uses all hardware threads). */
+        unsigned numThreads_ = 0;
+        /** The way inner nodes choose their points from the points of their children. */
+        SubsamplingMethod sampling_ = SubsamplingMethod::Stride;
+    };
+
+    /**
+     *  Builds the level of detail octree from points sorted by their morton codes.
+     *  The structure is determined top-down by splitting the sorted code range, the level of detail is created
+     *  bottom-up: each inner node takes a subsample of the points remaining in its children. Subtrees are built in
+     *  parallel, the levels above them level by level.
+     */
+    class OctreeBuilder
+    {
+    public:
+        explicit OctreeBuilder(const OctreeBuildOptions& options);
+
+        std::vector<PointCloudNodeRecord> Build(const PointCloudPoint* points, const std::uint64_t* codes, std::uint64_t numPoints,
+            const MortonGrid& grid, const glm::vec3& boundsMin, const glm::vec3& boundsMax, PointCloudWriter& writer,
+            const PointCloudAttributes* attributes = nullptr);
+
+        /** Returns the number of points dropped because too many points fell into a cell on the deepest level. */
+        std::uint64_t GetNumDroppedPoints() const { return numDroppedPoints_; }
+
+    private:
+        using PointIndexList = std::vector<std::uint64_t>;
+
+        /** The buffers of a thread for gathering the points of a chunk. */
+        struct ChunkBuffer
+        {
+            /** Holds the points. */
+            std::vector<PointCloudPoint> points_;
+            /** Holds the scan attributes of the points. */
+            std::vector<PointCloudAttributes> attributes_;
+            /** Holds the points of all children of a node while sampling. */
+            PointIndexList candidates_;
+            /** Holds the subsampler and its scratch memory. */
+            Subsampler subsampler_;
+        };
+
+        void BuildStructure(const std::uint64_t* codes, std::uint64_t numPoints, const MortonGrid& grid, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+        PointIndexList BuildSubtree(std::uint32_t nodeIndex, ChunkBuffer& chunkBuffer);
+        PointIndexList SampleChildren(std::uint32_t nodeIndex, std::vector<PointIndexList>& childPoints, ChunkBuffer& chunkBuffer, unsigned numThreads = 1);
+        void WriteNode(std::uint32_t nodeIndex, const PointIndexList& pointIndices, ChunkBuffer& chunkBuffer);
+
+        /** Holds the build options. */
+        OctreeBuildOptions options_;
+        /** Holds the (sorted) input points. */
+        const PointCloudPoint* points_ = nullptr;
+        /** Holds the scan attributes of the input points (may be nullptr). */
+        const PointCloudAttributes* attributes_ = nullptr;
+        /** Holds the writer for the node chunks. */
+        PointCloudWriter* writer_ = nullptr;
+        /** Holds the node records in breadth first order. */
+        std::vector<PointCloudNodeRecord> nodes_;
+        /** Holds the first point of the range of each node. */
+        std::vector<std::uint64_t> nodeBegin_;
+        /** Holds the end of the point range of each node. */
+        std::vector<std::uint64_t> nodeEnd_;
+        /** Holds the number of dropped points. */
+        std::atomic<std::uint64_t> numDroppedPoints_{ 0 };
+    };
+}
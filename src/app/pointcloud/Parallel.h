@@ -0,0 +1,77 @@
+/**
+ * @file   Parallel.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Helpers for distributing work over multiple threads.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace viscom {
+
+    /**
+     *  Returns the number of threads to use.
+     *  @param requestedThreads the requested number of threads, 0 uses all hardware threads.
+     */
+    inline unsigned GetNumWorkerThreads(unsigned requestedThreads = 0)
+    {
+        if (requestedThreads != 0) return requestedThreads;
+        return std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    /**
+     *  Splits the range [0, count) in one contiguous block per thread and processes the blocks in parallel.
+     *  The calling thread processes the last block.
+     *  @param count the number of elements.
+     *  @param numThreads the number of threads to use.
+     *  @param fn the function called as fn(begin, end, threadIndex) for each block.
+     */
+    template<typename Fn> void ParallelForBlocks(std::size_t count, unsigned numThreads, Fn fn)
+    {
+        numThreads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(numThreads, count)));
+        if (numThreads == 1) {
+            fn(std::size_t{ 0 }, count, 0U);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        auto blockSize = (count + numThreads - 1) / numThreads;
+        for (auto t = 0U; t < numThreads; ++t) {
+            auto begin = std::min(count, t * blockSize);
+            auto end = std::min(count, begin + blockSize);
+            if (t == numThreads - 1) fn(begin, end, t);
+            else threads.emplace_back([&fn, begin, end, t]() { fn(begin, end, t); });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+
+    /**
+     *  Processes the elements [0, count) in parallel, threads fetch the next element when they are done.
+     *  Used for work items with very different costs.
+     *  @param count the number of elements.
+     *  @param numThreads the number of threads to use.
+     *  @param fn the function called as fn(index, threadIndex) for each element.
+     */
+    template<typename Fn> void ParallelForDynamic(std::size_t count, unsigned numThreads, Fn fn)
+    {
+        std::atomic<std::size_t> nextIndex{ 0 };
+        numThreads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(numThreads, count)));
+        auto worker = [&fn, &nextIndex, count](unsigned threadIndex) {
+            for (auto i = nextIndex++; i < count; i = nextIndex++) fn(i, threadIndex);
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        for (auto t = 1U; t < numThreads; ++t) threads.emplace_back(worker, t);
+        worker(0);
+        for (auto& thread : threads) thread.join();
+    }
+}
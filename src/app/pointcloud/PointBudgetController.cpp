@@ -0,0 +1,78 @@
+/**
+ * @file   PointBudgetController.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the controller adapting the point budget to the frame time.
+ */
+
+#include "PointBudgetController.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace viscom {
+
+    /**
+     *  Creates a controller starting at the given budget.
+     *  @param budget the initial budget.
+     */
+    PointBudgetController::PointBudgetController(std::uint64_t budget) :
+        budget_{ budget }
+    {
+    }
+
+    /**
+     *  Adds the frame time of a frame and adapts the budget.
+     *  @param frameTime the time of the frame in milliseconds, frames without a measurement are skipped.
+     *  @return the budget of the next frame.
+     */
+    std::uint64_t PointBudgetController::Update(float frameTime)
+    {
+        if (!(frameTime > 0.0f) || !(parameters_.targetFrameTime_ > 0.0f)) return budget_;
+
+        if (smoothedFrameTime_ == 0.0f) smoothedFrameTime_ = frameTime;
+        else smoothedFrameTime_ += parameters_.smoothing_ * (frameTime - smoothedFrameTime_);
+        ++framesSinceChange_;
+
+        auto load = GetLoad();
+        if (load < parameters_.lowerLoad_) ++framesBelowLowerLoad_;
+        else framesBelowLowerLoad_ = 0;
+        if (framesSinceChange_ < parameters_.settleFrames_) return budget_;
+
+        auto targetLoad = 0.5f * (parameters_.lowerLoad_ + parameters_.upperLoad_);
+        auto factor = 1.0f;
+        if (load > parameters_.upperLoad_) factor = std::max(parameters_.maxReduction_, targetLoad / load);
+        else if (framesBelowLowerLoad_ >= parameters_.raiseDelay_) factor = std::min(parameters_.maxRaise_, targetLoad / load);
+
+        auto budget = ClampBudget(static_cast<double>(budget_) * factor);
+        if (budget == budget_) return budget_;
+
+        // the smoothed time still reflects the old budget, it is predicted for the new one until new frames arrive.
+        smoothedFrameTime_ *= static_cast<float>(static_cast<double>(budget) / static_cast<double>(budget_));
+        budget_ = budget;
+        framesSinceChange_ = 0;
+        framesBelowLowerLoad_ = 0;
+        ++numChanges_;
+        return budget_;
+    }
+
+    /**
+     *  Sets the budget, e.g. when it was chosen by hand, and forgets the measured frame times.
+     *  @param budget the new budget.
+     */
+    void PointBudgetController::Reset(std::uint64_t budget)
+    {
+        budget_ = budget;
+        smoothedFrameTime_ = 0.0f;
+        framesSinceChange_ = 0;
+        framesBelowLowerLoad_ = 0;
+    }
+
+    /** Clamps a budget to the limits and rounds it to thousands of points, so tiny changes are skipped. */
+    std::uint64_t PointBudgetController::ClampBudget(double budget) const
+    {
+        auto rounded = static_cast<std::uint64_t>(std::round(budget / 1000.0)) * 1000;
+        return std::min(std::max(rounded, parameters_.minBudget_), std::max(parameters_.minBudget_, parameters_.maxBudget_));
+    }
+}
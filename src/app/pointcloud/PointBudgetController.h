@@ -0,0 +1,83 @@
+/**
+ * @file   PointBudgetController.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the controller adapting the point budget to the frame time.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace viscom {
+
+    /** Parameters of the point budget controller. */
+    struct PointBudgetControllerParameters
+    {
+        /** The frame time the budget is adjusted to in milliseconds. */
+        float targetFrameTime_ = 1000.0f / 60.0f;
+        /** The load (frame time relative to the target) above which the budget is reduced. */
+        float upperLoad_ = 0.95f;
+        /** The load below which the budget is raised, in between the budget is kept. */
+        float lowerLoad_ = 0.75f;
+        /** The smallest budget chosen. */
+        std::uint64_t minBudget_ = 100000;
+        /** The largest budget chosen. */
+        std::uint64_t maxBudget_ = 50000000;
+        /** The number of frames after a change until the next one, the measured times lag behind a few frames. */
+        unsigned settleFrames_ = 10;
+        /** The number of consecutive frames below the lower load until the budget is raised. */
+        unsigned raiseDelay_ = 30;
+        /** The largest factor the budget is raised by at once. */
+        float maxRaise_ = 1.2f;
+        /** The smallest factor the budget is reduced by at once. */
+        float maxReduction_ = 0.5f;
+        /** The weight of a new frame time in the smoothed frame time. */
+        float smoothing_ = 0.25f;
+    };
+
+    /**
+     *  Adapts the point budget to the measured frame times. The budget is reduced as soon as the smoothed frame time
+     *  exceeds the upper load and raised slowly after it stayed below the lower load for a while; in between the
+     *  budget is kept, so the level of detail does not pop back and forth. The cost of a frame is assumed to be
+     *  roughly proportional to the budget, each change aims for the middle between both loads.
+     */
+    class PointBudgetController
+    {
+    public:
+        explicit PointBudgetController(std::uint64_t budget);
+
+        std::uint64_t Update(float frameTime);
+        void Reset(std::uint64_t budget);
+
+        /** Returns the parameters. */
+        PointBudgetControllerParameters& GetParameters() { return parameters_; }
+        /** Returns the parameters. */
+        const PointBudgetControllerParameters& GetParameters() const { return parameters_; }
+        /** Returns the current budget. */
+        std::uint64_t GetBudget() const { return budget_; }
+        /** Returns the smoothed frame time in milliseconds. */
+        float GetSmoothedFrameTime() const { return smoothedFrameTime_; }
+        /** Returns the smoothed frame time relative to the target. */
+        float GetLoad() const { return smoothedFrameTime_ / parameters_.targetFrameTime_; }
+        /** Returns the number of budget changes so far. */
+        std::uint64_t GetNumChanges() const { return numChanges_; }
+
+    private:
+        std::uint64_t ClampBudget(double budget) const;
+
+        /** Holds the parameters. */
+        PointBudgetControllerParameters parameters_;
+        /** Holds the current budget. */
+        std::uint64_t budget_;
+        /** Holds the smoothed frame time, zero until the first measurement. */
+        float smoothedFrameTime_ = 0.0f;
+        /** Holds the number of frames since the last change. */
+        unsigned framesSinceChange_ = 0;
+        /** Holds the number of consecutive frames below the lower load. */
+        unsigned framesBelowLowerLoad_ = 0;
+        /** Holds the number of budget changes. */
+        std::uint64_t numChanges_ = 0;
+    };
+}
@@ -0,0 +1,123 @@
+/**
+ * @file   PointCloudFile.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the reader for out-of-core point cloud files.
+ */
+
+#include "PointCloudFile.h"
+
+#include <stdexcept>
+
+namespace viscom {
+
+    /**
+     *  Maps a point cloud file and validates its header and node table.
+     *  @param filename the name of the point cloud file.
+     */
+    PointCloudFile::PointCloudFile(const std::string& filename) :
+        file_{ filename }
+    {
+        if (file_.GetSize() < sizeof(PointCloudFileHeader)) throw std::runtime_error("File \"" + filename + "\" is not a point cloud file.");
+
+        header_ = reinterpret_cast<const PointCloudFileHeader*>(file_.GetData());
+        if (header_->magic_ != POINTCLOUD_MAGIC) throw std::runtime_error("File \"" + filename + "\" is not a point cloud file.");
+        if (header_->version_ != POINTCLOUD_VERSION) throw std::runtime_error("Point cloud file \"" + filename + "\" has an unsupported version.");
+        if (IsColumnar()) {
+            // every columnar file stores positions and colors, the scan attributes are optional.
+            if ((header_->attributes_ & ~POINTCLOUD_ALL_ATTRIBUTES) != 0 || (header_->attributes_ & POINTCLOUD_POSITION_COLOR) != POINTCLOUD_POSITION_COLOR
+                || header_->pointStride_ != GetColumnarStride(header_->attributes_))
+                throw std::runtime_error("Point cloud file \"" + filename + "\" has an unsupported point layout.");
+        } else if (GetPointLayoutStride(header_->pointLayout_) == 0 || header_->pointStride_ != GetPointLayoutStride(header_->pointLayout_)) {
+            throw std::runtime_error("Point cloud file \"" + filename + "\" has an unsupported point layout.");
+        }
+
+        auto nodeTableSize = static_cast<std::uint64_t>(header_->numNodes_) * sizeof(PointCloudNodeRecord);
+        if (header_->numNodes_ == 0 || header_->nodeTableOffset_ % alignof(PointCloudNodeRecord) != 0
+            || header_->nodeTableOffset_ > file_.GetSize() || nodeTableSize > file_.GetSize() - header_->nodeTableOffset_)
+            throw std::runtime_error("Point cloud file \"" + filename + "\" is truncated.");
+
+        nodes_ = reinterpret_cast<const PointCloudNodeRecord*>(file_.GetData() + header_->nodeTableOffset_);
+
+        // the traversals follow the links and map the chunks without further checks, so corrupt records fail here.
+        for (std::uint32_t i = 0; i < header_->numNodes_; ++i) {
+            const auto& node = nodes_[i];
+            auto childrenValid = node.numChildren_ == 0 || (node.firstChild_ > i && static_cast<std::uint64_t>(node.firstChild_) + node.numChildren_ <= header_->numNodes_);
+            auto parentValid = node.parent_ == POINTCLOUD_NO_NODE ? i == 0 : node.parent_ < i;
+            auto chunkSize = GetNodeChunkSize(*header_, node.numPoints_);
+            auto chunkValid = node.numPoints_ == 0 || (node.dataOffset_ <= file_.GetSize() && chunkSize <= file_.GetSize() - node.dataOffset_);
+            if (!childrenValid || !parentValid || !chunkValid)
+                throw std::runtime_error("Node " + std::to_string(i) + " of point cloud file \"" + filename + "\" is corrupt.");
+        }
+    }
+
+    /**
+     *  Returns the points of a node inside the mapped file.
+     *  The pointer can be used directly as source for buffer uploads, the pages are read on first access.
+     *  @param nodeIndex the index of the node.
+     */
+    const void* PointCloudFile::GetNodeData(std::uint32_t nodeIndex) const
+    {
+        const auto& node = nodes_[nodeIndex];
+        if (node.dataOffset_ > file_.GetSize() || GetNodeDataSize(nodeIndex) > file_.GetSize() - node.dataOffset_)
+            throw std::runtime_error("Node " + std::to_string(nodeIndex) + " of point cloud file \"" + file_.GetFilename() + "\" is out of range.");
+        return file_.GetData() + node.dataOffset_;
+    }
+
+    /**
+     *  Returns the size of a nodes points in bytes, for columnar files including the padding between the columns.
+     *  @param nodeIndex the index of the node.
+     */
+    std::size_t PointCloudFile::GetNodeDataSize(std::uint32_t nodeIndex) const
+    {
+        return static_cast<std::size_t>(GetNodeChunkSize(*header_, nodes_[nodeIndex].numPoints_));
+    }
+
+    /**
+     *  Asks the operating system to start reading a nodes points in the background.
+     *  @param nodeIndex the index of the node.
+     */
+    void PointCloudFile::PrefetchNode(std::uint32_t nodeIndex) const
+    {
+        file_.Prefetch(static_cast<std::size_t>(nodes_[nodeIndex].dataOffset_), GetNodeDataSize(nodeIndex));
+    }
+
+    /**
+     *  Returns a column of a node inside the mapped file (columnar files only).
+     *  @param nodeIndex the index of the node.
+     *  @param attribute the attribute of the column, it has to be stored in the file.
+     */
+    const void* PointCloudFile::GetColumnData(std::uint32_t nodeIndex, PointAttribute attribute) const
+    {
+        if (!IsColumnar() || !HasAttribute(attribute))
+            throw std::runtime_error("Point cloud file \"" + file_.GetFilename() + "\" has no column for attribute " + std::to_string(static_cast<std::uint32_t>(attribute)) + ".");
+        auto data = static_cast<const std::uint8_t*>(GetNodeData(nodeIndex));
+        return data + GetColumnOffset(header_->attributes_, nodes_[nodeIndex].numPoints_, static_cast<std::uint32_t>(attribute));
+    }
+
+    /**
+     *  Returns the size of a column of a node in bytes.
+     *  @param nodeIndex the index of the node.
+     *  @param attribute the attribute of the column.
+     *  @return the size or 0 if the attribute is not stored in its own column.
+     */
+    std::size_t PointCloudFile::GetColumnSize(std::uint32_t nodeIndex, PointAttribute attribute) const
+    {
+        if (!IsColumnar() || !HasAttribute(attribute)) return 0;
+        return static_cast<std::size_t>(nodes_[nodeIndex].numPoints_) * GetPointAttributeSize(attribute);
+    }
+
+    /**
+     *  Asks the operating system to start reading a single column of a node in the background.
+     *  @param nodeIndex the index of the node.
+     *  @param attribute the attribute of the column.
+     */
+    void PointCloudFile::PrefetchColumn(std::uint32_t nodeIndex, PointAttribute attribute) const
+    {
+        auto size = GetColumnSize(nodeIndex, attribute);
+        if (size == 0) return;
+        auto offset = nodes_[nodeIndex].dataOffset_ + GetColumnOffset(header_->attributes_, nodes_[nodeIndex].numPoints_, static_cast<std::uint32_t>(attribute));
+        file_.Prefetch(static_cast<std::size_t>(offset), size);
+    }
+}
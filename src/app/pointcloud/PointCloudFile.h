@@ -0,0 +1,62 @@
+/**
+ * @file   PointCloudFile.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the reader for out-of-core point cloud files.
+ */
+
+#pragma once
+
+#include "PointCloudFormat.h"
+#include "MemoryMappedFile.h"
+
+namespace viscom {
+
+    /**
+     *  Gives access to a memory mapped point cloud file. Opening a file validates the header and the node table, the
+     *  node chunks are accessed (and paged in) on demand.
+     */
+    class PointCloudFile
+    {
+    public:
+        explicit PointCloudFile(const std::string& filename);
+        PointCloudFile(const PointCloudFile&) = delete;
+        PointCloudFile(PointCloudFile&&) = default;
+        PointCloudFile& operator=(const PointCloudFile&) = delete;
+        PointCloudFile& operator=(PointCloudFile&&) = default;
+        ~PointCloudFile() = default;
+
+        /** Returns the file header. */
+        const PointCloudFileHeader& GetHeader() const { return *header_; }
+        /** Returns the number of octree nodes. */
+        std::uint32_t GetNumNodes() const { return header_->numNodes_; }
+        /** Returns the node table. */
+        const PointCloudNodeRecord* GetNodes() const { return nodes_; }
+        /** Returns a single node. */
+        const PointCloudNodeRecord& GetNode(std::uint32_t nodeIndex) const { return nodes_[nodeIndex]; }
+        /** Returns the size of a single point in bytes. */
+        std::size_t GetPointStride() const { return header_->pointStride_; }
+        /** Returns whether each attribute is stored in its own column (PointLayout::Columnar). */
+        bool IsColumnar() const { return header_->pointLayout_ == PointLayout::Columnar; }
+        /** Returns the stored attributes, one bit per PointAttribute. */
+        std::uint32_t GetAttributes() const { return IsColumnar() ? header_->attributes_ : POINTCLOUD_POSITION_COLOR; }
+        /** Returns whether an attribute is stored. */
+        bool HasAttribute(PointAttribute attribute) const { return (GetAttributes() & GetAttributeBit(attribute)) != 0; }
+
+        const void* GetNodeData(std::uint32_t nodeIndex) const;
+        std::size_t GetNodeDataSize(std::uint32_t nodeIndex) const;
+        void PrefetchNode(std::uint32_t nodeIndex) const;
+        const void* GetColumnData(std::uint32_t nodeIndex, PointAttribute attribute) const;
+        std::size_t GetColumnSize(std::uint32_t nodeIndex, PointAttribute attribute) const;
+        void PrefetchColumn(std::uint32_t nodeIndex, PointAttribute attribute) const;
+
+    private:
+        /** Holds the mapped file. */
+        MemoryMappedFile file_;
+        /** Holds the header inside the mapped file. */
+        const PointCloudFileHeader* header_ = nullptr;
+        /** Holds the node table inside the mapped file. */
+        const PointCloudNodeRecord* nodes_ = nullptr;
+    };
+}
@@ -0,0 +1,258 @@
+/**
+ * @file   PointCloudFormat.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Definition of the on-disk layout of out-of-core point cloud files.
+ *
+ * A point cloud file consists of a fixed size header, a number of node chunks and the node table.
+ * Each node chunk holds the points of one octree node, starts at a multiple of POINTCLOUD_CHUNK_ALIGNMENT and can
+ * therefore be mapped and handed to the GPU directly. The node table is written last (its offset is stored in the
+ * header) so files can be written in a single streaming pass.
+ * With PointLayout::Columnar a chunk stores each attribute of its points in a separate column (all positions, then
+ * all colors, ...), so a single attribute can be read and uploaded without touching the others.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace viscom {
+
+    /** Magic number at the start of each point cloud file ("VPCF"). */
+    constexpr std::uint32_t POINTCLOUD_MAGIC = 0x46435056;
+    /** Current version of the point cloud file format. */
+    constexpr std::uint32_t POINTCLOUD_VERSION = 1;
+    /** Alignment of all node chunks in the file. */
+    constexpr std::uint64_t POINTCLOUD_CHUNK_ALIGNMENT = 4096;
+    /** Marks a non existing node index (e.g. the parent of the root node). */
+    constexpr std::uint32_t POINTCLOUD_NO_NODE = 0xffffffff;
+    /** Alignment of the columns inside a node chunk with PointLayout::Columnar, each column is an array of its type. */
+    constexpr std::uint64_t POINTCLOUD_COLUMN_ALIGNMENT = 16;
+
+    /** Layout of the points stored in the node chunks. */
+    enum class PointLayout : std::uint32_t
+    {
+        /** Float positions relative to the files origin and RGBA8 colors (PointCloudPoint). */
+        Float32RGBA8 = 0,
+        /** 16 bit positions relative to the bounding box of the node and RGBA8 colors (PointCloudCompactPoint). */
+        Quantized16RGBA8 = 1,
+        /** One column per attribute in the files attribute mask, positions quantized like Quantized16RGBA8. */
+        Columnar = 2
+    };
+
+    /** The attributes of a point, the columns of PointLayout::Columnar are stored in this order. */
+    enum class PointAttribute : std::uint32_t
+    {
+        /** The 16 bit position relative to the bounding box of the node (glm::u16vec3). */
+        Position = 0,
+        /** The RGBA8 color (glm::u8vec4). */
+        Color = 1,
+        /** The return intensity of the scanner (std::uint16_t). */
+        Intensity = 2,
+        /** The classification, e.g. ground or building (std::uint8_t). */
+        Classification = 3,
+        /** The number of the return of the laser pulse (std::uint8_t). */
+        ReturnNumber = 4,
+        /** The GPS time relative to the files GPS time origin (float). */
+        GPSTime = 5
+    };
+
+    /** The number of point attributes. */
+    constexpr std::uint32_t POINTCLOUD_NUM_ATTRIBUTES = 6;
+
+    /** A single point as stored with PointLayout::Float32RGBA8. */
+    struct PointCloudPoint
+    {
+        /** The points position. */
+        glm::vec3 position_;
+        /** The points color. */
+        glm::u8vec4 color_;
+    };
+
+    /**
+     *  A single point as stored with PointLayout::Quantized16RGBA8. Each coordinate maps the nodes bounding box to
+     *  [0, 65535], see QuantizePoint() and DequantizePosition().
+     */
+    struct PointCloudCompactPoint
+    {
+        /** The points quantized position. */
+        glm::u16vec3 position_;
+        /** Padding, keeps the color 4 byte aligned. */
+        std::uint16_t padding_;
+        /** The points color. */
+        glm::u8vec4 color_;
+    };
+
+    /** The scan attributes of a point next to position and color, as passed to the writer for PointLayout::Columnar. */
+    struct PointCloudAttributes
+    {
+        /** The return intensity. */
+        std::uint16_t intensity_ = 0;
+        /** The classification. */
+        std::uint8_t classification_ = 0;
+        /** The return number. */
+        std::uint8_t returnNumber_ = 0;
+        /** The GPS time relative to the files GPS time origin. */
+        float gpsTime_ = 0.0f;
+    };
+
+    /** The header at the start of each point cloud file. */
+    struct PointCloudFileHeader
+    {
+        /** The magic number (POINTCLOUD_MAGIC). */
+        std::uint32_t magic_ = POINTCLOUD_MAGIC;
+        /** The file format version (POINTCLOUD_VERSION). */
+        std::uint32_t version_ = POINTCLOUD_VERSION;
+        /** The layout of the points in the node chunks. */
+        PointLayout pointLayout_ = PointLayout::Float32RGBA8;
+        /** The size of a single point in bytes. */
+        std::uint32_t pointStride_ = sizeof(PointCloudPoint);
+        /** The total number of points in the file. */
+        std::uint64_t numPoints_ = 0;
+        /** The offset of the node table in the file. */
+        std::uint64_t nodeTableOffset_ = 0;
+        /** The number of octree nodes. */
+        std::uint32_t numNodes_ = 0;
+        /** The maximum number of points in a single node chunk. */
+        std::uint32_t maxPointsPerNode_ = 0;
+        /** The minimum of the bounding box of all points. */
+        glm::vec3 boundsMin_;
+        /** The maximum of the bounding box of all points. */
+        glm::vec3 boundsMax_;
+        /** The position of the local origin in the source coordinate system (e.g. georeferenced scans). */
+        glm::dvec3 origin_;
+        /** The attributes stored by PointLayout::Columnar, one bit per PointAttribute (0 for the other layouts). */
+        std::uint32_t attributes_ = 0;
+        /** The largest intensity of all points. */
+        std::uint32_t maxIntensity_ = 0;
+        /** The GPS time the GPS times of the points are relative to. */
+        double gpsTimeOrigin_ = 0.0;
+        /** The smallest GPS time of all points. */
+        float gpsTimeMin_ = 0.0f;
+        /** The largest GPS time of all points. */
+        float gpsTimeMax_ = 0.0f;
+        /** Reserved for later use, keeps the header at 128 bytes. */
+        std::uint8_t reserved_[16] = {};
+    };
+
+    /**
+     *  An entry of the node table. Nodes are stored in breadth first order with the root at index 0 and the children
+     *  of a node stored consecutively starting at firstChild_ in the order of the bits in childMask_.
+     *  The points of all nodes are disjoint, i.e., a node refines the points of its ancestors.
+     */
+    struct PointCloudNodeRecord
+    {
+        /** The minimum of the nodes bounding box. */
+        glm::vec3 boundsMin_;
+        /** The maximum of the nodes bounding box. */
+        glm::vec3 boundsMax_;
+        /** The offset of the nodes chunk in the file. */
+        std::uint64_t dataOffset_ = 0;
+        /** The number of points in the node. */
+        std::uint32_t numPoints_ = 0;
+        /** The index of the first child or POINTCLOUD_NO_NODE. */
+        std::uint32_t firstChild_ = POINTCLOUD_NO_NODE;
+        /** The index of the parent or POINTCLOUD_NO_NODE. */
+        std::uint32_t parent_ = POINTCLOUD_NO_NODE;
+        /** Bit i is set if the child in octant i exists. */
+        std::uint8_t childMask_ = 0;
+        /** The octree level of the node (root is 0). */
+        std::uint8_t level_ = 0;
+        /** The number of children. */
+        std::uint8_t numChildren_ = 0;
+        /** Padding, keeps the record 8 byte aligned. */
+        std::uint8_t padding_ = 0;
+    };
+
+    /**
+     *  Returns the size of a single point in an interleaved layout.
+     *  @param layout the point layout.
+     *  @return the size in bytes or 0 for unknown layouts and PointLayout::Columnar, see GetColumnarStride().
+     */
+    inline std::uint32_t GetPointLayoutStride(PointLayout layout)
+    {
+        switch (layout) {
+        case PointLayout::Float32RGBA8: return sizeof(PointCloudPoint);
+        case PointLayout::Quantized16RGBA8: return sizeof(PointCloudCompactPoint);
+        default: return 0;
+        }
+    }
+
+    /** Returns the bit of an attribute in an attribute mask. */
+    constexpr std::uint32_t GetAttributeBit(PointAttribute attribute) { return 1U << static_cast<std::uint32_t>(attribute); }
+
+    /** The attributes every columnar file stores, and the only ones of the interleaved layouts. */
+    constexpr std::uint32_t POINTCLOUD_POSITION_COLOR = GetAttributeBit(PointAttribute::Position) | GetAttributeBit(PointAttribute::Color);
+    /** All attributes. */
+    constexpr std::uint32_t POINTCLOUD_ALL_ATTRIBUTES = (1U << POINTCLOUD_NUM_ATTRIBUTES) - 1;
+
+    /**
+     *  Returns the size of a single value of an attribute in a column.
+     *  @param attribute the attribute.
+     *  @return the size in bytes.
+     */
+    inline std::uint32_t GetPointAttributeSize(PointAttribute attribute)
+    {
+        switch (attribute) {
+        case PointAttribute::Position: return sizeof(glm::u16vec3);
+        case PointAttribute::Color: return sizeof(glm::u8vec4);
+        case PointAttribute::Intensity: return sizeof(std::uint16_t);
+        case PointAttribute::Classification: return sizeof(std::uint8_t);
+        case PointAttribute::ReturnNumber: return sizeof(std::uint8_t);
+        case PointAttribute::GPSTime: return sizeof(float);
+        default: return 0;
+        }
+    }
+
+    /**
+     *  Returns the size of a single point with PointLayout::Columnar, the sum of the sizes of its attributes.
+     *  @param attributes the stored attributes.
+     */
+    inline std::uint32_t GetColumnarStride(std::uint32_t attributes)
+    {
+        std::uint32_t stride = 0;
+        for (std::uint32_t a = 0; a < POINTCLOUD_NUM_ATTRIBUTES; ++a) {
+            if ((attributes & (1U << a)) != 0) stride += GetPointAttributeSize(static_cast<PointAttribute>(a));
+        }
+        return stride;
+    }
+
+    /**
+     *  Returns the offset of a column in a chunk with PointLayout::Columnar. Each column starts at a multiple of
+     *  POINTCLOUD_COLUMN_ALIGNMENT, the attributes before it in PointAttribute order come first.
+     *  @param attributes the stored attributes.
+     *  @param numPoints the number of points in the chunk.
+     *  @param attribute the attribute of the column, POINTCLOUD_NUM_ATTRIBUTES gives the size of the chunk.
+     *  @return the offset in bytes.
+     */
+    inline std::uint64_t GetColumnOffset(std::uint32_t attributes, std::uint32_t numPoints, std::uint32_t attribute)
+    {
+        std::uint64_t offset = 0;
+        for (std::uint32_t a = 0; a < attribute && a < POINTCLOUD_NUM_ATTRIBUTES; ++a) {
+            if ((attributes & (1U << a)) == 0) continue;
+            offset += static_cast<std::uint64_t>(numPoints) * GetPointAttributeSize(static_cast<PointAttribute>(a));
+            offset = (offset + POINTCLOUD_COLUMN_ALIGNMENT - 1) / POINTCLOUD_COLUMN_ALIGNMENT * POINTCLOUD_COLUMN_ALIGNMENT;
+        }
+        return offset;
+    }
+
+    /**
+     *  Returns the size of the chunk of a node.
+     *  @param header the file header.
+     *  @param numPoints the number of points in the node.
+     *  @return the size in bytes.
+     */
+    inline std::uint64_t GetNodeChunkSize(const PointCloudFileHeader& header, std::uint32_t numPoints)
+    {
+        if (header.pointLayout_ == PointLayout::Columnar) return GetColumnOffset(header.attributes_, numPoints, POINTCLOUD_NUM_ATTRIBUTES);
+        return static_cast<std::uint64_t>(numPoints) * header.pointStride_;
+    }
+
+    static_assert(sizeof(PointCloudPoint) == 16, "Unexpected size of PointCloudPoint.");
+    static_assert(sizeof(PointCloudCompactPoint) == 12, "Unexpected size of PointCloudCompactPoint.");
+    static_assert(sizeof(PointCloudAttributes) == 8, "Unexpected size of PointCloudAttributes.");
+    static_assert(sizeof(PointCloudFileHeader) == 128, "Unexpected size of PointCloudFileHeader.");
+    static_assert(sizeof(PointCloudNodeRecord) == 48, "Unexpected size of PointCloudNodeRecord.");
+}
@@ -0,0 +1,184 @@
+/**
+ * @file   PointCloudWriter.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the streaming writer for point cloud files.
+ */
+
+#include "PointCloudWriter.h"
+#include "PointQuantization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace viscom {
+
+    /**
+     *  Creates the file and reserves space for the header.
+     *  @param filename the name of the file.
+     *  @param boundsMin the minimum of the bounding box of all points.
+     *  @param boundsMax the maximum of the bounding box of all points.
+     *  @param origin the position of the local origin in the source coordinate system.
+     *  @param maxPointsPerNode the maximum number of points in a single node chunk.
+     *  @param layout the layout of the points in the file.
+     *  @param attributes the attributes stored with PointLayout::Columnar, positions and colors are always stored.
+     */
+    PointCloudWriter::PointCloudWriter(const std::string& filename, const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::dvec3& origin, std::uint32_t maxPointsPerNode,
+        PointLayout layout, std::uint32_t attributes) :
+        filename_{ filename },
+        file_{ filename, std::ios::binary | std::ios::trunc }
+    {
+        if (!file_) throw std::runtime_error("Could not create file \"" + filename + "\".");
+        if (GetPointLayoutStride(layout) == 0 && layout != PointLayout::Columnar) throw std::runtime_error("Unknown point layout.");
+
+        header_.boundsMin_ = boundsMin;
+        header_.boundsMax_ = boundsMax;
+        header_.origin_ = origin;
+        header_.maxPointsPerNode_ = maxPointsPerNode;
+        header_.pointLayout_ = layout;
+        header_.pointStride_ = GetPointLayoutStride(layout);
+        if (layout == PointLayout::Columnar) {
+            header_.attributes_ = (attributes & POINTCLOUD_ALL_ATTRIBUTES) | POINTCLOUD_POSITION_COLOR;
+            header_.pointStride_ = GetColumnarStride(header_.attributes_);
+        }
+
+        // the header is rewritten with the final values by Finish().
+        file_.write(reinterpret_cast<const char*>(&header_), sizeof(PointCloudFileHeader));
+        fileSize_ = sizeof(PointCloudFileHeader);
+    }
+
+    PointCloudWriter::~PointCloudWriter() = default;
+
+    /**
+     *  Writes the points of a node to a new chunk, converting them to the files point layout.
+     *  @param points the points of the node.
+     *  @param numPoints the number of points.
+     *  @param boundsMin the minimum of the nodes bounding box.
+     *  @param boundsMax the maximum of the nodes bounding box.
+     *  @param attributes the scan attributes of the points, only used by columnar files (may be nullptr).
+     *  @return the offset of the chunk in the file.
+     */
+    std::uint64_t PointCloudWriter::WriteChunk(const PointCloudPoint* points, std::size_t numPoints, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+        const PointCloudAttributes* attributes)
+    {
+        if (numPoints > header_.maxPointsPerNode_) throw std::runtime_error("Node chunk exceeds the maximum number of points per node.");
+
+        if (header_.pointLayout_ == PointLayout::Columnar) {
+            auto columns = CreateColumns(points, numPoints, boundsMin, boundsMax, attributes);
+            std::uint32_t maxIntensity = 0;
+            auto gpsTimeMin = std::numeric_limits<float>::max();
+            auto gpsTimeMax = std::numeric_limits<float>::lowest();
+            for (std::size_t i = 0; attributes != nullptr && i < numPoints; ++i) {
+                maxIntensity = std::max<std::uint32_t>(maxIntensity, attributes[i].intensity_);
+                gpsTimeMin = std::min(gpsTimeMin, attributes[i].gpsTime_);
+                gpsTimeMax = std::max(gpsTimeMax, attributes[i].gpsTime_);
+            }
+
+            std::lock_guard<std::mutex> lock{ writeMutex_ };
+            header_.numPoints_ += numPoints;
+            header_.maxIntensity_ = std::max(header_.maxIntensity_, maxIntensity);
+            if (attributes != nullptr && numPoints > 0) {
+                header_.gpsTimeMin_ = hasGPSTime_ ? std::min(header_.gpsTimeMin_, gpsTimeMin) : gpsTimeMin;
+                header_.gpsTimeMax_ = hasGPSTime_ ? std::max(header_.gpsTimeMax_, gpsTimeMax) : gpsTimeMax;
+                hasGPSTime_ = true;
+            }
+            return Write(columns.data(), columns.size());
+        }
+
+        if (header_.pointLayout_ == PointLayout::Quantized16RGBA8) {
+            // quantize outside of the lock, so threads only serialize on the file access.
+            std::vector<PointCloudCompactPoint> compactPoints(numPoints);
+            for (std::size_t i = 0; i < numPoints; ++i) compactPoints[i] = QuantizePoint(points[i], boundsMin, boundsMax);
+
+            std::lock_guard<std::mutex> lock{ writeMutex_ };
+            header_.numPoints_ += numPoints;
+            return Write(compactPoints.data(), numPoints * sizeof(PointCloudCompactPoint));
+        }
+
+        std::lock_guard<std::mutex> lock{ writeMutex_ };
+        header_.numPoints_ += numPoints;
+        return Write(points, numPoints * sizeof(PointCloudPoint));
+    }
+
+    /**
+     *  Writes the node table and the final header.
+     *  @param nodes the octree nodes in breadth first order.
+     */
+    void PointCloudWriter::Finish(const std::vector<PointCloudNodeRecord>& nodes)
+    {
+        std::lock_guard<std::mutex> lock{ writeMutex_ };
+        Pad();
+        header_.nodeTableOffset_ = fileSize_;
+        header_.numNodes_ = static_cast<std::uint32_t>(nodes.size());
+        file_.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(PointCloudNodeRecord));
+        fileSize_ += nodes.size() * sizeof(PointCloudNodeRecord);
+
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(&header_), sizeof(PointCloudFileHeader));
+        file_.close();
+        if (!file_) throw std::runtime_error("Could not write to file \"" + filename_ + "\".");
+    }
+
+    /** Converts the points of a chunk to columns, the padding between the columns is zero. */
+    std::vector<std::uint8_t> PointCloudWriter::CreateColumns(const PointCloudPoint* points, std::size_t numPoints, const glm::vec3& boundsMin,
+        const glm::vec3& boundsMax, const PointCloudAttributes* attributes) const
+    {
+        auto count = static_cast<std::uint32_t>(numPoints);
+        std::vector<std::uint8_t> columns(static_cast<std::size_t>(GetNodeChunkSize(header_, count)), 0);
+        auto column = [this, &columns, count](PointAttribute attribute) {
+            return columns.data() + GetColumnOffset(header_.attributes_, count, static_cast<std::uint32_t>(attribute));
+        };
+        // the chunk is a byte buffer, values are copied in instead of aliasing it with their types.
+        auto store = [](std::uint8_t* column, std::size_t i, const auto& value) { std::memcpy(column + i * sizeof(value), &value, sizeof(value)); };
+
+        auto positions = column(PointAttribute::Position);
+        auto colors = column(PointAttribute::Color);
+        for (std::size_t i = 0; i < numPoints; ++i) {
+            auto point = QuantizePoint(points[i], boundsMin, boundsMax);
+            store(positions, i, point.position_);
+            store(colors, i, point.color_);
+        }
+        if (attributes == nullptr) return columns;
+
+        auto hasAttribute = [this](PointAttribute attribute) { return (header_.attributes_ & GetAttributeBit(attribute)) != 0; };
+        if (hasAttribute(PointAttribute::Intensity)) {
+            auto intensities = column(PointAttribute::Intensity);
+            for (std::size_t i = 0; i < numPoints; ++i) store(intensities, i, attributes[i].intensity_);
+        }
+        if (hasAttribute(PointAttribute::Classification)) {
+            auto classifications = column(PointAttribute::Classification);
+            for (std::size_t i = 0; i < numPoints; ++i) store(classifications, i, attributes[i].classification_);
+        }
+        if (hasAttribute(PointAttribute::ReturnNumber)) {
+            auto returnNumbers = column(PointAttribute::ReturnNumber);
+            for (std::size_t i = 0; i < numPoints; ++i) store(returnNumbers, i, attributes[i].returnNumber_);
+        }
+        if (hasAttribute(PointAttribute::GPSTime)) {
+            auto gpsTimes = column(PointAttribute::GPSTime);
+            for (std::size_t i = 0; i < numPoints; ++i) store(gpsTimes, i, attributes[i].gpsTime_);
+        }
+        return columns;
+    }
+
+    /** Writes a chunk at the next aligned position and returns its offset, the caller needs to hold the lock. */
+    std::uint64_t PointCloudWriter::Write(const void* data, std::size_t size)
+    {
+        Pad();
+        auto offset = fileSize_;
+        file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        fileSize_ += size;
+        if (!file_) throw std::runtime_error("Could not write to file \"" + filename_ + "\".");
+        return offset;
+    }
+
+    void PointCloudWriter::Pad()
+    {
+        static const char zeros[POINTCLOUD_CHUNK_ALIGNMENT] = {};
+        auto padding = (POINTCLOUD_CHUNK_ALIGNMENT - fileSize_ % POINTCLOUD_CHUNK_ALIGNMENT) % POINTCLOUD_CHUNK_ALIGNMENT;
+        file_.write(zeros, static_cast<std::streamsize>(padding));
+        fileSize_ += padding;
+    }
+}
@@ -0,0 +1,63 @@
+/**
+ * @file   PointCloudWriter.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the streaming writer for point cloud files.
+ */
+
+#pragma once
+
+#include "PointCloudFormat.h"
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace viscom {
+
+    /**
+     *  Writes point cloud files in a single pass: node chunks can be written in any order (and from multiple threads),
+     *  the node table and the final header are written by Finish(). Files with PointLayout::Columnar store the
+     *  attributes given to the constructor, the scan attributes are passed next to the points of each chunk.
+     */
+    class PointCloudWriter
+    {
+    public:
+        PointCloudWriter(const std::string& filename, const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::dvec3& origin, std::uint32_t maxPointsPerNode,
+            PointLayout layout = PointLayout::Quantized16RGBA8, std::uint32_t attributes = POINTCLOUD_POSITION_COLOR);
+        PointCloudWriter(const PointCloudWriter&) = delete;
+        PointCloudWriter& operator=(const PointCloudWriter&) = delete;
+        ~PointCloudWriter();
+
+        std::uint64_t WriteChunk(const PointCloudPoint* points, std::size_t numPoints, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+            const PointCloudAttributes* attributes = nullptr);
+        void Finish(const std::vector<PointCloudNodeRecord>& nodes);
+
+        /** Sets the GPS time the GPS times of the points are relative to. */
+        void SetGPSTimeOrigin(double gpsTimeOrigin) { header_.gpsTimeOrigin_ = gpsTimeOrigin; }
+
+        /** Returns the number of bytes written so far. */
+        std::uint64_t GetBytesWritten() const { return fileSize_; }
+
+    private:
+        std::vector<std::uint8_t> CreateColumns(const PointCloudPoint* points, std::size_t numPoints, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+            const PointCloudAttributes* attributes) const;
+        void Pad();
+        std::uint64_t Write(const void* data, std::size_t size);
+
+        /** Holds the name of the file. */
+        std::string filename_;
+        /** Holds the output stream. */
+        std::ofstream file_;
+        /** Holds the header. */
+        PointCloudFileHeader header_;
+        /** Holds the current size of the file. */
+        std::uint64_t fileSize_ = 0;
+        /** Holds whether a chunk with GPS times was written, the first one sets the range. */
+        bool hasGPSTime_ = false;
+        /** Synchronizes chunks written by different threads. */
+        std::mutex writeMutex_;
+    };
+}
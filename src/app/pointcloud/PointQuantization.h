@@ -0,0 +1,67 @@
+/**
+ * @file   PointQuantization.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Quantization of point positions relative to node bounding boxes.
+ *
+ * Positions are mapped linearly from a nodes bounding box to [0, 65535] per axis. Dequantization uses the same
+ * formula as the vertex shader (pointCloud.vert), which gets the coordinates normalized to [0, 1] from the vertex
+ * fetch, so both produce the same positions.
+ */
+
+#pragma once
+
+#include "PointCloudFormat.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace viscom {
+
+    /** The largest quantized coordinate. */
+    constexpr float POINT_QUANTIZATION_MAX = 65535.0f;
+
+    /**
+     *  Quantizes a point relative to a bounding box.
+     *  @param point the point, it has to be inside the bounding box.
+     *  @param boundsMin the minimum of the bounding box.
+     *  @param boundsMax the maximum of the bounding box.
+     *  @return the quantized point.
+     */
+    inline PointCloudCompactPoint QuantizePoint(const PointCloudPoint& point, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+    {
+        PointCloudCompactPoint result;
+        auto extent = boundsMax - boundsMin;
+        for (auto i = 0; i < 3; ++i) {
+            auto t = extent[i] > 0.0f ? (point.position_[i] - boundsMin[i]) / extent[i] : 0.0f;
+            result.position_[i] = static_cast<std::uint16_t>(std::lround(std::min(std::max(t, 0.0f), 1.0f) * POINT_QUANTIZATION_MAX));
+        }
+        result.padding_ = 0;
+        result.color_ = point.color_;
+        return result;
+    }
+
+    /**
+     *  Reconstructs a position from its quantized coordinates.
+     *  @param position the quantized position.
+     *  @param boundsMin the minimum of the bounding box.
+     *  @param boundsMax the maximum of the bounding box.
+     *  @return the position.
+     */
+    inline glm::vec3 DequantizePosition(const glm::u16vec3& position, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+    {
+        return boundsMin + (glm::vec3(position) / POINT_QUANTIZATION_MAX) * (boundsMax - boundsMin);
+    }
+
+    /**
+     *  Returns the largest error of a quantized coordinate, half a quantization step on the longest axis.
+     *  @param boundsMin the minimum of the bounding box.
+     *  @param boundsMax the maximum of the bounding box.
+     */
+    inline float GetQuantizationError(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+    {
+        auto extent = boundsMax - boundsMin;
+        return 0.5f * std::max(extent.x, std::max(extent.y, extent.z)) / POINT_QUANTIZATION_MAX;
+    }
+}
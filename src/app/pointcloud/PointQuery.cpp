@@ -0,0 +1,244 @@
+/**
+ * @file   PointQuery.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the spatial queries (nearest neighbors, radius, picking) on point cloud files.
+ */
+
+#include "PointQuery.h"
+#include "PointQuantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace viscom {
+
+    namespace {
+        /** Orders queued nodes so the heap returns the nearest first. */
+        using NearerNode = std::greater<std::pair<float, std::uint32_t>>;
+
+        /** Orders results so the heap returns the farthest first. */
+        bool IsNearerPoint(const PointQueryResult& a, const PointQueryResult& b) { return a.distance_ < b.distance_; }
+    }
+
+    /**
+     *  Creates the queries for a file.
+     *  @param file the point cloud file, it has to outlive the queries.
+     */
+    PointQuery::PointQuery(const PointCloudFile& file) :
+        file_{ file }
+    {
+    }
+
+    /**
+     *  Calls a function for each point of a node with its node index, point index, position and color.
+     *  @param nodeIndex the node.
+     *  @param visitor the function called.
+     */
+    template<typename Visitor> void PointQuery::VisitPoints(std::uint32_t nodeIndex, Visitor visitor)
+    {
+        const auto& node = file_.GetNode(nodeIndex);
+        ++statistics_.numVisitedNodes_;
+        statistics_.numTestedPoints_ += node.numPoints_;
+        if (node.numPoints_ == 0) return;
+
+        if (file_.IsColumnar()) {
+            auto positions = static_cast<const glm::u16vec3*>(file_.GetColumnData(nodeIndex, PointAttribute::Position));
+            auto colors = static_cast<const glm::u8vec4*>(file_.GetColumnData(nodeIndex, PointAttribute::Color));
+            for (std::uint32_t i = 0; i < node.numPoints_; ++i) {
+                visitor(nodeIndex, i, DequantizePosition(positions[i], node.boundsMin_, node.boundsMax_), colors[i]);
+            }
+        } else if (file_.GetHeader().pointLayout_ == PointLayout::Quantized16RGBA8) {
+            auto points = static_cast<const PointCloudCompactPoint*>(file_.GetNodeData(nodeIndex));
+            for (std::uint32_t i = 0; i < node.numPoints_; ++i) {
+                visitor(nodeIndex, i, DequantizePosition(points[i].position_, node.boundsMin_, node.boundsMax_), points[i].color_);
+            }
+        } else {
+            auto points = static_cast<const PointCloudPoint*>(file_.GetNodeData(nodeIndex));
+            for (std::uint32_t i = 0; i < node.numPoints_; ++i) visitor(nodeIndex, i, points[i].position_, points[i].color_);
+        }
+    }
+
+    /**
+     *  Finds the k nearest points to a position.
+     *  @param position the position.
+     *  @param k the number of points.
+     *  @param maxDistance the largest distance of a point found.
+     *  @return the points ordered by distance, less than k if the file (or the maximum distance) does not hold more.
+     */
+    const std::vector<PointQueryResult>& PointQuery::FindNearest(const glm::vec3& position, std::size_t k, float maxDistance)
+    {
+        results_.clear();
+        statistics_ = PointQueryStatistics{};
+        if (k == 0 || file_.GetNumNodes() == 0) return results_;
+
+        // results hold squared distances while searching, as a heap with the farthest point on top.
+        auto maxDistance2 = maxDistance * maxDistance;
+        auto getBound = [this, k, maxDistance2]() { return results_.size() < k ? maxDistance2 : results_.front().distance_; };
+        nodeQueue_.clear();
+        nodeQueue_.emplace_back(GetBoxDistance2(0, position), 0);
+        while (!nodeQueue_.empty()) {
+            std::pop_heap(nodeQueue_.begin(), nodeQueue_.end(), NearerNode{});
+            auto nodeIndex = nodeQueue_.back().second;
+            auto nodeDistance2 = nodeQueue_.back().first;
+            nodeQueue_.pop_back();
+            if (nodeDistance2 > getBound()) break;
+
+            VisitPoints(nodeIndex, [this, &position, k, maxDistance2](std::uint32_t nodeIndex, std::uint32_t pointIndex, const glm::vec3& point, const glm::u8vec4& color) {
+                auto offset = point - position;
+                auto distance2 = glm::dot(offset, offset);
+                if (distance2 > maxDistance2 || (results_.size() == k && distance2 >= results_.front().distance_)) return;
+                if (results_.size() == k) {
+                    std::pop_heap(results_.begin(), results_.end(), IsNearerPoint);
+                    results_.pop_back();
+                }
+                results_.push_back(PointQueryResult{ nodeIndex, pointIndex, point, color, distance2 });
+                std::push_heap(results_.begin(), results_.end(), IsNearerPoint);
+            });
+
+            const auto& node = file_.GetNode(nodeIndex);
+            for (auto child = node.firstChild_; child != POINTCLOUD_NO_NODE && child < node.firstChild_ + node.numChildren_; ++child) {
+                auto childDistance2 = GetBoxDistance2(child, position);
+                if (childDistance2 > getBound()) continue;
+                nodeQueue_.emplace_back(childDistance2, child);
+                std::push_heap(nodeQueue_.begin(), nodeQueue_.end(), NearerNode{});
+            }
+        }
+
+        std::sort_heap(results_.begin(), results_.end(), IsNearerPoint);
+        for (auto& result : results_) result.distance_ = std::sqrt(result.distance_);
+        return results_;
+    }
+
+    /**
+     *  Finds all points within a radius around a position.
+     *  @param position the position.
+     *  @param radius the radius.
+     *  @return the points in no particular order.
+     */
+    const std::vector<PointQueryResult>& PointQuery::FindInRadius(const glm::vec3& position, float radius)
+    {
+        results_.clear();
+        statistics_ = PointQueryStatistics{};
+        if (file_.GetNumNodes() == 0 || !(radius >= 0.0f)) return results_;
+
+        // the order of the nodes does not matter, the queue is used as a stack.
+        auto radius2 = radius * radius;
+        nodeQueue_.clear();
+        if (GetBoxDistance2(0, position) <= radius2) nodeQueue_.emplace_back(0.0f, 0);
+        while (!nodeQueue_.empty()) {
+            auto nodeIndex = nodeQueue_.back().second;
+            nodeQueue_.pop_back();
+
+            VisitPoints(nodeIndex, [this, &position, radius2](std::uint32_t nodeIndex, std::uint32_t pointIndex, const glm::vec3& point, const glm::u8vec4& color) {
+                auto offset = point - position;
+                auto distance2 = glm::dot(offset, offset);
+                if (distance2 <= radius2) results_.push_back(PointQueryResult{ nodeIndex, pointIndex, point, color, std::sqrt(distance2) });
+            });
+
+            const auto& node = file_.GetNode(nodeIndex);
+            for (auto child = node.firstChild_; child != POINTCLOUD_NO_NODE && child < node.firstChild_ + node.numChildren_; ++child) {
+                if (GetBoxDistance2(child, position) <= radius2) nodeQueue_.emplace_back(0.0f, child);
+            }
+        }
+        return results_;
+    }
+
+    /**
+     *  Finds the point nearest to the origin inside a cone around a ray, e.g. the point under the cursor with the cone
+     *  covering a few pixels around it.
+     *  @param origin the origin of the ray (the apex of the cone).
+     *  @param direction the direction of the ray.
+     *  @param coneSlope the radius of the cone per distance along the ray (the tangent of half its opening angle).
+     *  @param result the point found.
+     *  @param maxDistance the largest distance along the ray.
+     *  @return whether a point was found.
+     */
+    bool PointQuery::Pick(const glm::vec3& origin, const glm::vec3& direction, float coneSlope, PointQueryResult& result, float maxDistance)
+    {
+        results_.clear();
+        statistics_ = PointQueryStatistics{};
+        auto directionLength = glm::length(direction);
+        if (file_.GetNumNodes() == 0 || !(directionLength > 0.0f) || !(coneSlope >= 0.0f)) return false;
+        auto ray = direction / directionLength;
+
+        auto found = false;
+        auto bestDistance = maxDistance;
+        nodeQueue_.clear();
+        auto rootEntry = GetConeEntry(0, origin, ray, coneSlope, bestDistance);
+        if (rootEntry <= bestDistance) nodeQueue_.emplace_back(rootEntry, 0);
+        while (!nodeQueue_.empty()) {
+            std::pop_heap(nodeQueue_.begin(), nodeQueue_.end(), NearerNode{});
+            auto nodeIndex = nodeQueue_.back().second;
+            auto nodeEntry = nodeQueue_.back().first;
+            nodeQueue_.pop_back();
+            if (nodeEntry > bestDistance) break;
+
+            VisitPoints(nodeIndex, [&](std::uint32_t nodeIndex, std::uint32_t pointIndex, const glm::vec3& point, const glm::u8vec4& color) {
+                auto offset = point - origin;
+                auto along = glm::dot(offset, ray);
+                if (along < 0.0f || along >= bestDistance) return;
+                auto coneRadius = coneSlope * along;
+                if (glm::dot(offset, offset) - along * along > coneRadius * coneRadius) return;
+                result = PointQueryResult{ nodeIndex, pointIndex, point, color, along };
+                bestDistance = along;
+                found = true;
+            });
+
+            const auto& node = file_.GetNode(nodeIndex);
+            for (auto child = node.firstChild_; child != POINTCLOUD_NO_NODE && child < node.firstChild_ + node.numChildren_; ++child) {
+                auto childEntry = GetConeEntry(child, origin, ray, coneSlope, bestDistance);
+                if (childEntry > bestDistance) continue;
+                nodeQueue_.emplace_back(childEntry, child);
+                std::push_heap(nodeQueue_.begin(), nodeQueue_.end(), NearerNode{});
+            }
+        }
+        return found;
+    }
+
+    /**
+     *  Returns the squared distance of a position to the bounding box of a node, 0 inside.
+     *  @param nodeIndex the node.
+     *  @param position the position.
+     */
+    float PointQuery::GetBoxDistance2(std::uint32_t nodeIndex, const glm::vec3& position) const
+    {
+        const auto& node = file_.GetNode(nodeIndex);
+        auto offset = position - glm::clamp(position, node.boundsMin_, node.boundsMax_);
+        return glm::dot(offset, offset);
+    }
+
+    /**
+     *  Returns a lower bound of the distance along a ray of the points of a node inside a cone around it. A point
+     *  inside the cone is at most the cone slope times its distance to the origin away from the ray, so the ray
+     *  passes the box grown by this amount for the farthest corner before reaching any such point.
+     *  @param nodeIndex the node.
+     *  @param origin the origin of the ray.
+     *  @param direction the normalized direction of the ray.
+     *  @param coneSlope the radius of the cone per distance along the ray.
+     *  @param maxDistance the largest distance along the ray.
+     *  @return the distance or infinity if the ray misses the grown box before the maximum distance.
+     */
+    float PointQuery::GetConeEntry(std::uint32_t nodeIndex, const glm::vec3& origin, const glm::vec3& direction, float coneSlope, float maxDistance) const
+    {
+        const auto& node = file_.GetNode(nodeIndex);
+        auto farthestCorner = glm::max(glm::abs(node.boundsMin_ - origin), glm::abs(node.boundsMax_ - origin));
+        auto growth = glm::vec3(coneSlope * glm::length(farthestCorner));
+        auto boxMin = node.boundsMin_ - growth, boxMax = node.boundsMax_ + growth;
+
+        auto entry = 0.0f, exit = maxDistance;
+        for (auto axis = 0; axis < 3; ++axis) {
+            if (direction[axis] == 0.0f) {
+                if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis]) return std::numeric_limits<float>::infinity();
+                continue;
+            }
+            auto t0 = (boxMin[axis] - origin[axis]) / direction[axis], t1 = (boxMax[axis] - origin[axis]) / direction[axis];
+            entry = std::max(entry, std::min(t0, t1));
+            exit = std::min(exit, std::max(t0, t1));
+            if (entry > exit) return std::numeric_limits<float>::infinity();
+        }
+        return entry;
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file   PointQuery.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the spatial queries (nearest neighbors, radius, picking) on point cloud files.
+ */
+
+#pragma once
+
+#include "PointCloudFile.h"
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace viscom {
+
+    /** A point found by a query. */
+    struct PointQueryResult
+    {
+        /** The node the point is stored in. */
+        std::uint32_t nodeIndex_;
+        /** The index of the point in the node. */
+        std::uint32_t pointIndex_;
+        /** The position of the point. */
+        glm::vec3 position_;
+        /** The color of the point. */
+        glm::u8vec4 color_;
+        /** The distance to the query position, or along the ray for picks. */
+        float distance_;
+    };
+
+    /** Statistics of the last query. */
+    struct PointQueryStatistics
+    {
+        /** The number of nodes whose points were tested. */
+        std::uint32_t numVisitedNodes_ = 0;
+        /** The number of points tested. */
+        std::uint64_t numTestedPoints_ = 0;
+    };
+
+    /**
+     *  Answers spatial queries on all points of a file, independent of the level of detail drawn. Since every node
+     *  holds points, not only the leaves, nodes are visited nearest first by the distance of their bounding box and
+     *  the search stops once no box can contain a better point. Only the chunks of visited nodes are read, the
+     *  memory mapping pages in missing ones. Queries are not thread safe, each thread needs its own object.
+     */
+    class PointQuery
+    {
+    public:
+        explicit PointQuery(const PointCloudFile& file);
+
+        const std::vector<PointQueryResult>& FindNearest(const glm::vec3& position, std::size_t k,
+            float maxDistance = std::numeric_limits<float>::infinity());
+        const std::vector<PointQueryResult>& FindInRadius(const glm::vec3& position, float radius);
+        bool Pick(const glm::vec3& origin, const glm::vec3& direction, float coneSlope, PointQueryResult& result,
+            float maxDistance = std::numeric_limits<float>::infinity());
+
+        /** Returns the statistics of the last query. */
+        const PointQueryStatistics& GetStatistics() const { return statistics_; }
+
+    private:
+        template<typename Visitor> void VisitPoints(std::uint32_t nodeIndex, Visitor visitor);
+        float GetBoxDistance2(std::uint32_t nodeIndex, const glm::vec3& position) const;
+        float GetConeEntry(std::uint32_t nodeIndex, const glm::vec3& origin, const glm::vec3& direction, float coneSlope, float maxDistance) const;
+
+        /** Holds the point cloud file. */
+        const PointCloudFile& file_;
+        /** Holds the nodes still to visit with their distance, ordered as a heap with the nearest first. */
+        std::vector<std::pair<float, std::uint32_t>> nodeQueue_;
+        /** Holds the results of the last query. */
+        std::vector<PointQueryResult> results_;
+        /** Holds the statistics of the last query. */
+        PointQueryStatistics statistics_;
+    };
+}
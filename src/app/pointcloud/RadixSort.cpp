@@ -0,0 +1,63 @@
+/**
+ * @file   RadixSort.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the parallel radix sort for morton codes.
+ */
+
+#include "RadixSort.h"
+#include "Parallel.h"
+
+#include <array>
+
+namespace viscom {
+
+    /**
+     *  Sorts keys by their morton codes using a stable least significant digit radix sort with 8 bit digits.
+     *  Each pass builds per thread histograms of contiguous blocks and scatters the blocks in parallel. Passes in
+     *  which all keys have the same digit (e.g. the high bits of spatially coherent data) are skipped.
+     *  @param keys the keys to sort, contains the sorted keys afterwards.
+     *  @param scratch temporary memory, resized as needed.
+     *  @param numThreads the number of threads to use.
+     */
+    void ParallelRadixSort(std::vector<MortonKey>& keys, std::vector<MortonKey>& scratch, unsigned numThreads)
+    {
+        using Histogram = std::array<std::size_t, 256>;
+
+        const auto count = keys.size();
+        if (count < 2) return;
+        scratch.resize(count);
+        numThreads = static_cast<unsigned>(std::min<std::size_t>(GetNumWorkerThreads(numThreads), (count + 4095) / 4096));
+
+        std::vector<Histogram> histograms(numThreads);
+        for (auto shift = 0U; shift < 64; shift += 8) {
+            ParallelForBlocks(count, numThreads, [&keys, &histograms, shift](std::size_t begin, std::size_t end, unsigned t) {
+                auto& histogram = histograms[t];
+                histogram.fill(0);
+                for (auto i = begin; i < end; ++i) ++histogram[(keys[i].code_ >> shift) & 0xff];
+            });
+
+            // exclusive prefix sum over (digit, thread) so the scatter stays stable.
+            std::size_t offset = 0;
+            auto skipPass = false;
+            for (auto digit = 0U; digit < 256; ++digit) {
+                std::size_t digitCount = 0;
+                for (auto& histogram : histograms) {
+                    auto n = histogram[digit];
+                    histogram[digit] = offset;
+                    offset += n;
+                    digitCount += n;
+                }
+                if (digitCount == count) skipPass = true;
+            }
+            if (skipPass) continue;
+
+            ParallelForBlocks(count, numThreads, [&keys, &scratch, &histograms, shift](std::size_t begin, std::size_t end, unsigned t) {
+                auto& histogram = histograms[t];
+                for (auto i = begin; i < end; ++i) scratch[histogram[(keys[i].code_ >> shift) & 0xff]++] = keys[i];
+            });
+            keys.swap(scratch);
+        }
+    }
+}
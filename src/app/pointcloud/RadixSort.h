@@ -0,0 +1,26 @@
+/**
+ * @file   RadixSort.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the parallel radix sort for morton codes.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace viscom {
+
+    /** A morton code together with the index of the point it belongs to. */
+    struct MortonKey
+    {
+        /** The morton code. */
+        std::uint64_t code_;
+        /** The index of the point. */
+        std::uint64_t index_;
+    };
+
+    void ParallelRadixSort(std::vector<MortonKey>& keys, std::vector<MortonKey>& scratch, unsigned numThreads);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file   RangeAllocator.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the allocator of ranges inside a fixed size buffer.
+ */
+
+#include "RangeAllocator.h"
+
+#include <iterator>
+#include <stdexcept>
+
+namespace viscom {
+
+    /**
+     *  Creates an allocator with the whole buffer free.
+     *  @param size the size of the buffer.
+     */
+    RangeAllocator::RangeAllocator(std::uint64_t size) :
+        size_{ size }
+    {
+        if (size_ > 0) freeRanges_.emplace(0, size_);
+    }
+
+    /**
+     *  Allocates a range from the first free range large enough.
+     *  @param size the size of the range.
+     *  @param offset the offset of the range, only set on success.
+     *  @return whether a free range was large enough.
+     */
+    bool RangeAllocator::Allocate(std::uint64_t size, std::uint64_t& offset)
+    {
+        if (size == 0) return false;
+        for (auto range = freeRanges_.begin(); range != freeRanges_.end(); ++range) {
+            if (range->second < size) continue;
+
+            offset = range->first;
+            auto remainingSize = range->second - size;
+            freeRanges_.erase(range);
+            if (remainingSize > 0) freeRanges_.emplace(offset + size, remainingSize);
+            allocatedSize_ += size;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     *  Frees a range returned by Allocate.
+     *  @param offset the offset of the range.
+     *  @param size the size of the range.
+     */
+    void RangeAllocator::Free(std::uint64_t offset, std::uint64_t size)
+    {
+        if (size == 0) return;
+        if (offset + size > size_ || size > allocatedSize_) throw std::runtime_error("Freed range is not allocated.");
+
+        auto next = freeRanges_.lower_bound(offset);
+        auto previous = next != freeRanges_.begin() ? std::prev(next) : freeRanges_.end();
+        if ((next != freeRanges_.end() && next->first < offset + size)
+            || (previous != freeRanges_.end() && previous->first + previous->second > offset)) throw std::runtime_error("Freed range is not allocated.");
+        allocatedSize_ -= size;
+
+        if (previous != freeRanges_.end() && previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            freeRanges_.erase(previous);
+        }
+        if (next != freeRanges_.end() && next->first == offset + size) {
+            size += next->second;
+            freeRanges_.erase(next);
+        }
+        freeRanges_.emplace(offset, size);
+    }
+}
@@ -0,0 +1,44 @@
+/**
+ * @file   RangeAllocator.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the allocator of ranges inside a fixed size buffer.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+namespace viscom {
+
+    /**
+     *  Hands out ranges of a fixed size buffer (first fit), freed ranges are merged with their free neighbours.
+     *  Only offsets are managed, the buffer itself is owned by the caller. Offsets are multiples of the sizes of
+     *  the ranges allocated before them, so allocating only multiples of a vertex size keeps all ranges aligned.
+     */
+    class RangeAllocator
+    {
+    public:
+        explicit RangeAllocator(std::uint64_t size);
+
+        bool Allocate(std::uint64_t size, std::uint64_t& offset);
+        void Free(std::uint64_t offset, std::uint64_t size);
+
+        /** Returns the size of the buffer. */
+        std::uint64_t GetSize() const { return size_; }
+        /** Returns the number of allocated bytes. */
+        std::uint64_t GetAllocatedSize() const { return allocatedSize_; }
+        /** Returns the number of free ranges, a measure of the fragmentation. */
+        std::size_t GetNumFreeRanges() const { return freeRanges_.size(); }
+
+    private:
+        /** Holds the size of the buffer. */
+        std::uint64_t size_;
+        /** Holds the number of allocated bytes. */
+        std::uint64_t allocatedSize_ = 0;
+        /** Holds the free ranges (offset and size) ordered by offset. */
+        std::map<std::uint64_t, std::uint64_t> freeRanges_;
+    };
+}
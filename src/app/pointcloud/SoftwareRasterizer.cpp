@@ -0,0 +1,317 @@
+/**
+ * @file   SoftwareRasterizer.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the multithreaded CPU rasterizer for point cloud nodes.
+ */
+
+#include "SoftwareRasterizer.h"
+#include "Parallel.h"
+#include "PointQuantization.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX__)
+#define VISCOM_RASTERIZER_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VISCOM_RASTERIZER_SSE
+#include <emmintrin.h>
+#endif
+
+namespace viscom {
+
+    namespace {
+        /** The value of a pixel no point was drawn to, larger than any packed depth and color. */
+        constexpr std::uint64_t EMPTY_SAMPLE = ~std::uint64_t{ 0 };
+    }
+
+    /**
+     *  Creates a rasterizer, the framebuffer is empty until Resize() is called.
+     *  @param numThreads the number of threads, 0 uses all hardware threads.
+     */
+    SoftwareRasterizer::SoftwareRasterizer(unsigned numThreads) :
+        numThreads_{ GetNumWorkerThreads(numThreads) },
+        threadPoints_(numThreads_)
+    {
+        for (auto& points : threadPoints_) {
+            points.x_.resize(BATCH_SIZE);
+            points.y_.resize(BATCH_SIZE);
+            points.z_.resize(BATCH_SIZE);
+            points.colors_.resize(BATCH_SIZE);
+        }
+    }
+
+    /**
+     *  Changes the size of the framebuffer and clears it if the size changed.
+     *  @param width the width in pixels.
+     *  @param height the height in pixels.
+     */
+    void SoftwareRasterizer::Resize(unsigned width, unsigned height)
+    {
+        if (width == width_ && height == height_) return;
+        width_ = width;
+        height_ = height;
+        numTilesX_ = (width + TILE_SIZE - 1) / TILE_SIZE;
+        numSamples_ = static_cast<std::size_t>(numTilesX_) * ((height + TILE_SIZE - 1) / TILE_SIZE) * TILE_SIZE * TILE_SIZE;
+        samples_.reset(new std::atomic<std::uint64_t>[numSamples_]);
+        colors_.assign(static_cast<std::size_t>(width) * height, 0);
+        depths_.assign(static_cast<std::size_t>(width) * height, 1.0f);
+        Clear();
+    }
+
+    void SoftwareRasterizer::Clear()
+    {
+        ParallelForBlocks(numSamples_, numThreads_, [this](std::size_t begin, std::size_t end, unsigned) {
+            for (auto i = begin; i < end; ++i) samples_[i].store(EMPTY_SAMPLE, std::memory_order_relaxed);
+        });
+    }
+
+    /**
+     *  Draws the points of a list of nodes with all threads.
+     *  @param file the point cloud file.
+     *  @param nodes the nodes to draw.
+     *  @param viewProjection the view projection matrix.
+     */
+    void SoftwareRasterizer::Draw(const PointCloudFile& file, const std::vector<std::uint32_t>& nodes, const glm::mat4& viewProjection)
+    {
+        if (numSamples_ == 0) return;
+        CreateBatches(file, nodes);
+        ParallelForDynamic(batches_.size(), numThreads_, [this, &file, &viewProjection](std::size_t i, unsigned threadIndex) {
+            const auto& batch = batches_[i];
+            LoadBatch(file, batch, threadPoints_[threadIndex]);
+            DrawBatch(threadPoints_[threadIndex], batch.end_ - batch.begin_, viewProjection, true);
+        });
+    }
+
+    /**
+     *  Draws the points of a list of nodes on the calling thread without vector instructions. Used as reference for
+     *  tests, the result is the same as the one of Draw().
+     *  @param file the point cloud file.
+     *  @param nodes the nodes to draw.
+     *  @param viewProjection the view projection matrix.
+     */
+    void SoftwareRasterizer::DrawScalar(const PointCloudFile& file, const std::vector<std::uint32_t>& nodes, const glm::mat4& viewProjection)
+    {
+        if (numSamples_ == 0) return;
+        CreateBatches(file, nodes);
+        for (const auto& batch : batches_) {
+            LoadBatch(file, batch, threadPoints_[0]);
+            DrawBatch(threadPoints_[0], batch.end_ - batch.begin_, viewProjection, false);
+        }
+    }
+
+    /**
+     *  Converts the framebuffer to rows of colors and depths that can be uploaded to textures.
+     */
+    void SoftwareRasterizer::Resolve()
+    {
+        ParallelForBlocks(height_, numThreads_, [this](std::size_t begin, std::size_t end, unsigned) {
+            for (auto y = static_cast<unsigned>(begin); y < end; ++y) {
+                for (auto x = 0U; x < width_; ++x) {
+                    auto sample = samples_[GetSampleIndex(x, y)].load(std::memory_order_relaxed);
+                    auto pixel = static_cast<std::size_t>(y) * width_ + x;
+                    if (sample == EMPTY_SAMPLE) {
+                        colors_[pixel] = 0;
+                        depths_[pixel] = 1.0f;
+                        continue;
+                    }
+                    auto depthBits = static_cast<std::uint32_t>(sample >> 32);
+                    colors_[pixel] = static_cast<std::uint32_t>(sample);
+                    std::memcpy(&depths_[pixel], &depthBits, sizeof(float));
+                }
+            }
+        });
+    }
+
+    /** Returns the packed depth and color of a pixel. */
+    std::uint64_t SoftwareRasterizer::GetSample(unsigned x, unsigned y) const
+    {
+        return samples_[GetSampleIndex(x, y)].load(std::memory_order_relaxed);
+    }
+
+    /** Returns the name of the instruction set used for the projection. */
+    const char* SoftwareRasterizer::GetInstructionSet()
+    {
+#if defined(VISCOM_RASTERIZER_AVX)
+        return "AVX";
+#elif defined(VISCOM_RASTERIZER_SSE)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+    std::size_t SoftwareRasterizer::GetSampleIndex(unsigned x, unsigned y) const
+    {
+        auto tile = static_cast<std::size_t>(y / TILE_SIZE) * numTilesX_ + x / TILE_SIZE;
+        return tile * TILE_SIZE * TILE_SIZE + (y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE;
+    }
+
+    void SoftwareRasterizer::CreateBatches(const PointCloudFile& file, const std::vector<std::uint32_t>& nodes)
+    {
+        batches_.clear();
+        for (auto nodeIndex : nodes) {
+            auto numPoints = file.GetNode(nodeIndex).numPoints_;
+            for (std::uint32_t begin = 0; begin < numPoints; begin += static_cast<std::uint32_t>(BATCH_SIZE)) {
+                batches_.push_back(Batch{ nodeIndex, begin, std::min(numPoints, begin + static_cast<std::uint32_t>(BATCH_SIZE)) });
+            }
+        }
+    }
+
+    void SoftwareRasterizer::LoadBatch(const PointCloudFile& file, const Batch& batch, BatchPoints& points) const
+    {
+        const auto& node = file.GetNode(batch.nodeIndex_);
+        auto storeColor = [&points](std::size_t i, glm::u8vec4 color) {
+            // alpha marks covered pixels in the resolved image.
+            color.a = 255;
+            std::memcpy(&points.colors_[i], &color, sizeof(std::uint32_t));
+        };
+
+        if (file.IsColumnar()) {
+            auto positions = static_cast<const glm::u16vec3*>(file.GetColumnData(batch.nodeIndex_, PointAttribute::Position));
+            auto colors = static_cast<const glm::u8vec4*>(file.GetColumnData(batch.nodeIndex_, PointAttribute::Color));
+            for (auto p = batch.begin_; p < batch.end_; ++p) {
+                auto i = p - batch.begin_;
+                auto position = DequantizePosition(positions[p], node.boundsMin_, node.boundsMax_);
+                points.x_[i] = position.x;
+                points.y_[i] = position.y;
+                points.z_[i] = position.z;
+                storeColor(i, colors[p]);
+            }
+        } else if (file.GetHeader().pointLayout_ == PointLayout::Quantized16RGBA8) {
+            auto data = static_cast<const PointCloudCompactPoint*>(file.GetNodeData(batch.nodeIndex_));
+            for (auto p = batch.begin_; p < batch.end_; ++p) {
+                auto i = p - batch.begin_;
+                auto position = DequantizePosition(data[p].position_, node.boundsMin_, node.boundsMax_);
+                points.x_[i] = position.x;
+                points.y_[i] = position.y;
+                points.z_[i] = position.z;
+                storeColor(i, data[p].color_);
+            }
+        } else {
+            auto data = static_cast<const PointCloudPoint*>(file.GetNodeData(batch.nodeIndex_));
+            for (auto p = batch.begin_; p < batch.end_; ++p) {
+                auto i = p - batch.begin_;
+                points.x_[i] = data[p].position_.x;
+                points.y_[i] = data[p].position_.y;
+                points.z_[i] = data[p].position_.z;
+                storeColor(i, data[p].color_);
+            }
+        }
+    }
+
+    /**
+     *  Projects the points of a batch and writes the visible ones. The vectorized and the scalar code use the same
+     *  order of operations, so both give the same pixels and depths.
+     */
+    void SoftwareRasterizer::DrawBatch(const BatchPoints& points, std::size_t numPoints, const glm::mat4& viewProjection, bool vectorized)
+    {
+        const auto& m = viewProjection;
+        auto halfWidth = 0.5f * static_cast<float>(width_);
+        auto halfHeight = 0.5f * static_cast<float>(height_);
+        std::size_t i = 0;
+
+#if defined(VISCOM_RASTERIZER_AVX)
+        if (vectorized) {
+            __m256 row[4][4];
+            for (auto r = 0; r < 4; ++r) for (auto c = 0; c < 4; ++c) row[r][c] = _mm256_set1_ps(m[c][r]);
+            auto zero = _mm256_setzero_ps();
+            auto one = _mm256_set1_ps(1.0f);
+            auto half = _mm256_set1_ps(0.5f);
+            auto hw = _mm256_set1_ps(halfWidth);
+            auto hh = _mm256_set1_ps(halfHeight);
+            float screenX[8], screenY[8], depth[8];
+            for (; i + 8 <= numPoints; i += 8) {
+                auto x = _mm256_loadu_ps(&points.x_[i]);
+                auto y = _mm256_loadu_ps(&points.y_[i]);
+                auto z = _mm256_loadu_ps(&points.z_[i]);
+                __m256 clip[4];
+                for (auto r = 0; r < 4; ++r) {
+                    clip[r] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(row[r][0], x), _mm256_mul_ps(row[r][1], y)), _mm256_add_ps(_mm256_mul_ps(row[r][2], z), row[r][3]));
+                }
+                auto negW = _mm256_sub_ps(zero, clip[3]);
+                auto visible = _mm256_cmp_ps(clip[3], zero, _CMP_GT_OQ);
+                for (auto r = 0; r < 3; ++r) {
+                    visible = _mm256_and_ps(visible, _mm256_and_ps(_mm256_cmp_ps(clip[r], negW, _CMP_GE_OQ), _mm256_cmp_ps(clip[r], clip[3], _CMP_LE_OQ)));
+                }
+                auto mask = _mm256_movemask_ps(visible);
+                if (mask == 0) continue;
+
+                auto invW = _mm256_div_ps(one, clip[3]);
+                _mm256_storeu_ps(screenX, _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(clip[0], invW), hw), hw));
+                _mm256_storeu_ps(screenY, _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(clip[1], invW), hh), hh));
+                _mm256_storeu_ps(depth, _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(clip[2], invW), half), half));
+                for (auto l = 0; l < 8; ++l) {
+                    if ((mask & (1 << l)) != 0) WriteSample(screenX[l], screenY[l], depth[l], points.colors_[i + l]);
+                }
+            }
+        }
+#elif defined(VISCOM_RASTERIZER_SSE)
+        if (vectorized) {
+            __m128 row[4][4];
+            for (auto r = 0; r < 4; ++r) for (auto c = 0; c < 4; ++c) row[r][c] = _mm_set1_ps(m[c][r]);
+            auto zero = _mm_setzero_ps();
+            auto one = _mm_set1_ps(1.0f);
+            auto half = _mm_set1_ps(0.5f);
+            auto hw = _mm_set1_ps(halfWidth);
+            auto hh = _mm_set1_ps(halfHeight);
+            float screenX[4], screenY[4], depth[4];
+            for (; i + 4 <= numPoints; i += 4) {
+                auto x = _mm_loadu_ps(&points.x_[i]);
+                auto y = _mm_loadu_ps(&points.y_[i]);
+                auto z = _mm_loadu_ps(&points.z_[i]);
+                __m128 clip[4];
+                for (auto r = 0; r < 4; ++r) {
+                    clip[r] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(row[r][0], x), _mm_mul_ps(row[r][1], y)), _mm_add_ps(_mm_mul_ps(row[r][2], z), row[r][3]));
+                }
+                auto negW = _mm_sub_ps(zero, clip[3]);
+                auto visible = _mm_cmpgt_ps(clip[3], zero);
+                for (auto r = 0; r < 3; ++r) visible = _mm_and_ps(visible, _mm_and_ps(_mm_cmpge_ps(clip[r], negW), _mm_cmple_ps(clip[r], clip[3])));
+                auto mask = _mm_movemask_ps(visible);
+                if (mask == 0) continue;
+
+                auto invW = _mm_div_ps(one, clip[3]);
+                _mm_storeu_ps(screenX, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(clip[0], invW), hw), hw));
+                _mm_storeu_ps(screenY, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(clip[1], invW), hh), hh));
+                _mm_storeu_ps(depth, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(clip[2], invW), half), half));
+                for (auto l = 0; l < 4; ++l) {
+                    if ((mask & (1 << l)) != 0) WriteSample(screenX[l], screenY[l], depth[l], points.colors_[i + l]);
+                }
+            }
+        }
+#else
+        (void)vectorized;
+#endif
+
+        for (; i < numPoints; ++i) {
+            auto x = points.x_[i], y = points.y_[i], z = points.z_[i];
+            float clip[4];
+            for (auto r = 0; r < 4; ++r) clip[r] = (m[0][r] * x + m[1][r] * y) + (m[2][r] * z + m[3][r]);
+            auto negW = 0.0f - clip[3];
+            auto visible = clip[3] > 0.0f;
+            for (auto r = 0; r < 3; ++r) visible = visible && clip[r] >= negW && clip[r] <= clip[3];
+            if (!visible) continue;
+
+            auto invW = 1.0f / clip[3];
+            WriteSample((clip[0] * invW) * halfWidth + halfWidth, (clip[1] * invW) * halfHeight + halfHeight, (clip[2] * invW) * 0.5f + 0.5f, points.colors_[i]);
+        }
+    }
+
+    void SoftwareRasterizer::WriteSample(float screenX, float screenY, float depth, std::uint32_t color)
+    {
+        auto x = std::min(static_cast<unsigned>(std::max(screenX, 0.0f)), width_ - 1);
+        auto y = std::min(static_cast<unsigned>(std::max(screenY, 0.0f)), height_ - 1);
+
+        // depths are positive, so their bit patterns order like the values and the packed values compare by depth first.
+        std::uint32_t depthBits;
+        std::memcpy(&depthBits, &depth, sizeof(float));
+        auto value = (static_cast<std::uint64_t>(depthBits) << 32) | color;
+
+        auto& sample = samples_[GetSampleIndex(x, y)];
+        auto current = sample.load(std::memory_order_relaxed);
+        while (value < current && !sample.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file   SoftwareRasterizer.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the multithreaded CPU rasterizer for point cloud nodes.
+ */
+
+#pragma once
+
+#include "PointCloudFile.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace viscom {
+
+    /**
+     *  Draws the points of octree nodes into a color and depth buffer on the CPU, for nodes without a GPU and for
+     *  tests. Nodes are split into batches that threads fetch dynamically. Each batch is projected with vector
+     *  instructions (AVX or SSE2, chosen at compile time like FrustumCuller) and written to the framebuffer with an
+     *  atomic minimum on 64 bit values holding the depth in the upper and the color in the lower half. The nearest
+     *  point wins independent of the order the threads write in, so the image is the same for any number of threads.
+     *  The framebuffer is stored in 8x8 pixel tiles, so nearby points hit the same cache lines.
+     */
+    class SoftwareRasterizer
+    {
+    public:
+        /** The width and height of a framebuffer tile in pixels. */
+        static constexpr unsigned TILE_SIZE = 8;
+        /** The number of points projected by a thread at once. */
+        static constexpr std::size_t BATCH_SIZE = 4096;
+
+        explicit SoftwareRasterizer(unsigned numThreads = 0);
+
+        void Resize(unsigned width, unsigned height);
+        void Clear();
+        void Draw(const PointCloudFile& file, const std::vector<std::uint32_t>& nodes, const glm::mat4& viewProjection);
+        void DrawScalar(const PointCloudFile& file, const std::vector<std::uint32_t>& nodes, const glm::mat4& viewProjection);
+        void Resolve();
+
+        /** Returns the width of the framebuffer. */
+        unsigned GetWidth() const { return width_; }
+        /** Returns the height of the framebuffer. */
+        unsigned GetHeight() const { return height_; }
+        /** Returns the number of threads used for drawing. */
+        unsigned GetNumThreads() const { return numThreads_; }
+        /** Returns the resolved colors (RGBA8, bottom row first, alpha 0 where no point was drawn). */
+        const std::vector<std::uint32_t>& GetColors() const { return colors_; }
+        /** Returns the resolved depths in [0, 1] (bottom row first, 1 where no point was drawn). */
+        const std::vector<float>& GetDepths() const { return depths_; }
+        std::uint64_t GetSample(unsigned x, unsigned y) const;
+
+        static const char* GetInstructionSet();
+
+    private:
+        /** A range of points of a node drawn by one thread. */
+        struct Batch
+        {
+            /** Holds the node index. */
+            std::uint32_t nodeIndex_;
+            /** Holds the first point. */
+            std::uint32_t begin_;
+            /** Holds the point after the last one. */
+            std::uint32_t end_;
+        };
+
+        /** The points of a batch converted to separate arrays per coordinate. */
+        struct BatchPoints
+        {
+            /** Holds the x coordinates. */
+            std::vector<float> x_;
+            /** Holds the y coordinates. */
+            std::vector<float> y_;
+            /** Holds the z coordinates. */
+            std::vector<float> z_;
+            /** Holds the colors. */
+            std::vector<std::uint32_t> colors_;
+        };
+
+        std::size_t GetSampleIndex(unsigned x, unsigned y) const;
+        void CreateBatches(const PointCloudFile& file, const std::vector<std::uint32_t>& nodes);
+        void LoadBatch(const PointCloudFile& file, const Batch& batch, BatchPoints& points) const;
+        void DrawBatch(const BatchPoints& points, std::size_t numPoints, const glm::mat4& viewProjection, bool vectorized);
+        void WriteSample(float screenX, float screenY, float depth, std::uint32_t color);
+
+        /** Holds the number of threads. */
+        unsigned numThreads_;
+        /** Holds the width of the framebuffer. */
+        unsigned width_ = 0;
+        /** Holds the height of the framebuffer. */
+        unsigned height_ = 0;
+        /** Holds the number of tiles per row. */
+        unsigned numTilesX_ = 0;
+        /** Holds the number of samples including the padding of the tiles. */
+        std::size_t numSamples_ = 0;
+        /** Holds the packed depth and color of each pixel, in tile order. */
+        std::unique_ptr<std::atomic<std::uint64_t>[]> samples_;
+        /** Holds the batches of the current draw call. */
+        std::vector<Batch> batches_;
+        /** Holds the points of the batch processed by each thread. */
+        std::vector<BatchPoints> threadPoints_;
+        /** Holds the resolved colors. */
+        std::vector<std::uint32_t> colors_;
+        /** Holds the resolved depths. */
+        std::vector<float> depths_;
+    };
+}
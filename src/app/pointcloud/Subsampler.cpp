@@ -0,0 +1,408 @@
+/**
+ * @file   Subsampler.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the spatially uniform subsampling for the level of detail octree.
+ */
+
+#include "Subsampler.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace viscom {
+
+    namespace {
+        /** Marks an empty slot of a cell table. */
+        constexpr std::uint64_t EMPTY_KEY = ~std::uint64_t{ 0 };
+        /** Marks the end of the list of samples in a cell. */
+        constexpr std::uint32_t NO_SAMPLE = 0xffffffff;
+        /** The number of bits per axis of a cell key. */
+        constexpr unsigned CELL_BITS = 21;
+        /** The largest cell coordinate. */
+        constexpr int MAX_CELL = (1 << CELL_BITS) - 1;
+        /** The number of passes with wider spacing before the samples are thinned out. */
+        constexpr unsigned MAX_PASSES = 4;
+        /** The smallest number of points per thread, smaller inputs are not worth the merge. */
+        constexpr std::size_t MIN_POINTS_PER_THREAD = 4096;
+
+        std::uint64_t HashKey(std::uint64_t key) { return key * 0x9E3779B97F4A7C15ULL; }
+
+        std::uint64_t GetCellKey(const glm::ivec3& cell)
+        {
+            return static_cast<std::uint64_t>(cell.x) | (static_cast<std::uint64_t>(cell.y) << CELL_BITS) | (static_cast<std::uint64_t>(cell.z) << (2 * CELL_BITS));
+        }
+
+        glm::ivec3 GetKeyCell(std::uint64_t key)
+        {
+            return glm::ivec3(static_cast<int>(key & MAX_CELL), static_cast<int>((key >> CELL_BITS) & MAX_CELL), static_cast<int>(key >> (2 * CELL_BITS)));
+        }
+
+        /** Returns the partition of a cell, uses the low bits of the hash as the table slots use the high bits. */
+        unsigned GetPartition(std::uint64_t key, unsigned numPartitions)
+        {
+            return static_cast<unsigned>((static_cast<std::uint64_t>(static_cast<std::uint32_t>(HashKey(key))) * numPartitions) >> 32);
+        }
+
+        float DistanceSquared(const glm::vec3& a, const glm::vec3& b)
+        {
+            auto d = a - b;
+            return glm::dot(d, d);
+        }
+    }
+
+    /**
+     *  Prepares the table for a number of cells, the table grows when more are inserted.
+     *  @param expectedSize the expected number of cells.
+     */
+    void Subsampler::CellTable::Clear(std::size_t expectedSize)
+    {
+        std::size_t capacity = 16;
+        while (capacity < 2 * expectedSize) capacity *= 2;
+        if (keys_.size() != capacity) {
+            keys_.assign(capacity, EMPTY_KEY);
+            values_.resize(capacity);
+            shift_ = 64;
+            for (auto size = capacity; size > 1; size /= 2) --shift_;
+        } else if (size_ > 0) {
+            std::fill(keys_.begin(), keys_.end(), EMPTY_KEY);
+        }
+        size_ = 0;
+    }
+
+    /**
+     *  Finds a cell or inserts it, the table is kept at most half full.
+     *  @param key the key of the cell.
+     *  @param value the value of a newly inserted cell.
+     *  @param inserted set to whether the cell was inserted.
+     *  @return the value of the cell, valid until the next insert.
+     */
+    std::uint32_t* Subsampler::CellTable::Insert(std::uint64_t key, std::uint32_t value, bool& inserted)
+    {
+        if (2 * (size_ + 1) > keys_.size()) {
+            std::vector<std::uint64_t> keys(std::max<std::size_t>(16, 2 * keys_.size()), EMPTY_KEY);
+            std::vector<std::uint32_t> values(keys.size());
+            keys.swap(keys_);
+            values.swap(values_);
+            size_ = 0;
+            shift_ = keys.empty() ? 60 : shift_ - 1;
+            bool dummy;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                if (keys[i] != EMPTY_KEY) Insert(keys[i], values[i], dummy);
+            }
+        }
+
+        auto mask = keys_.size() - 1;
+        for (auto slot = static_cast<std::size_t>(HashKey(key) >> shift_);; slot = (slot + 1) & mask) {
+            if (keys_[slot] == key) {
+                inserted = false;
+                return &values_[slot];
+            }
+            if (keys_[slot] == EMPTY_KEY) {
+                keys_[slot] = key;
+                values_[slot] = value;
+                ++size_;
+                inserted = true;
+                return &values_[slot];
+            }
+        }
+    }
+
+    /**
+     *  Finds a cell.
+     *  @param key the key of the cell.
+     *  @return the value of the cell or nullptr if the cell is empty.
+     */
+    const std::uint32_t* Subsampler::CellTable::Find(std::uint64_t key) const
+    {
+        if (size_ == 0) return nullptr;
+        auto mask = keys_.size() - 1;
+        for (auto slot = static_cast<std::size_t>(HashKey(key) >> shift_);; slot = (slot + 1) & mask) {
+            if (keys_[slot] == key) return &values_[slot];
+            if (keys_[slot] == EMPTY_KEY) return nullptr;
+        }
+    }
+
+    /**
+     *  Creates a subsampler, the scratch memory is kept between calls.
+     *  @param method the subsampling method.
+     */
+    Subsampler::Subsampler(SubsamplingMethod method) :
+        method_{ method }
+    {
+    }
+
+    /**
+     *  Chooses at most a given number of points.
+     *  @param points the points.
+     *  @param indices the indices of the points to choose from, samples are preferred in this order.
+     *  @param numIndices the number of indices.
+     *  @param boundsMin the minimum of the bounding box of the points.
+     *  @param boundsMax the maximum of the bounding box of the points.
+     *  @param maxSamples the maximum number of samples.
+     *  @param numThreads the number of threads to use, 0 uses all hardware threads.
+     *  @return whether each index was chosen, valid until the next call.
+     */
+    const std::vector<std::uint8_t>& Subsampler::Sample(const PointCloudPoint* points, const std::uint64_t* indices, std::size_t numIndices,
+        const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::size_t maxSamples, unsigned numThreads)
+    {
+        points_ = points;
+        indices_ = indices;
+        numIndices_ = numIndices;
+        maxSamples_ = maxSamples;
+        spacing_ = 0.0f;
+        numPasses_ = 0;
+
+        if (numIndices <= maxSamples || maxSamples == 0) {
+            selected_.assign(numIndices, maxSamples == 0 ? 0 : 1);
+            numSamples_ = maxSamples == 0 ? 0 : numIndices;
+            return selected_;
+        }
+        if (method_ == SubsamplingMethod::Stride) {
+            numPasses_ = 1;
+            numSamples_ = SampleStride(numIndices, maxSamples);
+            return selected_;
+        }
+
+        numThreads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(GetNumWorkerThreads(numThreads), numIndices / MIN_POINTS_PER_THREAD)));
+        ResizeThreadData(numThreads);
+
+        // start with the spacing of the wanted number of samples on a surface spanning the two largest extents of the box.
+        auto extent = glm::max(boundsMax - boundsMin, glm::vec3(0.0f));
+        auto largest = glm::max(glm::max(extent.x, extent.y), extent.z);
+        auto middle = extent.x + extent.y + extent.z - largest - glm::min(glm::min(extent.x, extent.y), extent.z);
+        auto spacing = std::sqrt(largest * glm::max(middle, 1e-3f * largest) / static_cast<float>(maxSamples));
+        // the cell keys address at most 2^21 cells per axis.
+        spacing = glm::max(spacing, glm::max(largest, 1e-6f) / static_cast<float>(MAX_CELL));
+        gridMin_ = boundsMin;
+
+        std::size_t numSamples = 0;
+        for (numPasses_ = 1;; ++numPasses_) {
+            cellSize_ = spacing;
+            inverseCellSize_ = 1.0f / spacing;
+            selected_.assign(numIndices, 0);
+            numSamples = method_ == SubsamplingMethod::VoxelGrid ? SampleVoxelGrid(numThreads) : SamplePoissonDisk(numThreads);
+            spacing_ = spacing;
+            if (numSamples <= maxSamples || numPasses_ == MAX_PASSES) break;
+            // the number of samples on a surface falls with the square of the spacing, overshoot a little to save a pass.
+            spacing *= std::sqrt(static_cast<float>(numSamples) / static_cast<float>(maxSamples)) * 1.05f;
+        }
+
+        if (numSamples > maxSamples) {
+            auto stride = (numSamples + maxSamples - 1) / maxSamples;
+            std::size_t counter = 0;
+            numSamples = 0;
+            for (auto& selected : selected_) {
+                if (selected == 0) continue;
+                if (counter++ % stride == 0) ++numSamples;
+                else selected = 0;
+            }
+        }
+        numSamples_ = numSamples;
+        return selected_;
+    }
+
+    std::size_t Subsampler::SampleStride(std::size_t numIndices, std::size_t maxSamples)
+    {
+        auto stride = (numIndices + maxSamples - 1) / maxSamples;
+        selected_.resize(numIndices);
+        for (std::size_t i = 0; i < numIndices; ++i) selected_[i] = i % stride == 0 ? 1 : 0;
+        return (numIndices + stride - 1) / stride;
+    }
+
+    /**
+     *  Chooses the point closest to the center of each occupied cell. Each thread keeps the closest points of its
+     *  block in its own hash grid, the merge keeps the closest point per cell and the lower index on ties.
+     *  @param numThreads the number of threads to use.
+     *  @return the number of samples.
+     */
+    std::size_t Subsampler::SampleVoxelGrid(unsigned numThreads)
+    {
+        auto centerDistance = [this](const Candidate& candidate) {
+            return DistanceSquared(candidate.position_, gridMin_ + (glm::vec3(GetKeyCell(candidate.key_)) + 0.5f) * cellSize_);
+        };
+
+        ParallelForBlocks(numIndices_, numThreads, [this, numThreads, &centerDistance](std::size_t begin, std::size_t end, unsigned t) {
+            auto& table = threadTables_[t];
+            auto& samples = threadSamples_[t];
+            table.Clear(std::min(end - begin, 2 * maxSamples_ / numThreads));
+            samples.clear();
+
+            // points in morton order mostly fall into the cell of the point before them, which skips the table lookup.
+            bool inserted;
+            auto lastKey = EMPTY_KEY;
+            std::uint32_t lastSample = 0;
+            for (auto i = begin; i < end; ++i) {
+                Candidate candidate{ points_[indices_[i]].position_, static_cast<std::uint32_t>(i), 0 };
+                candidate.key_ = GetCellKey(GetCell(candidate.position_));
+                if (candidate.key_ != lastKey) {
+                    lastKey = candidate.key_;
+                    lastSample = *table.Insert(candidate.key_, static_cast<std::uint32_t>(samples.size()), inserted);
+                    if (inserted) {
+                        samples.push_back(candidate);
+                        continue;
+                    }
+                }
+                if (centerDistance(candidate) < centerDistance(samples[lastSample])) samples[lastSample] = candidate;
+            }
+
+            for (auto p = 0U; p < numThreads && numThreads > 1; ++p) buckets_[t * numThreads + p].clear();
+            for (const auto& sample : samples) {
+                if (numThreads == 1) selected_[sample.input_] = 1;
+                else buckets_[t * numThreads + GetPartition(sample.key_, numThreads)].push_back(sample);
+            }
+        });
+        if (numThreads == 1) return threadSamples_[0].size();
+
+        // the blocks are merged in order, so keeping the old sample on equal distances keeps the lower index.
+        ParallelForDynamic(numThreads, numThreads, [this, numThreads, &centerDistance](std::size_t p, unsigned) {
+            auto& table = partitionTables_[p];
+            auto& samples = partitionSamples_[p];
+            table.Clear(2 * maxSamples_ / numThreads);
+            samples.clear();
+
+            bool inserted;
+            for (auto t = 0U; t < numThreads; ++t) {
+                for (const auto& candidate : buckets_[t * numThreads + p]) {
+                    auto sample = table.Insert(candidate.key_, static_cast<std::uint32_t>(samples.size()), inserted);
+                    if (inserted) samples.push_back(candidate);
+                    else if (centerDistance(candidate) < centerDistance(samples[*sample])) samples[*sample] = candidate;
+                }
+            }
+            for (const auto& sample : samples) selected_[sample.input_] = 1;
+            partitionCounts_[p] = samples.size();
+        });
+
+        std::size_t numSamples = 0;
+        for (auto p = 0U; p < numThreads; ++p) numSamples += partitionCounts_[p];
+        return numSamples;
+    }
+
+    /**
+     *  Chooses each point that has no chosen point within the cell size, the points are visited in input order.
+     *  Each thread samples its block into its own hash grid with cells of the size of the minimum distance. The merge
+     *  drops every sample that has a sample with a lower index from another block within the minimum distance, which
+     *  may drop a few more samples at the block borders than a sequential pass would.
+     *  @param numThreads the number of threads to use.
+     *  @return the number of samples.
+     */
+    std::size_t Subsampler::SamplePoissonDisk(unsigned numThreads)
+    {
+        auto radiusSquared = cellSize_ * cellSize_;
+
+        ParallelForBlocks(numIndices_, numThreads, [this, numThreads, radiusSquared](std::size_t begin, std::size_t end, unsigned t) {
+            auto& table = threadTables_[t];
+            auto& samples = threadSamples_[t];
+            auto& next = threadNext_[t];
+            table.Clear(std::min(end - begin, maxSamples_ / numThreads));
+            samples.clear();
+            next.clear();
+
+            bool inserted;
+            for (auto i = begin; i < end; ++i) {
+                const auto& position = points_[indices_[i]].position_;
+                auto cell = GetCell(position);
+
+                auto rejected = false;
+                for (auto z = std::max(cell.z - 1, 0); z <= std::min(cell.z + 1, MAX_CELL) && !rejected; ++z) {
+                    for (auto y = std::max(cell.y - 1, 0); y <= std::min(cell.y + 1, MAX_CELL) && !rejected; ++y) {
+                        for (auto x = std::max(cell.x - 1, 0); x <= std::min(cell.x + 1, MAX_CELL) && !rejected; ++x) {
+                            auto head = table.Find(GetCellKey(glm::ivec3(x, y, z)));
+                            for (auto s = head != nullptr ? *head : NO_SAMPLE; s != NO_SAMPLE && !rejected; s = next[s])
+                                rejected = DistanceSquared(samples[s].position_, position) < radiusSquared;
+                        }
+                    }
+                }
+                if (rejected) continue;
+
+                auto sampleIndex = static_cast<std::uint32_t>(samples.size());
+                samples.push_back(Candidate{ position, static_cast<std::uint32_t>(i), GetCellKey(cell) });
+                auto head = table.Insert(samples.back().key_, sampleIndex, inserted);
+                next.push_back(inserted ? NO_SAMPLE : *head);
+                *head = sampleIndex;
+            }
+
+            for (auto p = 0U; p < numThreads && numThreads > 1; ++p) buckets_[t * numThreads + p].clear();
+            for (const auto& sample : samples) {
+                if (numThreads == 1) selected_[sample.input_] = 1;
+                else buckets_[t * numThreads + GetPartition(sample.key_, numThreads)].push_back(sample);
+            }
+        });
+        if (numThreads == 1) return threadSamples_[0].size();
+
+        ParallelForDynamic(numThreads, numThreads, [this, numThreads](std::size_t p, unsigned) {
+            auto& table = partitionTables_[p];
+            auto& samples = partitionSamples_[p];
+            auto& next = partitionNext_[p];
+            table.Clear(maxSamples_ / numThreads);
+            samples.clear();
+            next.clear();
+
+            bool inserted;
+            for (auto t = 0U; t < numThreads; ++t) {
+                for (const auto& candidate : buckets_[t * numThreads + p]) {
+                    auto sampleIndex = static_cast<std::uint32_t>(samples.size());
+                    samples.push_back(candidate);
+                    auto head = table.Insert(candidate.key_, sampleIndex, inserted);
+                    next.push_back(inserted ? NO_SAMPLE : *head);
+                    *head = sampleIndex;
+                }
+            }
+        });
+
+        // all partitions are complete, the conflicts are resolved read-only.
+        ParallelForDynamic(numThreads, numThreads, [this, numThreads, radiusSquared](std::size_t p, unsigned) {
+            std::size_t numSamples = 0;
+            for (const auto& candidate : partitionSamples_[p]) {
+                auto cell = GetKeyCell(candidate.key_);
+                auto rejected = false;
+                for (auto z = std::max(cell.z - 1, 0); z <= std::min(cell.z + 1, MAX_CELL) && !rejected; ++z) {
+                    for (auto y = std::max(cell.y - 1, 0); y <= std::min(cell.y + 1, MAX_CELL) && !rejected; ++y) {
+                        for (auto x = std::max(cell.x - 1, 0); x <= std::min(cell.x + 1, MAX_CELL) && !rejected; ++x) {
+                            auto key = GetCellKey(glm::ivec3(x, y, z));
+                            auto q = GetPartition(key, numThreads);
+                            const auto& samples = partitionSamples_[q];
+                            const auto& next = partitionNext_[q];
+                            auto head = partitionTables_[q].Find(key);
+                            for (auto s = head != nullptr ? *head : NO_SAMPLE; s != NO_SAMPLE && !rejected; s = next[s]) {
+                                rejected = samples[s].input_ < candidate.input_
+                                    && DistanceSquared(samples[s].position_, candidate.position_) < radiusSquared;
+                            }
+                        }
+                    }
+                }
+                if (rejected) continue;
+                selected_[candidate.input_] = 1;
+                ++numSamples;
+            }
+            partitionCounts_[p] = numSamples;
+        });
+
+        std::size_t numSamples = 0;
+        for (auto p = 0U; p < numThreads; ++p) numSamples += partitionCounts_[p];
+        return numSamples;
+    }
+
+    glm::ivec3 Subsampler::GetCell(const glm::vec3& position) const
+    {
+        auto cell = glm::floor((position - gridMin_) * inverseCellSize_);
+        return glm::ivec3(glm::clamp(cell, glm::vec3(0.0f), glm::vec3(static_cast<float>(MAX_CELL))));
+    }
+
+    void Subsampler::ResizeThreadData(unsigned numThreads)
+    {
+        if (threadTables_.size() < numThreads) {
+            threadTables_.resize(numThreads);
+            threadSamples_.resize(numThreads);
+            threadNext_.resize(numThreads);
+            partitionTables_.resize(numThreads);
+            partitionSamples_.resize(numThreads);
+            partitionNext_.resize(numThreads);
+            partitionCounts_.resize(numThreads);
+        }
+        // the buckets are indexed by the current number of threads.
+        if (buckets_.size() < static_cast<std::size_t>(numThreads) * numThreads) buckets_.resize(static_cast<std::size_t>(numThreads) * numThreads);
+    }
+}
@@ -0,0 +1,129 @@
+/**
+ * @file   Subsampler.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the spatially uniform subsampling for the level of detail octree.
+ */
+
+#pragma once
+
+#include "PointCloudFormat.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace viscom {
+
+    /** The ways of choosing the points of an inner octree node from the points of its children. */
+    enum class SubsamplingMethod
+    {
+        /** Every n-th point in the order of the input (morton order in the octree builder). */
+        Stride,
+        /** The point closest to the center of each occupied cell of a regular grid. */
+        VoxelGrid,
+        /** Points in the order of the input that have no chosen point closer than a minimum distance. */
+        PoissonDisk
+    };
+
+    /**
+     *  Chooses a spatially uniform subset of points. The grid based methods fill a hash grid per thread from
+     *  contiguous blocks of the input and merge them in parallel, each thread merging the cells of one partition
+     *  of the hash values. The spacing starts at the one that gives the wanted number of samples on a surface
+     *  through the bounding box and is widened until no more samples than wanted are chosen.
+     */
+    class Subsampler
+    {
+    public:
+        explicit Subsampler(SubsamplingMethod method = SubsamplingMethod::Stride);
+
+        const std::vector<std::uint8_t>& Sample(const PointCloudPoint* points, const std::uint64_t* indices, std::size_t numIndices,
+            const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::size_t maxSamples, unsigned numThreads = 1);
+
+        /** Returns the subsampling method. */
+        SubsamplingMethod GetMethod() const { return method_; }
+        /** Returns the number of samples chosen by the last call. */
+        std::size_t GetNumSamples() const { return numSamples_; }
+        /** Returns the cell size or minimum distance of the last call (0 for SubsamplingMethod::Stride). */
+        float GetSpacing() const { return spacing_; }
+        /** Returns the number of passes of the last call, each pass with a wider spacing. */
+        unsigned GetNumPasses() const { return numPasses_; }
+
+    private:
+        /** A point chosen by a thread, with the cell it lies in. */
+        struct Candidate
+        {
+            /** Holds the position. */
+            glm::vec3 position_;
+            /** Holds the index of the point in the input (the position in the index list). */
+            std::uint32_t input_;
+            /** Holds the key of the grid cell. */
+            std::uint64_t key_;
+        };
+
+        /** A hash grid with open addressing, maps the keys of occupied cells to an index. */
+        struct CellTable
+        {
+            void Clear(std::size_t expectedSize);
+            std::uint32_t* Insert(std::uint64_t key, std::uint32_t value, bool& inserted);
+            const std::uint32_t* Find(std::uint64_t key) const;
+
+            /** Holds the keys, empty slots hold EMPTY_KEY. */
+            std::vector<std::uint64_t> keys_;
+            /** Holds the values. */
+            std::vector<std::uint32_t> values_;
+            /** Holds the number of occupied slots. */
+            std::size_t size_ = 0;
+            /** Holds the shift of the hash that gives the slot, 64 - log2 of the number of slots. */
+            unsigned shift_ = 64;
+        };
+
+        std::size_t SampleStride(std::size_t numIndices, std::size_t maxSamples);
+        std::size_t SampleVoxelGrid(unsigned numThreads);
+        std::size_t SamplePoissonDisk(unsigned numThreads);
+        glm::ivec3 GetCell(const glm::vec3& position) const;
+        void ResizeThreadData(unsigned numThreads);
+
+        /** Holds the subsampling method. */
+        SubsamplingMethod method_;
+        /** Holds the points of the current call. */
+        const PointCloudPoint* points_ = nullptr;
+        /** Holds the indices of the points of the current call. */
+        const std::uint64_t* indices_ = nullptr;
+        /** Holds the number of indices of the current call. */
+        std::size_t numIndices_ = 0;
+        /** Holds the minimum of the grid. */
+        glm::vec3 gridMin_;
+        /** Holds the cell size of the current pass. */
+        float cellSize_ = 1.0f;
+        /** Holds the inverse of the cell size. */
+        float inverseCellSize_ = 1.0f;
+        /** Holds the number of samples wanted in the current call. */
+        std::size_t maxSamples_ = 0;
+        /** Holds whether each point of the input was chosen. */
+        std::vector<std::uint8_t> selected_;
+        /** Holds the number of samples of the last call. */
+        std::size_t numSamples_ = 0;
+        /** Holds the spacing of the last call. */
+        float spacing_ = 0.0f;
+        /** Holds the number of passes of the last call. */
+        unsigned numPasses_ = 0;
+
+        /** Holds the hash grid of each thread. */
+        std::vector<CellTable> threadTables_;
+        /** Holds the points chosen by each thread. */
+        std::vector<std::vector<Candidate>> threadSamples_;
+        /** Holds the next point in the same cell of each point chosen by a thread (Poisson disk only). */
+        std::vector<std::vector<std::uint32_t>> threadNext_;
+        /** Holds the points chosen by each thread for each partition, indexed by thread * partitions + partition. */
+        std::vector<std::vector<Candidate>> buckets_;
+        /** Holds the merged hash grid of each partition. */
+        std::vector<CellTable> partitionTables_;
+        /** Holds the merged points of each partition. */
+        std::vector<std::vector<Candidate>> partitionSamples_;
+        /** Holds the next point in the same cell of each merged point (Poisson disk only). */
+        std::vector<std::vector<std::uint32_t>> partitionNext_;
+        /** Holds the number of samples of each partition. */
+        std::vector<std::size_t> partitionCounts_;
+    };
+}
@@ -0,0 +1,241 @@
+/**
+ * @file   LoopbackTransport.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the loopback connections standing in for the cluster network in the benchmarks.
+ */
+
+#include "LoopbackTransport.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace viscom {
+
+    namespace {
+        /** The size of the package header: the id followed by the size of the data. */
+        constexpr std::size_t PACKAGE_HEADER_SIZE = sizeof(std::uint16_t) + sizeof(std::uint32_t);
+        /** The number of bytes read at once. */
+        constexpr std::size_t RECEIVE_SIZE = 1 << 20;
+
+#ifdef _WIN32
+        using SocketHandle = SOCKET;
+
+        void InitSockets()
+        {
+            static struct WinsockInit {
+                WinsockInit() { WSADATA data; WSAStartup(MAKEWORD(2, 2), &data); }
+                ~WinsockInit() { WSACleanup(); }
+            } winsock;
+        }
+
+        void CloseSocket(SocketHandle socket) { closesocket(socket); }
+#else
+        using SocketHandle = int;
+
+        void InitSockets() {}
+
+        void CloseSocket(SocketHandle socket) { close(socket); }
+#endif
+
+        SocketHandle ToHandle(std::uintptr_t socket) { return static_cast<SocketHandle>(socket); }
+
+        /** Waits until a socket can be read, returns false after the timeout. */
+        bool WaitReadable(std::uintptr_t socket, int timeoutMilliseconds)
+        {
+            fd_set readSet;
+            FD_ZERO(&readSet);
+            FD_SET(ToHandle(socket), &readSet);
+            timeval timeout{ timeoutMilliseconds / 1000, (timeoutMilliseconds % 1000) * 1000 };
+            return select(static_cast<int>(ToHandle(socket)) + 1, &readSet, nullptr, nullptr, &timeout) > 0;
+        }
+
+        sockaddr_in LoopbackAddress(std::uint16_t port)
+        {
+            sockaddr_in address;
+            std::memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(port);
+            return address;
+        }
+    }
+
+    /**
+     *  Takes ownership of a connected socket.
+     *  @param socket the socket.
+     */
+    LoopbackConnection::LoopbackConnection(std::uintptr_t socket) :
+        socket_{ socket }
+    {
+        // requests are small and answered every frame, they must not wait for more data.
+        int noDelay = 1;
+        setsockopt(ToHandle(socket_), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+    }
+
+    LoopbackConnection::LoopbackConnection(LoopbackConnection&& rhs) noexcept :
+        socket_{ rhs.socket_ },
+        received_{ std::move(rhs.received_) },
+        receivedStart_{ rhs.receivedStart_ }
+    {
+        rhs.socket_ = INVALID_SOCKET_HANDLE;
+    }
+
+    LoopbackConnection& LoopbackConnection::operator=(LoopbackConnection&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            Close();
+            socket_ = rhs.socket_;
+            received_ = std::move(rhs.received_);
+            receivedStart_ = rhs.receivedStart_;
+            rhs.socket_ = INVALID_SOCKET_HANDLE;
+        }
+        return *this;
+    }
+
+    LoopbackConnection::~LoopbackConnection()
+    {
+        Close();
+    }
+
+    /**
+     *  Connects to a listener on this machine.
+     *  @param port the port of the listener.
+     */
+    LoopbackConnection LoopbackConnection::Connect(std::uint16_t port)
+    {
+        InitSockets();
+        auto socketHandle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        auto address = LoopbackAddress(port);
+        if (connect(socketHandle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            CloseSocket(socketHandle);
+            throw std::runtime_error("Could not connect to port " + std::to_string(port) + ".");
+        }
+        return LoopbackConnection{ static_cast<std::uintptr_t>(socketHandle) };
+    }
+
+    /**
+     *  Sends a package, waits until it is written.
+     *  @param packageID the id of the package.
+     *  @param data the data.
+     *  @param size the size of the data in bytes.
+     */
+    void LoopbackConnection::Send(std::uint16_t packageID, const void* data, std::size_t size)
+    {
+        if (!IsOpen()) throw std::runtime_error("The loopback connection is closed.");
+        std::uint8_t header[PACKAGE_HEADER_SIZE];
+        auto packageSize = static_cast<std::uint32_t>(size);
+        std::memcpy(header, &packageID, sizeof(std::uint16_t));
+        std::memcpy(header + sizeof(std::uint16_t), &packageSize, sizeof(std::uint32_t));
+
+        const std::uint8_t* parts[] = { header, static_cast<const std::uint8_t*>(data) };
+        std::size_t partSizes[] = { PACKAGE_HEADER_SIZE, size };
+        for (auto p = 0; p < 2; ++p) {
+            for (std::size_t sent = 0; sent < partSizes[p];) {
+                auto result = send(ToHandle(socket_), reinterpret_cast<const char*>(parts[p] + sent), static_cast<int>(partSizes[p] - sent), 0);
+                if (result <= 0) {
+                    Close();
+                    throw std::runtime_error("Could not send over the loopback connection.");
+                }
+                sent += static_cast<std::size_t>(result);
+            }
+        }
+    }
+
+    /**
+     *  Receives the next package.
+     *  @param packageID the id of the package received.
+     *  @param data the data of the package received.
+     *  @param timeoutMilliseconds the time to wait for a package.
+     *  @return whether a package was received.
+     */
+    bool LoopbackConnection::Receive(std::uint16_t& packageID, std::vector<std::uint8_t>& data, int timeoutMilliseconds)
+    {
+        while (!PopPackage(packageID, data)) {
+            if (!IsOpen() || !WaitReadable(socket_, timeoutMilliseconds)) return false;
+            // the data already arrived is read without waiting again.
+            timeoutMilliseconds = 0;
+
+            if (receivedStart_ > 0) {
+                received_.erase(received_.begin(), received_.begin() + static_cast<std::ptrdiff_t>(receivedStart_));
+                receivedStart_ = 0;
+            }
+            auto size = received_.size();
+            received_.resize(size + RECEIVE_SIZE);
+            auto result = recv(ToHandle(socket_), reinterpret_cast<char*>(received_.data() + size), static_cast<int>(RECEIVE_SIZE), 0);
+            received_.resize(size + static_cast<std::size_t>(std::max<decltype(result)>(result, 0)));
+            if (result <= 0) Close();
+        }
+        return true;
+    }
+
+    bool LoopbackConnection::PopPackage(std::uint16_t& packageID, std::vector<std::uint8_t>& data)
+    {
+        if (received_.size() - receivedStart_ < PACKAGE_HEADER_SIZE) return false;
+        std::uint32_t packageSize;
+        std::memcpy(&packageID, received_.data() + receivedStart_, sizeof(std::uint16_t));
+        std::memcpy(&packageSize, received_.data() + receivedStart_ + sizeof(std::uint16_t), sizeof(std::uint32_t));
+        if (received_.size() - receivedStart_ < PACKAGE_HEADER_SIZE + packageSize) return false;
+
+        auto start = received_.begin() + static_cast<std::ptrdiff_t>(receivedStart_ + PACKAGE_HEADER_SIZE);
+        data.assign(start, start + packageSize);
+        receivedStart_ += PACKAGE_HEADER_SIZE + packageSize;
+        return true;
+    }
+
+    void LoopbackConnection::Close()
+    {
+        if (socket_ == INVALID_SOCKET_HANDLE) return;
+        CloseSocket(ToHandle(socket_));
+        socket_ = INVALID_SOCKET_HANDLE;
+    }
+
+    /**
+     *  Starts listening on the loopback interface.
+     */
+    LoopbackListener::LoopbackListener()
+    {
+        InitSockets();
+        auto socketHandle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        auto address = LoopbackAddress(0);
+        socklen_t addressSize = sizeof(address);
+        if (bind(socketHandle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(socketHandle, 64) != 0
+            || getsockname(socketHandle, reinterpret_cast<sockaddr*>(&address), &addressSize) != 0) {
+            CloseSocket(socketHandle);
+            throw std::runtime_error("Could not listen on the loopback interface.");
+        }
+        socket_ = static_cast<std::uintptr_t>(socketHandle);
+        port_ = ntohs(address.sin_port);
+    }
+
+    LoopbackListener::~LoopbackListener()
+    {
+        CloseSocket(ToHandle(socket_));
+    }
+
+    /**
+     *  Accepts the next connection.
+     *  @param timeoutMilliseconds the time to wait for a connection.
+     */
+    LoopbackConnection LoopbackListener::Accept(int timeoutMilliseconds)
+    {
+        if (!WaitReadable(socket_, timeoutMilliseconds)) throw std::runtime_error("No connection within " + std::to_string(timeoutMilliseconds) + " ms.");
+        auto socketHandle = accept(ToHandle(socket_), nullptr, nullptr);
+        return LoopbackConnection{ static_cast<std::uintptr_t>(socketHandle) };
+    }
+}
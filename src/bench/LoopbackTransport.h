@@ -0,0 +1,75 @@
+/**
+ * @file   LoopbackTransport.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the loopback connections standing in for the cluster network in the benchmarks.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace viscom {
+
+    /**
+     *  A TCP connection over the loopback interface sending packages like the cluster network does: each package
+     *  has an id and a size. Sending waits until the package is written, receiving never waits longer than asked.
+     */
+    class LoopbackConnection
+    {
+    public:
+        LoopbackConnection() = default;
+        explicit LoopbackConnection(std::uintptr_t socket);
+        LoopbackConnection(const LoopbackConnection&) = delete;
+        LoopbackConnection(LoopbackConnection&& rhs) noexcept;
+        LoopbackConnection& operator=(const LoopbackConnection&) = delete;
+        LoopbackConnection& operator=(LoopbackConnection&& rhs) noexcept;
+        ~LoopbackConnection();
+
+        static LoopbackConnection Connect(std::uint16_t port);
+
+        void Send(std::uint16_t packageID, const void* data, std::size_t size);
+        bool Receive(std::uint16_t& packageID, std::vector<std::uint8_t>& data, int timeoutMilliseconds = 0);
+
+        /** Returns whether the connection is open, it closes when the other side closed it. */
+        bool IsOpen() const { return socket_ != INVALID_SOCKET_HANDLE; }
+
+    private:
+        /** The value of a socket that is not open. */
+        static constexpr std::uintptr_t INVALID_SOCKET_HANDLE = ~std::uintptr_t{ 0 };
+
+        bool PopPackage(std::uint16_t& packageID, std::vector<std::uint8_t>& data);
+        void Close();
+
+        /** Holds the socket. */
+        std::uintptr_t socket_ = INVALID_SOCKET_HANDLE;
+        /** Holds the bytes received but not returned yet. */
+        std::vector<std::uint8_t> received_;
+        /** Holds the position of the first byte not returned yet. */
+        std::size_t receivedStart_ = 0;
+    };
+
+    /** Accepts loopback connections on a port chosen by the system. */
+    class LoopbackListener
+    {
+    public:
+        LoopbackListener();
+        LoopbackListener(const LoopbackListener&) = delete;
+        LoopbackListener& operator=(const LoopbackListener&) = delete;
+        ~LoopbackListener();
+
+        LoopbackConnection Accept(int timeoutMilliseconds);
+
+        /** Returns the port connections are accepted on. */
+        std::uint16_t GetPort() const { return port_; }
+
+    private:
+        /** Holds the listening socket. */
+        std::uintptr_t socket_;
+        /** Holds the port. */
+        std::uint16_t port_ = 0;
+    };
+}
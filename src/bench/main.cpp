@@ -0,0 +1,1497 @@
+/**
+ * @file   main.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Entry point of the point cloud micro benchmarks.
+ */
+
+#include "LoopbackTransport.h"
+#include "app/pointcloud/ChunkDistribution.h"
+#include "app/pointcloud/DepthPyramid.h"
+#include "app/pointcloud/FrustumCuller.h"
+#include "app/pointcloud/LiveIngestion.h"
+#include "app/pointcloud/LODTraversal.h"
+#include "app/pointcloud/Morton.h"
+#include "app/pointcloud/NodeLoader.h"
+#include "app/pointcloud/PointBudgetController.h"
+#include "app/pointcloud/PointCloudFile.h"
+#include "app/pointcloud/PointQuantization.h"
+#include "app/pointcloud/PointQuery.h"
+#include "app/pointcloud/SoftwareRasterizer.h"
+#include "app/pointcloud/Subsampler.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: PointCloudBench culling [options]" << std::endl
+            << "Options:" << std::endl
+            << "  --file <file.vpc>      use the nodes of a point cloud file (default: synthetic octree)" << std::endl
+            << "  --nodes <n>            number of synthetic nodes (default: 100000)" << std::endl
+            << "  --frusta <n>           number of frusta, e.g. 8 for four stereo windows (default: 8)" << std::endl
+            << "  --iterations <n>       number of culling passes measured (default: 1000)" << std::endl
+            << std::endl
+            << "Usage: PointCloudBench raster --file <file.vpc> [options]" << std::endl
+            << "Options:" << std::endl
+            << "  --width <n>            width of the framebuffer (default: 1920)" << std::endl
+            << "  --height <n>           height of the framebuffer (default: 1080)" << std::endl
+            << "  --threads <n,n,...>    thread counts measured (default: 1,2,4,8)" << std::endl
+            << "  --iterations <n>       number of frames measured per thread count (default: 10)" << std::endl
+            << "  --point-budget <n>     point budget of the level of detail selection (default: 5000000)" << std::endl
+            << "  --preview <file.ppm>   write the rasterized image" << std::endl
+            << std::endl
+            << "Usage: PointCloudBench budget [options]" << std::endl
+            << "Options:" << std::endl
+            << "  --rate <hz>            target frame rate (default: 60)" << std::endl
+            << "  --nodes <ms,ms,...>    simulated time per million points of each node (default: 1.5,2,3)" << std::endl
+            << "  --frames <n>           number of simulated frames (default: 3000)" << std::endl
+            << "  --noise <f>            relative noise of the frame times (default: 0.05)" << std::endl
+            << std::endl
+            << "Usage: PointCloudBench occlusion [options]" << std::endl
+            << "Options:" << std::endl
+            << "  --file <file.vpc>      test the nodes of a point cloud against its rasterized depths (default: synthetic wall)" << std::endl
+            << "  --boxes <n>            number of synthetic boxes (default: 100000)" << std::endl
+            << "  --width <n>            width of the depth buffer (default: 240)" << std::endl
+            << "  --height <n>           height of the depth buffer (default: 135)" << std::endl
+            << "  --move <f>             camera movement between the depth buffer and the test in m (default: 0.2)" << std::endl
+            << "  --point-budget <n>     point budget of the rasterized selection (default: 5000000)" << std::endl
+            << std::endl
+            << "Usage: PointCloudBench query --file <file.vpc> [options]" << std::endl
+            << "Options:" << std::endl
+            << "  --queries <n>          number of queries of each kind (default: 10000)" << std::endl
+            << "  --k <n>                number of nearest neighbors (default: 16)" << std::endl
+            << "  --radius <f>           radius relative to the diagonal of the bounding box (default: 0.002)" << std::endl
+            << "  --cone <pixels>        radius of the pick cone in pixels of a 1080p screen (default: 3)" << std::endl
+            << "  --verify               compare the results to a brute force search" << std::endl
+            << std::endl
+            << "Usage: PointCloudBench ingest [options]" << std::endl
+            << "Options:" << std::endl
+            << "  --points <n>           number of synthetic scanner points (default: 10000000)" << std::endl
+            << "  --batch <n>            number of points per batch (default: 10000)" << std::endl
+            << "  --rate <hz>            frame rate of the simulated render thread (default: 60)" << std::endl
+            << "  --upload-budget <mb>   bytes applied by the render thread per frame (default: 16)" << std::endl
+            << "  --leaf-points <n>      number of points a leaf holds before it is split (default: 20000)" << std::endl
+            << std::endl
+            << "Usage: PointCloudBench distribute --file <file.vpc> [options]" << std::endl
+            << "Options:" << std::endl
+            << "  --slaves <n>           number of simulated slave processes (default: 4)" << std::endl
+            << "  --budget <mb>          bytes sent by the master per frame (default: 8)" << std::endl
+            << "  --rate <hz>            frame rate of the master and the slaves (default: 60)" << std::endl
+            << "  --frames <n>           number of frames a slave waits for its view (default: 3000)" << std::endl
+            << "  --cache <prefix>       cache directory of the slaves, followed by their index (default: chunk_cache_bench)" << std::endl
+            << "  --runs <n>             number of runs, the first one with empty caches (default: 2)" << std::endl
+            << std::endl
+            << "Usage: PointCloudBench columns --file <file.vpc> [options]" << std::endl
+            << "Options:" << std::endl
+            << "  --point-budget <n>     point budget of the level of detail selection loaded (default: 5000000)" << std::endl
+            << "  --threads <n>          number of loader threads (default: 2)" << std::endl
+            << std::endl
+            << "Usage: PointCloudBench subsample [options]" << std::endl
+            << "Options:" << std::endl
+            << "  --points <n>           number of synthetic scanner points (default: 4000000)" << std::endl
+            << "  --samples <n>          maximum number of samples (default: 65536)" << std::endl
+            << "  --threads <n,n,...>    thread counts measured (default: 1,2,4,8)" << std::endl
+            << "  --iterations <n>       number of runs measured per thread count (default: 5)" << std::endl;
+    }
+
+    /** Creates the nodes of a complete octree over a 100m cube, level by level until enough nodes exist. */
+    std::vector<viscom::PointCloudNodeRecord> CreateSyntheticNodes(std::size_t numNodes)
+    {
+        std::vector<viscom::PointCloudNodeRecord> nodes(1);
+        nodes[0].boundsMin_ = glm::vec3(-50.0f);
+        nodes[0].boundsMax_ = glm::vec3(50.0f);
+        for (std::size_t i = 0; nodes.size() < numNodes; ++i) {
+            auto center = 0.5f * (nodes[i].boundsMin_ + nodes[i].boundsMax_);
+            for (auto c = 0; c < 8 && nodes.size() < numNodes; ++c) {
+                viscom::PointCloudNodeRecord child;
+                child.boundsMin_ = glm::vec3((c & 4) != 0 ? center.x : nodes[i].boundsMin_.x, (c & 2) != 0 ? center.y : nodes[i].boundsMin_.y, (c & 1) != 0 ? center.z : nodes[i].boundsMin_.z);
+                child.boundsMax_ = glm::vec3((c & 4) != 0 ? nodes[i].boundsMax_.x : center.x, (c & 2) != 0 ? nodes[i].boundsMax_.y : center.y, (c & 1) != 0 ? nodes[i].boundsMax_.z : center.z);
+                nodes.push_back(child);
+            }
+        }
+        return nodes;
+    }
+
+    /** Creates the frusta of windows arranged around the viewer, each pair of frusta are the eyes of one window. */
+    std::vector<viscom::Frustum> CreateFrusta(std::size_t numFrusta)
+    {
+        std::vector<viscom::Frustum> frusta;
+        auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+        auto numWindows = (numFrusta + 1) / 2;
+        for (std::size_t f = 0; f < numFrusta; ++f) {
+            auto angle = 6.2831853f * static_cast<float>(f / 2) / static_cast<float>(numWindows);
+            glm::vec3 direction{ std::sin(angle), 0.0f, -std::cos(angle) };
+            glm::vec3 eye{ (f % 2 == 0 ? -0.032f : 0.032f) * direction.z, 1.7f, (f % 2 == 0 ? 0.032f : -0.032f) * direction.x };
+            frusta.push_back(viscom::Frustum::FromMatrix(projection * glm::lookAt(eye, eye + direction, glm::vec3(0.0f, 1.0f, 0.0f))));
+        }
+        return frusta;
+    }
+
+    /** Measures the culling throughput of the vectorized kernel against the scalar fallback. */
+    int RunCullingBenchmark(int argc, char** argv)
+    {
+        std::string filename;
+        std::size_t numNodes = 100000;
+        std::size_t numFrusta = 8;
+        auto iterations = 1000;
+        for (auto i = 0; i < argc; ++i) {
+            auto hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--file") == 0 && hasValue) filename = argv[++i];
+            else if (std::strcmp(argv[i], "--nodes") == 0 && hasValue) numNodes = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+            else if (std::strcmp(argv[i], "--frusta") == 0 && hasValue) numFrusta = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+            else if (std::strcmp(argv[i], "--iterations") == 0 && hasValue) iterations = std::max(1, std::atoi(argv[++i]));
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+        if (numFrusta == 0 || numFrusta > viscom::FrustumCuller::MAX_FRUSTA) {
+            std::cerr << "Error: the number of frusta has to be between 1 and " << viscom::FrustumCuller::MAX_FRUSTA << "." << std::endl;
+            return 1;
+        }
+
+        viscom::FrustumCuller culler;
+        std::unique_ptr<viscom::PointCloudFile> file;
+        std::vector<viscom::PointCloudNodeRecord> syntheticNodes;
+        if (!filename.empty()) {
+            file = std::make_unique<viscom::PointCloudFile>(filename);
+            culler.SetNodes(file->GetNodes(), file->GetNumNodes());
+        } else {
+            syntheticNodes = CreateSyntheticNodes(numNodes);
+            culler.SetNodes(syntheticNodes.data(), syntheticNodes.size());
+        }
+        auto frusta = CreateFrusta(numFrusta);
+
+        using Clock = std::chrono::high_resolution_clock;
+        auto measure = [&culler, iterations](auto pass) {
+            pass();
+            auto start = Clock::now();
+            for (auto i = 0; i < iterations; ++i) pass();
+            return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+        };
+
+        auto scalarTime = measure([&]() { culler.CullScalar(frusta.data(), frusta.size(), 0, culler.GetNumNodes()); });
+        auto scalarMasks = culler.GetVisibilityMasks();
+        auto vectorTime = measure([&]() { culler.Cull(frusta.data(), frusta.size()); });
+        const auto& vectorMasks = culler.GetVisibilityMasks();
+
+        std::size_t numMismatches = 0, numVisible = 0;
+        for (std::size_t i = 0; i < vectorMasks.size(); ++i) {
+            if (vectorMasks[i] != scalarMasks[i]) ++numMismatches;
+            if (vectorMasks[i] != 0) ++numVisible;
+        }
+
+        auto nodes = static_cast<double>(culler.GetNumNodes());
+        std::cout << culler.GetNumNodes() << " nodes, " << numFrusta << " frusta, " << numVisible << " nodes visible in any frustum." << std::endl;
+        std::cout << std::setw(10) << "kernel" << std::setw(14) << "pass [us]" << std::setw(14) << "nodes/us" << std::setw(18) << "node-frusta/us" << std::endl;
+        std::cout << std::fixed << std::setprecision(2)
+            << std::setw(10) << "scalar" << std::setw(14) << scalarTime << std::setw(14) << nodes / scalarTime << std::setw(18) << nodes * numFrusta / scalarTime << std::endl
+            << std::setw(10) << viscom::FrustumCuller::GetInstructionSet() << std::setw(14) << vectorTime << std::setw(14) << nodes / vectorTime
+            << std::setw(18) << nodes * numFrusta / vectorTime << std::endl;
+        std::cout << "Speedup: " << scalarTime / vectorTime << "x, " << (vectorTime < 500.0 ? "within" : "exceeds") << " the 0.5 ms frame budget." << std::endl;
+        if (numMismatches != 0) {
+            std::cerr << "Error: " << numMismatches << " nodes differ between the scalar and the vectorized kernel." << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    /** Writes the resolved colors of the software rasterizer as binary PPM, empty pixels are black. */
+    void WritePreview(const std::string& filename, const viscom::SoftwareRasterizer& rasterizer)
+    {
+        std::ofstream out(filename, std::ios::binary);
+        if (!out) throw std::runtime_error("Cannot open preview file '" + filename + "'.");
+        out << "P6\n" << rasterizer.GetWidth() << " " << rasterizer.GetHeight() << "\n255\n";
+        const auto& colors = rasterizer.GetColors();
+        std::vector<std::uint8_t> row(rasterizer.GetWidth() * 3);
+        for (auto y = rasterizer.GetHeight(); y-- > 0;) {
+            for (auto x = 0U; x < rasterizer.GetWidth(); ++x) {
+                auto color = colors[static_cast<std::size_t>(y) * rasterizer.GetWidth() + x];
+                for (auto c = 0; c < 3; ++c) row[x * 3 + c] = static_cast<std::uint8_t>(color >> (8 * c));
+            }
+            out.write(reinterpret_cast<const char*>(row.data()), row.size());
+        }
+    }
+
+    /** Measures the scaling of the software rasterizer over thread counts and compares each image to the scalar reference. */
+    int RunRasterBenchmark(int argc, char** argv)
+    {
+        std::string filename, previewFilename;
+        unsigned width = 1920, height = 1080;
+        std::vector<unsigned> threadCounts{ 1, 2, 4, 8 };
+        auto iterations = 10;
+        viscom::LODTraversalParameters lodParameters;
+        for (auto i = 0; i < argc; ++i) {
+            auto hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--file") == 0 && hasValue) filename = argv[++i];
+            else if (std::strcmp(argv[i], "--width") == 0 && hasValue) width = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+            else if (std::strcmp(argv[i], "--height") == 0 && hasValue) height = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+            else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+                threadCounts.clear();
+                std::istringstream list(argv[++i]);
+                for (std::string count; std::getline(list, count, ',');) threadCounts.push_back(static_cast<unsigned>(std::max(1, std::atoi(count.c_str()))));
+            }
+            else if (std::strcmp(argv[i], "--iterations") == 0 && hasValue) iterations = std::max(1, std::atoi(argv[++i]));
+            else if (std::strcmp(argv[i], "--point-budget") == 0 && hasValue) lodParameters.pointBudget_ = std::strtoull(argv[++i], nullptr, 10);
+            else if (std::strcmp(argv[i], "--preview") == 0 && hasValue) previewFilename = argv[++i];
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+        if (filename.empty() || threadCounts.empty()) {
+            PrintUsage();
+            return 1;
+        }
+
+        viscom::PointCloudFile file(filename);
+        const auto& header = file.GetHeader();
+        auto center = 0.5f * (header.boundsMin_ + header.boundsMax_);
+        auto radius = 0.5f * glm::length(header.boundsMax_ - header.boundsMin_);
+        auto eye = center + glm::vec3(0.6f, 0.4f, 1.0f) * (1.5f * radius);
+        auto viewProjection = glm::perspective(glm::radians(60.0f), static_cast<float>(width) / static_cast<float>(height), 0.01f * radius, 4.0f * radius)
+            * glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+
+        viscom::LODTraversal traversal;
+        auto nodes = traversal.Traverse(file.GetNodes(), viewProjection, static_cast<float>(height), lodParameters);
+        auto numPoints = static_cast<double>(traversal.GetStatistics().numSelectedPoints_);
+
+        viscom::SoftwareRasterizer reference(1);
+        reference.Resize(width, height);
+        reference.DrawScalar(file, nodes, viewProjection);
+
+        std::cout << nodes.size() << " nodes, " << traversal.GetStatistics().numSelectedPoints_ << " points, " << width << "x" << height << " pixels, "
+            << viscom::SoftwareRasterizer::GetInstructionSet() << " projection." << std::endl;
+        std::cout << std::setw(10) << "threads" << std::setw(14) << "frame [ms]" << std::setw(14) << "Mpoints/s" << std::setw(10) << "speedup" << std::endl;
+
+        using Clock = std::chrono::high_resolution_clock;
+        auto result = 0;
+        auto baseTime = 0.0;
+        for (auto numThreads : threadCounts) {
+            viscom::SoftwareRasterizer rasterizer(numThreads);
+            rasterizer.Resize(width, height);
+            rasterizer.Draw(file, nodes, viewProjection);
+
+            auto time = 0.0;
+            for (auto i = 0; i < iterations; ++i) {
+                auto start = Clock::now();
+                rasterizer.Clear();
+                rasterizer.Draw(file, nodes, viewProjection);
+                time += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            }
+            time /= iterations;
+            if (baseTime == 0.0) baseTime = time;
+
+            std::size_t numMismatches = 0;
+            for (auto y = 0U; y < height; ++y) {
+                for (auto x = 0U; x < width; ++x) if (rasterizer.GetSample(x, y) != reference.GetSample(x, y)) ++numMismatches;
+            }
+
+            std::cout << std::fixed << std::setprecision(2) << std::setw(10) << rasterizer.GetNumThreads() << std::setw(14) << time
+                << std::setw(14) << numPoints / (1000.0 * time) << std::setw(9) << baseTime / time << "x" << std::endl;
+            if (numMismatches != 0) {
+                std::cerr << "Error: " << numMismatches << " pixels differ between " << numThreads << " threads and the scalar reference." << std::endl;
+                result = 1;
+            }
+        }
+
+        if (!previewFilename.empty()) {
+            reference.Resolve();
+            WritePreview(previewFilename, reference);
+        }
+        return result;
+    }
+
+    /** Draws the depths of a wall (a rectangle at a constant z) by intersecting the ray of each pixel with it. */
+    std::vector<float> DrawWallDepths(unsigned width, unsigned height, const glm::mat4& viewProjection, const glm::vec3& wallMin, const glm::vec3& wallMax)
+    {
+        std::vector<float> depths(static_cast<std::size_t>(width) * height, 1.0f);
+        auto inverse = glm::inverse(viewProjection);
+        for (auto y = 0U; y < height; ++y) {
+            for (auto x = 0U; x < width; ++x) {
+                glm::vec2 ndc{ (x + 0.5f) / width * 2.0f - 1.0f, (y + 0.5f) / height * 2.0f - 1.0f };
+                auto nearPoint = inverse * glm::vec4(ndc, -1.0f, 1.0f), farPoint = inverse * glm::vec4(ndc, 1.0f, 1.0f);
+                auto origin = glm::vec3(nearPoint) / nearPoint.w, direction = glm::vec3(farPoint) / farPoint.w - origin;
+                auto t = (wallMin.z - origin.z) / direction.z;
+                auto hit = origin + t * direction;
+                if (t < 0.0f || t > 1.0f || hit.x < wallMin.x || hit.x > wallMax.x || hit.y < wallMin.y || hit.y > wallMax.y) continue;
+                auto clip = viewProjection * glm::vec4(hit, 1.0f);
+                depths[static_cast<std::size_t>(y) * width + x] = 0.5f * clip.z / clip.w + 0.5f;
+            }
+        }
+        return depths;
+    }
+
+    /**
+     *  Tests boxes against a depth pyramid and compares the result to the test of every covered pixel. The depths are
+     *  drawn from a camera moved by a small distance, so they are reprojected like depths of the last frame. Boxes
+     *  culled by the pyramid have to be occluded in the depths drawn from the current camera.
+     */
+    int RunOcclusionBenchmark(int argc, char** argv)
+    {
+        std::string filename;
+        std::size_t numBoxes = 100000;
+        unsigned width = 240, height = 135;
+        auto move = 0.2f;
+        viscom::LODTraversalParameters lodParameters;
+        for (auto i = 0; i < argc; ++i) {
+            auto hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--file") == 0 && hasValue) filename = argv[++i];
+            else if (std::strcmp(argv[i], "--boxes") == 0 && hasValue) numBoxes = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+            else if (std::strcmp(argv[i], "--width") == 0 && hasValue) width = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+            else if (std::strcmp(argv[i], "--height") == 0 && hasValue) height = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+            else if (std::strcmp(argv[i], "--move") == 0 && hasValue) move = static_cast<float>(std::atof(argv[++i]));
+            else if (std::strcmp(argv[i], "--point-budget") == 0 && hasValue) lodParameters.pointBudget_ = std::strtoull(argv[++i], nullptr, 10);
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+
+        std::vector<glm::vec3> boxMins, boxMaxs;
+        std::vector<std::uint64_t> boxPoints;
+        std::vector<float> depths, currentDepths;
+        glm::mat4 depthViewProjection, viewProjection;
+        auto projection = glm::perspective(glm::radians(60.0f), static_cast<float>(width) / static_cast<float>(height), 0.1f, 200.0f);
+        if (!filename.empty()) {
+            viscom::PointCloudFile file(filename);
+            const auto& header = file.GetHeader();
+            auto center = 0.5f * (header.boundsMin_ + header.boundsMax_);
+            auto radius = 0.5f * glm::length(header.boundsMax_ - header.boundsMin_);
+            auto eye = center + glm::vec3(0.6f, 0.4f, 1.0f) * (1.5f * radius);
+            projection = glm::perspective(glm::radians(60.0f), static_cast<float>(width) / static_cast<float>(height), 0.01f * radius, 4.0f * radius);
+            depthViewProjection = projection * glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+            viewProjection = projection * glm::lookAt(eye + glm::vec3(move * radius, 0.0f, 0.0f), center, glm::vec3(0.0f, 1.0f, 0.0f));
+
+            viscom::LODTraversal traversal;
+            viscom::SoftwareRasterizer rasterizer;
+            rasterizer.Resize(width, height);
+            rasterizer.Draw(file, traversal.Traverse(file.GetNodes(), depthViewProjection, static_cast<float>(height), lodParameters), depthViewProjection);
+            rasterizer.Resolve();
+            depths = rasterizer.GetDepths();
+            rasterizer.Clear();
+            rasterizer.Draw(file, traversal.Traverse(file.GetNodes(), viewProjection, static_cast<float>(height), lodParameters), viewProjection);
+            rasterizer.Resolve();
+            currentDepths = rasterizer.GetDepths();
+
+            // the selected nodes are the candidates for culling, as in the renderer.
+            for (auto nodeIndex : traversal.GetSelectedNodes()) {
+                const auto& node = file.GetNode(nodeIndex);
+                boxMins.push_back(node.boundsMin_);
+                boxMaxs.push_back(node.boundsMax_);
+                boxPoints.push_back(node.numPoints_);
+            }
+        } else {
+            glm::vec3 wallMin{ -6.0f, -4.0f, -12.0f }, wallMax{ 6.0f, 4.0f, -12.0f };
+            depthViewProjection = projection * glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            viewProjection = projection * glm::lookAt(glm::vec3(move, 0.0f, 0.0f), glm::vec3(move, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            depths = DrawWallDepths(width, height, depthViewProjection, wallMin, wallMax);
+            currentDepths = DrawWallDepths(width, height, viewProjection, wallMin, wallMax);
+
+            std::mt19937 random(42);
+            std::uniform_real_distribution<float> x(-15.0f, 15.0f), y(-10.0f, 10.0f), z(-40.0f, -2.0f), size(0.1f, 4.0f);
+            for (std::size_t i = 0; i < numBoxes; ++i) {
+                glm::vec3 center{ x(random), y(random), z(random) };
+                auto halfSize = 0.5f * size(random);
+                boxMins.push_back(center - halfSize);
+                boxMaxs.push_back(center + halfSize);
+                boxPoints.push_back(1000);
+            }
+        }
+
+        using Clock = std::chrono::high_resolution_clock;
+        viscom::DepthPyramid pyramid, currentPyramid;
+        auto start = Clock::now();
+        pyramid.Reproject(depths.data(), width, height, depthViewProjection, viewProjection);
+        auto buildTime = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        currentPyramid.Build(currentDepths.data(), width, height, viewProjection);
+
+        std::vector<std::uint8_t> occluded(boxMins.size()), occludedReference(boxMins.size());
+        auto measure = [&](auto test) {
+            auto testStart = Clock::now();
+            for (std::size_t i = 0; i < boxMins.size(); ++i) test(i);
+            return std::chrono::duration<double, std::micro>(Clock::now() - testStart).count();
+        };
+        auto pyramidTime = measure([&](std::size_t i) { occluded[i] = pyramid.IsOccluded(boxMins[i], boxMaxs[i]) ? 1 : 0; });
+        auto referenceTime = measure([&](std::size_t i) { occludedReference[i] = pyramid.IsOccludedReference(boxMins[i], boxMaxs[i]) ? 1 : 0; });
+
+        std::size_t numOccluded = 0, numOccludedReference = 0, numNotConservative = 0, numFalseCulls = 0;
+        std::uint64_t occludedPoints = 0, totalPoints = 0;
+        for (std::size_t i = 0; i < boxMins.size(); ++i) {
+            totalPoints += boxPoints[i];
+            numOccludedReference += occludedReference[i];
+            if (occluded[i] == 0) continue;
+            ++numOccluded;
+            occludedPoints += boxPoints[i];
+            if (occludedReference[i] == 0) ++numNotConservative;
+            if (!currentPyramid.IsOccludedReference(boxMins[i], boxMaxs[i])) ++numFalseCulls;
+        }
+
+        auto boxes = static_cast<double>(boxMins.size());
+        std::cout << boxMins.size() << " boxes, " << width << "x" << height << " depths, " << pyramid.GetNumLevels() << " levels, reprojected in "
+            << std::fixed << std::setprecision(2) << buildTime << " us." << std::endl;
+        std::cout << std::setw(10) << "test" << std::setw(12) << "culled" << std::setw(14) << "boxes/us" << std::endl
+            << std::setw(10) << "pyramid" << std::setw(12) << numOccluded << std::setw(14) << boxes / pyramidTime << std::endl
+            << std::setw(10) << "pixels" << std::setw(12) << numOccludedReference << std::setw(14) << boxes / referenceTime << std::endl;
+        std::cout << "Points saved: " << occludedPoints << " of " << totalPoints << " (" << 100.0 * static_cast<double>(occludedPoints) / static_cast<double>(std::max<std::uint64_t>(totalPoints, 1))
+            << "%), " << numFalseCulls << " boxes culled that are visible from the current camera." << std::endl;
+        if (numNotConservative != 0) {
+            std::cerr << "Error: " << numNotConservative << " boxes culled by the pyramid are visible in the per pixel test." << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    /** Reads all points of a file for the brute force reference of the query benchmark. */
+    std::vector<viscom::PointQueryResult> ReadAllPoints(const viscom::PointCloudFile& file)
+    {
+        std::vector<viscom::PointQueryResult> points;
+        points.reserve(static_cast<std::size_t>(file.GetHeader().numPoints_));
+        viscom::PointQuery query(file);
+        // a radius covering the whole file returns every point exactly once.
+        const auto& header = file.GetHeader();
+        auto center = 0.5f * (header.boundsMin_ + header.boundsMax_);
+        for (const auto& point : query.FindInRadius(center, glm::length(header.boundsMax_ - header.boundsMin_))) points.push_back(point);
+        return points;
+    }
+
+    /** Returns the position of a point of a file. */
+    glm::vec3 GetPointPosition(const viscom::PointCloudFile& file, std::uint32_t nodeIndex, std::uint32_t pointIndex)
+    {
+        const auto& node = file.GetNode(nodeIndex);
+        if (file.IsColumnar()) {
+            const auto& position = static_cast<const glm::u16vec3*>(file.GetColumnData(nodeIndex, viscom::PointAttribute::Position))[pointIndex];
+            return viscom::DequantizePosition(position, node.boundsMin_, node.boundsMax_);
+        }
+        if (file.GetHeader().pointLayout_ == viscom::PointLayout::Quantized16RGBA8) {
+            const auto& point = static_cast<const viscom::PointCloudCompactPoint*>(file.GetNodeData(nodeIndex))[pointIndex];
+            return viscom::DequantizePosition(point.position_, node.boundsMin_, node.boundsMax_);
+        }
+        return static_cast<const viscom::PointCloudPoint*>(file.GetNodeData(nodeIndex))[pointIndex].position_;
+    }
+
+    /** Returns a percentile of sorted latencies. */
+    double GetPercentile(const std::vector<double>& sortedLatencies, double percentile)
+    {
+        if (sortedLatencies.empty()) return 0.0;
+        auto index = static_cast<std::size_t>(std::ceil(percentile * static_cast<double>(sortedLatencies.size()))) - 1;
+        return sortedLatencies[std::min(index, sortedLatencies.size() - 1)];
+    }
+
+    /**
+     *  Measures the latency of nearest neighbor, radius and pick queries around random points of a file. Queries
+     *  start at points of the file moved by a small random offset, picks are rays from outside of the bounding box
+     *  towards such points with a cone of a few pixels. With --verify the results are compared to a brute force
+     *  search over all points.
+     */
+    int RunQueryBenchmark(int argc, char** argv)
+    {
+        std::string filename;
+        std::size_t numQueries = 10000, k = 16;
+        auto radiusScale = 0.002f;
+        auto conePixels = 3.0f;
+        auto verify = false;
+        for (auto i = 0; i < argc; ++i) {
+            auto hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--file") == 0 && hasValue) filename = argv[++i];
+            else if (std::strcmp(argv[i], "--queries") == 0 && hasValue) numQueries = static_cast<std::size_t>(std::max(1LL, std::atoll(argv[++i])));
+            else if (std::strcmp(argv[i], "--k") == 0 && hasValue) k = static_cast<std::size_t>(std::max(1LL, std::atoll(argv[++i])));
+            else if (std::strcmp(argv[i], "--radius") == 0 && hasValue) radiusScale = static_cast<float>(std::atof(argv[++i]));
+            else if (std::strcmp(argv[i], "--cone") == 0 && hasValue) conePixels = static_cast<float>(std::atof(argv[++i]));
+            else if (std::strcmp(argv[i], "--verify") == 0) verify = true;
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+        if (filename.empty()) {
+            PrintUsage();
+            return 1;
+        }
+
+        viscom::PointCloudFile file(filename);
+        const auto& header = file.GetHeader();
+        std::vector<std::uint32_t> filledNodes;
+        for (std::uint32_t i = 0; i < file.GetNumNodes(); ++i) if (file.GetNode(i).numPoints_ > 0) filledNodes.push_back(i);
+        if (filledNodes.empty()) throw std::runtime_error("The file \"" + filename + "\" has no points.");
+
+        auto center = 0.5f * (header.boundsMin_ + header.boundsMax_);
+        auto diagonal = glm::length(header.boundsMax_ - header.boundsMin_);
+        auto radius = radiusScale * diagonal;
+        // the cone of a pixel radius on a 1080 pixel high screen with a vertical field of view of 60 degrees.
+        auto coneSlope = conePixels * std::tan(glm::radians(30.0f)) / 540.0f;
+
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<glm::vec3> positions, rayOrigins;
+        viscom::PointQuery query(file);
+        for (std::size_t i = 0; i < numQueries; ++i) {
+            auto nodeIndex = filledNodes[random() % filledNodes.size()];
+            auto pointIndex = static_cast<std::uint32_t>(random() % file.GetNode(nodeIndex).numPoints_);
+            positions.push_back(GetPointPosition(file, nodeIndex, pointIndex) + radius * glm::vec3(unit(random), unit(random), unit(random)));
+            glm::vec3 direction{ unit(random), unit(random), unit(random) };
+            if (glm::length(direction) < 1e-3f) direction = glm::vec3(0.0f, 0.0f, 1.0f);
+            rayOrigins.push_back(center + glm::normalize(direction) * diagonal);
+        }
+
+        using Clock = std::chrono::high_resolution_clock;
+        std::vector<double> nearestLatencies, radiusLatencies, pickLatencies;
+        std::uint64_t nearestNodes = 0, radiusNodes = 0, pickNodes = 0, nearestPoints = 0, radiusPoints = 0, pickPoints = 0, numPicked = 0, numInRadius = 0;
+        std::vector<std::vector<float>> nearestDistances;
+        std::vector<std::size_t> radiusCounts;
+        std::vector<float> pickDistances;
+        for (std::size_t i = 0; i < numQueries; ++i) {
+            auto start = Clock::now();
+            const auto& nearest = query.FindNearest(positions[i], k);
+            nearestLatencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            nearestNodes += query.GetStatistics().numVisitedNodes_;
+            nearestPoints += query.GetStatistics().numTestedPoints_;
+            if (verify) {
+                nearestDistances.emplace_back();
+                for (const auto& result : nearest) nearestDistances.back().push_back(result.distance_);
+            }
+
+            start = Clock::now();
+            const auto& inRadius = query.FindInRadius(positions[i], radius);
+            radiusLatencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            radiusNodes += query.GetStatistics().numVisitedNodes_;
+            radiusPoints += query.GetStatistics().numTestedPoints_;
+            numInRadius += inRadius.size();
+            if (verify) radiusCounts.push_back(inRadius.size());
+
+            viscom::PointQueryResult picked;
+            start = Clock::now();
+            auto found = query.Pick(rayOrigins[i], positions[i] - rayOrigins[i], coneSlope, picked);
+            pickLatencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            pickNodes += query.GetStatistics().numVisitedNodes_;
+            pickPoints += query.GetStatistics().numTestedPoints_;
+            if (found) ++numPicked;
+            if (verify) pickDistances.push_back(found ? picked.distance_ : -1.0f);
+        }
+
+        std::cout << header.numPoints_ << " points in " << file.GetNumNodes() << " nodes, " << numQueries << " queries each (k " << k << ", radius "
+            << radius << ", cone " << conePixels << " pixels)." << std::endl;
+        std::cout << std::setw(10) << "query" << std::setw(12) << "p50 [us]" << std::setw(12) << "p99 [us]" << std::setw(12) << "max [us]"
+            << std::setw(12) << "nodes" << std::setw(14) << "points" << std::endl;
+        auto printRow = [numQueries](const char* name, std::vector<double>& latencies, std::uint64_t numNodes, std::uint64_t numPoints) {
+            std::sort(latencies.begin(), latencies.end());
+            auto queries = static_cast<double>(numQueries);
+            std::cout << std::fixed << std::setprecision(1) << std::setw(10) << name << std::setw(12) << GetPercentile(latencies, 0.5)
+                << std::setw(12) << GetPercentile(latencies, 0.99) << std::setw(12) << latencies.back()
+                << std::setw(12) << static_cast<double>(numNodes) / queries << std::setw(14) << static_cast<double>(numPoints) / queries << std::endl;
+        };
+        printRow("nearest", nearestLatencies, nearestNodes, nearestPoints);
+        printRow("radius", radiusLatencies, radiusNodes, radiusPoints);
+        printRow("pick", pickLatencies, pickNodes, pickPoints);
+        std::cout << "Average of " << static_cast<double>(numInRadius) / static_cast<double>(numQueries) << " points in the radius, "
+            << numPicked << " of " << numQueries << " picks hit." << std::endl;
+        if (!verify) return 0;
+
+        // the brute force search keeps the distances only, ties may be resolved by different points.
+        auto points = ReadAllPoints(file);
+        std::size_t numErrors = 0;
+        std::vector<float> distances(points.size());
+        for (std::size_t i = 0; i < numQueries; ++i) {
+            for (std::size_t p = 0; p < points.size(); ++p) distances[p] = glm::length(points[p].position_ - positions[i]);
+            auto numNearest = std::min(k, distances.size());
+            std::partial_sort(distances.begin(), distances.begin() + static_cast<std::ptrdiff_t>(numNearest), distances.end());
+            auto sameNearest = nearestDistances[i].size() == numNearest;
+            for (std::size_t n = 0; n < numNearest && sameNearest; ++n) sameNearest = std::abs(nearestDistances[i][n] - distances[n]) <= 1e-5f * diagonal;
+            auto inRadius = static_cast<std::size_t>(std::count_if(distances.begin(), distances.end(), [radius](float distance) { return distance <= radius; }));
+
+            auto ray = glm::normalize(positions[i] - rayOrigins[i]);
+            auto pickDistance = -1.0f;
+            for (const auto& point : points) {
+                auto offset = point.position_ - rayOrigins[i];
+                auto along = glm::dot(offset, ray);
+                auto coneRadius = coneSlope * along;
+                if (along < 0.0f || glm::dot(offset, offset) - along * along > coneRadius * coneRadius) continue;
+                if (pickDistance < 0.0f || along < pickDistance) pickDistance = along;
+            }
+            auto samePick = (pickDistance < 0.0f) == (pickDistances[i] < 0.0f) && std::abs(pickDistance - pickDistances[i]) <= 1e-5f * diagonal;
+
+            // points exactly on the radius may fall to either side due to rounding.
+            if (!sameNearest || std::max(inRadius, radiusCounts[i]) - std::min(inRadius, radiusCounts[i]) > 1 || !samePick) ++numErrors;
+        }
+        if (numErrors != 0) {
+            std::cerr << "Error: " << numErrors << " queries differ from the brute force search." << std::endl;
+            return 1;
+        }
+        std::cout << "All queries match the brute force search over " << points.size() << " points." << std::endl;
+        return 0;
+    }
+
+    /**
+     *  Inserts enough points in a single call into a live octree with small leaves that nodes are split in the middle
+     *  of the call, and checks that every point ends up exactly once inside a node of a consistent tree.
+     */
+    bool CheckLiveOctreeSplits()
+    {
+        viscom::LiveOctreeParameters parameters;
+        parameters.maxLeafPoints_ = 16;
+        parameters.gridSize_ = 4;
+        viscom::LiveOctree octree(glm::vec3(0.0f), 2.0f, parameters);
+        std::vector<viscom::PointCloudPoint> points(20000);
+        std::uint64_t state = 1;
+        for (auto& point : points) {
+            for (auto axis = 0; axis < 3; ++axis) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                point.position_[axis] = static_cast<float>(state >> 40) / static_cast<float>(1 << 24) * 2.0f - 1.0f;
+            }
+            point.color_ = glm::u8vec4(255);
+        }
+        octree.Insert(points.data(), points.size());
+
+        const auto& nodes = octree.GetNodes();
+        std::size_t numErrors = 0;
+        std::uint64_t numNodePoints = 0;
+        for (std::size_t n = 0; n < nodes.size(); ++n) {
+            const auto& nodePoints = octree.GetNodePoints(static_cast<std::uint32_t>(n));
+            numNodePoints += nodePoints.size();
+            if (nodes[n].numPoints_ != nodePoints.size()) ++numErrors;
+            for (const auto& point : nodePoints) {
+                if (glm::any(glm::lessThan(point.position_, nodes[n].boundsMin_)) || glm::any(glm::greaterThan(point.position_, nodes[n].boundsMax_))) ++numErrors;
+            }
+            for (auto child = nodes[n].firstChild_; child != viscom::POINTCLOUD_NO_NODE && child < nodes[n].firstChild_ + nodes[n].numChildren_; ++child) {
+                if (nodes[child].parent_ != n) ++numErrors;
+            }
+        }
+        const auto& statistics = octree.GetStatistics();
+        if (statistics.numSplits_ == 0 || statistics.numPoints_ != points.size() || numNodePoints != points.size()) ++numErrors;
+        if (numErrors != 0) {
+            std::cerr << "Error: inserting " << points.size() << " points with " << statistics.numSplits_ << " splits left " << numErrors
+                << " inconsistencies in the live octree." << std::endl;
+            return false;
+        }
+        std::cout << "Inserted " << points.size() << " points into a live octree with " << statistics.numSplits_ << " splits in one call." << std::endl;
+        return true;
+    }
+
+    /**
+     *  Measures the sustained throughput of the live ingestion. A producer pushes the points of a synthetic scanner
+     *  (a rotating line scanner on a slowly moving platform above a terrain) as fast as the queue accepts them, while
+     *  a simulated render thread applies the node updates at a fixed frame rate to its own copy of the octree, as the
+     *  live renderer does. Reports the time the render thread spends per frame and checks its copy at the end.
+     */
+    int RunIngestBenchmark(int argc, char** argv)
+    {
+        if (!CheckLiveOctreeSplits()) return 1;
+        std::uint64_t numPoints = 10000000, uploadBudget = 16ULL << 20;
+        std::size_t batchSize = 10000;
+        auto frameRate = 60.0;
+        viscom::LiveOctreeParameters parameters;
+        for (auto i = 0; i < argc; ++i) {
+            auto hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--points") == 0 && hasValue) numPoints = static_cast<std::uint64_t>(std::max(1LL, std::atoll(argv[++i])));
+            else if (std::strcmp(argv[i], "--batch") == 0 && hasValue) batchSize = static_cast<std::size_t>(std::max(1LL, std::atoll(argv[++i])));
+            else if (std::strcmp(argv[i], "--rate") == 0 && hasValue) frameRate = std::max(1.0, std::atof(argv[++i]));
+            else if (std::strcmp(argv[i], "--upload-budget") == 0 && hasValue) uploadBudget = static_cast<std::uint64_t>(std::max(1LL, std::atoll(argv[++i]))) << 20;
+            else if (std::strcmp(argv[i], "--leaf-points") == 0 && hasValue) parameters.maxLeafPoints_ = static_cast<std::uint32_t>(std::max(1LL, std::atoll(argv[++i])));
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+
+        using Clock = std::chrono::steady_clock;
+        viscom::LiveIngestion ingestion(glm::vec3(0.0f), 256.0f, parameters);
+        std::vector<viscom::PointCloudNodeRecord> nodes;
+        std::vector<std::vector<viscom::PointCloudPoint>> nodePoints;
+        std::vector<double> frameTimes;
+        std::atomic<bool> producerDone{ false };
+        std::thread renderThread([&]() {
+            auto frameLength = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frameRate));
+            auto nextFrame = Clock::now();
+            viscom::LiveNodeUpdate update;
+            while (true) {
+                auto finished = producerDone && ingestion.IsIdle();
+                auto start = Clock::now();
+                std::uint64_t uploadedBytes = 0;
+                std::uint32_t numUpdates = 0;
+                while ((finished || numUpdates == 0 || uploadedBytes < uploadBudget) && ingestion.TryPopUpdate(update)) {
+                    auto numNodes = static_cast<std::size_t>(update.nodeIndex_) + 1;
+                    if (update.record_.firstChild_ != viscom::POINTCLOUD_NO_NODE) numNodes = std::max<std::size_t>(numNodes, update.record_.firstChild_ + update.record_.numChildren_);
+                    if (nodes.size() < numNodes) {
+                        viscom::PointCloudNodeRecord placeholder;
+                        placeholder.boundsMin_ = placeholder.boundsMax_ = glm::vec3(0.0f);
+                        nodes.resize(numNodes, placeholder);
+                        nodePoints.resize(numNodes);
+                    }
+                    nodes[update.nodeIndex_] = update.record_;
+                    auto& points = nodePoints[update.nodeIndex_];
+                    points.resize(update.firstPoint_);
+                    points.insert(points.end(), update.points_.begin(), update.points_.end());
+                    uploadedBytes += update.points_.size() * sizeof(viscom::PointCloudPoint);
+                    ++numUpdates;
+                }
+                if (finished) return;
+                frameTimes.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+                nextFrame += frameLength;
+                std::this_thread::sleep_until(nextFrame);
+            }
+        });
+
+        // a line scanner turning at 50 Hz with 2000 points per turn, moving along x at 2 m/s over a terrain.
+        auto start = Clock::now();
+        std::vector<viscom::PointCloudPoint> batch;
+        for (std::uint64_t i = 0; i < numPoints; ++i) {
+            auto time = static_cast<double>(i) / 100000.0;
+            auto angle = static_cast<float>(i % 2000) * 6.2831853f / 2000.0f;
+            auto scanner = glm::vec3(-100.0f + 2.0f * static_cast<float>(std::fmod(time, 100.0)), 0.0f, 2.0f);
+            auto direction = glm::vec3(0.3f * std::sin(0.7f * static_cast<float>(time)), std::cos(angle), std::sin(angle));
+            // rays upwards hit a ceiling, rays downwards the terrain.
+            auto distance = direction.z > 0.05f ? 8.0f / direction.z : (direction.z < -0.05f ? 2.0f / -direction.z : 100.0f);
+            auto position = scanner + std::min(distance, 100.0f) * direction;
+            position.z += 0.3f * std::sin(0.2f * position.x) * std::cos(0.3f * position.y);
+            batch.push_back(viscom::PointCloudPoint{ position, glm::u8vec4(static_cast<std::uint8_t>(i % 256), 128, 255, 255) });
+            if (batch.size() < batchSize && i + 1 < numPoints) continue;
+            while (!ingestion.Push(std::move(batch))) std::this_thread::yield();
+            batch.clear();
+        }
+        while (!ingestion.IsIdle()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        auto ingestTime = std::chrono::duration<double>(Clock::now() - start).count();
+        producerDone = true;
+        renderThread.join();
+
+        auto statistics = ingestion.GetStatistics();
+        std::cout << statistics.numInsertedPoints_ << " points ingested into " << statistics.numNodes_ << " nodes (" << statistics.numRejectedPoints_
+            << " outside of the root) in " << std::fixed << std::setprecision(2) << ingestTime << " s: "
+            << static_cast<double>(statistics.numInsertedPoints_) / ingestTime / 1e6 << " Mpts/s sustained, " << statistics.numProducerStalls_
+            << " producer stalls." << std::endl;
+        std::cout << "Throughput of the last window of the worker: " << statistics.pointsPerSecond_ / 1e6 << " Mpts/s." << std::endl;
+        if (!frameTimes.empty()) {
+            std::sort(frameTimes.begin(), frameTimes.end());
+            std::cout << "Render thread over " << frameTimes.size() << " frames at " << frameRate << " Hz: " << std::setprecision(3) << GetPercentile(frameTimes, 0.5)
+                << " ms median, " << GetPercentile(frameTimes, 0.99) << " ms p99, " << frameTimes.back() << " ms max per frame to apply updates." << std::endl;
+        }
+
+        // the copy of the render thread has to hold every point exactly once, inside its node and with consistent links.
+        std::size_t numErrors = 0;
+        std::uint64_t numCopiedPoints = 0;
+        for (std::size_t n = 0; n < nodes.size(); ++n) {
+            const auto& node = nodes[n];
+            numCopiedPoints += nodePoints[n].size();
+            if (node.numPoints_ != nodePoints[n].size()) ++numErrors;
+            for (const auto& point : nodePoints[n]) {
+                if (glm::any(glm::lessThan(point.position_, node.boundsMin_)) || glm::any(glm::greaterThan(point.position_, node.boundsMax_))) ++numErrors;
+            }
+            for (auto child = node.firstChild_; child != viscom::POINTCLOUD_NO_NODE && child < node.firstChild_ + node.numChildren_; ++child) {
+                if (nodes[child].parent_ != n || nodes[child].level_ != node.level_ + 1) ++numErrors;
+            }
+        }
+        if (nodes.size() != statistics.numNodes_) ++numErrors;
+        if (numCopiedPoints != statistics.numInsertedPoints_) ++numErrors;
+        if (numErrors != 0) {
+            std::cerr << "Error: the copy of the render thread has " << numErrors << " inconsistencies (" << numCopiedPoints << " points in "
+                << nodes.size() << " nodes)." << std::endl;
+            return 1;
+        }
+        std::cout << "The copy of the render thread matches the octree." << std::endl;
+        return 0;
+    }
+
+    /** The id of the report a simulated slave sends to the master when it is done. */
+    constexpr std::uint16_t DISTRIBUTION_REPORT_PACKAGE_ID = 0x5053;
+
+    /** The results of a simulated slave of the distribution benchmark. */
+    struct DistributionReport
+    {
+        /** The index of the slave. */
+        std::uint32_t index_ = 0;
+        /** Whether all selected nodes arrived within the frame limit. */
+        std::uint32_t complete_ = 0;
+        /** The time from the start of the slave until the first selected points were available in seconds. */
+        double firstPointsTime_ = -1.0;
+        /** The time from the start of the slave until all selected points were available in seconds. */
+        double completeTime_ = -1.0;
+        /** The number of bytes received. */
+        std::uint64_t receivedBytes_ = 0;
+        /** The number of chunks received. */
+        std::uint32_t numReceivedChunks_ = 0;
+        /** The number of chunks found in the cache. */
+        std::uint32_t numCachedChunks_ = 0;
+        /** The number of nodes selected for the view of the slave. */
+        std::uint32_t numSelectedNodes_ = 0;
+        /** The number of chunks of the local copy that differ from the original file. */
+        std::uint32_t numMismatchedChunks_ = 0;
+    };
+
+    /** Returns the base name of the cached copy of a dataset, as the chunk replica names it. */
+    std::string GetChunkCacheName(const std::string& cacheDirectory, std::uint64_t datasetId)
+    {
+        std::ostringstream name;
+        name << cacheDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << datasetId;
+        return name.str();
+    }
+
+    /**
+     *  Sends the manifest in small parts and requests it again while it arrives, as a slave does when the manifest
+     *  takes longer than its retry interval, and checks that the parts sent twice do not complete it early.
+     *  @param file the point cloud file.
+     *  @param cacheDirectory the directory of the cached copy, its files of the dataset are removed.
+     *  @return whether the manifest arrived intact once all parts were received.
+     */
+    bool CheckRepeatedManifest(const viscom::PointCloudFile& file, const std::string& cacheDirectory)
+    {
+        viscom::ChunkServer server(file, 64);
+        auto cacheName = GetChunkCacheName(cacheDirectory, server.GetDatasetId());
+        std::remove((cacheName + ".vpc").c_str());
+        std::remove((cacheName + ".chunks").c_str());
+
+        std::vector<std::vector<std::uint8_t>> messages;
+        auto collect = [&messages](int, const std::vector<std::uint8_t>& message) { messages.push_back(message); };
+        auto request = viscom::ChunkReplica::CreateManifestRequest();
+        server.Receive(0, request.data(), request.size());
+        server.Send(~std::uint64_t{ 0 }, collect);
+        auto numParts = messages.size();
+        server.Receive(0, request.data(), request.size());
+        server.Send(~std::uint64_t{ 0 }, collect);
+        if (numParts < 2 || messages.size() != 2 * numParts) {
+            std::cerr << "Error: the manifest was sent in " << numParts << " parts and " << messages.size() - numParts << " parts again." << std::endl;
+            return false;
+        }
+
+        // the first half of the parts of both rounds add up to the size of the manifest.
+        viscom::ChunkReplica replica(cacheDirectory);
+        for (std::size_t i = 0; i < numParts / 2; ++i) {
+            replica.Receive(messages[i].data(), messages[i].size());
+            replica.Receive(messages[numParts + i].data(), messages[numParts + i].size());
+        }
+        replica.Update();
+        if (replica.IsReady()) {
+            std::cerr << "Error: the manifest was complete after " << numParts / 2 << " of " << numParts << " parts, each received twice." << std::endl;
+            return false;
+        }
+        for (auto i = numParts + numParts / 2; i < messages.size(); ++i) replica.Receive(messages[i].data(), messages[i].size());
+        replica.Update();
+        if (!replica.IsReady()) {
+            std::cerr << "Error: the manifest was not complete after all " << numParts << " parts were received." << std::endl;
+            return false;
+        }
+        std::cout << "The manifest arrived intact in " << numParts << " parts with the first half of them sent twice." << std::endl;
+        return true;
+    }
+
+    /**
+     *  Runs a simulated slave of the distribution benchmark: it connects to the master, requests the chunks its own
+     *  view needs each frame and measures when the first and when all of them are on disk. Its view looks out from
+     *  the center of the point cloud in its own direction, like one projector of a surround display.
+     */
+    int RunDistributionSlave(int argc, char** argv)
+    {
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        std::string filename, cacheDirectory;
+        std::uint16_t port = 0;
+        std::uint32_t index = 0, numSlaves = 1;
+        auto maxFrames = 3000, frameRate = 60;
+        for (auto i = 0; i < argc; ++i) {
+            auto hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--file") == 0 && hasValue) filename = argv[++i];
+            else if (std::strcmp(argv[i], "--cache") == 0 && hasValue) cacheDirectory = argv[++i];
+            else if (std::strcmp(argv[i], "--port") == 0 && hasValue) port = static_cast<std::uint16_t>(std::atoi(argv[++i]));
+            else if (std::strcmp(argv[i], "--index") == 0 && hasValue) index = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+            else if (std::strcmp(argv[i], "--slaves") == 0 && hasValue) numSlaves = static_cast<std::uint32_t>(std::max(1, std::atoi(argv[++i])));
+            else if (std::strcmp(argv[i], "--frames") == 0 && hasValue) maxFrames = std::max(1, std::atoi(argv[++i]));
+            else if (std::strcmp(argv[i], "--rate") == 0 && hasValue) frameRate = std::max(1, std::atoi(argv[++i]));
+            else return 1;
+        }
+
+        auto connection = viscom::LoopbackConnection::Connect(port);
+        viscom::ChunkReplica replica(cacheDirectory);
+        std::unique_ptr<viscom::PointCloudFile> file;
+        viscom::LODTraversal traversal;
+        viscom::LODTraversalParameters lodParameters;
+        glm::mat4 viewProjection;
+        std::vector<viscom::NodeLoadRequest> requests;
+        std::vector<std::uint8_t> message;
+        DistributionReport report;
+        report.index_ = index;
+
+        auto frameLength = std::chrono::microseconds(1000000 / frameRate);
+        auto nextFrame = Clock::now();
+        auto lastManifestRequest = nextFrame - std::chrono::seconds(10);
+        for (auto frame = 0; frame < maxFrames && connection.IsOpen(); ++frame) {
+            std::uint16_t packageID;
+            while (connection.Receive(packageID, message)) {
+                if (packageID == viscom::CHUNK_DATA_PACKAGE_ID) replica.Receive(message.data(), message.size());
+            }
+            replica.Update();
+
+            if (!replica.IsReady()) {
+                if (Clock::now() - lastManifestRequest >= std::chrono::seconds(2)) {
+                    auto request = viscom::ChunkReplica::CreateManifestRequest();
+                    connection.Send(viscom::CHUNK_REQUEST_PACKAGE_ID, request.data(), request.size());
+                    lastManifestRequest = Clock::now();
+                }
+            }
+            else {
+                if (!file) {
+                    file = std::make_unique<viscom::PointCloudFile>(replica.GetFilename());
+                    const auto& header = file->GetHeader();
+                    auto center = 0.5f * (header.boundsMin_ + header.boundsMax_);
+                    auto radius = 0.5f * glm::length(header.boundsMax_ - header.boundsMin_);
+                    auto angle = 6.2831853f * static_cast<float>(index) / static_cast<float>(numSlaves);
+                    glm::vec3 direction{ std::sin(angle), 0.0f, -std::cos(angle) };
+                    viewProjection = glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.01f * radius, 4.0f * radius)
+                        * glm::lookAt(center, center + direction, glm::vec3(0.0f, 1.0f, 0.0f));
+                }
+
+                // the chunks are requested in the order of the selection, as the renderer does.
+                const auto& nodes = traversal.Traverse(file->GetNodes(), viewProjection, 1080.0f, lodParameters);
+                requests.clear();
+                std::uint32_t numAvailable = 0, numAvailablePoints = 0;
+                for (std::size_t i = 0; i < nodes.size(); ++i) {
+                    if (replica.IsAvailable(nodes[i])) {
+                        ++numAvailable;
+                        numAvailablePoints += file->GetNode(nodes[i]).numPoints_;
+                    }
+                    else requests.push_back(viscom::NodeLoadRequest{ static_cast<float>(nodes.size() - i), nodes[i] });
+                }
+                replica.Request(requests);
+                if (replica.CreateChunkRequest(message)) connection.Send(viscom::CHUNK_REQUEST_PACKAGE_ID, message.data(), message.size());
+
+                auto time = std::chrono::duration<double>(Clock::now() - start).count();
+                if (report.firstPointsTime_ < 0.0 && numAvailablePoints > 0) report.firstPointsTime_ = time;
+                if (numAvailable == nodes.size()) {
+                    report.completeTime_ = time;
+                    report.complete_ = 1;
+                    report.numSelectedNodes_ = static_cast<std::uint32_t>(nodes.size());
+                    break;
+                }
+            }
+
+            nextFrame += frameLength;
+            std::this_thread::sleep_until(nextFrame);
+        }
+
+        const auto& statistics = replica.GetStatistics();
+        report.receivedBytes_ = statistics.receivedBytes_;
+        report.numReceivedChunks_ = statistics.numReceivedChunks_;
+        report.numCachedChunks_ = statistics.numCachedChunks_;
+        if (file && !filename.empty()) {
+            // every chunk on disk has to match the original file byte for byte.
+            viscom::PointCloudFile original(filename);
+            for (std::uint32_t n = 0; n < file->GetNumNodes(); ++n) {
+                if (!replica.IsAvailable(n) || file->GetNodeDataSize(n) == 0) continue;
+                if (std::memcmp(file->GetNodeData(n), original.GetNodeData(n), file->GetNodeDataSize(n)) != 0) ++report.numMismatchedChunks_;
+            }
+        }
+        connection.Send(DISTRIBUTION_REPORT_PACKAGE_ID, &report, sizeof(DistributionReport));
+        return report.complete_ != 0 ? 0 : 1;
+    }
+
+    /**
+     *  Measures the distribution of a point cloud from the master to simulated slaves. The slaves are separate
+     *  processes connected over the loopback interface instead of the cluster network, each with its own chunk
+     *  cache. The master sends chunks every frame up to the byte budget. The first run starts with empty caches,
+     *  the second one with the caches filled by the first run, as after a restart of the slaves.
+     */
+    int RunDistributionBenchmark(int argc, char** argv, const char* executable)
+    {
+        std::string filename, cacheDirectory = "chunk_cache_bench";
+        auto numSlaves = 4, frameRate = 60, maxFrames = 3000, numRuns = 2;
+        std::uint64_t budget = 8ULL << 20;
+        for (auto i = 0; i < argc; ++i) {
+            auto hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--file") == 0 && hasValue) filename = argv[++i];
+            else if (std::strcmp(argv[i], "--slaves") == 0 && hasValue) numSlaves = std::max(1, std::atoi(argv[++i]));
+            else if (std::strcmp(argv[i], "--budget") == 0 && hasValue) budget = static_cast<std::uint64_t>(std::max(1.0, std::atof(argv[++i]) * (1 << 20)));
+            else if (std::strcmp(argv[i], "--rate") == 0 && hasValue) frameRate = std::max(1, std::atoi(argv[++i]));
+            else if (std::strcmp(argv[i], "--frames") == 0 && hasValue) maxFrames = std::max(1, std::atoi(argv[++i]));
+            else if (std::strcmp(argv[i], "--cache") == 0 && hasValue) cacheDirectory = argv[++i];
+            else if (std::strcmp(argv[i], "--runs") == 0 && hasValue) numRuns = std::max(1, std::atoi(argv[++i]));
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+        if (filename.empty()) {
+            PrintUsage();
+            return 1;
+        }
+
+        using Clock = std::chrono::steady_clock;
+        viscom::PointCloudFile file(filename);
+        if (!CheckRepeatedManifest(file, cacheDirectory + "_manifest")) return 1;
+        std::cout << file.GetNumNodes() << " nodes, " << file.GetHeader().numPoints_ << " points, " << numSlaves << " slaves, "
+            << static_cast<double>(budget) / (1 << 20) << " MB per frame at " << frameRate << " Hz." << std::endl;
+        auto result = 0;
+        for (auto run = 0; run < numRuns; ++run) {
+            viscom::ChunkServer server(file);
+            if (run == 0) {
+                for (auto s = 0; s < numSlaves; ++s) {
+                    auto cacheName = GetChunkCacheName(cacheDirectory + std::to_string(s), server.GetDatasetId());
+                    std::remove((cacheName + ".vpc").c_str());
+                    std::remove((cacheName + ".chunks").c_str());
+                }
+            }
+
+            viscom::LoopbackListener listener;
+            std::vector<std::thread> processes;
+            for (auto s = 0; s < numSlaves; ++s) {
+                std::ostringstream command;
+                command << "\"" << executable << "\" distribute-slave --file \"" << filename << "\" --cache \"" << cacheDirectory << s << "\" --port "
+                    << listener.GetPort() << " --index " << s << " --slaves " << numSlaves << " --frames " << maxFrames << " --rate " << frameRate;
+                processes.emplace_back([command = command.str()]() { std::system(command.c_str()); });
+            }
+            // the order of the connections does not matter, each slave reports its index.
+            std::vector<viscom::LoopbackConnection> connections;
+            for (auto s = 0; s < numSlaves; ++s) connections.push_back(listener.Accept(10000));
+
+            std::vector<DistributionReport> reports;
+            std::vector<std::uint8_t> message;
+            auto start = Clock::now();
+            auto frameLength = std::chrono::microseconds(1000000 / frameRate);
+            auto nextFrame = start;
+            auto finishTime = 0.0;
+            while (reports.size() < static_cast<std::size_t>(numSlaves)) {
+                auto numOpen = 0;
+                for (std::size_t c = 0; c < connections.size(); ++c) {
+                    std::uint16_t packageID;
+                    while (connections[c].Receive(packageID, message)) {
+                        if (packageID == viscom::CHUNK_REQUEST_PACKAGE_ID) server.Receive(static_cast<int>(c), message.data(), message.size());
+                        else if (packageID == DISTRIBUTION_REPORT_PACKAGE_ID && message.size() == sizeof(DistributionReport)) {
+                            reports.emplace_back();
+                            std::memcpy(&reports.back(), message.data(), sizeof(DistributionReport));
+                            finishTime = std::chrono::duration<double>(Clock::now() - start).count();
+                        }
+                    }
+                    if (connections[c].IsOpen()) ++numOpen;
+                }
+                if (numOpen == 0) break;
+
+                server.Send(budget, [&connections](int clientID, const std::vector<std::uint8_t>& data) {
+                    if (connections[clientID].IsOpen()) connections[clientID].Send(viscom::CHUNK_DATA_PACKAGE_ID, data.data(), data.size());
+                });
+                nextFrame += frameLength;
+                std::this_thread::sleep_until(nextFrame);
+            }
+            for (auto& process : processes) process.join();
+
+            std::sort(reports.begin(), reports.end(), [](const DistributionReport& a, const DistributionReport& b) { return a.index_ < b.index_; });
+            std::cout << std::endl << "Run " << (run + 1) << (run == 0 ? " (empty caches):" : " (filled caches):") << std::endl;
+            std::cout << std::setw(8) << "slave" << std::setw(14) << "first [ms]" << std::setw(14) << "view [ms]" << std::setw(12) << "MB" << std::setw(12) << "MB/s"
+                << std::setw(10) << "chunks" << std::setw(10) << "cached" << std::setw(10) << "nodes" << std::endl;
+            std::uint64_t totalBytes = 0;
+            auto maxFirstPoints = 0.0, maxComplete = 0.0;
+            for (const auto& report : reports) {
+                totalBytes += report.receivedBytes_;
+                maxFirstPoints = std::max(maxFirstPoints, report.firstPointsTime_);
+                maxComplete = std::max(maxComplete, report.completeTime_);
+                auto megabytes = static_cast<double>(report.receivedBytes_) / (1 << 20);
+                std::cout << std::fixed << std::setprecision(1) << std::setw(8) << report.index_ << std::setw(14) << 1000.0 * report.firstPointsTime_
+                    << std::setw(14) << 1000.0 * report.completeTime_ << std::setw(12) << std::setprecision(2) << megabytes << std::setw(12)
+                    << (report.completeTime_ > 0.0 ? megabytes / report.completeTime_ : 0.0) << std::setw(10) << report.numReceivedChunks_
+                    << std::setw(10) << report.numCachedChunks_ << std::setw(10) << report.numSelectedNodes_ << std::endl;
+                if (report.complete_ == 0) {
+                    std::cerr << "Error: slave " << report.index_ << " did not receive its view within " << maxFrames << " frames." << std::endl;
+                    result = 1;
+                }
+                if (report.numMismatchedChunks_ != 0) {
+                    std::cerr << "Error: " << report.numMismatchedChunks_ << " chunks of slave " << report.index_ << " differ from the file." << std::endl;
+                    result = 1;
+                }
+            }
+            if (reports.size() != static_cast<std::size_t>(numSlaves)) {
+                std::cerr << "Error: only " << reports.size() << " of " << numSlaves << " slaves reported." << std::endl;
+                result = 1;
+            }
+
+            auto statistics = server.GetStatistics();
+            std::cout << "Master: " << std::setprecision(2) << static_cast<double>(statistics.sentBytes_) / (1 << 20) << " MB sent in " << finishTime << " s ("
+                << (finishTime > 0.0 ? static_cast<double>(statistics.sentBytes_) / (1 << 20) / finishTime : 0.0) << " MB/s), slowest slave: first points after "
+                << std::setprecision(1) << 1000.0 * maxFirstPoints << " ms, whole view after " << 1000.0 * maxComplete << " ms." << std::endl;
+            std::cout << "Chunks read " << statistics.numReadChunks_ << " times for " << statistics.numSentChunks_ << " deliveries, "
+                << statistics.numSentManifests_ << " manifests; received " << static_cast<double>(totalBytes) / (1 << 20) << " MB in total." << std::endl;
+        }
+        return result;
+    }
+
+    /**
+     *  Simulates a cluster adapting its shared point budget: each node needs a fixed time plus a time per point, the
+     *  slowest node counts and the measurements arrive a few frames late. Halfway through the scene gets twice as
+     *  expensive. Checks that the budget settles within the band of the controller and stops changing.
+     */
+    int RunBudgetBenchmark(int argc, char** argv)
+    {
+        auto targetRate = 60.0f;
+        std::vector<float> pointTimes{ 1.5f, 2.0f, 3.0f };
+        auto numFrames = 3000;
+        auto noise = 0.05f;
+        for (auto i = 0; i < argc; ++i) {
+            auto hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--rate") == 0 && hasValue) targetRate = std::max(1.0f, static_cast<float>(std::atof(argv[++i])));
+            else if (std::strcmp(argv[i], "--nodes") == 0 && hasValue) {
+                pointTimes.clear();
+                std::istringstream list(argv[++i]);
+                for (std::string time; std::getline(list, time, ',');) pointTimes.push_back(std::max(0.01f, static_cast<float>(std::atof(time.c_str()))));
+            }
+            else if (std::strcmp(argv[i], "--frames") == 0 && hasValue) numFrames = std::max(100, std::atoi(argv[++i]));
+            else if (std::strcmp(argv[i], "--noise") == 0 && hasValue) noise = std::max(0.0f, static_cast<float>(std::atof(argv[++i])));
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+        if (pointTimes.empty()) {
+            PrintUsage();
+            return 1;
+        }
+
+        constexpr auto fixedTime = 2.0f;
+        constexpr auto measurementLag = 4;
+        viscom::PointBudgetController controller(viscom::LODTraversalParameters{}.pointBudget_);
+        controller.GetParameters().targetFrameTime_ = 1000.0f / targetRate;
+        const auto& parameters = controller.GetParameters();
+
+        std::mt19937 random(42);
+        std::normal_distribution<float> noiseDistribution(1.0f, noise);
+        std::deque<float> measurements;
+        std::cout << std::setw(8) << "frame" << std::setw(14) << "budget [k]" << std::setw(14) << "frame [ms]" << std::setw(10) << "load" << std::endl;
+
+        auto result = 0;
+        for (auto phase = 0; phase < 2; ++phase) {
+            auto sceneFactor = phase == 0 ? 1.0f : 2.0f;
+            auto changesBeforeSettling = controller.GetNumChanges();
+            auto phaseFrames = numFrames / 2;
+            auto loadSum = 0.0f;
+            auto maxLoad = 0.0f;
+            for (auto frame = 0; frame < phaseFrames; ++frame) {
+                auto frameTime = 0.0f;
+                for (auto pointTime : pointTimes) {
+                    auto nodeTime = fixedTime + pointTime * sceneFactor * static_cast<float>(controller.GetBudget()) / 1000000.0f;
+                    frameTime = std::max(frameTime, nodeTime * std::max(0.0f, noiseDistribution(random)));
+                }
+                measurements.push_back(frameTime);
+                if (measurements.size() > measurementLag) {
+                    controller.Update(measurements.front());
+                    measurements.pop_front();
+                }
+
+                if (frame == phaseFrames / 2) changesBeforeSettling = controller.GetNumChanges();
+                if (frame >= phaseFrames / 2) {
+                    auto load = frameTime / parameters.targetFrameTime_;
+                    loadSum += load;
+                    maxLoad = std::max(maxLoad, load);
+                }
+                if (frame % (phaseFrames / 10) == 0) {
+                    std::cout << std::fixed << std::setprecision(2) << std::setw(8) << phase * phaseFrames + frame << std::setw(14) << controller.GetBudget() / 1000
+                        << std::setw(14) << frameTime << std::setw(10) << frameTime / parameters.targetFrameTime_ << std::endl;
+                }
+            }
+
+            auto settledFrames = static_cast<float>(phaseFrames - phaseFrames / 2);
+            auto averageLoad = loadSum / settledFrames;
+            auto numLateChanges = controller.GetNumChanges() - changesBeforeSettling;
+            std::cout << "Scene x" << sceneFactor << ": budget " << controller.GetBudget() << ", average load " << averageLoad << " (max " << maxLoad << "), "
+                << numLateChanges << " changes in the second half." << std::endl;
+            if (averageLoad > parameters.upperLoad_ || averageLoad < parameters.lowerLoad_ - noise) {
+                std::cerr << "Error: the average load did not settle between " << parameters.lowerLoad_ << " and " << parameters.upperLoad_ << "." << std::endl;
+                result = 1;
+            }
+            if (numLateChanges > 2) {
+                std::cerr << "Error: the budget kept changing after settling (" << numLateChanges << " changes)." << std::endl;
+                result = 1;
+            }
+        }
+        return result;
+    }
+
+    /** Loads nodes with the loader and waits until all are in memory, returns the time in milliseconds. */
+    double LoadNodes(viscom::NodeLoader& loader, const std::vector<std::uint32_t>& nodes, std::uint32_t columns)
+    {
+        using Clock = std::chrono::high_resolution_clock;
+        std::vector<viscom::NodeLoadRequest> requests;
+        for (auto nodeIndex : nodes) requests.push_back(viscom::NodeLoadRequest{ 0.0f, nodeIndex, columns });
+
+        auto start = Clock::now();
+        loader.Request(requests);
+        for (auto nodeIndex : nodes) {
+            while (loader.GetState(nodeIndex) != viscom::NodeLoader::State::Ready) std::this_thread::yield();
+        }
+        auto time = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        for (auto nodeIndex : nodes) loader.Release(nodeIndex);
+        return time;
+    }
+
+    /**
+     *  Loads the selection of a view of a columnar file for each color mode, first positions and the shown column
+     *  like a node that is not on the GPU, then the column alone like a resident node after switching the color
+     *  mode. The bytes read are compared to whole chunks and to interleaving the same attributes.
+     */
+    int RunColumnsBenchmark(int argc, char** argv)
+    {
+        std::string filename;
+        unsigned numThreads = 2;
+        viscom::LODTraversalParameters lodParameters;
+        for (auto i = 0; i < argc; ++i) {
+            auto hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--file") == 0 && hasValue) filename = argv[++i];
+            else if (std::strcmp(argv[i], "--point-budget") == 0 && hasValue) lodParameters.pointBudget_ = std::strtoull(argv[++i], nullptr, 10);
+            else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) numThreads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+        if (filename.empty()) {
+            PrintUsage();
+            return 1;
+        }
+
+        viscom::PointCloudFile file(filename);
+        if (!file.IsColumnar()) throw std::runtime_error("\"" + filename + "\" is not a columnar point cloud file (convert it with --layout columnar).");
+        const auto& header = file.GetHeader();
+        auto center = 0.5f * (header.boundsMin_ + header.boundsMax_);
+        auto radius = 0.5f * glm::length(header.boundsMax_ - header.boundsMin_);
+        auto eye = center + glm::vec3(0.6f, 0.4f, 1.0f) * (1.5f * radius);
+        auto viewProjection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.01f * radius, 4.0f * radius) * glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+
+        viscom::LODTraversal traversal;
+        auto nodes = traversal.Traverse(file.GetNodes(), viewProjection, 1080.0f, lodParameters);
+        std::uint64_t chunkBytes = 0;
+        for (auto nodeIndex : nodes) chunkBytes += file.GetNodeDataSize(nodeIndex);
+        auto numPoints = traversal.GetStatistics().numSelectedPoints_;
+        auto interleavedBytes = numPoints * file.GetPointStride();
+
+        viscom::NodeLoader loader(file, numThreads);
+        auto chunkTime = LoadNodes(loader, nodes, 0);
+        std::cout << nodes.size() << " nodes, " << numPoints << " points, " << file.GetPointStride() << " bytes per point in "
+            << std::bitset<viscom::POINTCLOUD_NUM_ATTRIBUTES>(file.GetAttributes()).count() << " columns." << std::endl;
+        std::cout << std::fixed << std::setprecision(1) << "Whole chunks: " << static_cast<double>(chunkBytes) / (1 << 20) << " MB in " << chunkTime
+            << " ms, interleaved: " << static_cast<double>(interleavedBytes) / (1 << 20) << " MB." << std::endl;
+        std::cout << std::setw(16) << "color mode" << std::setw(12) << "load [MB]" << std::setw(10) << "[ms]" << std::setw(10) << "saved"
+            << std::setw(14) << "switch [MB]" << std::setw(10) << "[ms]" << std::setw(10) << "saved" << std::endl;
+
+        const char* modeNames[] = { "RGB", "Intensity", "Classification", "Return Number", "GPS Time" };
+        const viscom::PointAttribute modeAttributes[] = { viscom::PointAttribute::Color, viscom::PointAttribute::Intensity, viscom::PointAttribute::Classification,
+            viscom::PointAttribute::ReturnNumber, viscom::PointAttribute::GPSTime };
+        auto result = 0;
+        for (auto m = 0; m < 5; ++m) {
+            if (!file.HasAttribute(modeAttributes[m])) continue;
+            auto attributeBit = viscom::GetAttributeBit(modeAttributes[m]);
+            auto loadColumns = viscom::GetAttributeBit(viscom::PointAttribute::Position) | attributeBit;
+
+            auto loadedBytes = loader.GetNumLoadedBytes();
+            auto loadTime = LoadNodes(loader, nodes, loadColumns);
+            auto loadBytes = loader.GetNumLoadedBytes() - loadedBytes;
+            loadedBytes = loader.GetNumLoadedBytes();
+            auto switchTime = LoadNodes(loader, nodes, attributeBit);
+            auto switchBytes = loader.GetNumLoadedBytes() - loadedBytes;
+
+            // a switch of an interleaved file reloads all attributes.
+            std::cout << std::setw(16) << modeNames[m] << std::setw(12) << static_cast<double>(loadBytes) / (1 << 20) << std::setw(10) << loadTime
+                << std::setw(9) << 100.0 * (1.0 - static_cast<double>(loadBytes) / static_cast<double>(interleavedBytes)) << "%"
+                << std::setw(14) << static_cast<double>(switchBytes) / (1 << 20) << std::setw(10) << switchTime
+                << std::setw(9) << 100.0 * (1.0 - static_cast<double>(switchBytes) / static_cast<double>(interleavedBytes)) << "%" << std::endl;
+
+            auto expectedBytes = numPoints * viscom::GetColumnarStride(loadColumns);
+            auto expectedSwitchBytes = numPoints * viscom::GetPointAttributeSize(modeAttributes[m]);
+            if (loadBytes != expectedBytes || switchBytes != expectedSwitchBytes) {
+                std::cerr << "Error: the loader read " << loadBytes << " and " << switchBytes << " bytes instead of " << expectedBytes << " and "
+                    << expectedSwitchBytes << " for " << modeNames[m] << "." << std::endl;
+                result = 1;
+            }
+        }
+        std::cout << "Times are measured with the pages of earlier passes cached, bytes are the bytes read by the loader." << std::endl;
+        return result;
+    }
+
+    /**
+     *  Creates the points of static terrestrial scanners 2m above a terrain, sorted by their morton codes like the
+     *  input of the octree builder. The density falls with the square of the distance to the nearest scanner.
+     */
+    std::vector<viscom::PointCloudPoint> CreateScannerPoints(std::size_t numPoints)
+    {
+        const glm::vec2 scanners[] = { glm::vec2(20.0f, 20.0f), glm::vec2(75.0f, 30.0f), glm::vec2(40.0f, 80.0f), glm::vec2(85.0f, 85.0f) };
+        auto terrain = [](float x, float y) { return 3.0f * std::sin(0.1f * x) * std::cos(0.07f * y) + 0.5f * std::sin(0.9f * x + 0.4f * y); };
+        std::mt19937 rng{ 42 };
+        std::uniform_real_distribution<float> uniform{ 0.0f, 1.0f };
+        std::vector<viscom::PointCloudPoint> points;
+        points.reserve(numPoints);
+        while (points.size() < numPoints) {
+            const auto& scanner = scanners[points.size() % 4];
+            auto azimuth = 6.2831853f * uniform(rng);
+            // uniform elevation between 80 and 1 degrees below the horizon, the ground distance is 2m / tan(elevation).
+            auto elevation = glm::radians(1.0f + 79.0f * uniform(rng));
+            auto distance = 2.0f / std::tan(elevation);
+            glm::vec2 ground = scanner + distance * glm::vec2(std::cos(azimuth), std::sin(azimuth));
+            if (ground.x < 0.0f || ground.y < 0.0f || ground.x > 100.0f || ground.y > 100.0f) continue;
+
+            viscom::PointCloudPoint point;
+            point.position_ = glm::vec3(ground.x, ground.y, terrain(ground.x, ground.y));
+            point.color_ = glm::u8vec4(static_cast<std::uint8_t>(2.55f * ground.x), static_cast<std::uint8_t>(2.55f * ground.y), 128, 255);
+            points.push_back(point);
+        }
+
+        glm::vec3 boundsMin{ std::numeric_limits<float>::max() }, boundsMax{ std::numeric_limits<float>::lowest() };
+        for (const auto& point : points) {
+            boundsMin = glm::min(boundsMin, point.position_);
+            boundsMax = glm::max(boundsMax, point.position_);
+        }
+        viscom::MortonGrid grid{ boundsMin, boundsMax };
+        std::vector<std::pair<std::uint64_t, std::size_t>> codes(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) codes[i] = std::make_pair(grid.Encode(points[i].position_), i);
+        std::sort(codes.begin(), codes.end());
+        std::vector<viscom::PointCloudPoint> sortedPoints(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) sortedPoints[i] = points[codes[i].second];
+        return sortedPoints;
+    }
+
+    /**
+     *  Returns the fraction of the scanned surface within the ideal sample spacing of a sample. The surface is
+     *  approximated by the occupied cells of a 512^3 grid, each counted once regardless of its number of points, and
+     *  the ideal spacing is the one of the maximum number of samples spread evenly over its area.
+     */
+    double ComputeCoverage(const std::vector<viscom::PointCloudPoint>& points, const std::vector<std::uint8_t>& selected,
+        const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::size_t maxSamples)
+    {
+        auto cellKey = [](const glm::ivec3& cell) { return static_cast<std::uint64_t>(cell.x) | (static_cast<std::uint64_t>(cell.y) << 21) | (static_cast<std::uint64_t>(cell.z) << 42); };
+        auto getCell = [&boundsMin](const glm::vec3& position, float cellSize) { return glm::ivec3(glm::floor((position - boundsMin) / cellSize)) + 1; };
+
+        auto extent = boundsMax - boundsMin;
+        auto fineSize = glm::max(glm::max(extent.x, extent.y), extent.z) / 512.0f;
+        std::unordered_map<std::uint64_t, std::size_t> surfaceCells;
+        for (std::size_t i = 0; i < points.size(); ++i) surfaceCells.emplace(cellKey(getCell(points[i].position_, fineSize)), i);
+        auto spacing = std::sqrt(static_cast<float>(surfaceCells.size()) * fineSize * fineSize / static_cast<float>(maxSamples));
+
+        std::unordered_map<std::uint64_t, std::vector<glm::vec3>> sampleCells;
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            if (selected[i] != 0) sampleCells[cellKey(getCell(points[i].position_, spacing))].push_back(points[i].position_);
+        }
+
+        std::size_t numCovered = 0;
+        for (const auto& surfaceCell : surfaceCells) {
+            const auto& position = points[surfaceCell.second].position_;
+            auto cell = getCell(position, spacing);
+            auto covered = false;
+            for (auto z = -1; z <= 1 && !covered; ++z) {
+                for (auto y = -1; y <= 1 && !covered; ++y) {
+                    for (auto x = -1; x <= 1 && !covered; ++x) {
+                        auto samples = sampleCells.find(cellKey(cell + glm::ivec3(x, y, z)));
+                        if (samples == sampleCells.end()) continue;
+                        for (const auto& sample : samples->second) covered = covered || glm::dot(sample - position, sample - position) <= spacing * spacing;
+                    }
+                }
+            }
+            if (covered) ++numCovered;
+        }
+        return static_cast<double>(numCovered) / static_cast<double>(surfaceCells.size());
+    }
+
+    /**
+     *  Measures the throughput of the subsampling methods used for the inner octree nodes by thread count and the
+     *  coverage they reach per point drawn on a synthetic scan with strongly varying density. The coverage is the
+     *  fraction of the surface with a sample within the spacing an even distribution of the maximum number of samples
+     *  would have, a method reaching the same coverage with fewer samples gives a better image per point of budget.
+     */
+    int RunSubsampleBenchmark(int argc, char** argv)
+    {
+        std::size_t numPoints = 4000000, maxSamples = 65536;
+        std::vector<unsigned> threadCounts{ 1, 2, 4, 8 };
+        auto iterations = 5;
+        for (auto i = 0; i < argc; ++i) {
+            auto hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--points") == 0 && hasValue) numPoints = static_cast<std::size_t>(std::max(1LL, std::atoll(argv[++i])));
+            else if (std::strcmp(argv[i], "--samples") == 0 && hasValue) maxSamples = static_cast<std::size_t>(std::max(1LL, std::atoll(argv[++i])));
+            else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+                threadCounts.clear();
+                std::istringstream list(argv[++i]);
+                for (std::string count; std::getline(list, count, ',');) threadCounts.push_back(static_cast<unsigned>(std::max(1, std::atoi(count.c_str()))));
+            }
+            else if (std::strcmp(argv[i], "--iterations") == 0 && hasValue) iterations = std::max(1, std::atoi(argv[++i]));
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+        if (threadCounts.empty()) {
+            PrintUsage();
+            return 1;
+        }
+
+        std::cout << "Generating " << numPoints << " scanner points..." << std::endl;
+        auto points = CreateScannerPoints(numPoints);
+        glm::vec3 boundsMin{ std::numeric_limits<float>::max() }, boundsMax{ std::numeric_limits<float>::lowest() };
+        for (const auto& point : points) {
+            boundsMin = glm::min(boundsMin, point.position_);
+            boundsMax = glm::max(boundsMax, point.position_);
+        }
+        std::vector<std::uint64_t> indices(points.size());
+        for (std::size_t i = 0; i < indices.size(); ++i) indices[i] = i;
+
+        std::cout << std::setw(10) << "method" << std::setw(9) << "threads" << std::setw(10) << "[ms]" << std::setw(16) << "points/s" << std::setw(10) << "speedup"
+            << std::setw(10) << "samples" << std::setw(8) << "passes" << std::setw(11) << "coverage" << std::setw(16) << "per 1k samples" << std::endl;
+        const char* methodNames[] = { "stride", "voxel", "poisson" };
+        const viscom::SubsamplingMethod methods[] = { viscom::SubsamplingMethod::Stride, viscom::SubsamplingMethod::VoxelGrid, viscom::SubsamplingMethod::PoissonDisk };
+        for (auto m = 0; m < 3; ++m) {
+            viscom::Subsampler subsampler{ methods[m] };
+            auto baseTime = 0.0;
+            for (auto numThreads : threadCounts) {
+                // the first run allocates the scratch memory of the subsampler.
+                subsampler.Sample(points.data(), indices.data(), indices.size(), boundsMin, boundsMax, maxSamples, numThreads);
+                auto start = std::chrono::steady_clock::now();
+                for (auto i = 0; i < iterations; ++i) subsampler.Sample(points.data(), indices.data(), indices.size(), boundsMin, boundsMax, maxSamples, numThreads);
+                auto time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+                if (baseTime == 0.0) baseTime = time;
+
+                const auto& selected = subsampler.Sample(points.data(), indices.data(), indices.size(), boundsMin, boundsMax, maxSamples, numThreads);
+                auto coverage = ComputeCoverage(points, selected, boundsMin, boundsMax, maxSamples);
+                std::cout << std::setw(10) << methodNames[m] << std::setw(9) << numThreads << std::fixed << std::setprecision(2) << std::setw(10) << time
+                    << std::setprecision(0) << std::setw(16) << static_cast<double>(points.size()) / (time / 1000.0)
+                    << std::setprecision(2) << std::setw(10) << baseTime / time << std::setw(10) << subsampler.GetNumSamples() << std::setw(8) << subsampler.GetNumPasses()
+                    << std::setprecision(1) << std::setw(10) << 100.0 * coverage << "%"
+                    << std::setprecision(3) << std::setw(15) << 100.0 * coverage / (static_cast<double>(subsampler.GetNumSamples()) / 1000.0) << "%" << std::endl;
+            }
+        }
+        std::cout << "Coverage is the fraction of the scanned surface within the spacing of " << maxSamples << " evenly spread samples of a sample." << std::endl;
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try {
+        if (argc >= 2 && std::strcmp(argv[1], "culling") == 0) return RunCullingBenchmark(argc - 2, argv + 2);
+        if (argc >= 2 && std::strcmp(argv[1], "raster") == 0) return RunRasterBenchmark(argc - 2, argv + 2);
+        if (argc >= 2 && std::strcmp(argv[1], "budget") == 0) return RunBudgetBenchmark(argc - 2, argv + 2);
+        if (argc >= 2 && std::strcmp(argv[1], "occlusion") == 0) return RunOcclusionBenchmark(argc - 2, argv + 2);
+        if (argc >= 2 && std::strcmp(argv[1], "query") == 0) return RunQueryBenchmark(argc - 2, argv + 2);
+        if (argc >= 2 && std::strcmp(argv[1], "ingest") == 0) return RunIngestBenchmark(argc - 2, argv + 2);
+        if (argc >= 2 && std::strcmp(argv[1], "distribute") == 0) return RunDistributionBenchmark(argc - 2, argv + 2, argv[0]);
+        if (argc >= 2 && std::strcmp(argv[1], "distribute-slave") == 0) return RunDistributionSlave(argc - 2, argv + 2);
+        if (argc >= 2 && std::strcmp(argv[1], "columns") == 0) return RunColumnsBenchmark(argc - 2, argv + 2);
+        if (argc >= 2 && std::strcmp(argv[1], "subsample") == 0) return RunSubsampleBenchmark(argc - 2, argv + 2);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    PrintUsage();
+    return 1;
+}
@@ -0,0 +1,343 @@
+/**
+ * @file   PointCloudConverter.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the conversion of raw scans to point cloud files.
+ */
+
+#include "PointCloudConverter.h"
+#include "PointReaders.h"
+#include "app/pointcloud/MemoryMappedFile.h"
+#include "app/pointcloud/Parallel.h"
+#include "app/pointcloud/PointCloudWriter.h"
+#include "app/pointcloud/RadixSort.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+
+namespace viscom {
+
+    namespace {
+
+        /** Memory needed per point while sorting a run (input, converted, keys, scratch, sorted codes and points, converted and sorted scan attributes). */
+        constexpr std::uint64_t SORT_BYTES_PER_POINT = sizeof(InputPoint) + sizeof(PointCloudPoint) + 2 * sizeof(MortonKey) + sizeof(std::uint64_t) + sizeof(PointCloudPoint)
+            + 2 * sizeof(PointCloudAttributes);
+        /** Number of elements buffered per run while merging. */
+        constexpr std::size_t MERGE_BUFFER_SIZE = 1 << 16;
+
+        double SecondsSince(std::chrono::high_resolution_clock::time_point start)
+        {
+            return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+
+        template<typename T> void WriteArray(const std::string& filename, const T* data, std::size_t count)
+        {
+            std::ofstream file{ filename, std::ios::binary | std::ios::trunc };
+            file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+            if (!file) throw std::runtime_error("Could not write temporary file \"" + filename + "\".");
+        }
+
+        /** Reads a sorted run in blocks while merging. */
+        struct RunCursor
+        {
+            std::ifstream codesFile_;
+            std::ifstream pointsFile_;
+            std::ifstream attributesFile_;
+            std::vector<std::uint64_t> codes_;
+            std::vector<PointCloudPoint> points_;
+            std::vector<PointCloudAttributes> attributes_;
+            std::size_t position_ = 0;
+
+            RunCursor(const std::string& codesFile, const std::string& pointsFile, const std::string& attributesFile) :
+                codesFile_{ codesFile, std::ios::binary },
+                pointsFile_{ pointsFile, std::ios::binary }
+            {
+                if (!attributesFile.empty()) attributesFile_.open(attributesFile, std::ios::binary);
+                if (!codesFile_ || !pointsFile_ || (!attributesFile.empty() && !attributesFile_))
+                    throw std::runtime_error("Could not open temporary file \"" + codesFile + "\".");
+                Refill();
+            }
+
+            bool Refill()
+            {
+                codes_.resize(MERGE_BUFFER_SIZE);
+                points_.resize(MERGE_BUFFER_SIZE);
+                codesFile_.read(reinterpret_cast<char*>(codes_.data()), MERGE_BUFFER_SIZE * sizeof(std::uint64_t));
+                pointsFile_.read(reinterpret_cast<char*>(points_.data()), MERGE_BUFFER_SIZE * sizeof(PointCloudPoint));
+                auto count = static_cast<std::size_t>(codesFile_.gcount()) / sizeof(std::uint64_t);
+                codes_.resize(count);
+                points_.resize(count);
+                if (attributesFile_.is_open()) {
+                    attributes_.resize(count);
+                    attributesFile_.read(reinterpret_cast<char*>(attributes_.data()), static_cast<std::streamsize>(count * sizeof(PointCloudAttributes)));
+                }
+                position_ = 0;
+                return count != 0;
+            }
+        };
+    }
+
+    /**
+     *  Constructor.
+     *  @param options the conversion options.
+     */
+    PointCloudConverter::PointCloudConverter(const ConverterOptions& options) :
+        options_{ options }
+    {
+    }
+
+    /**
+     *  Converts a scan to a point cloud file.
+     *  @param reader the reader for the scan.
+     *  @param outputFile the name of the point cloud file.
+     */
+    void PointCloudConverter::Convert(PointReader& reader, const std::string& outputFile)
+    {
+        timings_ = ConverterTimings();
+        auto tempPrefix = options_.tempPrefix_.empty() ? outputFile : options_.tempPrefix_;
+        attributes_ = options_.layout_ == PointLayout::Columnar ? reader.GetAttributes() | POINTCLOUD_POSITION_COLOR : POINTCLOUD_POSITION_COLOR;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        ComputeBounds(reader);
+        timings_.bounds_ = SecondsSince(start);
+        if (numPoints_ == 0) throw std::runtime_error("The input does not contain any points.");
+
+        start = std::chrono::high_resolution_clock::now();
+        auto runFiles = CreateSortedRuns(reader, tempPrefix);
+        timings_.sort_ = SecondsSince(start);
+        if (runFiles.empty()) throw std::runtime_error("The input does not contain any points.");
+
+        start = std::chrono::high_resolution_clock::now();
+        std::string codesFile = runFiles[0] + ".codes";
+        std::string pointsFile = runFiles[0] + ".points";
+        std::string attributesFile = HasScanAttributes() ? runFiles[0] + ".attributes" : std::string();
+        if (runFiles.size() > 1) {
+            codesFile = tempPrefix + ".sorted.codes";
+            pointsFile = tempPrefix + ".sorted.points";
+            if (HasScanAttributes()) attributesFile = tempPrefix + ".sorted.attributes";
+            MergeRuns(runFiles, codesFile, pointsFile, attributesFile);
+            for (const auto& runFile : runFiles) {
+                std::remove((runFile + ".codes").c_str());
+                std::remove((runFile + ".points").c_str());
+                if (HasScanAttributes()) std::remove((runFile + ".attributes").c_str());
+            }
+        }
+        timings_.merge_ = SecondsSince(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        {
+            // the sorted points are mapped, the operating system pages them as the octree is built.
+            MemoryMappedFile codes{ codesFile };
+            MemoryMappedFile points{ pointsFile };
+            std::unique_ptr<MemoryMappedFile> attributes;
+            if (HasScanAttributes()) attributes = std::make_unique<MemoryMappedFile>(attributesFile);
+            BuildOctree(reinterpret_cast<const PointCloudPoint*>(points.GetData()),
+                attributes ? reinterpret_cast<const PointCloudAttributes*>(attributes->GetData()) : nullptr,
+                reinterpret_cast<const std::uint64_t*>(codes.GetData()), glm::vec3(0.0f), glm::vec3(sourceMax_ - sourceMin_), sourceMin_, outputFile);
+        }
+        timings_.build_ = SecondsSince(start);
+
+        std::remove(codesFile.c_str());
+        std::remove(pointsFile.c_str());
+        if (HasScanAttributes()) std::remove(attributesFile.c_str());
+    }
+
+    /**
+     *  Builds a point cloud file from points in memory.
+     *  @param points the points.
+     *  @param boundsMin the minimum of the bounding box of the points.
+     *  @param boundsMax the maximum of the bounding box of the points.
+     *  @param outputFile the name of the point cloud file.
+     *  @param attributes the scan attributes of the points (GPS times relative to 0), stored in columnar files (may be empty).
+     */
+    void PointCloudConverter::BuildInMemory(const std::vector<PointCloudPoint>& points, const glm::vec3& boundsMin, const glm::vec3& boundsMax, const std::string& outputFile,
+        const std::vector<PointCloudAttributes>& attributes)
+    {
+        timings_ = ConverterTimings();
+        numPoints_ = points.size();
+        grid_ = MortonGrid(boundsMin, boundsMax);
+        attributes_ = options_.layout_ == PointLayout::Columnar && !attributes.empty() ? POINTCLOUD_ALL_ATTRIBUTES : POINTCLOUD_POSITION_COLOR;
+        gpsTimeOrigin_ = 0.0;
+        if (HasScanAttributes() && attributes.size() != points.size()) throw std::runtime_error("The number of attributes and points differ.");
+
+        std::vector<std::uint64_t> sortedCodes;
+        std::vector<PointCloudPoint> sortedPoints;
+        std::vector<PointCloudAttributes> sortedAttributes;
+        auto start = std::chrono::high_resolution_clock::now();
+        SortByMortonCode(points.data(), points.size(), grid_, options_.build_.numThreads_, sortedCodes, sortedPoints,
+            HasScanAttributes() ? attributes.data() : nullptr, &sortedAttributes);
+        timings_.sort_ = SecondsSince(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        BuildOctree(sortedPoints.data(), HasScanAttributes() ? sortedAttributes.data() : nullptr, sortedCodes.data(), boundsMin, boundsMax, glm::dvec3(0.0), outputFile);
+        timings_.build_ = SecondsSince(start);
+    }
+
+    /**
+     *  Computes the morton codes of points and sorts the points by them.
+     *  @param points the points.
+     *  @param numPoints the number of points.
+     *  @param grid the grid for computing the morton codes.
+     *  @param numThreads the number of threads to use.
+     *  @param sortedCodes the sorted codes.
+     *  @param sortedPoints the sorted points.
+     *  @param attributes the scan attributes of the points, sorted with them (may be nullptr).
+     *  @param sortedAttributes the sorted scan attributes (only used with attributes).
+     */
+    void PointCloudConverter::SortByMortonCode(const PointCloudPoint* points, std::size_t numPoints, const MortonGrid& grid, unsigned numThreads,
+        std::vector<std::uint64_t>& sortedCodes, std::vector<PointCloudPoint>& sortedPoints, const PointCloudAttributes* attributes,
+        std::vector<PointCloudAttributes>* sortedAttributes)
+    {
+        numThreads = GetNumWorkerThreads(numThreads);
+        std::vector<MortonKey> keys(numPoints);
+        std::vector<MortonKey> scratch;
+        ParallelForBlocks(numPoints, numThreads, [points, &keys, &grid](std::size_t begin, std::size_t end, unsigned) {
+            for (auto i = begin; i < end; ++i) keys[i] = MortonKey{ grid.Encode(points[i].position_), i };
+        });
+
+        ParallelRadixSort(keys, scratch, numThreads);
+
+        sortedCodes.resize(numPoints);
+        sortedPoints.resize(numPoints);
+        ParallelForBlocks(numPoints, numThreads, [points, &keys, &sortedCodes, &sortedPoints](std::size_t begin, std::size_t end, unsigned) {
+            for (auto i = begin; i < end; ++i) {
+                sortedCodes[i] = keys[i].code_;
+                sortedPoints[i] = points[keys[i].index_];
+            }
+        });
+        if (attributes == nullptr || sortedAttributes == nullptr) return;
+
+        sortedAttributes->resize(numPoints);
+        ParallelForBlocks(numPoints, numThreads, [attributes, &keys, sortedAttributes](std::size_t begin, std::size_t end, unsigned) {
+            for (auto i = begin; i < end; ++i) (*sortedAttributes)[i] = attributes[keys[i].index_];
+        });
+    }
+
+    void PointCloudConverter::ComputeBounds(PointReader& reader)
+    {
+        numPoints_ = 0;
+        sourceMin_ = glm::dvec3(std::numeric_limits<double>::max());
+        sourceMax_ = glm::dvec3(std::numeric_limits<double>::lowest());
+
+        // formats storing the bounds and the number of points in their header do not need the extra pass.
+        if (!reader.GetBounds(sourceMin_, sourceMax_) || (numPoints_ = reader.GetNumPoints()) == 0) {
+            std::vector<InputPoint> buffer(MERGE_BUFFER_SIZE);
+            reader.Rewind();
+            while (auto numRead = reader.Read(buffer.data(), buffer.size())) {
+                numPoints_ += numRead;
+                for (auto i = 0U; i < numRead; ++i) {
+                    sourceMin_ = glm::min(sourceMin_, buffer[i].position_);
+                    sourceMax_ = glm::max(sourceMax_, buffer[i].position_);
+                }
+            }
+        }
+        grid_ = MortonGrid(glm::vec3(0.0f), glm::vec3(sourceMax_ - sourceMin_));
+    }
+
+    std::vector<std::string> PointCloudConverter::CreateSortedRuns(PointReader& reader, const std::string& tempPrefix)
+    {
+        auto numThreads = GetNumWorkerThreads(options_.build_.numThreads_);
+        auto batchSize = static_cast<std::size_t>(std::min<std::uint64_t>(numPoints_, std::max<std::uint64_t>(1 << 20, options_.memoryBudget_ / SORT_BYTES_PER_POINT)));
+
+        std::vector<InputPoint> input(batchSize);
+        std::vector<PointCloudPoint> localPoints(batchSize);
+        std::vector<PointCloudAttributes> localAttributes(HasScanAttributes() ? batchSize : 0);
+        std::vector<std::uint64_t> sortedCodes;
+        std::vector<PointCloudPoint> sortedPoints;
+        std::vector<PointCloudAttributes> sortedAttributes;
+        std::vector<std::string> runFiles;
+
+        numPoints_ = 0;
+        reader.Rewind();
+        while (auto numRead = reader.Read(input.data(), input.size())) {
+            // GPS times are stored as floats, relative to the first point they keep sub millisecond precision for hours.
+            if (numPoints_ == 0) gpsTimeOrigin_ = input[0].gpsTime_;
+            numPoints_ += numRead;
+            auto origin = sourceMin_;
+            auto gpsTimeOrigin = gpsTimeOrigin_;
+            auto withAttributes = HasScanAttributes();
+            ParallelForBlocks(numRead, numThreads, [&input, &localPoints, &localAttributes, origin, gpsTimeOrigin, withAttributes](std::size_t begin, std::size_t end, unsigned) {
+                for (auto i = begin; i < end; ++i) {
+                    localPoints[i].position_ = glm::vec3(input[i].position_ - origin);
+                    localPoints[i].color_ = input[i].color_;
+                    if (!withAttributes) continue;
+                    localAttributes[i].intensity_ = input[i].intensity_;
+                    localAttributes[i].classification_ = input[i].classification_;
+                    localAttributes[i].returnNumber_ = input[i].returnNumber_;
+                    localAttributes[i].gpsTime_ = static_cast<float>(input[i].gpsTime_ - gpsTimeOrigin);
+                }
+            });
+            SortByMortonCode(localPoints.data(), numRead, grid_, numThreads, sortedCodes, sortedPoints,
+                withAttributes ? localAttributes.data() : nullptr, &sortedAttributes);
+
+            runFiles.push_back(tempPrefix + ".run" + std::to_string(runFiles.size()));
+            WriteArray(runFiles.back() + ".codes", sortedCodes.data(), numRead);
+            WriteArray(runFiles.back() + ".points", sortedPoints.data(), numRead);
+            if (withAttributes) WriteArray(runFiles.back() + ".attributes", sortedAttributes.data(), numRead);
+        }
+        return runFiles;
+    }
+
+    void PointCloudConverter::MergeRuns(const std::vector<std::string>& runFiles, const std::string& codesFile, const std::string& pointsFile,
+        const std::string& attributesFile) const
+    {
+        using HeapEntry = std::pair<std::uint64_t, std::size_t>;
+
+        std::vector<std::unique_ptr<RunCursor>> runs;
+        std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+        for (const auto& runFile : runFiles) {
+            runs.push_back(std::make_unique<RunCursor>(runFile + ".codes", runFile + ".points", attributesFile.empty() ? std::string() : runFile + ".attributes"));
+            if (!runs.back()->codes_.empty()) heap.emplace(runs.back()->codes_[0], runs.size() - 1);
+        }
+
+        std::ofstream codesOut{ codesFile, std::ios::binary | std::ios::trunc };
+        std::ofstream pointsOut{ pointsFile, std::ios::binary | std::ios::trunc };
+        std::ofstream attributesOut;
+        if (!attributesFile.empty()) attributesOut.open(attributesFile, std::ios::binary | std::ios::trunc);
+        std::vector<std::uint64_t> codeBuffer;
+        std::vector<PointCloudPoint> pointBuffer;
+        std::vector<PointCloudAttributes> attributeBuffer;
+        codeBuffer.reserve(MERGE_BUFFER_SIZE);
+        pointBuffer.reserve(MERGE_BUFFER_SIZE);
+        auto flush = [&]() {
+            codesOut.write(reinterpret_cast<const char*>(codeBuffer.data()), static_cast<std::streamsize>(codeBuffer.size() * sizeof(std::uint64_t)));
+            pointsOut.write(reinterpret_cast<const char*>(pointBuffer.data()), static_cast<std::streamsize>(pointBuffer.size() * sizeof(PointCloudPoint)));
+            if (attributesOut.is_open()) attributesOut.write(reinterpret_cast<const char*>(attributeBuffer.data()), static_cast<std::streamsize>(attributeBuffer.size() * sizeof(PointCloudAttributes)));
+            codeBuffer.clear();
+            pointBuffer.clear();
+            attributeBuffer.clear();
+        };
+
+        while (!heap.empty()) {
+            auto runIndex = heap.top().second;
+            heap.pop();
+            auto& run = *runs[runIndex];
+            codeBuffer.push_back(run.codes_[run.position_]);
+            pointBuffer.push_back(run.points_[run.position_]);
+            if (!attributesFile.empty()) attributeBuffer.push_back(run.attributes_[run.position_]);
+            if (codeBuffer.size() == MERGE_BUFFER_SIZE) flush();
+
+            if (++run.position_ < run.codes_.size() || run.Refill()) heap.emplace(run.codes_[run.position_], runIndex);
+        }
+        flush();
+        if (!codesOut || !pointsOut || (!attributesFile.empty() && !attributesOut)) throw std::runtime_error("Could not write temporary file \"" + codesFile + "\".");
+    }
+
+    void PointCloudConverter::BuildOctree(const PointCloudPoint* points, const PointCloudAttributes* attributes, const std::uint64_t* codes,
+        const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::dvec3& origin, const std::string& outputFile)
+    {
+        PointCloudWriter writer{ outputFile, boundsMin, boundsMax, origin, options_.build_.maxPointsPerNode_, options_.layout_, attributes_ };
+        writer.SetGPSTimeOrigin(gpsTimeOrigin_);
+        OctreeBuilder builder{ options_.build_ };
+        auto nodes = builder.Build(points, codes, numPoints_, grid_, boundsMin, boundsMax, writer, attributes);
+        writer.Finish(nodes);
+        numDroppedPoints_ = builder.GetNumDroppedPoints();
+    }
+}
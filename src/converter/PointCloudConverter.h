@@ -0,0 +1,100 @@
+/**
+ * @file   PointCloudConverter.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the conversion of raw scans to point cloud files.
+ */
+
+#pragma once
+
+#include "app/pointcloud/OctreeBuilder.h"
+
+#include <string>
+#include <vector>
+
+namespace viscom {
+
+    class PointReader;
+
+    /** Options for converting scans. */
+    struct ConverterOptions
+    {
+        /** The options for the octree construction. */
+        OctreeBuildOptions build_;
+        /** The amount of memory used for sorting, inputs larger than this are sorted out-of-core. */
+        std::uint64_t memoryBudget_ = 4ULL << 30;
+        /** The prefix for temporary files (empty uses the name of the output file). */
+        std::string tempPrefix_;
+        /** The layout of the points in the output file, PointLayout::Columnar keeps the scan attributes of the input. */
+        PointLayout layout_ = PointLayout::Quantized16RGBA8;
+    };
+
+    /** Timings of the conversion stages in seconds. */
+    struct ConverterTimings
+    {
+        /** Time for reading the input and computing the bounds. */
+        double bounds_ = 0.0;
+        /** Time for computing and sorting the morton codes. */
+        double sort_ = 0.0;
+        /** Time for merging sorted runs. */
+        double merge_ = 0.0;
+        /** Time for building the octree and writing the output. */
+        double build_ = 0.0;
+    };
+
+    /**
+     *  Converts scans to point cloud files: the input is cut into runs that fit into the memory budget, each run is
+     *  sorted by morton codes in parallel and written to a temporary file. The runs are merged into a single sorted
+     *  file, which is mapped for building the octree. For columnar files the scan attributes of the points go
+     *  through the same stages in files of their own.
+     */
+    class PointCloudConverter
+    {
+    public:
+        explicit PointCloudConverter(const ConverterOptions& options);
+
+        void Convert(PointReader& reader, const std::string& outputFile);
+        void BuildInMemory(const std::vector<PointCloudPoint>& points, const glm::vec3& boundsMin, const glm::vec3& boundsMax, const std::string& outputFile,
+            const std::vector<PointCloudAttributes>& attributes = {});
+
+        static void SortByMortonCode(const PointCloudPoint* points, std::size_t numPoints, const MortonGrid& grid, unsigned numThreads,
+            std::vector<std::uint64_t>& sortedCodes, std::vector<PointCloudPoint>& sortedPoints,
+            const PointCloudAttributes* attributes = nullptr, std::vector<PointCloudAttributes>* sortedAttributes = nullptr);
+
+        /** Returns the timings of the last conversion. */
+        const ConverterTimings& GetTimings() const { return timings_; }
+        /** Returns the number of points in the last conversion. */
+        std::uint64_t GetNumPoints() const { return numPoints_; }
+        /** Returns the number of points dropped in the last conversion. */
+        std::uint64_t GetNumDroppedPoints() const { return numDroppedPoints_; }
+
+    private:
+        void ComputeBounds(PointReader& reader);
+        std::vector<std::string> CreateSortedRuns(PointReader& reader, const std::string& tempPrefix);
+        void MergeRuns(const std::vector<std::string>& runFiles, const std::string& codesFile, const std::string& pointsFile, const std::string& attributesFile) const;
+        void BuildOctree(const PointCloudPoint* points, const PointCloudAttributes* attributes, const std::uint64_t* codes, const glm::vec3& boundsMin,
+            const glm::vec3& boundsMax, const glm::dvec3& origin, const std::string& outputFile);
+        /** Returns whether the scan attributes are kept, i.e., the output is columnar and the input has some. */
+        bool HasScanAttributes() const { return (attributes_ & ~POINTCLOUD_POSITION_COLOR) != 0; }
+
+        /** Holds the conversion options. */
+        ConverterOptions options_;
+        /** Holds the minimum of the bounding box in the source coordinate system. */
+        glm::dvec3 sourceMin_;
+        /** Holds the maximum of the bounding box in the source coordinate system. */
+        glm::dvec3 sourceMax_;
+        /** Holds the morton grid. */
+        MortonGrid grid_;
+        /** Holds the attributes stored in the output file. */
+        std::uint32_t attributes_ = POINTCLOUD_POSITION_COLOR;
+        /** Holds the GPS time the GPS times in the output file are relative to. */
+        double gpsTimeOrigin_ = 0.0;
+        /** Holds the number of points. */
+        std::uint64_t numPoints_ = 0;
+        /** Holds the number of dropped points. */
+        std::uint64_t numDroppedPoints_ = 0;
+        /** Holds the timings. */
+        ConverterTimings timings_;
+    };
+}
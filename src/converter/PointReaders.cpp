@@ -0,0 +1,452 @@
+/**
+ * @file   PointReaders.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Implementation of the readers for raw scan files (PLY, XYZ, LAS).
+ */
+
+#include "PointReaders.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace viscom {
+
+    namespace {
+
+        std::ifstream OpenFile(const std::string& filename)
+        {
+            std::ifstream file{ filename, std::ios::binary };
+            if (!file) throw std::runtime_error("Could not open file \"" + filename + "\".");
+            return file;
+        }
+
+        template<typename T> T ReadLittleEndian(const std::uint8_t* data)
+        {
+            T result;
+            std::memcpy(&result, data, sizeof(T));
+            return result;
+        }
+
+        /** Reads ASCII files with one point per line ("x y z [r g b]"), values separated by white space or commas. */
+        class XYZReader final : public PointReader
+        {
+        public:
+            explicit XYZReader(const std::string& filename) : file_{ OpenFile(filename) } {}
+
+            std::size_t Read(InputPoint* points, std::size_t maxPoints) override
+            {
+                std::size_t numRead = 0;
+                std::string line;
+                double values[6];
+                while (numRead < maxPoints && std::getline(file_, line)) {
+                    auto numValues = 0;
+                    auto current = line.c_str();
+                    while (numValues < 6) {
+                        while (*current == ' ' || *current == '\t' || *current == ',' || *current == ';') ++current;
+                        char* valueEnd = nullptr;
+                        values[numValues] = std::strtod(current, &valueEnd);
+                        if (valueEnd == current) break;
+                        current = valueEnd;
+                        ++numValues;
+                    }
+                    if (numValues < 3) continue;
+
+                    auto& point = points[numRead++];
+                    point = InputPoint();
+                    point.position_ = glm::dvec3(values[0], values[1], values[2]);
+                    point.color_ = glm::u8vec4(255);
+                    if (numValues == 6) {
+                        for (auto c = 0; c < 3; ++c) point.color_[c] = static_cast<std::uint8_t>(std::min(std::max(values[3 + c], 0.0), 255.0));
+                    }
+                }
+                return numRead;
+            }
+
+            void Rewind() override
+            {
+                file_.clear();
+                file_.seekg(0);
+            }
+
+        private:
+            /** Holds the input file. */
+            std::ifstream file_;
+        };
+
+        /** Reads the vertices of PLY files in ASCII or binary encoding. */
+        class PLYReader final : public PointReader
+        {
+        public:
+            explicit PLYReader(const std::string& filename) : file_{ OpenFile(filename) }
+            {
+                std::string line;
+                std::getline(file_, line);
+                if (line.compare(0, 3, "ply") != 0) throw std::runtime_error("File \"" + filename + "\" is not a PLY file.");
+
+                auto inVertexElement = false;
+                auto vertexElementFound = false;
+                while (std::getline(file_, line)) {
+                    if (!line.empty() && line.back() == '\r') line.pop_back();
+                    std::istringstream tokens{ line };
+                    std::string keyword;
+                    tokens >> keyword;
+
+                    if (keyword == "end_header") break;
+                    if (keyword == "format") {
+                        std::string format;
+                        tokens >> format;
+                        if (format == "ascii") encoding_ = Encoding::ASCII;
+                        else if (format == "binary_little_endian") encoding_ = Encoding::LittleEndian;
+                        else if (format == "binary_big_endian") encoding_ = Encoding::BigEndian;
+                        else throw std::runtime_error("Unknown PLY format \"" + format + "\".");
+                    } else if (keyword == "element") {
+                        std::string name;
+                        std::uint64_t count = 0;
+                        tokens >> name >> count;
+                        inVertexElement = name == "vertex";
+                        if (inVertexElement) {
+                            vertexElementFound = true;
+                            numVertices_ = count;
+                        } else if (!vertexElementFound && count != 0) {
+                            throw std::runtime_error("PLY files with elements before the vertices are not supported.");
+                        }
+                    } else if (keyword == "property" && inVertexElement) {
+                        std::string type, name;
+                        tokens >> type >> name;
+                        if (type == "list") throw std::runtime_error("PLY vertices with list properties are not supported.");
+                        Property property;
+                        property.type_ = ParseType(type);
+                        property.offset_ = vertexStride_;
+                        property.target_ = ParseTarget(name);
+                        vertexStride_ += GetTypeSize(property.type_);
+                        if (property.target_ == Target::Intensity) attributes_ |= GetAttributeBit(PointAttribute::Intensity);
+                        else if (property.target_ == Target::Classification) attributes_ |= GetAttributeBit(PointAttribute::Classification);
+                        else if (property.target_ == Target::ReturnNumber) attributes_ |= GetAttributeBit(PointAttribute::ReturnNumber);
+                        else if (property.target_ == Target::GPSTime) attributes_ |= GetAttributeBit(PointAttribute::GPSTime);
+                        properties_.push_back(property);
+                    }
+                }
+
+                if (!vertexElementFound) throw std::runtime_error("PLY file \"" + filename + "\" does not contain vertices.");
+                dataStart_ = file_.tellg();
+            }
+
+            std::size_t Read(InputPoint* points, std::size_t maxPoints) override
+            {
+                auto numToRead = static_cast<std::size_t>(std::min<std::uint64_t>(maxPoints, numVertices_ - numVerticesRead_));
+                if (numToRead == 0) return 0;
+
+                if (encoding_ == Encoding::ASCII) {
+                    std::vector<double> values(properties_.size());
+                    std::string line;
+                    for (auto i = 0U; i < numToRead; ++i) {
+                        if (!std::getline(file_, line)) throw std::runtime_error("Unexpected end of PLY file.");
+                        std::istringstream tokens{ line };
+                        for (auto& value : values) tokens >> value;
+                        SetPoint(points[i], [&values](std::size_t p) { return values[p]; });
+                    }
+                } else {
+                    buffer_.resize(numToRead * vertexStride_);
+                    file_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+                    if (!file_) throw std::runtime_error("Unexpected end of PLY file.");
+                    for (auto i = 0U; i < numToRead; ++i) {
+                        auto vertex = buffer_.data() + i * vertexStride_;
+                        SetPoint(points[i], [this, vertex](std::size_t p) { return ReadBinaryValue(vertex + properties_[p].offset_, properties_[p].type_); });
+                    }
+                }
+                numVerticesRead_ += numToRead;
+                return numToRead;
+            }
+
+            void Rewind() override
+            {
+                file_.clear();
+                file_.seekg(dataStart_);
+                numVerticesRead_ = 0;
+            }
+
+            std::uint64_t GetNumPoints() const override { return numVertices_; }
+            std::uint32_t GetAttributes() const override { return attributes_; }
+
+        private:
+            enum class Encoding { ASCII, LittleEndian, BigEndian };
+            enum class Type { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+            enum class Target { None, X, Y, Z, Red, Green, Blue, Alpha, Intensity, Classification, ReturnNumber, GPSTime };
+
+            /** A property of the vertex element. */
+            struct Property
+            {
+                /** The properties type. */
+                Type type_ = Type::Float32;
+                /** The offset inside a binary vertex. */
+                std::size_t offset_ = 0;
+                /** The point attribute the property is read to. */
+                Target target_ = Target::None;
+            };
+
+            static Type ParseType(const std::string& type)
+            {
+                if (type == "char" || type == "int8") return Type::Int8;
+                if (type == "uchar" || type == "uint8") return Type::UInt8;
+                if (type == "short" || type == "int16") return Type::Int16;
+                if (type == "ushort" || type == "uint16") return Type::UInt16;
+                if (type == "int" || type == "int32") return Type::Int32;
+                if (type == "uint" || type == "uint32") return Type::UInt32;
+                if (type == "float" || type == "float32") return Type::Float32;
+                if (type == "double" || type == "float64") return Type::Float64;
+                throw std::runtime_error("Unknown PLY property type \"" + type + "\".");
+            }
+
+            static Target ParseTarget(const std::string& name)
+            {
+                if (name == "x") return Target::X;
+                if (name == "y") return Target::Y;
+                if (name == "z") return Target::Z;
+                if (name == "red" || name == "r" || name == "diffuse_red") return Target::Red;
+                if (name == "green" || name == "g" || name == "diffuse_green") return Target::Green;
+                if (name == "blue" || name == "b" || name == "diffuse_blue") return Target::Blue;
+                if (name == "alpha" || name == "a") return Target::Alpha;
+                // scalar fields exported by CloudCompare carry a "scalar_" prefix.
+                auto field = name.compare(0, 7, "scalar_") == 0 ? name.substr(7) : name;
+                std::transform(field.begin(), field.end(), field.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+                if (field == "intensity") return Target::Intensity;
+                if (field == "classification") return Target::Classification;
+                if (field == "return_number" || field == "returnnumber") return Target::ReturnNumber;
+                if (field == "gps_time" || field == "gpstime") return Target::GPSTime;
+                return Target::None;
+            }
+
+            static std::size_t GetTypeSize(Type type)
+            {
+                switch (type) {
+                case Type::Int8: case Type::UInt8: return 1;
+                case Type::Int16: case Type::UInt16: return 2;
+                case Type::Int32: case Type::UInt32: case Type::Float32: return 4;
+                default: return 8;
+                }
+            }
+
+            double ReadBinaryValue(const std::uint8_t* data, Type type) const
+            {
+                std::uint8_t bytes[8];
+                auto size = GetTypeSize(type);
+                if (encoding_ == Encoding::BigEndian) std::reverse_copy(data, data + size, bytes);
+                else std::copy(data, data + size, bytes);
+
+                switch (type) {
+                case Type::Int8: return ReadLittleEndian<std::int8_t>(bytes);
+                case Type::UInt8: return ReadLittleEndian<std::uint8_t>(bytes);
+                case Type::Int16: return ReadLittleEndian<std::int16_t>(bytes);
+                case Type::UInt16: return ReadLittleEndian<std::uint16_t>(bytes);
+                case Type::Int32: return ReadLittleEndian<std::int32_t>(bytes);
+                case Type::UInt32: return ReadLittleEndian<std::uint32_t>(bytes);
+                case Type::Float32: return ReadLittleEndian<float>(bytes);
+                default: return ReadLittleEndian<double>(bytes);
+                }
+            }
+
+            template<typename ValueFn> void SetPoint(InputPoint& point, ValueFn value) const
+            {
+                point = InputPoint();
+                point.position_ = glm::dvec3(0.0);
+                point.color_ = glm::u8vec4(255);
+                for (auto p = 0U; p < properties_.size(); ++p) {
+                    const auto& property = properties_[p];
+                    if (property.target_ == Target::None) continue;
+                    auto v = value(p);
+                    if (property.target_ <= Target::Z) {
+                        point.position_[static_cast<int>(property.target_) - static_cast<int>(Target::X)] = v;
+                    } else if (property.target_ == Target::Intensity) {
+                        point.intensity_ = static_cast<std::uint16_t>(std::min(std::max(v, 0.0), 65535.0));
+                    } else if (property.target_ == Target::Classification) {
+                        point.classification_ = static_cast<std::uint8_t>(std::min(std::max(v, 0.0), 255.0));
+                    } else if (property.target_ == Target::ReturnNumber) {
+                        point.returnNumber_ = static_cast<std::uint8_t>(std::min(std::max(v, 0.0), 255.0));
+                    } else if (property.target_ == Target::GPSTime) {
+                        point.gpsTime_ = v;
+                    } else {
+                        // float colors are in [0, 1], 16 bit colors in [0, 65535].
+                        if (property.type_ == Type::Float32 || property.type_ == Type::Float64) v *= 255.0;
+                        else if (property.type_ == Type::UInt16) v /= 257.0;
+                        point.color_[static_cast<int>(property.target_) - static_cast<int>(Target::Red)] = static_cast<std::uint8_t>(std::min(std::max(v, 0.0), 255.0));
+                    }
+                }
+            }
+
+            /** Holds the input file. */
+            std::ifstream file_;
+            /** Holds the encoding of the vertex data. */
+            Encoding encoding_ = Encoding::ASCII;
+            /** Holds the properties of the vertex element. */
+            std::vector<Property> properties_;
+            /** Holds the attributes found in the properties. */
+            std::uint32_t attributes_ = POINTCLOUD_POSITION_COLOR;
+            /** Holds the size of a binary vertex. */
+            std::size_t vertexStride_ = 0;
+            /** Holds the number of vertices. */
+            std::uint64_t numVertices_ = 0;
+            /** Holds the number of vertices read so far. */
+            std::uint64_t numVerticesRead_ = 0;
+            /** Holds the start of the vertex data. */
+            std::streampos dataStart_;
+            /** Holds the buffer for binary vertices. */
+            std::vector<std::uint8_t> buffer_;
+        };
+
+        /** Reads uncompressed LAS files (version 1.0 to 1.4, point data formats 0 to 10). */
+        class LASReader final : public PointReader
+        {
+        public:
+            explicit LASReader(const std::string& filename) : file_{ OpenFile(filename) }
+            {
+                std::uint8_t header[375] = {};
+                file_.read(reinterpret_cast<char*>(header), sizeof(header));
+                auto headerBytes = file_.gcount();
+                if (headerBytes < 227 || std::memcmp(header, "LASF", 4) != 0) throw std::runtime_error("File \"" + filename + "\" is not a LAS file.");
+                file_.clear();
+
+                auto versionMinor = header[25];
+                dataStart_ = ReadLittleEndian<std::uint32_t>(header + 96);
+                pointFormat_ = header[104] & 0x3f;
+                if ((header[104] & 0xc0) != 0) throw std::runtime_error("Compressed LAS files are not supported.");
+                recordLength_ = ReadLittleEndian<std::uint16_t>(header + 105);
+                numPoints_ = ReadLittleEndian<std::uint32_t>(header + 107);
+                if (versionMinor >= 4 && headerBytes >= 255) {
+                    auto numPoints14 = ReadLittleEndian<std::uint64_t>(header + 247);
+                    if (numPoints14 != 0) numPoints_ = numPoints14;
+                }
+                for (auto c = 0; c < 3; ++c) {
+                    scale_[c] = ReadLittleEndian<double>(header + 131 + 8 * c);
+                    offset_[c] = ReadLittleEndian<double>(header + 155 + 8 * c);
+                    boundsMax_[c] = ReadLittleEndian<double>(header + 179 + 16 * c);
+                    boundsMin_[c] = ReadLittleEndian<double>(header + 187 + 16 * c);
+                }
+
+                switch (pointFormat_) {
+                case 2: colorOffset_ = 20; break;
+                case 3: case 5: colorOffset_ = 28; break;
+                case 7: case 8: case 10: colorOffset_ = 30; break;
+                default: colorOffset_ = 0; break;
+                }
+                // formats 6 to 10 widen the return number and classification fields and move the GPS time.
+                gpsTimeOffset_ = pointFormat_ >= 6 ? 22 : (pointFormat_ == 0 || pointFormat_ == 2 ? 0 : 20);
+                if (pointFormat_ > 10 || recordLength_ < 20 || (colorOffset_ != 0 && recordLength_ < colorOffset_ + 6)
+                    || (gpsTimeOffset_ != 0 && recordLength_ < gpsTimeOffset_ + 8))
+                    throw std::runtime_error("LAS point format " + std::to_string(pointFormat_) + " is not supported.");
+
+                Rewind();
+            }
+
+            std::size_t Read(InputPoint* points, std::size_t maxPoints) override
+            {
+                auto numToRead = static_cast<std::size_t>(std::min<std::uint64_t>(maxPoints, numPoints_ - numPointsRead_));
+                if (numToRead == 0) return 0;
+
+                buffer_.resize(numToRead * recordLength_);
+                file_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+                if (!file_) throw std::runtime_error("Unexpected end of LAS file.");
+
+                for (auto i = 0U; i < numToRead; ++i) {
+                    auto record = buffer_.data() + i * recordLength_;
+                    auto& point = points[i];
+                    for (auto c = 0; c < 3; ++c) point.position_[c] = ReadLittleEndian<std::int32_t>(record + 4 * c) * scale_[c] + offset_[c];
+
+                    if (colorOffset_ != 0) {
+                        for (auto c = 0; c < 3; ++c) point.color_[c] = static_cast<std::uint8_t>(ReadLittleEndian<std::uint16_t>(record + colorOffset_ + 2 * c) >> 8);
+                        point.color_[3] = 255;
+                    } else {
+                        // without colors the intensity is shown as gray value.
+                        auto intensity = static_cast<std::uint8_t>(ReadLittleEndian<std::uint16_t>(record + 12) >> 8);
+                        point.color_ = glm::u8vec4(intensity, intensity, intensity, 255);
+                    }
+
+                    point.intensity_ = ReadLittleEndian<std::uint16_t>(record + 12);
+                    if (pointFormat_ >= 6) {
+                        point.returnNumber_ = record[14] & 0x0f;
+                        point.classification_ = record[16];
+                    } else {
+                        point.returnNumber_ = record[14] & 0x07;
+                        point.classification_ = record[15] & 0x1f;
+                    }
+                    point.gpsTime_ = gpsTimeOffset_ != 0 ? ReadLittleEndian<double>(record + gpsTimeOffset_) : 0.0;
+                }
+                numPointsRead_ += numToRead;
+                return numToRead;
+            }
+
+            void Rewind() override
+            {
+                file_.clear();
+                file_.seekg(dataStart_);
+                numPointsRead_ = 0;
+            }
+
+            bool GetBounds(glm::dvec3& boundsMin, glm::dvec3& boundsMax) const override
+            {
+                boundsMin = boundsMin_;
+                boundsMax = boundsMax_;
+                return true;
+            }
+
+            std::uint64_t GetNumPoints() const override { return numPoints_; }
+
+            std::uint32_t GetAttributes() const override
+            {
+                auto attributes = POINTCLOUD_POSITION_COLOR | GetAttributeBit(PointAttribute::Intensity) | GetAttributeBit(PointAttribute::Classification)
+                    | GetAttributeBit(PointAttribute::ReturnNumber);
+                return gpsTimeOffset_ != 0 ? attributes | GetAttributeBit(PointAttribute::GPSTime) : attributes;
+            }
+
+        private:
+            /** Holds the input file. */
+            std::ifstream file_;
+            /** Holds the offset of the point records. */
+            std::uint32_t dataStart_ = 0;
+            /** Holds the point data format. */
+            unsigned pointFormat_ = 0;
+            /** Holds the size of a point record. */
+            std::size_t recordLength_ = 0;
+            /** Holds the offset of the color inside a record (0 if there is none). */
+            std::size_t colorOffset_ = 0;
+            /** Holds the offset of the GPS time inside a record (0 if there is none). */
+            std::size_t gpsTimeOffset_ = 0;
+            /** Holds the number of points. */
+            std::uint64_t numPoints_ = 0;
+            /** Holds the number of points read so far. */
+            std::uint64_t numPointsRead_ = 0;
+            /** Holds the scale of the integer coordinates. */
+            glm::dvec3 scale_;
+            /** Holds the offset of the integer coordinates. */
+            glm::dvec3 offset_;
+            /** Holds the minimum of the bounding box. */
+            glm::dvec3 boundsMin_;
+            /** Holds the maximum of the bounding box. */
+            glm::dvec3 boundsMax_;
+            /** Holds the buffer for point records. */
+            std::vector<std::uint8_t> buffer_;
+        };
+    }
+
+    /**
+     *  Creates a reader for a scan file depending on its extension (.ply, .xyz/.txt/.pts, .las).
+     *  @param filename the name of the scan file.
+     */
+    std::unique_ptr<PointReader> CreatePointReader(const std::string& filename)
+    {
+        auto extension = filename.substr(filename.find_last_of('.') + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+
+        if (extension == "ply") return std::make_unique<PLYReader>(filename);
+        if (extension == "xyz" || extension == "txt" || extension == "pts") return std::make_unique<XYZReader>(filename);
+        if (extension == "las") return std::make_unique<LASReader>(filename);
+        throw std::runtime_error("Unknown point cloud format \"" + extension + "\".");
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ * @file   PointReaders.h
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Declaration of the readers for raw scan files (PLY, XYZ, LAS).
+ */
+
+#pragma once
+
+#include "app/pointcloud/PointCloudFormat.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <glm/glm.hpp>
+
+namespace viscom {
+
+    /** A point as read from a scan file. */
+    struct InputPoint
+    {
+        /** The points position in the source coordinate system. */
+        glm::dvec3 position_;
+        /** The points color. */
+        glm::u8vec4 color_;
+        /** The return intensity. */
+        std::uint16_t intensity_ = 0;
+        /** The classification. */
+        std::uint8_t classification_ = 0;
+        /** The return number. */
+        std::uint8_t returnNumber_ = 0;
+        /** The GPS time. */
+        double gpsTime_ = 0.0;
+    };
+
+    /** Streams the points of a scan file in blocks, so files larger than the main memory can be read. */
+    class PointReader
+    {
+    public:
+        PointReader() = default;
+        PointReader(const PointReader&) = delete;
+        PointReader& operator=(const PointReader&) = delete;
+        virtual ~PointReader() = default;
+
+        /**
+         *  Reads the next points.
+         *  @param points the memory to read to.
+         *  @param maxPoints the maximum number of points to read.
+         *  @return the number of points read, 0 at the end of the file.
+         */
+        virtual std::size_t Read(InputPoint* points, std::size_t maxPoints) = 0;
+        /** Restarts reading at the first point. */
+        virtual void Rewind() = 0;
+        /** Returns the bounding box if it is stored in the files header. */
+        virtual bool GetBounds(glm::dvec3&, glm::dvec3&) const { return false; }
+        /** Returns the number of points if it is stored in the files header, 0 otherwise. */
+        virtual std::uint64_t GetNumPoints() const { return 0; }
+        /** Returns the attributes the file stores, one bit per PointAttribute (positions and colors are always read). */
+        virtual std::uint32_t GetAttributes() const { return POINTCLOUD_POSITION_COLOR; }
+    };
+
+    std::unique_ptr<PointReader> CreatePointReader(const std::string& filename);
+}
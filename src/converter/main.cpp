@@ -0,0 +1,273 @@
+/**
+ * @file   main.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Entry point of the point cloud converter.
+ */
+
+#include "PointCloudConverter.h"
+#include "PointReaders.h"
+#include "app/pointcloud/Parallel.h"
+#include "app/pointcloud/PointCloudFile.h"
+#include "app/pointcloud/PointQuantization.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: PointCloudConverter [options] <input.(ply|xyz|las)> <output.vpc>" << std::endl
+            << "       PointCloudConverter --benchmark [number of points] [options]" << std::endl
+            << "       PointCloudConverter --check-quantization [number of points] [options]" << std::endl
+            << "Options:" << std::endl
+            << "  --threads <n>          number of threads (default: all hardware threads)" << std::endl
+            << "  --memory <MB>          memory used for sorting, larger inputs are sorted out-of-core (default: 4096)" << std::endl
+            << "  --max-node-points <n>  maximum number of points per octree node (default: 32768)" << std::endl
+            << "  --temp <prefix>        prefix for temporary files (default: output file name)" << std::endl
+            << "  --layout <name>        point layout: compact (16 bit positions, default), float or columnar (compact positions," << std::endl
+            << "                         one column per attribute, keeps intensity, classification, return number and GPS time)" << std::endl
+            << "  --sampling <name>      points of the inner nodes: stride (every n-th point, default), voxel (one point per grid cell)" << std::endl
+            << "                         or poisson (minimum distance between the points)" << std::endl;
+    }
+
+    /** Creates a deterministic synthetic scan: a height field with a few spheres on top. */
+    std::vector<viscom::PointCloudPoint> CreateSyntheticScan(std::size_t numPoints)
+    {
+        std::mt19937 rng{ 42 };
+        std::uniform_real_distribution<float> uniform{ 0.0f, 1.0f };
+        std::vector<viscom::PointCloudPoint> points(numPoints);
+        for (auto& point : points) {
+            auto u = uniform(rng);
+            auto v = uniform(rng);
+            if (uniform(rng) < 0.7f) {
+                point.position_ = glm::vec3(100.0f * u, 100.0f * v, 5.0f * std::sin(10.0f * u) * std::cos(7.0f * v) + 5.0f);
+            } else {
+                auto sphere = static_cast<float>(static_cast<int>(uniform(rng) * 4.0f));
+                auto theta = 6.2831853f * u;
+                auto phi = std::acos(2.0f * v - 1.0f);
+                glm::vec3 center{ 20.0f + 20.0f * sphere, 50.0f, 20.0f };
+                point.position_ = center + 8.0f * glm::vec3(std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta), std::cos(phi));
+            }
+            point.color_ = glm::u8vec4(static_cast<std::uint8_t>(255.0f * u), static_cast<std::uint8_t>(255.0f * v), 128, 255);
+        }
+        return points;
+    }
+
+    /** Derives scan attributes from a point, so they can be checked after the conversion. */
+    viscom::PointCloudAttributes GetSyntheticAttributes(const viscom::PointCloudPoint& point)
+    {
+        viscom::PointCloudAttributes attributes;
+        attributes.intensity_ = static_cast<std::uint16_t>(std::min(std::max(point.position_.z / 30.0f, 0.0f), 1.0f) * 65535.0f);
+        attributes.classification_ = point.position_.z > 12.0f ? 6 : 2;
+        attributes.returnNumber_ = static_cast<std::uint8_t>(1 + point.color_.r % 3);
+        attributes.gpsTime_ = 10.0f * point.position_.x;
+        return attributes;
+    }
+
+    /** Measures the conversion throughput for increasing numbers of threads. */
+    int RunBenchmark(std::size_t numPoints, viscom::ConverterOptions options)
+    {
+        std::cout << "Generating " << numPoints << " points..." << std::endl;
+        auto points = CreateSyntheticScan(numPoints);
+        glm::vec3 boundsMin{ std::numeric_limits<float>::max() };
+        glm::vec3 boundsMax{ std::numeric_limits<float>::lowest() };
+        for (const auto& point : points) {
+            boundsMin = glm::min(boundsMin, point.position_);
+            boundsMax = glm::max(boundsMax, point.position_);
+        }
+
+        std::vector<unsigned> threadCounts;
+        auto maxThreads = viscom::GetNumWorkerThreads(options.build_.numThreads_);
+        for (auto t = 1U; t < maxThreads; t *= 2) threadCounts.push_back(t);
+        threadCounts.push_back(maxThreads);
+
+        auto outputFile = (options.tempPrefix_.empty() ? std::string("benchmark") : options.tempPrefix_) + ".vpc";
+        std::cout << std::setw(8) << "threads" << std::setw(12) << "sort [s]" << std::setw(12) << "build [s]" << std::setw(16) << "points/s" << std::setw(10) << "speedup" << std::endl;
+        auto baseTime = 0.0;
+        for (auto numThreads : threadCounts) {
+            options.build_.numThreads_ = numThreads;
+            viscom::PointCloudConverter converter{ options };
+            converter.BuildInMemory(points, boundsMin, boundsMax, outputFile);
+
+            const auto& timings = converter.GetTimings();
+            auto totalTime = timings.sort_ + timings.build_;
+            if (baseTime == 0.0) baseTime = totalTime;
+            std::cout << std::setw(8) << numThreads << std::fixed << std::setprecision(3) << std::setw(12) << timings.sort_ << std::setw(12) << timings.build_
+                << std::setprecision(0) << std::setw(16) << static_cast<double>(numPoints) / totalTime
+                << std::setprecision(2) << std::setw(10) << baseTime / totalTime << std::endl;
+        }
+        std::remove(outputFile.c_str());
+        return 0;
+    }
+
+    /**
+     *  Converts a synthetic scan to all point layouts and checks that every quantized position is within half a
+     *  quantization step (plus float rounding) of the float position. The columns of the columnar file have to hold
+     *  the quantized positions and colors of the compact file and the attributes of the points.
+     */
+    int RunQuantizationCheck(std::size_t numPoints, viscom::ConverterOptions options)
+    {
+        auto points = CreateSyntheticScan(numPoints);
+        glm::vec3 boundsMin{ std::numeric_limits<float>::max() };
+        glm::vec3 boundsMax{ std::numeric_limits<float>::lowest() };
+        for (const auto& point : points) {
+            boundsMin = glm::min(boundsMin, point.position_);
+            boundsMax = glm::max(boundsMax, point.position_);
+        }
+
+        auto prefix = options.tempPrefix_.empty() ? std::string("quantization") : options.tempPrefix_;
+        auto floatFile = prefix + ".float.vpc";
+        auto compactFile = prefix + ".compact.vpc";
+        auto columnarFile = prefix + ".columnar.vpc";
+        options.layout_ = viscom::PointLayout::Float32RGBA8;
+        viscom::PointCloudConverter{ options }.BuildInMemory(points, boundsMin, boundsMax, floatFile);
+        options.layout_ = viscom::PointLayout::Quantized16RGBA8;
+        viscom::PointCloudConverter{ options }.BuildInMemory(points, boundsMin, boundsMax, compactFile);
+        std::vector<viscom::PointCloudAttributes> attributes(points.size());
+        std::transform(points.begin(), points.end(), attributes.begin(), GetSyntheticAttributes);
+        options.layout_ = viscom::PointLayout::Columnar;
+        viscom::PointCloudConverter{ options }.BuildInMemory(points, boundsMin, boundsMax, columnarFile, attributes);
+
+        auto numErrors = 0ULL;
+        auto numColumnErrors = 0ULL;
+        auto maxError = 0.0f;
+        auto maxRelativeError = 0.0f;
+        std::uint64_t floatBytes = 0, compactBytes = 0, columnarBytes = 0;
+        {
+            viscom::PointCloudFile floatCloud{ floatFile };
+            viscom::PointCloudFile compactCloud{ compactFile };
+            viscom::PointCloudFile columnarCloud{ columnarFile };
+            if (floatCloud.GetNumNodes() != compactCloud.GetNumNodes() || columnarCloud.GetNumNodes() != compactCloud.GetNumNodes())
+                throw std::runtime_error("The octrees of the layouts differ.");
+
+            for (auto n = 0U; n < floatCloud.GetNumNodes(); ++n) {
+                const auto& node = compactCloud.GetNode(n);
+                if (node.numPoints_ != floatCloud.GetNode(n).numPoints_ || node.numPoints_ != columnarCloud.GetNode(n).numPoints_)
+                    throw std::runtime_error("The octrees of the layouts differ.");
+                if (node.numPoints_ == 0) continue;
+                floatBytes += floatCloud.GetNodeDataSize(n);
+                compactBytes += compactCloud.GetNodeDataSize(n);
+                columnarBytes += columnarCloud.GetNodeDataSize(n);
+
+                auto magnitude = glm::max(glm::abs(node.boundsMin_), glm::abs(node.boundsMax_));
+                auto tolerance = viscom::GetQuantizationError(node.boundsMin_, node.boundsMax_)
+                    + 4.0f * std::numeric_limits<float>::epsilon() * std::max(magnitude.x, std::max(magnitude.y, magnitude.z));
+                auto floatPoints = static_cast<const viscom::PointCloudPoint*>(floatCloud.GetNodeData(n));
+                auto compactPoints = static_cast<const viscom::PointCloudCompactPoint*>(compactCloud.GetNodeData(n));
+                for (auto i = 0U; i < node.numPoints_; ++i) {
+                    auto position = viscom::DequantizePosition(compactPoints[i].position_, node.boundsMin_, node.boundsMax_);
+                    auto difference = glm::abs(position - floatPoints[i].position_);
+                    auto error = std::max(difference.x, std::max(difference.y, difference.z));
+                    maxError = std::max(maxError, error);
+                    maxRelativeError = std::max(maxRelativeError, error / tolerance);
+                    if (error > tolerance || compactPoints[i].color_ != floatPoints[i].color_) ++numErrors;
+                }
+
+                auto positions = static_cast<const glm::u16vec3*>(columnarCloud.GetColumnData(n, viscom::PointAttribute::Position));
+                auto colors = static_cast<const glm::u8vec4*>(columnarCloud.GetColumnData(n, viscom::PointAttribute::Color));
+                auto intensities = static_cast<const std::uint16_t*>(columnarCloud.GetColumnData(n, viscom::PointAttribute::Intensity));
+                auto classifications = static_cast<const std::uint8_t*>(columnarCloud.GetColumnData(n, viscom::PointAttribute::Classification));
+                auto returnNumbers = static_cast<const std::uint8_t*>(columnarCloud.GetColumnData(n, viscom::PointAttribute::ReturnNumber));
+                auto gpsTimes = static_cast<const float*>(columnarCloud.GetColumnData(n, viscom::PointAttribute::GPSTime));
+                for (auto i = 0U; i < node.numPoints_; ++i) {
+                    auto expected = GetSyntheticAttributes(floatPoints[i]);
+                    if (positions[i] != compactPoints[i].position_ || colors[i] != compactPoints[i].color_ || intensities[i] != expected.intensity_
+                        || classifications[i] != expected.classification_ || returnNumbers[i] != expected.returnNumber_ || gpsTimes[i] != expected.gpsTime_)
+                        ++numColumnErrors;
+                }
+            }
+        }
+        std::remove(floatFile.c_str());
+        std::remove(compactFile.c_str());
+        std::remove(columnarFile.c_str());
+
+        std::cout << "Checked " << numPoints << " points: max. error " << maxError << " (" << 100.0f * maxRelativeError << "% of the allowed error), "
+            << numErrors << " errors, " << numColumnErrors << " column errors." << std::endl;
+        std::cout << "Point data: " << (floatBytes >> 20) << " MB float, " << (compactBytes >> 20) << " MB compact ("
+            << static_cast<double>(floatBytes) / static_cast<double>(compactBytes) << "x smaller), " << (columnarBytes >> 20) << " MB columnar with all attributes." << std::endl;
+        return numErrors == 0 && numColumnErrors == 0 ? 0 : 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    viscom::ConverterOptions options;
+    std::vector<std::string> files;
+    auto benchmark = false;
+    auto checkQuantization = false;
+    std::size_t benchmarkPoints = 10000000;
+
+    for (auto i = 1; i < argc; ++i) {
+        auto hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--threads") == 0 && hasValue) options.build_.numThreads_ = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--memory") == 0 && hasValue) options.memoryBudget_ = std::strtoull(argv[++i], nullptr, 10) << 20;
+        else if (std::strcmp(argv[i], "--max-node-points") == 0 && hasValue) options.build_.maxPointsPerNode_ = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--temp") == 0 && hasValue) options.tempPrefix_ = argv[++i];
+        else if (std::strcmp(argv[i], "--layout") == 0 && hasValue) {
+            std::string layout = argv[++i];
+            if (layout == "float") options.layout_ = viscom::PointLayout::Float32RGBA8;
+            else if (layout == "compact") options.layout_ = viscom::PointLayout::Quantized16RGBA8;
+            else if (layout == "columnar") options.layout_ = viscom::PointLayout::Columnar;
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--sampling") == 0 && hasValue) {
+            std::string sampling = argv[++i];
+            if (sampling == "stride") options.build_.sampling_ = viscom::SubsamplingMethod::Stride;
+            else if (sampling == "voxel") options.build_.sampling_ = viscom::SubsamplingMethod::VoxelGrid;
+            else if (sampling == "poisson") options.build_.sampling_ = viscom::SubsamplingMethod::PoissonDisk;
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--benchmark") == 0) {
+            benchmark = true;
+            if (hasValue && argv[i + 1][0] != '-') benchmarkPoints = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--check-quantization") == 0) {
+            checkQuantization = true;
+            if (hasValue && argv[i + 1][0] != '-') benchmarkPoints = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (argv[i][0] == '-') {
+            PrintUsage();
+            return 1;
+        }
+        else files.emplace_back(argv[i]);
+    }
+
+    try {
+        if (benchmark) return RunBenchmark(benchmarkPoints, options);
+        if (checkQuantization) return RunQuantizationCheck(benchmarkPoints, options);
+        if (files.size() != 2 || options.build_.maxPointsPerNode_ == 0) {
+            PrintUsage();
+            return 1;
+        }
+
+        auto reader = viscom::CreatePointReader(files[0]);
+        viscom::PointCloudConverter converter{ options };
+        converter.Convert(*reader, files[1]);
+
+        const auto& timings = converter.GetTimings();
+        auto totalTime = timings.bounds_ + timings.sort_ + timings.merge_ + timings.build_;
+        std::cout << "Converted " << converter.GetNumPoints() << " points in " << totalTime << "s (bounds: " << timings.bounds_ << "s, sort: " << timings.sort_
+            << "s, merge: " << timings.merge_ << "s, build: " << timings.build_ << "s)." << std::endl;
+        if (converter.GetNumDroppedPoints() != 0) std::cout << "Dropped " << converter.GetNumDroppedPoints() << " duplicate points." << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
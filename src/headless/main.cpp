@@ -0,0 +1,438 @@
+/**
+ * @file   main.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Entry point of the headless point cloud benchmark replaying recorded camera paths.
+ */
+
+#include "app/CameraPath.h"
+#include "app/PointCloudRenderer.h"
+#include "app/ProgramBinaryCache.h"
+
+#include <glbinding/gl/gl.h>
+#include <glbinding/Binding.h>
+#include "core/glfw.h"
+#include <g3log/logworker.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: PointCloudHeadless --file <file.vpc> --path <camera_path.txt> [options]" << std::endl
+            << "Replays a camera path offscreen at a fixed timestep and reports the frame times as JSON." << std::endl
+            << "Options:" << std::endl
+            << "  --width <n>            width of the offscreen framebuffer (default: 1920)" << std::endl
+            << "  --height <n>           height of the offscreen framebuffer (default: 1080)" << std::endl
+            << "  --fps <n>              frames per second of path time (default: 60)" << std::endl
+            << "  --fov <degrees>        vertical field of view (default: 60)" << std::endl
+            << "  --warmup <n>           frames drawn at the start of the path before measuring (default: 0)" << std::endl
+            << "  --point-budget <k>     point budget of the level of detail selection in thousands" << std::endl
+            << "  --loader-threads <n>   number of threads loading nodes (default: 2)" << std::endl
+            << "  --software             draw with the CPU rasterizer instead of the GPU" << std::endl
+            << "  --submission <mode>    draw calls: indirect (one per buffer, default if OpenGL 4.3 is available) or per-node" << std::endl
+            << "  --sweep <k,k,...>      replay the path for each point budget (in thousands) with both submission modes" << std::endl
+            << "                         and report draw calls and frame times of each run" << std::endl
+            << "  --shaders <dir>        directory of the point cloud shaders (default: resources/shader)" << std::endl
+            << "  --program-cache <dir>  directory of the cached program binaries (default: shader_cache)" << std::endl
+            << "  --output <file.json>   write the report to a file instead of the standard output" << std::endl;
+    }
+
+    /** The options of a benchmark run. */
+    struct HeadlessOptions
+    {
+        std::string filename;
+        std::string pathFilename;
+        std::string shaderDirectory = "resources/shader";
+        std::string programCacheDirectory = "shader_cache";
+        std::string outputFilename;
+        int width = 1920;
+        int height = 1080;
+        double fps = 60.0;
+        float fov = 60.0f;
+        int numWarmupFrames = 0;
+        unsigned numLoaderThreads = 2;
+        bool software = false;
+        viscom::PointCloudSubmission submission = viscom::PointCloudSubmission::Indirect;
+        std::vector<std::uint64_t> sweepPointBudgets;
+        viscom::LODTraversalParameters lodParameters;
+    };
+
+    /** The measurements of a single frame. */
+    struct FrameMeasurement
+    {
+        double frameTime;
+        std::uint64_t numDrawnPoints;
+        std::uint64_t numDrawnNodes;
+        std::uint64_t numDrawCalls;
+        std::uint64_t uploadedBytes;
+    };
+
+    /** The frames of a single run of a sweep. */
+    struct SweepRun
+    {
+        viscom::PointCloudSubmission submission;
+        std::uint64_t pointBudget;
+        std::vector<FrameMeasurement> frames;
+    };
+
+    /** Owns the hidden window providing the OpenGL context. */
+    class HeadlessContext
+    {
+    public:
+        HeadlessContext()
+        {
+            if (glfwInit() == 0) throw std::runtime_error("Could not initialize GLFW.");
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+            glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+            // indirect draw calls need OpenGL 4.3, without it nodes are drawn separately.
+            const int versions[][2] = { { 4, 3 }, { 3, 3 } };
+            for (const auto& version : versions) {
+                glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+                glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+                window_ = glfwCreateWindow(64, 64, "PointCloudHeadless", nullptr, nullptr);
+                if (window_ != nullptr) break;
+            }
+            if (window_ == nullptr) {
+                glfwTerminate();
+                throw std::runtime_error("Could not create an OpenGL 3.3 context (a display is needed, e.g. run with xvfb-run).");
+            }
+            glfwMakeContextCurrent(window_);
+            glbinding::Binding::initialize();
+        }
+        HeadlessContext(const HeadlessContext&) = delete;
+        HeadlessContext& operator=(const HeadlessContext&) = delete;
+        ~HeadlessContext()
+        {
+            glfwDestroyWindow(window_);
+            glfwTerminate();
+        }
+
+    private:
+        /** Holds the hidden window. */
+        GLFWwindow* window_ = nullptr;
+    };
+
+    /** Owns the offscreen framebuffer the frames are drawn to. */
+    class OffscreenFramebuffer
+    {
+    public:
+        OffscreenFramebuffer(int width, int height)
+        {
+            gl::glGenRenderbuffers(2, renderbuffers_);
+            gl::glBindRenderbuffer(gl::GL_RENDERBUFFER, renderbuffers_[0]);
+            gl::glRenderbufferStorage(gl::GL_RENDERBUFFER, gl::GL_RGBA8, width, height);
+            gl::glBindRenderbuffer(gl::GL_RENDERBUFFER, renderbuffers_[1]);
+            gl::glRenderbufferStorage(gl::GL_RENDERBUFFER, gl::GL_DEPTH_COMPONENT24, width, height);
+            gl::glBindRenderbuffer(gl::GL_RENDERBUFFER, 0);
+
+            gl::glGenFramebuffers(1, &fbo_);
+            gl::glBindFramebuffer(gl::GL_FRAMEBUFFER, fbo_);
+            gl::glFramebufferRenderbuffer(gl::GL_FRAMEBUFFER, gl::GL_COLOR_ATTACHMENT0, gl::GL_RENDERBUFFER, renderbuffers_[0]);
+            gl::glFramebufferRenderbuffer(gl::GL_FRAMEBUFFER, gl::GL_DEPTH_ATTACHMENT, gl::GL_RENDERBUFFER, renderbuffers_[1]);
+            if (gl::glCheckFramebufferStatus(gl::GL_FRAMEBUFFER) != gl::GL_FRAMEBUFFER_COMPLETE) throw std::runtime_error("Could not create the offscreen framebuffer.");
+            gl::glViewport(0, 0, width, height);
+        }
+        OffscreenFramebuffer(const OffscreenFramebuffer&) = delete;
+        OffscreenFramebuffer& operator=(const OffscreenFramebuffer&) = delete;
+        ~OffscreenFramebuffer()
+        {
+            gl::glBindFramebuffer(gl::GL_FRAMEBUFFER, 0);
+            gl::glDeleteFramebuffers(1, &fbo_);
+            gl::glDeleteRenderbuffers(2, renderbuffers_);
+        }
+
+    private:
+        /** Holds the framebuffer object. */
+        GLuint fbo_ = 0;
+        /** Holds the color and depth renderbuffers. */
+        GLuint renderbuffers_[2] = { 0, 0 };
+    };
+
+    /** Returns a percentile of sorted values (nearest rank). */
+    double GetPercentile(const std::vector<double>& sortedValues, double percentile)
+    {
+        auto rank = static_cast<std::size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sortedValues.size())));
+        return sortedValues[std::min(std::max<std::size_t>(rank, 1), sortedValues.size()) - 1];
+    }
+
+    std::string EscapeJSON(const std::string& text)
+    {
+        std::string result;
+        for (auto c : text) {
+            if (c == '"' || c == '\\') result += '\\';
+            if (static_cast<unsigned char>(c) < 0x20) result += ' ';
+            else result += c;
+        }
+        return result;
+    }
+
+    const char* GetSubmissionName(viscom::PointCloudSubmission submission)
+    {
+        return submission == viscom::PointCloudSubmission::Indirect ? "indirect" : "per-node";
+    }
+
+    /** Returns the sorted frame times of a run. */
+    std::vector<double> GetSortedFrameTimes(const std::vector<FrameMeasurement>& frames)
+    {
+        std::vector<double> frameTimes;
+        for (const auto& frame : frames) frameTimes.push_back(frame.frameTime);
+        std::sort(frameTimes.begin(), frameTimes.end());
+        return frameTimes;
+    }
+
+    void WriteReport(std::ostream& out, const HeadlessOptions& options, const std::string& glRenderer, viscom::PointCloudSubmission submission,
+        const std::vector<FrameMeasurement>& frames, const viscom::PointCloudStreamingStatistics& streaming, const viscom::ProgramBinaryCacheStatistics& programs)
+    {
+        auto frameTimes = GetSortedFrameTimes(frames);
+        double frameTimeSum = 0.0;
+        std::uint64_t pointsSum = 0, pointsMin = frames.empty() ? 0 : frames.front().numDrawnPoints, pointsMax = 0;
+        std::uint64_t uploadedSum = 0, uploadedMax = 0;
+        std::uint64_t nodesSum = 0, drawCallsSum = 0, drawCallsMax = 0;
+        for (const auto& frame : frames) {
+            frameTimeSum += frame.frameTime;
+            pointsSum += frame.numDrawnPoints;
+            pointsMin = std::min(pointsMin, frame.numDrawnPoints);
+            pointsMax = std::max(pointsMax, frame.numDrawnPoints);
+            uploadedSum += frame.uploadedBytes;
+            uploadedMax = std::max(uploadedMax, frame.uploadedBytes);
+            nodesSum += frame.numDrawnNodes;
+            drawCallsSum += frame.numDrawCalls;
+            drawCallsMax = std::max(drawCallsMax, frame.numDrawCalls);
+        }
+        auto numFrames = static_cast<double>(std::max<std::size_t>(frames.size(), 1));
+
+        out << "{" << std::endl
+            << "  \"file\": \"" << EscapeJSON(options.filename) << "\"," << std::endl
+            << "  \"cameraPath\": \"" << EscapeJSON(options.pathFilename) << "\"," << std::endl
+            << "  \"renderer\": \"" << EscapeJSON(glRenderer) << "\"," << std::endl
+            << "  \"rasterizer\": \"" << (options.software ? "cpu" : "gpu") << "\"," << std::endl
+            << "  \"submission\": \"" << GetSubmissionName(submission) << "\"," << std::endl
+            << "  \"width\": " << options.width << "," << std::endl
+            << "  \"height\": " << options.height << "," << std::endl
+            << "  \"fps\": " << options.fps << "," << std::endl
+            << "  \"pointBudget\": " << options.lodParameters.pointBudget_ << "," << std::endl
+            << "  \"frames\": " << frames.size() << "," << std::endl
+            << "  \"frameTimeMs\": { \"mean\": " << frameTimeSum / numFrames
+            << ", \"p50\": " << GetPercentile(frameTimes, 50.0) << ", \"p90\": " << GetPercentile(frameTimes, 90.0)
+            << ", \"p95\": " << GetPercentile(frameTimes, 95.0) << ", \"p99\": " << GetPercentile(frameTimes, 99.0)
+            << ", \"max\": " << frameTimes.back() << " }," << std::endl
+            << "  \"pointsDrawn\": { \"mean\": " << static_cast<double>(pointsSum) / numFrames << ", \"min\": " << pointsMin
+            << ", \"max\": " << pointsMax << ", \"total\": " << pointsSum << " }," << std::endl
+            << "  \"nodesDrawn\": { \"mean\": " << static_cast<double>(nodesSum) / numFrames << " }," << std::endl
+            << "  \"drawCalls\": { \"mean\": " << static_cast<double>(drawCallsSum) / numFrames << ", \"max\": " << drawCallsMax << " }," << std::endl
+            << "  \"bytesUploaded\": { \"total\": " << uploadedSum << ", \"maxPerFrame\": " << uploadedMax << " }," << std::endl
+            << "  \"residentBytes\": " << streaming.residentBytes_ << "," << std::endl
+            << "  \"evictedNodes\": " << streaming.numEvictedNodes_ << "," << std::endl
+            << "  \"programs\": { \"loaded\": " << programs.numLoaded_ << ", \"loadTimeMs\": " << programs.loadTime_
+            << ", \"compiled\": " << programs.numCompiled_ << ", \"compileTimeMs\": " << programs.compileTime_ << " }" << std::endl
+            << "}" << std::endl;
+    }
+
+    /**
+     *  Writes the draw calls and frame times of the runs of a sweep, one run per point budget and submission mode.
+     */
+    void WriteSweepReport(std::ostream& out, const HeadlessOptions& options, const std::string& glRenderer, const std::vector<SweepRun>& runs)
+    {
+        out << "{" << std::endl
+            << "  \"file\": \"" << EscapeJSON(options.filename) << "\"," << std::endl
+            << "  \"cameraPath\": \"" << EscapeJSON(options.pathFilename) << "\"," << std::endl
+            << "  \"renderer\": \"" << EscapeJSON(glRenderer) << "\"," << std::endl
+            << "  \"width\": " << options.width << "," << std::endl
+            << "  \"height\": " << options.height << "," << std::endl
+            << "  \"runs\": [" << std::endl;
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            const auto& run = runs[i];
+            auto frameTimes = GetSortedFrameTimes(run.frames);
+            double frameTimeSum = 0.0, nodesSum = 0.0, drawCallsSum = 0.0;
+            for (const auto& frame : run.frames) {
+                frameTimeSum += frame.frameTime;
+                nodesSum += static_cast<double>(frame.numDrawnNodes);
+                drawCallsSum += static_cast<double>(frame.numDrawCalls);
+            }
+            auto numFrames = static_cast<double>(std::max<std::size_t>(run.frames.size(), 1));
+            out << "    { \"submission\": \"" << GetSubmissionName(run.submission) << "\", \"pointBudget\": " << run.pointBudget
+                << ", \"nodesDrawn\": " << nodesSum / numFrames << ", \"drawCalls\": " << drawCallsSum / numFrames
+                << ", \"frameTimeMs\": { \"mean\": " << frameTimeSum / numFrames << ", \"p50\": " << GetPercentile(frameTimes, 50.0)
+                << ", \"p95\": " << GetPercentile(frameTimes, 95.0) << " } }" << (i + 1 < runs.size() ? "," : "") << std::endl;
+        }
+        out << "  ]" << std::endl
+            << "}" << std::endl;
+    }
+
+    /**
+     *  Replays the camera path through a point cloud renderer. Path time advances by a fixed step per frame, so every
+     *  run sees the same camera poses regardless of how fast frames are drawn.
+     */
+    std::vector<FrameMeasurement> ReplayPath(const HeadlessOptions& options, const viscom::CameraPath& path, viscom::PointCloudRenderer& renderer,
+        const viscom::LODTraversalParameters& lodParameters, GLuint softwareProgram)
+    {
+        auto projection = glm::perspective(glm::radians(options.fov), static_cast<float>(options.width) / static_cast<float>(options.height), 0.1f, 1000.0f);
+        auto numFrames = static_cast<int>(std::floor(path.GetDuration() * options.fps)) + 1;
+
+        std::vector<FrameMeasurement> frames;
+        gl::glEnable(gl::GL_DEPTH_TEST);
+        gl::glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        using Clock = std::chrono::high_resolution_clock;
+        for (auto frame = -options.numWarmupFrames; frame < numFrames; ++frame) {
+            auto keyframe = path.Sample(static_cast<double>(std::max(frame, 0)) / options.fps);
+            auto view = glm::inverse(glm::translate(glm::mat4(1.0f), keyframe.position_) * glm::mat4_cast(keyframe.GetOrientation()));
+
+            auto start = Clock::now();
+            renderer.BeginFrame();
+            gl::glClear(gl::GL_COLOR_BUFFER_BIT | gl::GL_DEPTH_BUFFER_BIT);
+            if (softwareProgram != 0) renderer.DrawSoftware(projection * view, lodParameters, softwareProgram);
+            else renderer.Draw(projection * view, lodParameters);
+            // waiting for the GPU makes the measured time include the drawing, not only its submission.
+            gl::glFinish();
+            auto frameTime = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            if (frame < 0) continue;
+            frames.push_back(FrameMeasurement{ frameTime, renderer.GetNumDrawnPoints(), renderer.GetNumDrawnNodes(), renderer.GetNumDrawCalls(),
+                renderer.GetStreamingStatistics().uploadedBytes_ });
+        }
+        return frames;
+    }
+
+    /** Returns the indirect point cloud program or 0 if the context does not support it. */
+    GLuint GetIndirectProgram(viscom::ProgramBinaryCache& programCache)
+    {
+        GLint majorVersion = 0, minorVersion = 0;
+        gl::glGetIntegerv(gl::GL_MAJOR_VERSION, &majorVersion);
+        gl::glGetIntegerv(gl::GL_MINOR_VERSION, &minorVersion);
+        if (majorVersion < 4 || (majorVersion == 4 && minorVersion < 3)) return 0;
+        return programCache.GetProgram("pointCloudIndirect", { "pointCloudIndirect.vert", "pointCloud.frag" });
+    }
+
+    /**
+     *  Replays the camera path through the point cloud renderer of the application and reports the frame times, or
+     *  with a sweep the frame times and draw calls of each point budget with both submission modes.
+     */
+    int RunBenchmark(const HeadlessOptions& options)
+    {
+        viscom::CameraPath path{ options.pathFilename };
+        if (path.IsEmpty()) throw std::runtime_error("The camera path \"" + options.pathFilename + "\" has no keyframes.");
+
+        HeadlessContext context;
+        OffscreenFramebuffer framebuffer{ options.width, options.height };
+        std::string glRenderer = reinterpret_cast<const char*>(gl::glGetString(gl::GL_RENDERER));
+        viscom::ProgramBinaryCacheStatistics programStatistics;
+
+        std::vector<FrameMeasurement> frames;
+        std::vector<SweepRun> sweepRuns;
+        viscom::PointCloudStreamingStatistics streaming;
+        auto submission = options.submission;
+        {
+            viscom::ProgramBinaryCache programCache{ options.shaderDirectory, options.programCacheDirectory };
+            auto program = programCache.GetProgram("pointCloud", { "pointCloud.vert", "pointCloud.frag" });
+            auto indirectProgram = GetIndirectProgram(programCache);
+            auto softwareProgram = options.software ? programCache.GetProgram("softwareRasterizer", { "softwareRasterizer.vert", "softwareRasterizer.frag" }) : 0;
+            programStatistics = programCache.GetStatistics();
+            if (indirectProgram == 0 && (submission == viscom::PointCloudSubmission::Indirect || !options.sweepPointBudgets.empty())) {
+                std::cerr << "OpenGL 4.3 is not available, nodes are drawn with a draw call each." << std::endl;
+            }
+
+            if (options.sweepPointBudgets.empty()) {
+                viscom::PointCloudRenderer renderer{ options.filename, program, indirectProgram, options.numLoaderThreads };
+                renderer.SetSubmission(submission);
+                submission = renderer.GetSubmission();
+                frames = ReplayPath(options, path, renderer, options.lodParameters, softwareProgram);
+                streaming = renderer.GetStreamingStatistics();
+            }
+
+            // every run starts with an empty renderer, so the uploads of earlier runs do not change the results.
+            for (auto pointBudget : options.sweepPointBudgets) {
+                for (auto sweepSubmission : { viscom::PointCloudSubmission::PerNode, viscom::PointCloudSubmission::Indirect }) {
+                    if (sweepSubmission == viscom::PointCloudSubmission::Indirect && indirectProgram == 0) continue;
+                    viscom::PointCloudRenderer renderer{ options.filename, program, indirectProgram, options.numLoaderThreads };
+                    renderer.SetSubmission(sweepSubmission);
+                    auto lodParameters = options.lodParameters;
+                    lodParameters.pointBudget_ = pointBudget;
+                    sweepRuns.push_back(SweepRun{ sweepSubmission, pointBudget, ReplayPath(options, path, renderer, lodParameters, 0) });
+                }
+            }
+        }
+
+        std::ofstream outputFile;
+        if (!options.outputFilename.empty()) {
+            outputFile.open(options.outputFilename);
+            if (!outputFile) throw std::runtime_error("Could not create file \"" + options.outputFilename + "\".");
+        }
+        auto& output = options.outputFilename.empty() ? std::cout : outputFile;
+        if (!options.sweepPointBudgets.empty()) WriteSweepReport(output, options, glRenderer, sweepRuns);
+        else WriteReport(output, options, glRenderer, submission, frames, streaming, programStatistics);
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    HeadlessOptions options;
+    for (auto i = 1; i < argc; ++i) {
+        auto hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--file") == 0 && hasValue) options.filename = argv[++i];
+        else if (std::strcmp(argv[i], "--path") == 0 && hasValue) options.pathFilename = argv[++i];
+        else if (std::strcmp(argv[i], "--width") == 0 && hasValue) options.width = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--height") == 0 && hasValue) options.height = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--fps") == 0 && hasValue) options.fps = std::max(1.0, std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--fov") == 0 && hasValue) options.fov = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue) options.numWarmupFrames = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--point-budget") == 0 && hasValue) options.lodParameters.pointBudget_ = std::strtoull(argv[++i], nullptr, 10) * 1000;
+        else if (std::strcmp(argv[i], "--loader-threads") == 0 && hasValue) options.numLoaderThreads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        else if (std::strcmp(argv[i], "--software") == 0) options.software = true;
+        else if (std::strcmp(argv[i], "--submission") == 0 && hasValue) {
+            std::string submission = argv[++i];
+            if (submission == "indirect") options.submission = viscom::PointCloudSubmission::Indirect;
+            else if (submission == "per-node") options.submission = viscom::PointCloudSubmission::PerNode;
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--sweep") == 0 && hasValue) {
+            std::stringstream budgets{ argv[++i] };
+            std::string budget;
+            while (std::getline(budgets, budget, ',')) options.sweepPointBudgets.push_back(std::strtoull(budget.c_str(), nullptr, 10) * 1000);
+        }
+        else if (std::strcmp(argv[i], "--shaders") == 0 && hasValue) options.shaderDirectory = argv[++i];
+        else if (std::strcmp(argv[i], "--program-cache") == 0 && hasValue) options.programCacheDirectory = argv[++i];
+        else if (std::strcmp(argv[i], "--output") == 0 && hasValue) options.outputFilename = argv[++i];
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (options.filename.empty() || options.pathFilename.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    // the renderer logs through g3log like the application, the report itself goes to the standard output.
+    auto worker = g3::LogWorker::createLogWorker();
+    worker->addDefaultLogger("pointcloudheadless", "./");
+    initializeLogging(worker.get());
+
+    try {
+        return RunBenchmark(options);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,199 @@
+/**
+ * @file   main.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.17
+ *
+ * @brief  Entry point of the decoder of OpenGL call traces.
+ */
+
+#include "app/GLTraceFormat.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: GLTraceDecoder [options] <trace.bin>" << std::endl
+            << "Options:" << std::endl
+            << "  --summary      print the number of calls per function and the errors instead of every record" << std::endl
+            << "  --frame <n>    only decode the records of frame n" << std::endl;
+    }
+
+    /** A decoded trace file. */
+    struct GLTrace
+    {
+        /** The file header. */
+        viscom::GLTraceFileHeader header_;
+        /** The names of the functions. */
+        std::vector<std::string> functionNames_;
+        /** The records in file order (per thread and frame). */
+        std::vector<viscom::GLTraceRecord> records_;
+    };
+
+    GLTrace ReadTrace(const std::string& filename)
+    {
+        std::ifstream file{ filename, std::ios::binary };
+        if (!file) throw std::runtime_error("Could not open file \"" + filename + "\".");
+
+        GLTrace trace;
+        if (!file.read(reinterpret_cast<char*>(&trace.header_), sizeof(viscom::GLTraceFileHeader))
+            || trace.header_.magic_ != viscom::GLTRACE_MAGIC) throw std::runtime_error("\"" + filename + "\" is no OpenGL trace.");
+        if (trace.header_.version_ != viscom::GLTRACE_VERSION) throw std::runtime_error("Unsupported trace version " + std::to_string(trace.header_.version_) + ".");
+
+        trace.functionNames_.resize(trace.header_.numFunctions_);
+        for (auto& name : trace.functionNames_) {
+            std::uint16_t length = 0;
+            file.read(reinterpret_cast<char*>(&length), sizeof(length));
+            name.resize(length);
+            if (length > 0) file.read(&name[0], length);
+        }
+        if (!file) throw std::runtime_error("The function table of \"" + filename + "\" is truncated.");
+
+        viscom::GLTraceRecord record;
+        while (file.read(reinterpret_cast<char*>(&record), sizeof(viscom::GLTraceRecord))) {
+            // records of a crashed application may be cut off, they are ignored.
+            if (record.type_ == viscom::GLTraceRecordType::Call && record.function_ >= trace.functionNames_.size()) continue;
+            record.numArguments_ = std::min(record.numArguments_, static_cast<std::uint8_t>(viscom::GLTRACE_MAX_ARGUMENTS));
+            trace.records_.push_back(record);
+        }
+        return trace;
+    }
+
+    void PrintArgument(viscom::GLTraceArgumentType type, std::uint64_t bits)
+    {
+        switch (type) {
+        case viscom::GLTraceArgumentType::Int: std::cout << static_cast<std::int64_t>(bits); break;
+        case viscom::GLTraceArgumentType::UInt: std::cout << bits; break;
+        case viscom::GLTraceArgumentType::Float: {
+            auto floatBits = static_cast<std::uint32_t>(bits);
+            float value;
+            std::memcpy(&value, &floatBits, sizeof(value));
+            std::cout << value;
+            break;
+        }
+        case viscom::GLTraceArgumentType::Double: {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            std::cout << value;
+            break;
+        }
+        case viscom::GLTraceArgumentType::Enum: std::cout << "0x" << std::hex << std::setw(4) << std::setfill('0') << bits << std::dec << std::setfill(' '); break;
+        case viscom::GLTraceArgumentType::Boolean: std::cout << (bits != 0 ? "GL_TRUE" : "GL_FALSE"); break;
+        case viscom::GLTraceArgumentType::Pointer: std::cout << "0x" << std::hex << bits << std::dec; break;
+        default: std::cout << "?"; break;
+        }
+    }
+
+    void PrintRecords(const GLTrace& trace, std::int64_t frameFilter)
+    {
+        std::uint64_t frame = 0;
+        for (const auto& record : trace.records_) {
+            if (record.type_ == viscom::GLTraceRecordType::Frame) frame = record.arguments_[0];
+            if (frameFilter >= 0 && frame != static_cast<std::uint64_t>(frameFilter)) continue;
+
+            std::cout << std::setw(6) << frame << std::fixed << std::setprecision(3) << std::setw(12) << static_cast<double>(record.timestamp_) * 1e-6
+                << " ms  thread " << std::setw(2) << record.thread_ << "  ";
+            std::cout.unsetf(std::ios::floatfield);
+            std::cout << std::setprecision(6);
+            switch (record.type_) {
+            case viscom::GLTraceRecordType::Call:
+                std::cout << trace.functionNames_[record.function_] << "(";
+                for (auto i = 0U; i < record.numArguments_; ++i) {
+                    if (i > 0) std::cout << ", ";
+                    PrintArgument(record.argumentTypes_[i], record.arguments_[i]);
+                }
+                std::cout << ")";
+                break;
+            case viscom::GLTraceRecordType::Error:
+                std::cout << "error 0x" << std::hex << std::setw(4) << std::setfill('0') << record.arguments_[0] << std::dec << std::setfill(' ');
+                break;
+            case viscom::GLTraceRecordType::Frame:
+                std::cout << "--- frame " << record.arguments_[0] << " ---";
+                break;
+            case viscom::GLTraceRecordType::Dropped:
+                std::cout << "[" << record.arguments_[0] << " records dropped]";
+                break;
+            default:
+                std::cout << "[unknown record]";
+                break;
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    void PrintSummary(const GLTrace& trace)
+    {
+        std::map<std::uint16_t, std::uint64_t> callCounts;
+        std::map<std::uint64_t, std::uint64_t> errorCounts;
+        std::uint64_t numCalls = 0, numFrames = 0, numDropped = 0;
+        for (const auto& record : trace.records_) {
+            switch (record.type_) {
+            case viscom::GLTraceRecordType::Call: ++callCounts[record.function_]; ++numCalls; break;
+            case viscom::GLTraceRecordType::Error: ++errorCounts[record.arguments_[0]]; break;
+            case viscom::GLTraceRecordType::Frame: ++numFrames; break;
+            case viscom::GLTraceRecordType::Dropped: numDropped += record.arguments_[0]; break;
+            default: break;
+            }
+        }
+
+        std::vector<std::pair<std::uint16_t, std::uint64_t>> sortedCounts{ callCounts.begin(), callCounts.end() };
+        std::sort(sortedCounts.begin(), sortedCounts.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+
+        auto samplingInterval = std::max(trace.header_.samplingInterval_, 1U);
+        std::cout << numCalls << " recorded calls in " << numFrames << " frames (1 in " << samplingInterval << " calls recorded, "
+            << numDropped << " records dropped)." << std::endl;
+        std::cout << std::setw(40) << std::left << "function" << std::right << std::setw(12) << "calls" << std::setw(14) << "per frame" << std::endl;
+        for (const auto& count : sortedCounts) {
+            std::cout << std::setw(40) << std::left << trace.functionNames_[count.first] << std::right << std::setw(12) << count.second * samplingInterval
+                << std::fixed << std::setprecision(1) << std::setw(14) << static_cast<double>(count.second * samplingInterval) / static_cast<double>(std::max(numFrames, std::uint64_t{ 1 }))
+                << std::endl;
+            std::cout.unsetf(std::ios::floatfield);
+        }
+        for (const auto& error : errorCounts) {
+            std::cout << "error 0x" << std::hex << std::setw(4) << std::setfill('0') << error.first << std::dec << std::setfill(' ') << ": " << error.second << std::endl;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto summary = false;
+    std::int64_t frame = -1;
+    std::vector<std::string> files;
+
+    for (auto i = 1; i < argc; ++i) {
+        auto hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--summary") == 0) summary = true;
+        else if (std::strcmp(argv[i], "--frame") == 0 && hasValue) frame = std::atoll(argv[++i]);
+        else if (argv[i][0] == '-') {
+            PrintUsage();
+            return 1;
+        }
+        else files.emplace_back(argv[i]);
+    }
+    if (files.size() != 1) {
+        PrintUsage();
+        return 1;
+    }
+
+    try {
+        auto trace = ReadTrace(files[0]);
+        if (summary) PrintSummary(trace);
+        else PrintRecords(trace, frame);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}